@@ -5,7 +5,10 @@
 #include "ce_service.h"
 #include "compiledbreader.h"
 
+#include <compiledb.h>
+
 #include <QComboBox>
+#include <QDebug>
 #include <QEvent>
 #include <QHBoxLayout>
 #include <QHoverEvent>
@@ -108,10 +111,16 @@ CEWidget::CEWidget(CEPluginView *pluginView, KTextEditor::MainWindow *mainWindow
 
     QString file = doc->url().toLocalFile();
     QString compilecmds = CompileDBReader::locateCompileCommands(m_mainWindow, file);
-    QString args = CompileDBReader::filteredArgsForFile(compilecmds, file);
-    m_lineEdit->setText(args);
+    // the database is read on a worker thread the first time
+    CompileDB::commandForFile(compilecmds, file, this, [this, file](const QString &command) {
+        if (command.isEmpty() && !file.isEmpty()) {
+            qWarning() << "compile_command for " << file << " not found";
+        }
+        QString args = CompileDBReader::filteredArgsForFile(command, file);
+        m_lineEdit->setText(args);
 
-    warnIfBadArgs(args.split(QLatin1Char(' ')));
+        warnIfBadArgs(args.split(QLatin1Char(' ')));
+    });
 
     setFocusPolicy(Qt::StrongFocus);
 }
@@ -1,12 +1,7 @@
 #include "compiledbreader.h"
 
-#include <QDir>
 #include <QFile>
 #include <QFileInfo>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonValue>
 #include <QProcess>
 #include <QVariant>
 
@@ -79,48 +74,6 @@ QString CompileDBReader::locateCompileCommands(KTextEditor::MainWindow *mw, cons
     return QString();
 }
 
-QString CompileDBReader::argsForFile(const QString &compile_commandsPath, const QString &file)
-{
-    QFile f(compile_commandsPath);
-    if (!f.open(QFile::ReadOnly)) {
-        // TODO: Use Output view to report error
-        qWarning() << "Failed to load compile_commands: " << f.errorString();
-        return {};
-    }
-
-    QJsonParseError error;
-    QJsonDocument cmdCmds = QJsonDocument::fromJson(f.readAll(), &error);
-    if (error.error != QJsonParseError::NoError) {
-        qWarning() << "Failed to read compile_commands: " << error.errorString();
-        return {};
-    }
-
-    if (!cmdCmds.isArray()) {
-        qWarning() << "Invalid compile_commands, root element is not an array";
-        return {};
-    }
-
-    QJsonArray commandsArray = cmdCmds.array();
-
-    for (const auto &cmdJV : commandsArray) {
-        auto compileCommand = cmdJV.toObject();
-        auto cmpCmdFile = compileCommand.value(QStringLiteral("file")).toString();
-
-        QFileInfo fi(cmpCmdFile);
-        if (fi.isRelative()) {
-            QString dir = QDir::cleanPath(compileCommand.value(QStringLiteral("directory")).toString());
-            //             QString file = QDir::cleanPath(dir + QStringLiteral("/") + cmpCmdFile);
-        } else {
-            if (fi.canonicalFilePath() == file) {
-                return compileCommand.value(QStringLiteral("command")).toString();
-            }
-        }
-    }
-
-    qWarning() << "compile_command for " << file << " not found";
-    return {};
-}
-
 static void addCurrentFilePathToCompileCommands(const QString &currentCompiler, QStringList &commands, const QString &fileBasePath)
 {
     // For these compilers we include the current file path to
@@ -162,14 +115,12 @@ static void removeIncludeArgument(QStringList &commands)
     }
 }
 
-QString CompileDBReader::filteredArgsForFile(const QString &compile_commandsPath, const QString &file)
+QString CompileDBReader::filteredArgsForFile(const QString &command, const QString &file)
 {
-    QString args = argsForFile(compile_commandsPath, file);
-
     QFileInfo fi(file);
     QString fileBasePath = fi.canonicalPath();
 
-    QStringList argsList = args.split(QLatin1Char(' '));
+    QStringList argsList = command.split(QLatin1Char(' '));
     QString currentCompiler = argsList.takeFirst(); // First is the compiler, drop it
     QStringList finalArgs;
     finalArgs.reserve(argsList.size() - 2);
@@ -1,7 +1,6 @@
 #ifndef KATE_CMP_DB_READER_H
 #define KATE_CMP_DB_READER_H
 
-#include <QHash>
 #include <QString>
 
 namespace KTextEditor
@@ -20,21 +19,11 @@ public:
     static QString locateCompileCommands(KTextEditor::MainWindow *mw, const QString &openedFile);
 
     /**
-     * Get compiler args for file
-     */
-    static QString argsForFile(const QString &compile_commandsPath, const QString &file);
-
-    /**
-     * Filter some args like -o file.o
+     * Filter some args like -o file.o from the compile command of @file
      *
      * adds the path of @file to compile_commands
      */
-    static QString filteredArgsForFile(const QString &compile_commandsPath, const QString &file);
-
-    // private:
-    //     void readCompileCommands();
-    //
-    //     QHash<QString, QString> m_fileToArgs;
+    static QString filteredArgsForFile(const QString &command, const QString &file);
 };
 
 #endif // KATE_CMP_DB_READER_H
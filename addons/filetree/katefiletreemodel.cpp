@@ -28,6 +28,14 @@
 
 static constexpr int MaxHistoryItems = 10;
 
+// documents restored on demand by the application are not loaded yet,
+// they carry the url they will be loaded from
+static QUrl documentUrl(const KTextEditor::Document *doc)
+{
+    const QUrl url = doc->url();
+    return url.isEmpty() ? doc->property("unloadedUrl").toUrl() : url;
+}
+
 class ProxyItemDir;
 class ProxyItem
 {
@@ -347,7 +355,13 @@ const QString &ProxyItem::host() const
 
 void ProxyItem::updateDocumentName()
 {
-    const QString docName = m_doc ? m_doc->documentName() : QString();
+    QString docName;
+    if (m_doc) {
+        docName = m_doc->url().isEmpty() ? documentUrl(m_doc).fileName() : m_doc->documentName();
+        if (docName.isEmpty()) {
+            docName = m_doc->documentName();
+        }
+    }
 
     if (flag(ProxyItem::Host)) {
         m_documentName = QStringLiteral("[%1]%2").arg(m_host, docName);
@@ -1272,14 +1286,15 @@ void KateFileTreeModel::updateItemPathAndHost(ProxyItem *item)
     const KTextEditor::Document *doc = item->doc();
     Q_ASSERT(doc); // this method should not be called at directory items
 
-    QString path = doc->url().path();
+    const QUrl url = documentUrl(doc);
+    QString path = url.path();
     QString host;
-    if (doc->url().isEmpty()) {
+    if (url.isEmpty()) {
         path = doc->documentName();
         item->setFlag(ProxyItem::Empty);
     } else {
         item->clearFlag(ProxyItem::Empty);
-        host = doc->url().host();
+        host = url.host();
         if (!host.isEmpty()) {
             path = QStringLiteral("[%1]%2").arg(host, path);
         }
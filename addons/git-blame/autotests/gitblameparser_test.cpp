@@ -0,0 +1,82 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "gitblameparser_test.h"
+#include "gitblamecache.h"
+
+#include <QTest>
+
+QTEST_MAIN(GitBlameParserTest)
+
+static const QByteArray HashA("5c7f27a0915a9b20dc9f683d0d85b6e4b829bc85");
+static const QByteArray HashB("e3a1b0c9d8f7e6d5c4b3a29180716253a4b5c6d7");
+
+// git blame -p: details only for the first block of a commit, the last line has no newline
+static QByteArray porcelain()
+{
+    return HashA + " 1 1 2\n"
+                   "author Jane Doe\n"
+                   "author-mail <jane@example.org>\n"
+                   "author-time 1600000000\n"
+                   "author-tz +0200\n"
+                   "summary First commit\n"
+                   "filename file.txt\n"
+                   "\tline one\n"
+        + HashA + " 2 2\n"
+                  "\tline two\n"
+        + HashB + " 1 3 1\n"
+                  "author John Doe\r\n"
+                  "author-time 1700000000\n"
+                  "summary Second commit\n"
+                  "previous " + HashA + " file.txt\n"
+                  "filename file.txt\n"
+                  "\tline three\n"
+        + HashA + " 3 4 1\n"
+                  "filename file.txt\n"
+                  "\tline four";
+}
+
+void GitBlameParserTest::chunks_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    // all at once, byte by byte and split at all kinds of places in between
+    for (int chunkSize : {porcelain().size(), 1, 2, 3, 7, 16, 41, 100}) {
+        QTest::addRow("%d", chunkSize) << chunkSize;
+    }
+}
+
+void GitBlameParserTest::chunks()
+{
+    QFETCH(int, chunkSize);
+
+    const QByteArray data = porcelain();
+    GitBlameParser parser;
+    for (int pos = 0; pos < data.size(); pos += chunkSize) {
+        parser.feed(data.mid(pos, chunkSize));
+    }
+    parser.finish();
+
+    const BlameResult &result = parser.result();
+    QCOMPARE(int(result.lines.size()), 4);
+    QCOMPARE(result.lines[0].commitHash, HashA);
+    QCOMPARE(result.lines[1].commitHash, HashA);
+    QCOMPARE(result.lines[2].commitHash, HashB);
+    QCOMPARE(result.lines[3].commitHash, HashA);
+
+    // repeated commits are stored once, their details are not overwritten
+    QCOMPARE(result.commits.size(), 2);
+    const CommitInfo a = result.commits.value(HashA);
+    QCOMPARE(a.hash, HashA);
+    QCOMPARE(a.authorName, QStringLiteral("Jane Doe"));
+    QCOMPARE(a.authorDate, QDateTime::fromSecsSinceEpoch(1600000000));
+    QCOMPARE(a.summary, QByteArray("First commit"));
+
+    const CommitInfo b = result.commits.value(HashB);
+    QCOMPARE(b.authorName, QStringLiteral("John Doe"));
+    QCOMPARE(b.authorDate, QDateTime::fromSecsSinceEpoch(1700000000));
+    QCOMPARE(b.summary, QByteArray("Second commit"));
+}
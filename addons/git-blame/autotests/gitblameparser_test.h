@@ -0,0 +1,21 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef GITBLAMEPARSER_TEST_H
+#define GITBLAMEPARSER_TEST_H
+
+#include <QObject>
+
+class GitBlameParserTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void chunks_data();
+    void chunks();
+};
+
+#endif
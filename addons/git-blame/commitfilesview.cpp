@@ -6,6 +6,7 @@
 */
 #include "commitfilesview.h"
 
+#include <gitdiffprovider.h>
 #include <gitprocess.h>
 
 #include <QDebug>
@@ -362,6 +363,8 @@ CommitDiffTreeView::CommitDiffTreeView(QWidget *parent)
     connect(&m_tree, &QTreeView::clicked, this, &CommitDiffTreeView::showDiff);
 }
 
+CommitDiffTreeView::~CommitDiffTreeView() = default;
+
 void CommitDiffTreeView::openCommit(const QString &hash, const QString &filePath)
 {
     m_commitHash = hash;
@@ -398,6 +401,12 @@ void CommitDiffTreeView::createFileTreeForCommit(const QString &filePath, const
         m_gitDir = value.value();
     }
 
+    // all patches of the commit at once when the first file is clicked
+    m_diffProvider = std::make_unique<GitDiffProvider>(m_gitDir, QStringList{QStringLiteral("show"), QStringLiteral("--format="), m_commitHash});
+    connect(m_diffProvider.get(), &GitDiffProvider::diffReady, this, [this](const QString &, const QByteArray &patch) {
+        Q_EMIT showDiffRequested(patch);
+    });
+
     QStandardItem root;
     createFileTree(&root, m_gitDir, parseNumStat(rawNumStat));
 
@@ -443,18 +452,9 @@ void CommitDiffTreeView::createFileTreeForCommit(const QString &filePath, const
 
 void CommitDiffTreeView::showDiff(const QModelIndex &idx)
 {
-    const QString file = idx.data(FileItem::Path).toString();
-    QProcess git;
-    if (!setupGitProcess(git, m_gitDir, {QStringLiteral("show"), m_commitHash, QStringLiteral("--"), file})) {
+    if (!m_diffProvider || idx.data(FileItem::TypeRole).toInt() != FileItem::File) {
         return;
     }
-    git.start(QProcess::ReadOnly);
-
-    if (git.waitForStarted() && git.waitForFinished(-1)) {
-        if (git.exitStatus() != QProcess::NormalExit || git.exitCode() != 0) {
-            return;
-        }
-    }
 
-    Q_EMIT showDiffRequested(git.readAllStandardOutput());
+    m_diffProvider->requestFile(QDir(m_gitDir).relativeFilePath(idx.data(FileItem::Path).toString()));
 }
@@ -6,6 +6,10 @@
 #include <QTreeView>
 #include <QWidget>
 
+#include <memory>
+
+class GitDiffProvider;
+
 struct GitFileItem {
     QByteArray file;
     int linesAdded;
@@ -28,6 +32,7 @@ class CommitDiffTreeView : public QWidget
     Q_OBJECT
 public:
     explicit CommitDiffTreeView(QWidget *parent);
+    ~CommitDiffTreeView() override;
 
     /**
      * open treeview for commit with @p hash
@@ -50,6 +55,8 @@ private:
     QStandardItemModel m_model;
     QString m_gitDir;
     QString m_commitHash;
+    // patches of all files of the commit
+    std::unique_ptr<GitDiffProvider> m_diffProvider;
 };
 
 #endif
@@ -0,0 +1,308 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "gitblamecache.h"
+
+#include <gitprocess.h>
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QProcess>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// results of about that many files are kept, a result costs some bytes per line
+static constexpr int MaxEntries = 32;
+
+// files opened in a row, e.g. on session restore, only the last ones are worth it
+static constexpr int MaxPrefetch = 16;
+
+void GitBlameParser::feed(const QByteArray &data)
+{
+    m_rest += data;
+
+    const char *begin = m_rest.constData();
+    const char *const end = begin + m_rest.size();
+    while (begin < end) {
+        const char *lineEnd = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        if (!lineEnd) {
+            break;
+        }
+        parseLine(begin, lineEnd);
+        begin = lineEnd + 1;
+    }
+    m_rest.remove(0, begin - m_rest.constData());
+}
+
+void GitBlameParser::finish()
+{
+    if (!m_rest.isEmpty()) {
+        parseLine(m_rest.constData(), m_rest.constData() + m_rest.size());
+        m_rest.clear();
+    }
+}
+
+static bool startsWith(const char *begin, const char *end, const char *prefix, int prefixLen)
+{
+    return end - begin >= prefixLen && memcmp(begin, prefix, prefixLen) == 0;
+}
+
+void GitBlameParser::parseLine(const char *begin, const char *end)
+{
+    /**
+     * The output has a block per line:
+     *
+     * 5c7f27a0915a9b20dc9f683d0d85b6e4b829bc85 1 1 5
+     * author Xyz                 <- only for the first line of a commit
+     * author-time 1634045600
+     * summary Some title
+     * ...
+     * <tab>the line text
+     */
+    if (begin < end && *begin == '\t') {
+        // the text itself, only needed to end the block
+        m_inHeader = false;
+        m_commit = nullptr;
+        return;
+    }
+
+    if (!m_inHeader) {
+        // hash original-line final-line [lines in group]
+        constexpr int hashLen = 40;
+        if (end - begin < hashLen + 1 || begin[hashLen] != ' ') {
+            return;
+        }
+
+        auto it = m_result.commits.find(QByteArray::fromRawData(begin, hashLen));
+        if (it == m_result.commits.end()) {
+            const QByteArray hash(begin, hashLen);
+            it = m_result.commits.insert(hash, CommitInfo{hash, {}, {}, {}});
+            m_commit = &it.value();
+        }
+        m_hash = it.key();
+
+        const char *finalLine = static_cast<const char *>(memchr(begin + hashLen + 1, ' ', end - begin - hashLen - 1));
+        if (!finalLine) {
+            return;
+        }
+        m_line = atoi(finalLine + 1) - 1;
+        if (m_line >= 0) {
+            if (m_line >= int(m_result.lines.size())) {
+                m_result.lines.resize(m_line + 1);
+            }
+            m_result.lines[m_line].commitHash = m_hash;
+        }
+        m_inHeader = true;
+        return;
+    }
+
+    // details only for the first block of a commit
+    if (!m_commit) {
+        return;
+    }
+
+    // KTextEditor removes all \r characters in the internal buffers
+    if (end > begin && end[-1] == '\r') {
+        --end;
+    }
+
+    constexpr char author[] = "author ";
+    constexpr char authorTime[] = "author-time ";
+    constexpr char summary[] = "summary ";
+    if (startsWith(begin, end, author, sizeof(author) - 1)) {
+        m_commit->authorName = QString::fromUtf8(begin + sizeof(author) - 1, end - begin - int(sizeof(author) - 1));
+    } else if (startsWith(begin, end, authorTime, sizeof(authorTime) - 1)) {
+        const QByteArray timestamp(begin + sizeof(authorTime) - 1, end - begin - int(sizeof(authorTime) - 1));
+        m_commit->authorDate = QDateTime::fromSecsSinceEpoch(timestamp.toLongLong());
+    } else if (startsWith(begin, end, summary, sizeof(summary) - 1)) {
+        m_commit->summary = QByteArray(begin + sizeof(summary) - 1, end - begin - int(sizeof(summary) - 1));
+    }
+}
+
+GitBlameCache::GitBlameCache(QObject *parent)
+    : QObject(parent)
+    , m_cancel(std::make_shared<std::atomic<bool>>(false))
+{
+    // one for the file shown, one for prefetching
+    m_pool.setMaxThreadCount(2);
+}
+
+GitBlameCache::~GitBlameCache()
+{
+    m_cancel->store(true);
+    m_pool.waitForDone();
+}
+
+void GitBlameCache::request(const QString &filePath)
+{
+    // running already, e.g. as prefetch => just deliver the result
+    auto it = m_running.find(filePath);
+    if (it != m_running.end()) {
+        it.value() = true;
+        return;
+    }
+
+    m_prefetchQueue.removeAll(filePath);
+    start(filePath, false);
+}
+
+void GitBlameCache::prefetch(const QString &filePath)
+{
+    if (m_running.contains(filePath) || m_prefetchQueue.contains(filePath)) {
+        return;
+    }
+
+    m_prefetchQueue.append(filePath);
+    if (m_prefetchQueue.size() > MaxPrefetch) {
+        m_prefetchQueue.removeFirst();
+    }
+    startNextPrefetch();
+}
+
+static bool isIgnoredError(const QByteArray &error)
+{
+    // this repo doesn't have any commits, not a repo or file not in git
+    return error.startsWith("fatal: no such ref: HEAD") || error.startsWith("fatal: not a git repository") || error.startsWith("fatal: no such path ");
+}
+
+void GitBlameCache::start(const QString &filePath, bool prefetch)
+{
+    m_running.insert(filePath, !prefetch);
+
+    const auto cancel = m_cancel;
+    m_pool.start([this, filePath, cancel] {
+        auto done = [this, filePath](std::shared_ptr<const BlameResult> result, const QString &error) {
+            QMetaObject::invokeMethod(
+                this,
+                [this, filePath, result, error] {
+                    finished(filePath, result, error);
+                },
+                Qt::QueuedConnection);
+        };
+
+        const QFileInfo info(filePath);
+
+        // the key: which version of which file
+        QProcess revParse;
+        if (!setupGitProcess(revParse, info.absolutePath(), {QStringLiteral("rev-parse"), QStringLiteral("--show-toplevel"), QStringLiteral("HEAD")})) {
+            done(nullptr, QString());
+            return;
+        }
+        revParse.start(QProcess::ReadOnly);
+        if (!revParse.waitForFinished(-1) || revParse.exitStatus() != QProcess::NormalExit || revParse.exitCode() != 0) {
+            // no repo or no commit yet, nothing to blame
+            done(nullptr, QString());
+            return;
+        }
+
+        QFile file(filePath);
+        if (!file.open(QFile::ReadOnly)) {
+            done(nullptr, QString());
+            return;
+        }
+        // like git hash-object, without filters, we just need to notice changes
+        const QByteArray content = file.readAll();
+        QCryptographicHash blob(QCryptographicHash::Sha1);
+        blob.addData("blob " + QByteArray::number(content.size()));
+        blob.addData("\0", 1);
+        blob.addData(content);
+
+        const QByteArray key = revParse.readAllStandardOutput() + filePath.toUtf8() + '\0' + blob.result();
+        if (auto result = lookup(key)) {
+            done(result, QString());
+            return;
+        }
+
+        QProcess git;
+        if (!setupGitProcess(git, info.absolutePath(), {QStringLiteral("blame"), QStringLiteral("-p"), QStringLiteral("--"), info.fileName()})) {
+            done(nullptr, QString());
+            return;
+        }
+        git.start(QProcess::ReadOnly);
+
+        // parse while git still works on the older lines
+        GitBlameParser parser;
+        while (!cancel->load()) {
+            const bool ready = git.waitForReadyRead(100);
+            parser.feed(git.readAllStandardOutput());
+            if (!ready && git.state() == QProcess::NotRunning) {
+                break;
+            }
+        }
+        if (cancel->load()) {
+            git.kill();
+            git.waitForFinished();
+            return;
+        }
+
+        parser.feed(git.readAllStandardOutput());
+        parser.finish();
+
+        if (git.exitStatus() != QProcess::NormalExit || git.exitCode() != 0) {
+            const QByteArray error = git.readAllStandardError();
+            done(nullptr, isIgnoredError(error) ? QString() : QString::fromUtf8(error));
+            return;
+        }
+
+        auto result = std::make_shared<const BlameResult>(std::move(parser.result()));
+        insert(key, result);
+        done(result, QString());
+    });
+}
+
+void GitBlameCache::finished(const QString &filePath, std::shared_ptr<const BlameResult> result, const QString &error)
+{
+    // requested by someone in the meantime?
+    const bool requested = m_running.take(filePath);
+    if (requested) {
+        if (result) {
+            Q_EMIT blameReady(filePath, result);
+        } else if (!error.isEmpty()) {
+            Q_EMIT blameFailed(filePath, error);
+        }
+    }
+
+    startNextPrefetch();
+}
+
+void GitBlameCache::startNextPrefetch()
+{
+    // only if idle, prefetching must not delay what is shown
+    if (!m_running.isEmpty() || m_prefetchQueue.isEmpty()) {
+        return;
+    }
+
+    // the last opened file first
+    start(m_prefetchQueue.takeLast(), true);
+}
+
+std::shared_ptr<const BlameResult> GitBlameCache::lookup(const QByteArray &key)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+    it->lastUse = ++m_useCounter;
+    return it->result;
+}
+
+void GitBlameCache::insert(const QByteArray &key, std::shared_ptr<const BlameResult> result)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(key, {std::move(result), ++m_useCounter});
+
+    if (m_entries.size() > MaxEntries) {
+        auto oldest = std::min_element(m_entries.begin(), m_entries.end(), [](const Entry &l, const Entry &r) {
+            return l.lastUse < r.lastUse;
+        });
+        m_entries.erase(oldest);
+    }
+}
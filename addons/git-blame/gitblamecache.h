@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef GitBlameCache_h
+#define GitBlameCache_h
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+struct CommitInfo {
+    QByteArray hash;
+    QString authorName;
+    QDateTime authorDate;
+    QByteArray summary;
+};
+
+struct BlamedLine {
+    // shared with the key in BlameResult::commits
+    QByteArray commitHash;
+};
+
+/**
+ * Blame of one version of a file, immutable once done, shared between cache and users.
+ */
+struct BlameResult {
+    QHash<QByteArray, CommitInfo> commits;
+    std::vector<BlamedLine> lines;
+};
+
+/**
+ * Parser for "git blame -p" output, fed with the output as it arrives.
+ */
+class GitBlameParser
+{
+public:
+    /**
+     * Parse all complete lines of data, keeps the rest for the next call.
+     */
+    void feed(const QByteArray &data);
+
+    /**
+     * Parse what is left, no more data will follow.
+     */
+    void finish();
+
+    BlameResult &result()
+    {
+        return m_result;
+    }
+
+private:
+    void parseLine(const char *begin, const char *end);
+
+    QByteArray m_rest;
+    BlameResult m_result;
+    QByteArray m_hash;
+    int m_line = -1;
+    CommitInfo *m_commit = nullptr;
+    bool m_inHeader = false;
+};
+
+/**
+ * Blame results of all main windows, least recently used ones are dropped.
+ *
+ * Results are keyed by repository, path, HEAD and the hash of the file content on disk,
+ * a result is valid as long as neither HEAD nor the file changes.
+ * git runs and the output is parsed on worker threads, only the result arrives on the GUI thread.
+ */
+class GitBlameCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit GitBlameCache(QObject *parent = nullptr);
+    ~GitBlameCache() override;
+
+    /**
+     * Blame the file as it is on disk, the result arrives via blameReady or blameFailed.
+     */
+    void request(const QString &filePath);
+
+    /**
+     * Blame the file in the background if nothing else is to do, to have it at hand later.
+     */
+    void prefetch(const QString &filePath);
+
+    Q_SIGNAL void blameReady(const QString &filePath, std::shared_ptr<const BlameResult> result);
+    Q_SIGNAL void blameFailed(const QString &filePath, const QString &error);
+
+private:
+    void start(const QString &filePath, bool prefetch);
+    void finished(const QString &filePath, std::shared_ptr<const BlameResult> result, const QString &error);
+    void startNextPrefetch();
+
+    std::shared_ptr<const BlameResult> lookup(const QByteArray &key);
+    void insert(const QByteArray &key, std::shared_ptr<const BlameResult> result);
+
+    // cache, guarded by the mutex, used from the workers
+    struct Entry {
+        std::shared_ptr<const BlameResult> result;
+        quint64 lastUse = 0;
+    };
+    QMutex m_mutex;
+    QHash<QByteArray, Entry> m_entries;
+    quint64 m_useCounter = 0;
+
+    // files being blamed, requested ones are delivered when done
+    QHash<QString, bool> m_running;
+    QStringList m_prefetchQueue;
+
+    std::shared_ptr<std::atomic<bool>> m_cancel;
+    QThreadPool m_pool;
+};
+
+#endif // GitBlameCache_h
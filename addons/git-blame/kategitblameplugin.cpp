@@ -18,6 +18,7 @@
 #include <KSharedConfig>
 #include <KXMLGUIFactory>
 
+#include <KTextEditor/Application>
 #include <KTextEditor/Document>
 #include <KTextEditor/Editor>
 #include <KTextEditor/InlineNoteInterface>
@@ -146,6 +147,19 @@ K_PLUGIN_FACTORY_WITH_JSON(KateGitBlamePluginFactory, "kategitblameplugin.json",
 KateGitBlamePlugin::KateGitBlamePlugin(QObject *parent, const QList<QVariant> &)
     : KTextEditor::Plugin(parent)
 {
+    // blame what gets opened in the background, likely to be looked at soon
+    auto application = KTextEditor::Editor::instance()->application();
+    connect(application, &KTextEditor::Application::documentCreated, this, [this](KTextEditor::Document *document) {
+        connect(document, &KTextEditor::Document::documentUrlChanged, this, &KateGitBlamePlugin::prefetch);
+        prefetch(document);
+    });
+}
+
+void KateGitBlamePlugin::prefetch(KTextEditor::Document *document)
+{
+    if (document->url().isLocalFile()) {
+        m_blameCache.prefetch(document->url().toLocalFile());
+    }
 }
 
 QObject *KateGitBlamePlugin::createView(KTextEditor::MainWindow *mainWindow)
@@ -156,8 +170,8 @@ QObject *KateGitBlamePlugin::createView(KTextEditor::MainWindow *mainWindow)
 KateGitBlamePluginView::KateGitBlamePluginView(KateGitBlamePlugin *plugin, KTextEditor::MainWindow *mainwindow)
     : QObject(plugin)
     , m_mainWindow(mainwindow)
+    , m_blameCache(plugin->blameCache())
     , m_inlineNoteProvider(this)
-    , m_blameInfoProc(this)
     , m_showProc(this)
     , m_tooltip(this)
 {
@@ -186,7 +200,8 @@ KateGitBlamePluginView::KateGitBlamePluginView(KateGitBlamePlugin *plugin, KText
 
     connect(m_mainWindow, &KTextEditor::MainWindow::viewChanged, this, &KateGitBlamePluginView::viewChanged);
 
-    connect(&m_blameInfoProc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &KateGitBlamePluginView::blameFinished);
+    connect(m_blameCache, &GitBlameCache::blameReady, this, &KateGitBlamePluginView::blameReady);
+    connect(m_blameCache, &GitBlameCache::blameFailed, this, &KateGitBlamePluginView::blameFailed);
 
     connect(&m_showProc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &KateGitBlamePluginView::showFinished);
 
@@ -196,8 +211,6 @@ KateGitBlamePluginView::KateGitBlamePluginView(KateGitBlamePlugin *plugin, KText
 KateGitBlamePluginView::~KateGitBlamePluginView()
 {
     // ensure to kill, we segfault otherwise
-    m_blameInfoProc.kill();
-    m_blameInfoProc.waitForFinished();
     m_showProc.kill();
     m_showProc.waitForFinished();
 
@@ -238,36 +251,146 @@ void KateGitBlamePluginView::viewChanged(KTextEditor::View *view)
 
     qobject_cast<KTextEditor::InlineNoteInterface *>(view)->registerInlineNoteProvider(&m_inlineNoteProvider);
 
-    startBlameProcess(url);
+    // split view or switched back: reuse what we have, the cache knows if it is still up to date
+    auto document = view->document();
+    if (!m_documents.contains(document)) {
+        trackDocument(document);
+    }
+    if (!document->isModified() || !m_documents.value(document).result) {
+        requestBlame(document);
+    }
 }
 
-void KateGitBlamePluginView::startBlameProcess(const QUrl &url)
+void KateGitBlamePluginView::trackDocument(KTextEditor::Document *document)
 {
-    // same document? maybe split view? => no work to do, reuse the result we already have
-    if (m_blameUrl == url) {
+    m_documents.insert(document, {});
+
+    connect(document, &KTextEditor::Document::textInserted, this, &KateGitBlamePluginView::textInserted);
+    connect(document, &KTextEditor::Document::textRemoved, this, &KateGitBlamePluginView::textRemoved);
+
+    // new content on disk, new blame
+    connect(document, &KTextEditor::Document::documentSavedOrUploaded, this, &KateGitBlamePluginView::requestBlame);
+    connect(document, &KTextEditor::Document::reloaded, this, [this](KTextEditor::Document *document) {
+        m_documents[document] = {};
+        requestBlame(document);
+    });
+    connect(document, &KTextEditor::Document::documentUrlChanged, this, [this](KTextEditor::Document *document) {
+        m_documents[document] = {};
+    });
+    connect(document, &KTextEditor::Document::aboutToClose, this, [this](KTextEditor::Document *document) {
+        m_documents.remove(document);
+        disconnect(document, nullptr, this, nullptr);
+    });
+}
+
+void KateGitBlamePluginView::requestBlame(KTextEditor::Document *document)
+{
+    const auto url = document->url();
+    if (url.isLocalFile()) {
+        m_blameCache->request(url.toLocalFile());
+    }
+}
+
+void KateGitBlamePluginView::blameReady(const QString &filePath, std::shared_ptr<const BlameResult> result)
+{
+    for (auto it = m_documents.begin(); it != m_documents.end(); ++it) {
+        KTextEditor::Document *document = it.key();
+        if (document->url().toLocalFile() != filePath) {
+            continue;
+        }
+
+        // the result is for the file on disk, with local edits keep what we remapped so far
+        if (document->isModified() && it->result) {
+            continue;
+        }
+
+        it->result = result;
+        it->lineMap.resize(document->lines());
+        for (int line = 0; line < int(it->lineMap.size()); ++line) {
+            it->lineMap[line] = line < int(result->lines.size()) ? line : -1;
+        }
+
+        if (document == activeDocument()) {
+            Q_EMIT m_inlineNoteProvider.inlineNotesReset();
+        }
+    }
+}
+
+void KateGitBlamePluginView::blameFailed(const QString &filePath, const QString &error)
+{
+    // only tell about the file we show
+    const auto document = activeDocument();
+    if (!document || document->url().toLocalFile() != filePath) {
         return;
     }
 
-    // clear everything
-    m_blameUrl.clear();
-    m_blamedLines.clear();
-    m_blameInfoForHash.clear();
+    sendMessage(i18n("Git blame failed.") + QStringLiteral("\n") + error, true);
+}
 
-    // Kill any existing process...
-    if (m_blameInfoProc.state() != QProcess::NotRunning) {
-        m_blameInfoProc.kill();
-        m_blameInfoProc.waitForFinished();
+void KateGitBlamePluginView::textInserted(KTextEditor::Document *document, const KTextEditor::Cursor &position, const QString &text)
+{
+    auto it = m_documents.find(document);
+    if (it == m_documents.end() || !it->result) {
+        return;
     }
 
-    QString fileName{url.fileName()};
-    QDir dir{url.toLocalFile()};
-    dir.cdUp();
+    auto &lineMap = it->lineMap;
+    const int line = position.line();
+    if (line < 0 || line >= int(lineMap.size())) {
+        return;
+    }
 
-    if (!setupGitProcess(m_blameInfoProc, dir.absolutePath(), {QStringLiteral("blame"), QStringLiteral("-p"), QStringLiteral("./%1").arg(fileName)})) {
+    const int newLines = text.count(QLatin1Char('\n'));
+    if (newLines == 0) {
+        lineMap[line] = -1;
         return;
     }
-    m_blameInfoProc.start(QIODevice::ReadOnly);
-    m_blameUrl = url;
+
+    // which of the lines now at line...line + newLines is the original one, untouched
+    int untouched = -1;
+    const int lastPartLength = text.size() - text.lastIndexOf(QLatin1Char('\n')) - 1;
+    if (position.column() == 0 && text.endsWith(QLatin1Char('\n'))) {
+        // whole lines inserted before
+        untouched = newLines;
+    } else if (text.startsWith(QLatin1Char('\n')) && document->lineLength(line + newLines) == lastPartLength) {
+        // whole lines appended after
+        untouched = 0;
+    }
+
+    const int original = lineMap[line];
+    lineMap.insert(lineMap.begin() + line + 1, newLines, -1);
+    lineMap[line] = -1;
+    if (untouched != -1) {
+        lineMap[line + untouched] = original;
+    }
+}
+
+void KateGitBlamePluginView::textRemoved(KTextEditor::Document *document, const KTextEditor::Range &range)
+{
+    auto it = m_documents.find(document);
+    if (it == m_documents.end() || !it->result) {
+        return;
+    }
+
+    auto &lineMap = it->lineMap;
+    const int line = range.start().line();
+    const int removedLines = range.end().line() - line;
+    if (line < 0 || line + removedLines >= int(lineMap.size())) {
+        return;
+    }
+
+    if (removedLines == 0) {
+        if (!range.isEmpty()) {
+            lineMap[line] = -1;
+        }
+        return;
+    }
+
+    // whole lines removed => the line after them is untouched
+    const bool wholeLines = range.start().column() == 0 && range.end().column() == 0;
+    const int remaining = wholeLines ? lineMap[line + removedLines] : -1;
+    lineMap.erase(lineMap.begin() + line + 1, lineMap.begin() + line + removedLines + 1);
+    lineMap[line] = remaining;
 }
 
 void KateGitBlamePluginView::startShowProcess(const QUrl &url, const QString &hash)
@@ -292,21 +415,6 @@ void KateGitBlamePluginView::showCommitInfo(const QString &hash, KTextEditor::Vi
     startShowProcess(view->document()->url(), hash);
 }
 
-static int nextBlockStart(const QByteArray &out, int from)
-{
-    int next = out.indexOf('\t', from);
-    // tab must be the first character in line for next block
-    if (next > 0 && out[next - 1] != '\n') {
-        next++;
-        // move forward one line
-        next = out.indexOf('\n', next);
-        // try to look for another tab char
-        next = out.indexOf('\t', next);
-        // if not found => end
-    }
-    return next;
-}
-
 void KateGitBlamePluginView::sendMessage(const QString &text, bool error)
 {
     QVariantMap genericMessage;
@@ -317,144 +425,6 @@ void KateGitBlamePluginView::sendMessage(const QString &text, bool error)
     Q_EMIT message(genericMessage);
 }
 
-void KateGitBlamePluginView::blameFinished(int exitCode, QProcess::ExitStatus exitStatus)
-{
-    if (exitCode != 0 || exitStatus != QProcess::NormalExit) {
-        const auto error = m_blameInfoProc.readAllStandardError();
-
-        // Ignore, this repo doesn't have any commits or not a repo
-        if (error.startsWith("fatal: no such ref: HEAD") || error.startsWith("fatal: not a git repository") || error.startsWith("fatal: no such path ")) {
-            return;
-        }
-
-        QString text = i18n("Git blame failed.");
-        sendMessage(text + QStringLiteral("\n") + QString::fromUtf8(error), true);
-        return;
-    }
-
-    QByteArray out = m_blameInfoProc.readAllStandardOutput();
-    out.replace("\r", ""); // KTextEditor removes all \r characters in the internal buffers
-    // printf("recieved output: %d for: git %s\n", out.size(), qPrintable(m_blameInfoProc.arguments().join(QLatin1Char(' '))));
-
-    /**
-     * This is out git blame output parser.
-     *
-     * The output contains info about each line of text and commit info
-     * for that line. We store the commit info separately in a hash-map
-     * so that they don't need to be duplicated. For each line we store
-     * its line text and short commit. Text is needed because if you
-     * modify the doc, we use it to figure out where the original blame
-     * line is. The short commit is used to fetch the full commit from
-     * the hashmap
-     */
-
-    int start = 0;
-    int next = out.indexOf('\t');
-    next = out.indexOf('\n', next);
-
-    while (next != -1) {
-        //         printf("Block: (Size: %d) %s\n\n", (next - start), out.mid(start, next - start).constData());
-
-        CommitInfo commitInfo;
-        BlamedLine lineInfo;
-
-        /**
-         * Parse hash and line numbers
-         *
-         * 5c7f27a0915a9b20dc9f683d0d85b6e4b829bc85 1 1 5
-         */
-        int pos = out.indexOf(' ', start);
-        constexpr int hashLen = 40;
-        if (pos == -1 || (pos - start) != hashLen) {
-            printf("no proper hash\n");
-            break;
-        }
-        QByteArray hash = out.mid(start, pos - start);
-
-        // skip to line end,
-        // we don't care about line no etc here
-        int from = pos + 1;
-        pos = out.indexOf('\n', from);
-        if (pos == -1) {
-            qWarning() << "Git blame: Invalid blame output : No new line";
-            break;
-        }
-        pos++;
-
-        lineInfo.shortCommitHash = hash.mid(0, 7);
-
-        m_blamedLines.push_back(lineInfo);
-
-        // are we done because this line references the commit instead of
-        // containing the content?
-        if (out[pos] == '\t') {
-            pos++; // skip \t
-            from = pos;
-            pos = out.indexOf('\n', from); // go to line end
-            m_blamedLines.back().lineText = out.mid(from, pos - from);
-
-            start = next + 1;
-            next = nextBlockStart(out, start);
-            if (next == -1)
-                break;
-            next = out.indexOf('\n', next);
-            continue;
-        }
-
-        /**
-         * Parse actual commit
-         */
-        commitInfo.hash = hash;
-
-        // author Xyz
-        constexpr int authorLen = sizeof("author ") - 1;
-        pos += authorLen;
-        from = pos;
-        pos = out.indexOf('\n', pos);
-
-        commitInfo.authorName = QString::fromUtf8(out.mid(from, pos - from));
-        pos++;
-
-        // author-time timestamp
-        constexpr int authorTimeLen = sizeof("author-time ") - 1;
-        pos = out.indexOf("author-time ", pos);
-        if (pos == -1) {
-            qWarning() << "Invalid commit while git-blameing";
-            break;
-        }
-        pos += authorTimeLen;
-        from = pos;
-        pos = out.indexOf('\n', from);
-
-        qint64 timestamp = out.mid(from, pos - from).toLongLong();
-        commitInfo.authorDate = QDateTime::fromSecsSinceEpoch(timestamp);
-
-        constexpr int summaryLen = sizeof("summary ") - 1;
-        pos = out.indexOf("summary ", pos);
-        pos += summaryLen;
-        from = pos;
-        pos = out.indexOf('\n', pos);
-
-        commitInfo.summary = out.mid(from, pos - from);
-        //         printf("Commit{\n %s,\n %s,\n %s,\n %s\n}\n", qPrintable(commitInfo.commitHash), qPrintable(commitInfo.name),
-        //         qPrintable(commitInfo.date.toString()), qPrintable(commitInfo.title));
-
-        m_blameInfoForHash[lineInfo.shortCommitHash] = commitInfo;
-
-        from = pos;
-        pos = out.indexOf('\t', from);
-        from = pos + 1;
-        pos = out.indexOf('\n', from);
-        m_blamedLines.back().lineText = out.mid(from, pos - from);
-
-        start = next + 1;
-        next = nextBlockStart(out, start);
-        if (next == -1)
-            break;
-        next = out.indexOf('\n', next);
-    }
-}
-
 void KateGitBlamePluginView::showFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     if (exitCode != 0 || exitStatus != QProcess::NormalExit) {
@@ -503,57 +473,30 @@ void KateGitBlamePluginView::showFinished(int exitCode, QProcess::ExitStatus exi
 
 bool KateGitBlamePluginView::hasBlameInfo() const
 {
-    return !m_blamedLines.empty();
+    const auto it = m_documents.constFind(activeDocument());
+    return it != m_documents.constEnd() && it->result && !it->result->lines.empty();
 }
 
 const CommitInfo &KateGitBlamePluginView::blameInfo(int lineNr)
 {
-    if (m_blamedLines.empty() || m_blameInfoForHash.isEmpty() || !activeDocument()) {
-        return blameGetUpdateInfo(-1);
-    }
-
-    int totalBlamedLines = m_blamedLines.size();
-
-    int adjustedLineNr = lineNr + m_lineOffset;
-    const QByteArray lineText = activeDocument()->line(lineNr).toUtf8();
-
-    if (adjustedLineNr >= 0 && adjustedLineNr < totalBlamedLines) {
-        if (m_blamedLines[adjustedLineNr].lineText == lineText) {
-            return blameGetUpdateInfo(adjustedLineNr);
-        }
-    }
+    static const CommitInfo dummy{"hash", i18n("Not Committed Yet"), QDateTime::currentDateTime(), {}};
 
-    // search for the line 100 lines before and after until it matches
-    m_lineOffset = 0;
-    while (m_lineOffset < 100 && lineNr + m_lineOffset >= 0 && lineNr + m_lineOffset < totalBlamedLines) {
-        if (m_blamedLines[lineNr + m_lineOffset].lineText == lineText) {
-            return blameGetUpdateInfo(lineNr + m_lineOffset);
-        }
-        m_lineOffset++;
+    const auto it = m_documents.constFind(activeDocument());
+    if (it == m_documents.constEnd() || !it->result || lineNr < 0 || lineNr >= int(it->lineMap.size())) {
+        return dummy;
     }
 
-    m_lineOffset = 0;
-    while (m_lineOffset > -100 && lineNr + m_lineOffset >= 0 && (lineNr + m_lineOffset) < totalBlamedLines) {
-        if (m_blamedLines[lineNr + m_lineOffset].lineText == lineText) {
-            return blameGetUpdateInfo(lineNr + m_lineOffset);
-        }
-        m_lineOffset--;
+    // lines edited since the blame are not committed, too
+    const int blamedLine = it->lineMap[lineNr];
+    if (blamedLine < 0 || blamedLine >= int(it->result->lines.size())) {
+        return dummy;
     }
 
-    return blameGetUpdateInfo(-1);
-}
-
-const CommitInfo &KateGitBlamePluginView::blameGetUpdateInfo(int lineNr)
-{
-    static const CommitInfo dummy{"hash", i18n("Not Committed Yet"), QDateTime::currentDateTime(), {}};
-    if (m_blamedLines.empty() || lineNr < 0 || lineNr >= (int)m_blamedLines.size()) {
+    const auto commit = it->result->commits.constFind(it->result->lines[blamedLine].commitHash);
+    if (commit == it->result->commits.constEnd()) {
         return dummy;
     }
-
-    auto &commitInfo = m_blamedLines[lineNr];
-
-    Q_ASSERT(m_blameInfoForHash.contains(commitInfo.shortCommitHash));
-    return m_blameInfoForHash[commitInfo.shortCommitHash];
+    return commit.value();
 }
 
 void KateGitBlamePluginView::setToolTipIgnoreKeySequence(QKeySequence sequence)
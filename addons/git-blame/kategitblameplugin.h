@@ -7,12 +7,14 @@
 #ifndef KateGitBlamePlugin_h
 #define KateGitBlamePlugin_h
 
+#include "gitblamecache.h"
 #include "gitblametooltip.h"
 
 #include <KTextEditor/ConfigPage>
 #include <KTextEditor/InlineNoteProvider>
 #include <KTextEditor/MainWindow>
 #include <KTextEditor/Plugin>
+#include <KTextEditor/Range>
 
 #include <QProcess>
 
@@ -26,18 +28,6 @@
 
 enum class KateGitBlameMode { None, SingleLine, AllLines, Count = AllLines };
 
-struct CommitInfo {
-    QByteArray hash;
-    QString authorName;
-    QDateTime authorDate;
-    QByteArray summary;
-};
-
-struct BlamedLine {
-    QByteArray shortCommitHash;
-    QByteArray lineText;
-};
-
 class KateGitBlamePluginView;
 class GitBlameTooltip;
 
@@ -68,6 +58,16 @@ public:
     explicit KateGitBlamePlugin(QObject *parent = nullptr, const QList<QVariant> & = QList<QVariant>());
 
     QObject *createView(KTextEditor::MainWindow *mainWindow) override;
+
+    GitBlameCache *blameCache()
+    {
+        return &m_blameCache;
+    }
+
+private:
+    void prefetch(KTextEditor::Document *document);
+
+    GitBlameCache m_blameCache;
 };
 
 class KateGitBlamePluginView : public QObject, public KXMLGUIClient
@@ -97,8 +97,12 @@ private:
 
     void viewChanged(KTextEditor::View *view);
 
-    void startBlameProcess(const QUrl &url);
-    void blameFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void trackDocument(KTextEditor::Document *document);
+    void requestBlame(KTextEditor::Document *document);
+    void blameReady(const QString &filePath, std::shared_ptr<const BlameResult> result);
+    void blameFailed(const QString &filePath, const QString &error);
+    void textInserted(KTextEditor::Document *document, const KTextEditor::Cursor &position, const QString &text);
+    void textRemoved(KTextEditor::Document *document, const KTextEditor::Range &range);
 
     void startShowProcess(const QUrl &url, const QString &hash);
     void showFinished(int exitCode, QProcess::ExitStatus exitStatus);
@@ -108,19 +112,21 @@ private:
 
     void showDiffForFile(const QByteArray &diffContents);
 
-    const CommitInfo &blameGetUpdateInfo(int lineNr);
-
     KTextEditor::MainWindow *m_mainWindow;
+    GitBlameCache *m_blameCache;
 
     GitBlameInlineNoteProvider m_inlineNoteProvider;
 
-    QProcess m_blameInfoProc;
     QProcess m_showProc;
-    QHash<QByteArray, CommitInfo> m_blameInfoForHash;
-    std::vector<BlamedLine> m_blamedLines;
-    QUrl m_blameUrl;
+
+    struct DocumentBlame {
+        std::shared_ptr<const BlameResult> result;
+        // document line => line in the result, -1 for lines changed since
+        std::vector<int> lineMap;
+    };
+    QHash<KTextEditor::Document *, DocumentBlame> m_documents;
+
     QPointer<KTextEditor::View> m_lastView;
-    int m_lineOffset{0};
     GitBlameTooltip m_tooltip;
     QString m_showHash;
     class CommitDiffTreeView *m_commitFilesView;
@@ -0,0 +1,354 @@
+/***************************************************************************
+ *   This file is part of Kate build plugin                                *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>                      *
+ *                                                                         *
+ *   SPDX-License-Identifier: LGPL-2.0-or-later
+ ***************************************************************************/
+
+#include "BuildOutputParser.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QStack>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <utility>
+
+// pass the output on at most that often, in ms
+static constexpr int FrameInterval = 100;
+
+const QString BuildOutputParser::NinjaPrefix = QStringLiteral("[ninja]");
+
+struct BuildOutputParser::Result {
+    quint64 generation = 0;
+    QStringList lines;
+    std::vector<Diagnostic> diagnostics;
+    bool finished = false;
+    int exitCode = 0;
+};
+
+struct BuildOutputParser::Worker {
+    struct Job {
+        enum Type { Start, StdOut, StdErr, Finish } type = StdOut;
+        QByteArray data;
+        quint64 generation = 0;
+        QString workDir;
+        QStringList searchPaths;
+        int exitCode = 0;
+    };
+
+    // shared with the GUI thread
+    QMutex mutex;
+    std::deque<Job> jobs;
+    bool running = false;
+
+    // only used by the job that runs
+    quint64 generation = 0;
+    QString makeDir;
+    QStack<QString> makeDirStack;
+    QStringList searchPaths;
+    bool ninjaBuildDetected = false;
+    // make directory => file name in the output => resolved path
+    QHash<QString, QHash<QString, QString>> resolved;
+
+    // NOTE this will not allow spaces in file names.
+    // e.g. from gcc: "main.cpp:14: error: cannot convert ‘std::string’ to ‘int’ in return"
+    // e.g. from gcc: "main.cpp:14:8: error: cannot convert ‘std::string’ to ‘int’ in return"
+    // e.g. from icpc: "main.cpp(14): error: no suitable conversion function from "std::string" to "int" exists"
+    // e.g. from clang: ""main.cpp(14,8): fatal error: 'boost/scoped_array.hpp' file not found"
+    const QRegularExpression filenameDetector{QStringLiteral("((?:[a-np-zA-Z]:[\\\\/])?[^\\s:(]+)[:\\(](\\d+)[,:]?(\\d+)?[\\):]* (.*)")};
+    const QRegularExpression newDirDetector{QStringLiteral("make\\[.+\\]: .+ '(.*)'")};
+
+    static void enqueue(const std::shared_ptr<Worker> &worker, Job &&job, BuildOutputParser *parser, bool dropQueued = false);
+    void run(const QPointer<BuildOutputParser> &parser);
+    Result process(Job &job);
+    void processLine(const QString &line, std::vector<Diagnostic> &diagnostics);
+    QString resolve(const QString &name);
+};
+
+void BuildOutputParser::Worker::enqueue(const std::shared_ptr<Worker> &worker, Job &&job, BuildOutputParser *parser, bool dropQueued)
+{
+    QMutexLocker locker(&worker->mutex);
+    if (dropQueued) {
+        worker->jobs.clear();
+    }
+    worker->jobs.push_back(std::move(job));
+    if (worker->running) {
+        return;
+    }
+
+    // one job after the other, the output of a build depends on what came before
+    worker->running = true;
+    QThreadPool::globalInstance()->start([worker, parser = QPointer<BuildOutputParser>(parser)]() {
+        worker->run(parser);
+    });
+}
+
+void BuildOutputParser::Worker::run(const QPointer<BuildOutputParser> &parser)
+{
+    Q_FOREVER {
+        Job job;
+        {
+            QMutexLocker locker(&mutex);
+            if (jobs.empty()) {
+                running = false;
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        Result result = process(job);
+        if (job.type == Job::Start) {
+            continue;
+        }
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [parser, result = std::move(result)]() mutable {
+                if (parser) {
+                    parser->received(std::move(result));
+                }
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+BuildOutputParser::Result BuildOutputParser::Worker::process(Job &job)
+{
+    Result result;
+
+    switch (job.type) {
+    case Job::Start:
+        generation = job.generation;
+        makeDir = job.workDir;
+        makeDirStack.clear();
+        makeDirStack.push(makeDir);
+        searchPaths = job.searchPaths;
+        ninjaBuildDetected = false;
+        // files may come and go between builds
+        resolved.clear();
+        break;
+
+    case Job::Finish:
+        result.finished = true;
+        result.exitCode = job.exitCode;
+        break;
+
+    case Job::StdOut:
+    case Job::StdErr: {
+        // FIXME This works for utf8 but not for all charsets
+        QString text = QString::fromUtf8(job.data);
+        text.remove(QLatin1Char('\r'));
+        job.data.clear();
+
+        // the chunk consists of complete lines only
+        int pos = 0;
+        while (pos < text.size()) {
+            const int end = text.indexOf(QLatin1Char('\n'), pos);
+            QString line = text.mid(pos, end - pos);
+            pos = end + 1;
+
+            if (job.type == Job::StdErr) {
+                processLine(line, result.diagnostics);
+                result.lines.append(line);
+                continue;
+            }
+
+            const bool ninjaOutput = line.startsWith(NinjaPrefix);
+            ninjaBuildDetected |= ninjaOutput;
+            if (ninjaOutput) {
+                line = line.mid(NinjaPrefix.length());
+            }
+
+            const QRegularExpressionMatch match = newDirDetector.match(line);
+            if (match.hasMatch()) {
+                QString newDir = match.captured(1);
+                if ((makeDirStack.size() > 1) && (makeDirStack.top() == newDir)) {
+                    makeDirStack.pop();
+                    newDir = makeDirStack.top();
+                } else {
+                    makeDirStack.push(newDir);
+                }
+                makeDir = newDir;
+            } else if (ninjaBuildDetected && !ninjaOutput) {
+                processLine(line, result.diagnostics);
+            }
+            result.lines.append(line);
+        }
+        break;
+    }
+    }
+
+    result.generation = generation;
+    return result;
+}
+
+void BuildOutputParser::Worker::processLine(const QString &line, std::vector<Diagnostic> &diagnostics)
+{
+    // look for a filename
+    const QRegularExpressionMatch match = filenameDetector.match(line);
+    if (!match.hasMatch()) {
+        diagnostics.push_back({QString(), QStringLiteral("0"), QString(), line});
+        return;
+    }
+
+    QString filename = match.captured(1);
+#ifdef Q_OS_WIN
+    // convert '\' to '/' so the concatenation works
+    filename = QFileInfo(filename).filePath();
+#endif
+
+    diagnostics.push_back({resolve(filename), match.captured(2), match.captured(3), match.captured(4)});
+}
+
+QString BuildOutputParser::Worker::resolve(const QString &name)
+{
+    // a compiler names the same few headers over and over again
+    auto &known = resolved[makeDir];
+    const auto it = known.constFind(name);
+    if (it != known.cend()) {
+        return it.value();
+    }
+
+    // add path to file
+    QString filename = name;
+    if (QFile::exists(makeDir + QLatin1Char('/') + filename)) {
+        filename = makeDir + QLatin1Char('/') + filename;
+    }
+
+    // If we still do not have a file name try the extra search paths
+    int i = 1;
+    while (!QFile::exists(filename) && i < searchPaths.size()) {
+        if (QFile::exists(searchPaths[i] + QLatin1Char('/') + filename)) {
+            filename = searchPaths[i] + QLatin1Char('/') + filename;
+        }
+        i++;
+    }
+
+    // get canonical path, if possible, to avoid duplicated opened files
+    const QString canonicalFilePath = QFileInfo(filename).canonicalFilePath();
+    if (!canonicalFilePath.isEmpty()) {
+        filename = canonicalFilePath;
+    }
+
+    known.insert(name, filename);
+    return filename;
+}
+
+BuildOutputParser::BuildOutputParser(QObject *parent)
+    : QObject(parent)
+    , m_worker(std::make_shared<Worker>())
+{
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setInterval(FrameInterval);
+    connect(&m_frameTimer, &QTimer::timeout, this, &BuildOutputParser::flush);
+}
+
+BuildOutputParser::~BuildOutputParser()
+{
+    // a running job ends on its own, its results are dropped
+    QMutexLocker locker(&m_worker->mutex);
+    m_worker->jobs.clear();
+}
+
+void BuildOutputParser::start(const QString &workDir, const QStringList &searchPaths)
+{
+    m_stdOut.clear();
+    m_stdErr.clear();
+    m_lines.clear();
+    m_diagnostics.clear();
+    m_frameTimer.stop();
+
+    Worker::Job job;
+    job.type = Worker::Job::Start;
+    job.generation = ++m_generation;
+    job.workDir = workDir;
+    job.searchPaths = searchPaths;
+
+    // nobody waits for the output of the former build anymore
+    Worker::enqueue(m_worker, std::move(job), this, true);
+}
+
+void BuildOutputParser::addStdOut(const QByteArray &data)
+{
+    addOutput(false, m_stdOut, data);
+}
+
+void BuildOutputParser::addStdErr(const QByteArray &data)
+{
+    addOutput(true, m_stdErr, data);
+}
+
+void BuildOutputParser::addOutput(bool stdErr, QByteArray &pending, const QByteArray &data)
+{
+    // only complete lines go to the worker, only the new data needs a look for the last one
+    const int end = data.lastIndexOf('\n');
+    if (end < 0) {
+        pending += data;
+        return;
+    }
+
+    Worker::Job job;
+    job.type = stdErr ? Worker::Job::StdErr : Worker::Job::StdOut;
+    job.data = pending.isEmpty() ? data.left(end + 1) : pending + data.left(end + 1);
+    pending = data.mid(end + 1);
+
+    Worker::enqueue(m_worker, std::move(job), this);
+}
+
+void BuildOutputParser::finish(int exitCode)
+{
+    // the last lines may miss their newline
+    if (!m_stdOut.isEmpty()) {
+        addStdOut(QByteArray(1, '\n'));
+    }
+    if (!m_stdErr.isEmpty()) {
+        addStdErr(QByteArray(1, '\n'));
+    }
+
+    Worker::Job job;
+    job.type = Worker::Job::Finish;
+    job.exitCode = exitCode;
+
+    Worker::enqueue(m_worker, std::move(job), this);
+}
+
+void BuildOutputParser::received(Result &&result)
+{
+    // left over from a former build
+    if (result.generation != m_generation) {
+        return;
+    }
+
+    m_lines += result.lines;
+    std::move(result.diagnostics.begin(), result.diagnostics.end(), std::back_inserter(m_diagnostics));
+
+    if (result.finished) {
+        m_frameTimer.stop();
+        flush();
+        Q_EMIT finished(result.exitCode);
+        return;
+    }
+
+    if (!m_frameTimer.isActive()) {
+        m_frameTimer.start();
+    }
+}
+
+void BuildOutputParser::flush()
+{
+    if (m_lines.isEmpty() && m_diagnostics.empty()) {
+        return;
+    }
+
+    Q_EMIT output(std::exchange(m_lines, {}), std::exchange(m_diagnostics, {}));
+}
@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   This file is part of Kate build plugin                                *
+ *   SPDX-FileCopyrightText: 2026 agent <agent@local>                      *
+ *                                                                         *
+ *   SPDX-License-Identifier: LGPL-2.0-or-later
+ ***************************************************************************/
+
+#ifndef BuildOutputParser_h
+#define BuildOutputParser_h
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Turns the output of a build into text lines and diagnostics.
+ *
+ * Complete lines are handed in chunks to a worker thread which decodes them,
+ * follows the make directory changes and matches and resolves the file names.
+ * What it delivers is collected and passed on at most once per frame, so a
+ * build printing many thousand lines a second does not block the GUI.
+ */
+class BuildOutputParser : public QObject
+{
+    Q_OBJECT
+public:
+    struct Diagnostic {
+        // empty if the line did not name a file
+        QString filename;
+        QString line;
+        QString column;
+        QString message;
+    };
+
+    /**
+     * Put in front of NINJA_STATUS to tell ninja status lines from compiler output.
+     */
+    static const QString NinjaPrefix;
+
+    explicit BuildOutputParser(QObject *parent = nullptr);
+    ~BuildOutputParser() override;
+
+    /**
+     * Forget about the former build, output not yet delivered is dropped.
+     * @param workDir the directory the build starts in
+     * @param searchPaths the search paths of the target, the first one is the working directory
+     */
+    void start(const QString &workDir, const QStringList &searchPaths);
+
+    void addStdOut(const QByteArray &data);
+    void addStdErr(const QByteArray &data);
+
+    /**
+     * The build process is done, finished is emitted once all its output got delivered.
+     */
+    void finish(int exitCode);
+
+Q_SIGNALS:
+    /**
+     * @param lines the new output lines
+     * @param diagnostics the diagnostics found in them
+     */
+    void output(const QStringList &lines, const std::vector<BuildOutputParser::Diagnostic> &diagnostics);
+    void finished(int exitCode);
+
+private:
+    struct Worker;
+    struct Result;
+
+    void addOutput(bool stdErr, QByteArray &pending, const QByteArray &data);
+    void received(Result &&result);
+    void flush();
+
+    std::shared_ptr<Worker> m_worker;
+    quint64 m_generation = 0;
+
+    // incomplete last lines
+    QByteArray m_stdOut;
+    QByteArray m_stdErr;
+
+    // delivered by the worker, not yet passed on
+    QStringList m_lines;
+    std::vector<Diagnostic> m_diagnostics;
+    QTimer m_frameTimer;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "buildoutputparser_test.h"
+#include "BuildOutputParser.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+QTEST_MAIN(BuildOutputParserTest)
+
+namespace
+{
+// all that got delivered and how often
+struct Collector {
+    explicit Collector(BuildOutputParser &parser)
+    {
+        QObject::connect(&parser, &BuildOutputParser::output, [this](const QStringList &newLines, const std::vector<BuildOutputParser::Diagnostic> &newDiagnostics) {
+            lines += newLines;
+            diagnostics.insert(diagnostics.end(), newDiagnostics.begin(), newDiagnostics.end());
+            ++outputs;
+        });
+    }
+
+    QStringList lines;
+    std::vector<BuildOutputParser::Diagnostic> diagnostics;
+    int outputs = 0;
+};
+}
+
+void BuildOutputParserTest::splitLines()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    QFile source(tmp.path() + QStringLiteral("/main.cpp"));
+    QVERIFY(source.open(QFile::WriteOnly));
+    source.close();
+
+    BuildOutputParser parser;
+    Collector collector(parser);
+    QSignalSpy finished(&parser, &BuildOutputParser::finished);
+
+    // lines split across reads, \r\n line ends, the last line without one
+    parser.start(tmp.path(), {tmp.path()});
+    parser.addStdErr("main.cpp:14:8: err");
+    parser.addStdErr("or: cannot convert\r");
+    parser.addStdErr("\nIn file included from");
+    parser.addStdErr(" here");
+    parser.finish(1);
+    QVERIFY(finished.wait());
+    QCOMPARE(finished.at(0).at(0).toInt(), 1);
+
+    QCOMPARE(collector.lines, (QStringList{QStringLiteral("main.cpp:14:8: error: cannot convert"), QStringLiteral("In file included from here")}));
+    QCOMPARE(collector.diagnostics.size(), size_t(2));
+    QCOMPARE(collector.diagnostics.at(0).filename, QFileInfo(source).canonicalFilePath());
+    QCOMPARE(collector.diagnostics.at(0).line, QStringLiteral("14"));
+    QCOMPARE(collector.diagnostics.at(0).column, QStringLiteral("8"));
+    QCOMPARE(collector.diagnostics.at(0).message, QStringLiteral("error: cannot convert"));
+    QVERIFY(collector.diagnostics.at(1).filename.isEmpty());
+    QCOMPARE(collector.diagnostics.at(1).message, QStringLiteral("In file included from here"));
+}
+
+void BuildOutputParserTest::ninjaOutput()
+{
+    BuildOutputParser parser;
+    Collector collector(parser);
+    QSignalSpy finished(&parser, &BuildOutputParser::finished);
+
+    // compiler output on stdout is only parsed for ninja builds, status lines are not
+    parser.start(QStringLiteral("/nonexistent"), {QStringLiteral("/nonexistent")});
+    parser.addStdOut("main.cpp:1: warning: before ninja\n");
+    parser.addStdOut((BuildOutputParser::NinjaPrefix + QStringLiteral("[1/2] Building main.o\n")).toUtf8());
+    parser.addStdOut("main.cpp:3: warning: unused\n");
+    parser.finish(0);
+    QVERIFY(finished.wait());
+
+    QCOMPARE(collector.lines,
+             (QStringList{QStringLiteral("main.cpp:1: warning: before ninja"), QStringLiteral("[1/2] Building main.o"), QStringLiteral("main.cpp:3: warning: unused")}));
+    QCOMPARE(collector.diagnostics.size(), size_t(1));
+    QCOMPARE(collector.diagnostics.at(0).filename, QStringLiteral("main.cpp"));
+    QCOMPARE(collector.diagnostics.at(0).line, QStringLiteral("3"));
+    QCOMPARE(collector.diagnostics.at(0).message, QStringLiteral("warning: unused"));
+}
+
+void BuildOutputParserTest::batching()
+{
+    BuildOutputParser parser;
+    Collector collector(parser);
+    QSignalSpy finished(&parser, &BuildOutputParser::finished);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // one read per line and some in the middle of a line
+    QStringList expected;
+    parser.start(QStringLiteral("/nonexistent"), {QStringLiteral("/nonexistent")});
+    for (int i = 0; i < 10000; ++i) {
+        const QByteArray line = "line " + QByteArray::number(i);
+        expected.append(QString::fromUtf8(line));
+        if (i % 3 == 0) {
+            parser.addStdOut(line.left(3));
+            parser.addStdOut(line.mid(3) + '\n');
+        } else {
+            parser.addStdOut(line + '\n');
+        }
+    }
+    parser.finish(0);
+    QVERIFY(finished.wait());
+
+    // all in order, but passed on at most once per frame (100 ms) and at the end
+    QCOMPARE(collector.lines, expected);
+    QVERIFY(collector.diagnostics.empty());
+    QVERIFY(collector.outputs >= 1);
+    QVERIFY(collector.outputs <= timer.elapsed() / 100 + 1);
+}
+
+void BuildOutputParserTest::restart()
+{
+    BuildOutputParser parser;
+    Collector collector(parser);
+    QSignalSpy finished(&parser, &BuildOutputParser::finished);
+
+    // the output of the former build and its incomplete line are gone
+    parser.start(QStringLiteral("/nonexistent"), {QStringLiteral("/nonexistent")});
+    parser.addStdOut("old\nincomplete");
+    parser.finish(2);
+    parser.start(QStringLiteral("/nonexistent"), {QStringLiteral("/nonexistent")});
+    parser.addStdOut("new\n");
+    parser.finish(0);
+    QVERIFY(finished.wait());
+    QTest::qWait(50);
+
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(finished.at(0).at(0).toInt(), 0);
+    QCOMPARE(collector.lines, QStringList{QStringLiteral("new")});
+}
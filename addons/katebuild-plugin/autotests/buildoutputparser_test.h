@@ -0,0 +1,23 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#ifndef BUILDOUTPUTPARSER_TEST_H
+#define BUILDOUTPUTPARSER_TEST_H
+
+#include <QObject>
+
+class BuildOutputParserTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void splitLines();
+    void ninjaOutput();
+    void batching();
+    void restart();
+};
+
+#endif
@@ -33,7 +33,6 @@
 #include <QFileInfo>
 #include <QIcon>
 #include <QKeyEvent>
-#include <QRegularExpressionMatch>
 #include <QScrollBar>
 #include <QString>
 
@@ -63,7 +62,6 @@ static const QString DefConfClean;
 static const QString DefTargetName = QStringLiteral("all");
 static const QString DefBuildCmd = QStringLiteral("make");
 static const QString DefCleanCmd = QStringLiteral("make clean");
-static const QString NinjaPrefix = QStringLiteral("[ninja]");
 
 static QIcon messageIcon(KateBuildView::ErrorCategory severity)
 {
@@ -113,17 +111,8 @@ KateBuildView::KateBuildView(KTextEditor::Plugin *plugin, KTextEditor::MainWindo
     , m_buildWidget(nullptr)
     , m_outputWidgetWidth(0)
     , m_proc(this)
-    , m_stdOut()
-    , m_stdErr()
     , m_buildCancelled(false)
     , m_displayModeBeforeBuild(1)
-    // NOTE this will not allow spaces in file names.
-    // e.g. from gcc: "main.cpp:14: error: cannot convert ‘std::string’ to ‘int’ in return"
-    // e.g. from gcc: "main.cpp:14:8: error: cannot convert ‘std::string’ to ‘int’ in return"
-    // e.g. from icpc: "main.cpp(14): error: no suitable conversion function from "std::string" to "int" exists"
-    // e.g. from clang: ""main.cpp(14,8): fatal error: 'boost/scoped_array.hpp' file not found"
-    , m_filenameDetector(QStringLiteral("((?:[a-np-zA-Z]:[\\\\/])?[^\\s:(]+)[:\\(](\\d+)[,:]?(\\d+)?[\\):]* (.*)"))
-    , m_newDirDetector(QStringLiteral("make\\[.+\\]: .+ '(.*)'"))
 {
     KXMLGUIClient::setComponentName(QStringLiteral("katebuild"), i18n("Kate Build Plugin"));
     setXMLFile(QStringLiteral("ui.rc"));
@@ -227,6 +216,8 @@ KateBuildView::KateBuildView(KTextEditor::Plugin *plugin, KTextEditor::MainWindo
     connect(&m_proc, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &KateBuildView::slotProcExited);
     connect(&m_proc, &KProcess::readyReadStandardError, this, &KateBuildView::slotReadReadyStdErr);
     connect(&m_proc, &KProcess::readyReadStandardOutput, this, &KateBuildView::slotReadReadyStdOut);
+    connect(&m_outputParser, &BuildOutputParser::output, this, &KateBuildView::appendOutput);
+    connect(&m_outputParser, &BuildOutputParser::finished, this, &KateBuildView::buildFinished);
 
     connect(m_win, &KTextEditor::MainWindow::unhandledShortcutOverride, this, &KateBuildView::handleEsc);
     connect(m_win, &KTextEditor::MainWindow::viewChanged, this, &KateBuildView::slotViewChanged);
@@ -500,10 +491,10 @@ void KateBuildView::slotErrorSelected(QTreeWidgetItem *item)
 }
 
 /******************************************************************/
-void KateBuildView::addError(const QString &filename, const QString &line, const QString &column, const QString &message)
+QTreeWidgetItem *KateBuildView::createErrorItem(const QString &filename, const QString &line, const QString &column, const QString &message)
 {
     ErrorCategory errorCategory = CategoryInfo;
-    QTreeWidgetItem *item = new QTreeWidgetItem(m_buildUi.errTreeWidget);
+    QTreeWidgetItem *item = new QTreeWidgetItem();
     item->setBackground(1, Qt::gray);
     // The strings are twice in case kate is translated but not make.
     if (message.contains(QLatin1String("error")) || message.contains(i18nc("The same word as 'make' uses to mark an error.", "error"))
@@ -512,13 +503,11 @@ void KateBuildView::addError(const QString &filename, const QString &line, const
         errorCategory = CategoryError;
         item->setForeground(1, Qt::red);
         m_numErrors++;
-        item->setHidden(false);
     }
     if (message.contains(QLatin1String("warning")) || message.contains(i18nc("The same word as 'make' uses to mark a warning.", "warning"))) {
         errorCategory = CategoryWarning;
         item->setForeground(1, Qt::yellow);
         m_numWarnings++;
-        item->setHidden(m_buildUi.displayModeSlider->value() > 2);
     }
     item->setTextAlignment(1, Qt::AlignRight);
 
@@ -535,10 +524,6 @@ void KateBuildView::addError(const QString &filename, const QString &line, const
     item->setData(1, Qt::UserRole, line);
     item->setData(2, Qt::UserRole, column);
 
-    if (errorCategory == CategoryInfo) {
-        item->setHidden(m_buildUi.displayModeSlider->value() > 1);
-    }
-
     item->setData(0, ErrorRole, errorCategory);
 
     // add tooltips in all columns
@@ -546,6 +531,42 @@ void KateBuildView::addError(const QString &filename, const QString &line, const
     item->setData(0, Qt::ToolTipRole, filename);
     item->setData(1, Qt::ToolTipRole, QStringLiteral("<qt>%1</qt>").arg(message));
     item->setData(2, Qt::ToolTipRole, QStringLiteral("<qt>%1</qt>").arg(message));
+    return item;
+}
+
+/******************************************************************/
+void KateBuildView::appendOutput(const QStringList &lines, const std::vector<BuildOutputParser::Diagnostic> &diagnostics)
+{
+    // one paragraph per line, but only one layout update for all of them
+    if (!lines.isEmpty()) {
+        m_buildUi.plainTextEdit->appendPlainText(lines.join(QLatin1Char('\n')));
+    }
+
+    if (diagnostics.empty()) {
+        return;
+    }
+
+    QList<QTreeWidgetItem *> items;
+    items.reserve(int(diagnostics.size()));
+    for (const auto &diagnostic : diagnostics) {
+        items.append(createErrorItem(diagnostic.filename, diagnostic.line, diagnostic.column, diagnostic.message));
+    }
+    m_buildUi.errTreeWidget->addTopLevelItems(items);
+
+    // items can only be hidden once they are in the tree
+    const int mode = m_buildUi.displayModeSlider->value();
+    for (QTreeWidgetItem *item : qAsConst(items)) {
+        switch (static_cast<ErrorCategory>(item->data(0, ErrorRole).toInt())) {
+        case CategoryInfo:
+            item->setHidden(mode > 1);
+            break;
+        case CategoryWarning:
+            item->setHidden(mode > 2);
+            break;
+        case CategoryError:
+            break;
+        }
+    }
 }
 
 void KateBuildView::clearMarks()
@@ -753,11 +774,8 @@ void KateBuildView::clearBuildResults()
     clearMarks();
     m_buildUi.plainTextEdit->clear();
     m_buildUi.errTreeWidget->clear();
-    m_stdOut.clear();
-    m_stdErr.clear();
     m_numErrors = 0;
     m_numWarnings = 0;
-    m_make_dir_stack.clear();
 }
 
 /******************************************************************/
@@ -782,7 +800,6 @@ bool KateBuildView::startProcess(const QString &dir, const QString &command)
 
     // set working directory
     m_make_dir = dir;
-    m_make_dir_stack.push(m_make_dir);
 
     if (!QFile::exists(m_make_dir)) {
         KMessageBox::error(nullptr, i18n("Cannot run command: %1\nWork path does not exist: %2", command, m_make_dir));
@@ -795,8 +812,8 @@ bool KateBuildView::startProcess(const QString &dir, const QString &command)
     const auto nstatus = QStringLiteral("NINJA_STATUS");
     auto curr = env.value(nstatus, QStringLiteral("[%f/%t] "));
     // add marker to search on later on
-    env.insert(nstatus, NinjaPrefix + curr);
-    m_ninjaBuildDetected = false;
+    env.insert(nstatus, BuildOutputParser::NinjaPrefix + curr);
+    m_outputParser.start(m_make_dir, m_searchPaths);
 
     m_proc.setProcessEnvironment(env);
     m_proc.setWorkingDirectory(m_make_dir);
@@ -979,6 +996,15 @@ void KateBuildView::slotProcExited(int exitCode, QProcess::ExitStatus)
     m_buildUi.buildAgainButton->setEnabled(true);
     m_buildUi.buildAgainButton2->setEnabled(true);
 
+    // the result is known once the rest of the output is parsed
+    m_outputParser.addStdOut(m_proc.readAllStandardOutput());
+    m_outputParser.addStdErr(m_proc.readAllStandardError());
+    m_outputParser.finish(exitCode);
+}
+
+/******************************************************************/
+void KateBuildView::buildFinished(int exitCode)
+{
     QString buildStatus = i18n("Building <b>%1</b> completed.", m_currentlyBuildingTarget);
 
     // did we get any errors?
@@ -1023,122 +1049,14 @@ void KateBuildView::slotProcExited(int exitCode, QProcess::ExitStatus)
 /******************************************************************/
 void KateBuildView::slotReadReadyStdOut()
 {
-    // read data from procs stdout and add
-    // the text to the end of the output
-    // FIXME This works for utf8 but not for all charsets
-    QString l = QString::fromUtf8(m_proc.readAllStandardOutput());
-    l.remove(QLatin1Char('\r'));
-    m_stdOut += l;
-
-    // handle one line at a time
-    do {
-        const int end = m_stdOut.indexOf(QLatin1Char('\n'));
-        if (end < 0) {
-            break;
-        }
-
-        QString line = m_stdOut.mid(0, end);
-        const bool ninjaOutput = line.startsWith(NinjaPrefix);
-        m_ninjaBuildDetected |= ninjaOutput;
-        if (ninjaOutput) {
-            line = line.mid(NinjaPrefix.length());
-        }
-        m_buildUi.plainTextEdit->appendPlainText(line);
-        // qDebug() << line;
-
-        QRegularExpressionMatch match = m_newDirDetector.match(line);
-
-        if (match.hasMatch()) {
-            // qDebug() << "Enter/Exit dir found";
-            QString newDir = match.captured(1);
-            // qDebug () << "New dir = " << newDir;
-
-            if ((m_make_dir_stack.size() > 1) && (m_make_dir_stack.top() == newDir)) {
-                m_make_dir_stack.pop();
-                newDir = m_make_dir_stack.top();
-            } else {
-                m_make_dir_stack.push(newDir);
-            }
-
-            m_make_dir = newDir;
-        } else if (m_ninjaBuildDetected && !ninjaOutput) {
-            processLine(line);
-        }
-
-        m_stdOut.remove(0, end + 1);
-    } while (1);
+    // the parser splits and parses the lines on a worker thread
+    m_outputParser.addStdOut(m_proc.readAllStandardOutput());
 }
 
 /******************************************************************/
 void KateBuildView::slotReadReadyStdErr()
 {
-    // FIXME This works for utf8 but not for all charsets
-    QString l = QString::fromUtf8(m_proc.readAllStandardError());
-    l.remove(QLatin1Char('\r'));
-    m_stdErr += l;
-
-    do {
-        const int end = m_stdErr.indexOf(QLatin1Char('\n'));
-        if (end < 0) {
-            break;
-        }
-
-        const QString line = m_stdErr.mid(0, end);
-        m_buildUi.plainTextEdit->appendPlainText(line);
-
-        processLine(line);
-
-        m_stdErr.remove(0, end + 1);
-    } while (1);
-}
-
-/******************************************************************/
-void KateBuildView::processLine(const QString &line)
-{
-    // qDebug() << line ;
-
-    // look for a filename
-    QRegularExpressionMatch match = m_filenameDetector.match(line);
-
-    if (!match.hasMatch()) {
-        addError(QString(), QStringLiteral("0"), QString(), line);
-        // kDebug() << "A filename was not found in the line ";
-        return;
-    }
-
-    QString filename = match.captured(1);
-    const QString line_n = match.captured(2);
-    const QString col_n = match.captured(3);
-    const QString msg = match.captured(4);
-
-#ifdef Q_OS_WIN
-    // convert '\' to '/' so the concatenation works
-    filename = QFileInfo(filename).filePath();
-#endif
-
-    // qDebug() << "File Name:"<<m_make_dir << filename << " msg:"<< msg;
-    // add path to file
-    if (QFile::exists(m_make_dir + QLatin1Char('/') + filename)) {
-        filename = m_make_dir + QLatin1Char('/') + filename;
-    }
-
-    // If we still do not have a file name try the extra search paths
-    int i = 1;
-    while (!QFile::exists(filename) && i < m_searchPaths.size()) {
-        if (QFile::exists(m_searchPaths[i] + QLatin1Char('/') + filename)) {
-            filename = m_searchPaths[i] + QLatin1Char('/') + filename;
-        }
-        i++;
-    }
-
-    // get canonical path, if possible, to avoid duplicated opened files
-    auto canonicalFilePath(QFileInfo(filename).canonicalFilePath());
-    if (!canonicalFilePath.isEmpty()) {
-        filename = canonicalFilePath;
-    }
-
-    // Now we have the data we need show the error/warning
-    addError(filename, line_n, col_n, msg);
+    m_outputParser.addStdErr(m_proc.readAllStandardError());
 }
 
 /******************************************************************/
@@ -25,8 +25,6 @@
 #include <KProcess>
 #include <QHash>
 #include <QPointer>
-#include <QRegularExpression>
-#include <QStack>
 #include <QString>
 
 #include <KTextEditor/Document>
@@ -40,6 +38,7 @@
 #include <KConfigGroup>
 #include <KXMLGUIClient>
 
+#include "BuildOutputParser.h"
 #include "targets.h"
 #include "ui_build.h"
 
@@ -117,8 +116,9 @@ private:
 #ifdef Q_OS_WIN
     QString caseFixed(const QString &path);
 #endif
-    void processLine(const QString &);
-    void addError(const QString &filename, const QString &line, const QString &column, const QString &message);
+    void appendOutput(const QStringList &lines, const std::vector<BuildOutputParser::Diagnostic> &diagnostics);
+    QTreeWidgetItem *createErrorItem(const QString &filename, const QString &line, const QString &column, const QString &message);
+    void buildFinished(int exitCode);
     bool startProcess(const QString &dir, const QString &command);
     bool checkLocal(const QUrl &dir);
     void clearBuildResults();
@@ -136,17 +136,12 @@ private:
     int m_outputWidgetWidth;
     TargetsUi *m_targetsUi;
     KProcess m_proc;
-    QString m_stdOut;
-    QString m_stdErr;
+    BuildOutputParser m_outputParser;
     QString m_currentlyBuildingTarget;
     bool m_buildCancelled;
     int m_displayModeBeforeBuild;
     QString m_make_dir;
-    QStack<QString> m_make_dir_stack;
     QStringList m_searchPaths;
-    QRegularExpression m_filenameDetector;
-    bool m_ninjaBuildDetected = false;
-    QRegularExpression m_newDirDetector;
     unsigned int m_numErrors = 0;
     unsigned int m_numWarnings = 0;
     QString m_prevItemContent;
@@ -0,0 +1,278 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "lspclientbenchmark.h"
+#include "../lspclientserver.h"
+#include "../lsptrafficrecord.h"
+
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+#include <QTimer>
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+
+QTEST_GUILESS_MAIN(LSPClientBenchmark)
+
+// count heap allocations, reported per iteration along with timing
+static std::atomic<quint64> s_allocations{0};
+
+void *operator new(std::size_t size)
+{
+    ++s_allocations;
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+static constexpr int COMPLETION_ITEMS = 2000;
+static constexpr int SEMANTIC_TOKENS = 20000;
+static constexpr int SYMBOLS = 200;
+static constexpr int SYMBOL_CHILDREN = 20;
+static constexpr int DIAGNOSTICS_BURST = 20;
+static constexpr int DIAGNOSTICS_PER_FILE = 200;
+
+static QByteArray toPayload(const QJsonObject &msg)
+{
+    auto ob = msg;
+    ob[QStringLiteral("jsonrpc")] = QStringLiteral("2.0");
+    return QJsonDocument(ob).toJson(QJsonDocument::Compact);
+}
+
+static QJsonObject request(int id, const QString &method)
+{
+    return QJsonObject{{QStringLiteral("id"), id}, {QStringLiteral("method"), method}};
+}
+
+static QJsonObject reply(int id, const QJsonValue &result)
+{
+    return QJsonObject{{QStringLiteral("id"), id}, {QStringLiteral("result"), result}};
+}
+
+static QJsonObject range(int line, int column, int length)
+{
+    auto pos = [](int l, int c) {
+        return QJsonObject{{QStringLiteral("line"), l}, {QStringLiteral("character"), c}};
+    };
+    return QJsonObject{{QStringLiteral("start"), pos(line, column)}, {QStringLiteral("end"), pos(line, column + length)}};
+}
+
+static void writeRecording(QIODevice &device, const QUrl &document)
+{
+    int time = 0;
+    auto toServer = [&](const QJsonObject &msg) {
+        writeTrafficEntry(device, LSPTrafficEntry::ToServer, ++time, toPayload(msg));
+    };
+    auto fromServer = [&](const QJsonObject &msg) {
+        writeTrafficEntry(device, LSPTrafficEntry::FromServer, ++time, toPayload(msg));
+    };
+
+    toServer(request(1, QStringLiteral("initialize")));
+    QJsonObject capabilities{{QStringLiteral("completionProvider"), QJsonObject()},
+                             {QStringLiteral("documentSymbolProvider"), true},
+                             {QStringLiteral("semanticTokensProvider"), QJsonObject{{QStringLiteral("full"), true}}}};
+    fromServer(reply(1, QJsonObject{{QStringLiteral("capabilities"), capabilities}}));
+    toServer(QJsonObject{{QStringLiteral("method"), QStringLiteral("initialized")}});
+
+    toServer(request(2, QStringLiteral("textDocument/completion")));
+    QJsonArray items;
+    for (int i = 0; i < COMPLETION_ITEMS; ++i) {
+        items.push_back(QJsonObject{{QStringLiteral("label"), QStringLiteral("completion_%1").arg(i)},
+                                    {QStringLiteral("kind"), 3},
+                                    {QStringLiteral("detail"), QStringLiteral("int completion_%1(const char *)").arg(i)},
+                                    {QStringLiteral("sortText"), QStringLiteral("%1").arg(i, 6, 10, QLatin1Char('0'))}});
+    }
+    fromServer(reply(2, QJsonObject{{QStringLiteral("isIncomplete"), false}, {QStringLiteral("items"), items}}));
+
+    toServer(request(3, QStringLiteral("textDocument/semanticTokens/full")));
+    QJsonArray data;
+    for (int i = 0; i < SEMANTIC_TOKENS; ++i) {
+        for (int v : {i % 3 == 0 ? 1 : 0, 4, 6, i % 10, 0}) {
+            data.push_back(v);
+        }
+    }
+    fromServer(reply(3, QJsonObject{{QStringLiteral("resultId"), QStringLiteral("1")}, {QStringLiteral("data"), data}}));
+
+    toServer(request(4, QStringLiteral("textDocument/documentSymbol")));
+    QJsonArray symbols;
+    for (int i = 0; i < SYMBOLS; ++i) {
+        const int line = i * (SYMBOL_CHILDREN + 2);
+        QJsonArray children;
+        for (int j = 0; j < SYMBOL_CHILDREN; ++j) {
+            children.push_back(QJsonObject{{QStringLiteral("name"), QStringLiteral("member_%1").arg(j)},
+                                           {QStringLiteral("kind"), 6},
+                                           {QStringLiteral("range"), range(line + j + 1, 4, 20)},
+                                           {QStringLiteral("selectionRange"), range(line + j + 1, 8, 8)}});
+        }
+        symbols.push_back(QJsonObject{{QStringLiteral("name"), QStringLiteral("Class_%1").arg(i)},
+                                      {QStringLiteral("kind"), 5},
+                                      {QStringLiteral("range"), range(line, 0, 1)},
+                                      {QStringLiteral("selectionRange"), range(line, 6, 8)},
+                                      {QStringLiteral("children"), children}});
+    }
+    fromServer(reply(4, symbols));
+
+    // a change triggers a burst of diagnostics, as seen with e.g. a header edit
+    toServer(QJsonObject{{QStringLiteral("method"), QStringLiteral("textDocument/didChange")}});
+    for (int i = 0; i < DIAGNOSTICS_BURST; ++i) {
+        QJsonArray diagnostics;
+        for (int j = 0; j < DIAGNOSTICS_PER_FILE; ++j) {
+            diagnostics.push_back(QJsonObject{{QStringLiteral("range"), range(j, 0, 10)},
+                                              {QStringLiteral("severity"), 2},
+                                              {QStringLiteral("source"), QStringLiteral("bench")},
+                                              {QStringLiteral("message"), QStringLiteral("unused variable 'v%1'").arg(j)}});
+        }
+        const auto uri = i == 0 ? document.toString() : document.toString() + QStringLiteral(".%1.h").arg(i);
+        QJsonObject params{{QStringLiteral("uri"), uri}, {QStringLiteral("diagnostics"), diagnostics}};
+        fromServer(QJsonObject{{QStringLiteral("method"), QStringLiteral("textDocument/publishDiagnostics")}, {QStringLiteral("params"), params}});
+    }
+}
+
+// run one request to completion, bail out if the replay does not answer
+// the handlers may still be called after a timeout, so they must not refer to the stack
+template<typename Request>
+static bool roundTrip(Request request)
+{
+    struct State {
+        QEventLoop loop;
+        bool done = false;
+    };
+    auto state = std::make_shared<State>();
+    QTimer::singleShot(5000, &state->loop, &QEventLoop::quit);
+    request([weakState = std::weak_ptr<State>(state)]() {
+        if (auto state = weakState.lock()) {
+            state->done = true;
+            state->loop.quit();
+        }
+    });
+    if (!state->done) {
+        state->loop.exec();
+    }
+    return state->done;
+}
+
+static void reportAllocations(quint64 before, int iterations)
+{
+    if (iterations > 0) {
+        qInfo("allocations per iteration: %llu", (s_allocations - before) / iterations);
+    }
+}
+
+void LSPClientBenchmark::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_document = QUrl::fromLocalFile(m_dir.filePath(QStringLiteral("bench.cpp")));
+
+    const auto recordingPath = m_dir.filePath(QStringLiteral("bench.lsprec"));
+    QFile recording(recordingPath);
+    QVERIFY(recording.open(QIODevice::WriteOnly));
+    writeRecording(recording, m_document);
+    recording.close();
+
+    m_server.reset(new LSPClientServer({QStringLiteral(LSP_REPLAY_SERVER), recordingPath}, QUrl::fromLocalFile(m_dir.path())));
+    QVERIFY(m_server->start());
+    QTRY_VERIFY(m_server->state() == LSPClientServer::State::Running);
+}
+
+void LSPClientBenchmark::cleanupTestCase()
+{
+    m_server.reset();
+}
+
+void LSPClientBenchmark::benchCompletion()
+{
+    auto count = std::make_shared<int>(0);
+    int iterations = 0;
+    const quint64 before = s_allocations;
+    QBENCHMARK {
+        ++iterations;
+        QVERIFY(roundTrip([this, count](const std::function<void()> &done) {
+            m_server->documentCompletion(m_document, {0, 0}, this, [count, done](const QList<LSPCompletionItem> &items) {
+                *count = items.size();
+                done();
+            });
+        }));
+    }
+    reportAllocations(before, iterations);
+    QCOMPARE(*count, COMPLETION_ITEMS);
+}
+
+void LSPClientBenchmark::benchSemanticTokens()
+{
+    auto count = std::make_shared<int>(0);
+    int iterations = 0;
+    const quint64 before = s_allocations;
+    QBENCHMARK {
+        ++iterations;
+        QVERIFY(roundTrip([this, count](const std::function<void()> &done) {
+            m_server->documentSemanticTokensFull(m_document, QString(), this, [count, done](const LSPSemanticTokensDelta &tokens) {
+                *count = tokens.data.size();
+                done();
+            });
+        }));
+    }
+    reportAllocations(before, iterations);
+    QCOMPARE(*count, SEMANTIC_TOKENS * 5);
+}
+
+void LSPClientBenchmark::benchDocumentSymbols()
+{
+    auto count = std::make_shared<int>(0);
+    int iterations = 0;
+    const quint64 before = s_allocations;
+    QBENCHMARK {
+        ++iterations;
+        QVERIFY(roundTrip([this, count](const std::function<void()> &done) {
+            m_server->documentSymbols(m_document, this, [count, done](const QList<LSPSymbolInformation> &symbols) {
+                *count = symbols.size();
+                done();
+            });
+        }));
+    }
+    reportAllocations(before, iterations);
+    QCOMPARE(*count, SYMBOLS);
+}
+
+void LSPClientBenchmark::benchDiagnosticsBurst()
+{
+    auto count = std::make_shared<int>(0);
+    int iterations = 0;
+    const quint64 before = s_allocations;
+    QBENCHMARK {
+        ++iterations;
+        *count = 0;
+        QVERIFY(roundTrip([this, count](const std::function<void()> &done) {
+            auto conn = std::make_shared<QMetaObject::Connection>();
+            *conn = connect(m_server.get(), &LSPClientServer::publishDiagnostics, this, [count, done, conn](const LSPPublishDiagnosticsParams &params) {
+                if (params.diagnostics.size() == DIAGNOSTICS_PER_FILE && ++*count == DIAGNOSTICS_BURST) {
+                    disconnect(*conn);
+                    done();
+                }
+            });
+            m_server->didChange(m_document, 1, QStringLiteral("int main() {}"));
+        }));
+    }
+    reportAllocations(before, iterations);
+    QCOMPARE(*count, DIAGNOSTICS_BURST);
+}
@@ -0,0 +1,36 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <memory>
+
+class LSPClientServer;
+
+// Measures client side overhead (framing, parsing, dispatch) of typical
+// LSP traffic, using lspreplayserver to play back a synthesized recording.
+class LSPClientBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void benchCompletion();
+    void benchSemanticTokens();
+    void benchDocumentSymbols();
+    void benchDiagnosticsBurst();
+
+private:
+    QTemporaryDir m_dir;
+    QUrl m_document;
+    std::unique_ptr<LSPClientServer> m_server;
+};
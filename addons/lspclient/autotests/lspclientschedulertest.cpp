@@ -0,0 +1,117 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "lspclientschedulertest.h"
+#include "../lspclientserver.h"
+#include "../lsptrafficrecord.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+#include <memory>
+
+QTEST_GUILESS_MAIN(LSPClientSchedulerTest)
+
+static const QString SYMBOLS = QStringLiteral("textDocument/documentSymbol");
+static const QString COMPLETION = QStringLiteral("textDocument/completion");
+
+static QByteArray toPayload(QJsonObject msg)
+{
+    msg[QStringLiteral("jsonrpc")] = QStringLiteral("2.0");
+    return QJsonDocument(msg).toJson(QJsonDocument::Compact);
+}
+
+static void writeRecording(QIODevice &device)
+{
+    int time = 0;
+    auto exchange = [&](int id, const QString &method, const QJsonValue &result) {
+        writeTrafficEntry(device, LSPTrafficEntry::ToServer, ++time, toPayload({{QStringLiteral("id"), id}, {QStringLiteral("method"), method}}));
+        writeTrafficEntry(device, LSPTrafficEntry::FromServer, ++time, toPayload({{QStringLiteral("id"), id}, {QStringLiteral("result"), result}}));
+    };
+
+    const QJsonObject capabilities{{QStringLiteral("completionProvider"), QJsonObject()}, {QStringLiteral("documentSymbolProvider"), true}};
+    exchange(1, QStringLiteral("initialize"), QJsonObject{{QStringLiteral("capabilities"), capabilities}});
+    exchange(2, SYMBOLS, QJsonArray());
+    exchange(3, COMPLETION, QJsonObject{{QStringLiteral("isIncomplete"), false}, {QStringLiteral("items"), QJsonArray()}});
+}
+
+void LSPClientSchedulerTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    const auto recordingPath = m_dir.filePath(QStringLiteral("scheduler.lsprec"));
+    QFile recording(recordingPath);
+    QVERIFY(recording.open(QIODevice::WriteOnly));
+    writeRecording(recording);
+    recording.close();
+
+    m_server.reset(new LSPClientServer({QStringLiteral(LSP_REPLAY_SERVER), recordingPath}, QUrl::fromLocalFile(m_dir.path())));
+    QVERIFY(m_server->start());
+    QTRY_VERIFY(m_server->state() == LSPClientServer::State::Running);
+}
+
+void LSPClientSchedulerTest::cleanupTestCase()
+{
+    m_server.reset();
+}
+
+void LSPClientSchedulerTest::testPriorityAndSupersede()
+{
+    // replies may arrive after a failed check returned, don't let them touch the stack
+    auto symbolReplies = std::make_shared<QStringList>();
+    auto completionReplies = std::make_shared<int>(0);
+    const auto requestSymbols = [this, symbolReplies](const QString &name) {
+        m_server->documentSymbols(QUrl::fromLocalFile(m_dir.filePath(name)), this, [symbolReplies, name](const QList<LSPSymbolInformation> &) {
+            symbolReplies->append(name);
+        });
+    };
+
+    // replies are only read once we return to the event loop, until then the bookkeeping is exact
+    requestSymbols(QStringLiteral("a.cpp"));
+    requestSymbols(QStringLiteral("b.cpp"));
+    requestSymbols(QStringLiteral("c.cpp"));
+    auto stats = m_server->requestStats();
+    QCOMPARE(stats[SYMBOLS].inFlight, 2);
+    QCOMPARE(stats[SYMBOLS].queued, 1);
+
+    // interactive requests don't wait for background slots
+    m_server->documentCompletion(QUrl::fromLocalFile(m_dir.filePath(QStringLiteral("a.cpp"))), {0, 0}, this, [completionReplies](const QList<LSPCompletionItem> &) {
+        ++*completionReplies;
+    });
+    stats = m_server->requestStats();
+    QCOMPARE(stats[COMPLETION].inFlight, 1);
+    QCOMPARE(stats[SYMBOLS].queued, 1);
+
+    // a newer request for the same document cancels the sent one, its slot goes to the queued c.cpp
+    requestSymbols(QStringLiteral("a.cpp"));
+    stats = m_server->requestStats();
+    QCOMPARE(stats[SYMBOLS].cancelled, 1);
+    QCOMPARE(stats[SYMBOLS].inFlight, 2);
+    QCOMPARE(stats[SYMBOLS].queued, 1);
+
+    // and a queued one is replaced before the server sees it
+    requestSymbols(QStringLiteral("a.cpp"));
+    stats = m_server->requestStats();
+    QCOMPARE(stats[SYMBOLS].cancelled, 2);
+    QCOMPARE(stats[SYMBOLS].inFlight, 2);
+    QCOMPARE(stats[SYMBOLS].queued, 1);
+
+    // one reply per document, none for the superseded ones
+    QTRY_COMPARE(symbolReplies->size(), 3);
+    QTRY_COMPARE(*completionReplies, 1);
+    QTest::qWait(100);
+    symbolReplies->sort();
+    QCOMPARE(*symbolReplies, (QStringList{QStringLiteral("a.cpp"), QStringLiteral("b.cpp"), QStringLiteral("c.cpp")}));
+
+    stats = m_server->requestStats();
+    QCOMPARE(stats[SYMBOLS].completed, 3);
+    QCOMPARE(stats[SYMBOLS].inFlight, 0);
+    QCOMPARE(stats[SYMBOLS].queued, 0);
+    QCOMPARE(stats[COMPLETION].completed, 1);
+}
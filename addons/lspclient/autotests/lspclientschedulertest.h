@@ -0,0 +1,31 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QTemporaryDir>
+
+#include <memory>
+
+class LSPClientServer;
+
+// Checks throttling of background requests and superseding of stale ones,
+// against lspreplayserver answering every request right away.
+class LSPClientSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testPriorityAndSupersede();
+
+private:
+    QTemporaryDir m_dir;
+    std::unique_ptr<LSPClientServer> m_server;
+};
@@ -20,9 +20,17 @@
 #include <QStyledItemDelegate>
 
 #include <drawing_utils.h>
+#include <kfts_fuzzy_match.h>
 #include <ktexteditor_utils.h>
 
+#include <algorithm>
+#include <limits>
+
 static constexpr int SymbolInfoRole = Qt::UserRole + 1;
+// number of queries for which results are kept
+static constexpr int MaxCachedQueries = 32;
+// limit on number of symbols shown
+static constexpr int MaxShownSymbols = 1000;
 
 struct GotoSymbolItem {
     QUrl fileUrl;
@@ -245,14 +253,102 @@ void GotoSymbolHUDDialog::slotTextChanged(const QString &text)
         return;
     }
 
-    auto hh = [this](const std::vector<LSPSymbolInformation> &symbols) {
-        model->clear();
-        for (const auto &sym : symbols) {
-            auto item = new QStandardItem(iconForSymbolKind(sym.kind), sym.name);
-            item->setData(QVariant::fromValue(GotoSymbolItem{sym.url, sym.range.start(), sym.kind}), SymbolInfoRole);
-            model->appendRow(item);
-        }
-        m_treeView.setCurrentIndex(model->index(0, 0));
+    /**
+     * show what we already know while the server is busy, results for a prefix of the query
+     * are filtered locally
+     */
+    const auto cached = cachedSymbols(text);
+    if (cached) {
+        showSymbols(text, *cached, m_cache.contains(text));
+    }
+
+    m_query = text;
+    m_results.clear();
+    m_handle.cancel();
+    if (m_cache.contains(text)) {
+        return;
+    }
+
+    auto h = [this, text](const std::vector<LSPSymbolInformation> &symbols) {
+        onSymbols(text, symbols, true);
     };
-    server->workspaceSymbol(text, this, hh);
+    auto ph = [this, text](const std::vector<LSPSymbolInformation> &symbols) {
+        onSymbols(text, symbols, false);
+    };
+    m_handle = server->workspaceSymbol(text, this, h, ph);
+}
+
+void GotoSymbolHUDDialog::onSymbols(const QString &query, const std::vector<LSPSymbolInformation> &symbols, bool final)
+{
+    // some older query, already superseded
+    if (query != m_query) {
+        return;
+    }
+
+    // final reply only holds what was not already sent as partial result
+    m_results.insert(m_results.end(), symbols.begin(), symbols.end());
+
+    if (final) {
+        m_cache[query] = m_results;
+        m_cacheOrder.removeOne(query);
+        m_cacheOrder.push_back(query);
+        if (m_cacheOrder.size() > MaxCachedQueries) {
+            m_cache.remove(m_cacheOrder.takeFirst());
+        }
+    }
+
+    // partial results may be empty, keep showing the locally filtered ones then
+    if (final || !m_results.empty()) {
+        showSymbols(query, m_results, true);
+    }
+}
+
+const std::vector<LSPSymbolInformation> *GotoSymbolHUDDialog::cachedSymbols(const QString &query) const
+{
+    // longest cached prefix
+    for (int len = query.size(); len >= 2; --len) {
+        const auto it = m_cache.constFind(query.left(len));
+        if (it != m_cache.constEnd()) {
+            return &it.value();
+        }
+    }
+    return nullptr;
+}
+
+void GotoSymbolHUDDialog::showSymbols(const QString &filter, const std::vector<LSPSymbolInformation> &symbols, bool exact)
+{
+    /**
+     * rank by fuzzy match, keep server order otherwise
+     * if the symbols are for this very query, also keep what the server matched but we do not
+     */
+    std::vector<std::pair<int, const LSPSymbolInformation *>> ranked;
+    ranked.reserve(symbols.size());
+    for (const auto &sym : symbols) {
+        int score = 0;
+        if (kfts::fuzzy_match(filter, sym.name, score)) {
+            ranked.push_back({score, &sym});
+        } else if (exact) {
+            ranked.push_back({std::numeric_limits<int>::min(), &sym});
+        }
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto &l, const auto &r) {
+        return l.first > r.first;
+    });
+
+    QList<QStandardItem *> items;
+    items.reserve(std::min<int>(ranked.size(), MaxShownSymbols));
+    for (const auto &entry : ranked) {
+        if (items.size() >= MaxShownSymbols) {
+            break;
+        }
+        const auto &sym = *entry.second;
+        auto item = new QStandardItem(iconForSymbolKind(sym.kind), sym.name);
+        item->setData(QVariant::fromValue(GotoSymbolItem{sym.url, sym.range.start(), sym.kind}), SymbolInfoRole);
+        items.push_back(item);
+    }
+
+    // one insertion, avoids per row view updates
+    model->clear();
+    model->invisibleRootItem()->appendRows(items);
+    m_treeView.setCurrentIndex(model->index(0, 0));
 }
@@ -8,10 +8,14 @@
 
 #include <quickdialog.h>
 
-#include "lspclientprotocol.h"
+#include "lspclientserver.h"
+
+#include <QHash>
+#include <QStringList>
+
+#include <vector>
 
 class QStandardItemModel;
-class LSPClientServer;
 
 namespace KTextEditor
 {
@@ -30,6 +34,9 @@ protected Q_SLOTS:
 
 private:
     void slotTextChanged(const QString &text);
+    void onSymbols(const QString &query, const std::vector<LSPSymbolInformation> &symbols, bool final);
+    void showSymbols(const QString &filter, const std::vector<LSPSymbolInformation> &symbols, bool exact);
+    const std::vector<LSPSymbolInformation> *cachedSymbols(const QString &query) const;
     QIcon iconForSymbolKind(LSPSymbolKind kind) const;
     void setPaletteToEditorColors();
 
@@ -37,6 +44,14 @@ private:
     KTextEditor::MainWindow *mainWindow;
     QSharedPointer<LSPClientServer> server;
 
+    // recent server results by query, most recently used query last
+    QHash<QString, std::vector<LSPSymbolInformation>> m_cache;
+    QStringList m_cacheOrder;
+    // query in flight and the (partial) results received so far
+    QString m_query;
+    std::vector<LSPSymbolInformation> m_results;
+    LSPClientServer::RequestHandle m_handle;
+
     const QIcon m_icon_pkg = QIcon::fromTheme(QStringLiteral("code-block"));
     const QIcon m_icon_class = QIcon::fromTheme(QStringLiteral("code-class"));
     const QIcon m_icon_typedef = QIcon::fromTheme(QStringLiteral("code-typedef"));
@@ -10,6 +10,7 @@
 #include "lspclienthover.h"
 #include "lspclientplugin.h"
 #include "lspclientservermanager.h"
+#include "lspclientstatsview.h"
 #include "lspclientsymbolview.h"
 #include "lspclientutils.h"
 
@@ -483,6 +484,7 @@ class LSPClientActionView : public QObject
     QPointer<QAction> m_switchSourceHeader;
     QPointer<QAction> m_quickFix;
     QPointer<QAction> m_memoryUsage;
+    QPointer<QAction> m_serverStats;
     QPointer<KActionMenu> m_requestCodeAction;
 
     // toolview
@@ -506,6 +508,8 @@ class LSPClientActionView : public QObject
     QPointer<QTreeView> m_declTree;
     // ... and for type definition
     QPointer<QTreeView> m_typeDefTree;
+    // server statistics tab
+    QPointer<LSPClientStatsView> m_statsView;
 
     // diagnostics tab
     QPointer<QTreeView> m_diagnosticsTree;
@@ -677,6 +681,8 @@ public:
         // extra
         m_memoryUsage = actionCollection()->addAction(QStringLiteral("lspclient_clangd_memoryusage"), this, &self_type::clangdMemoryUsage);
         m_memoryUsage->setText(i18n("Server memory usage"));
+        m_serverStats = actionCollection()->addAction(QStringLiteral("lspclient_server_stats"), this, &self_type::showServerStats);
+        m_serverStats->setText(i18n("Server performance statistics"));
 
         // server control and misc actions
         m_closeDynamic = actionCollection()->addAction(QStringLiteral("lspclient_close_dynamic"), this, &self_type::closeDynamic);
@@ -729,6 +735,7 @@ public:
         moreOptions->addAction(m_messages);
         moreOptions->addSeparator();
         moreOptions->addAction(m_memoryUsage);
+        moreOptions->addAction(m_serverStats);
 
         // sync with plugin settings if updated
         connect(m_plugin, &LSPClientPlugin::update, this, &self_type::configUpdated);
@@ -2177,6 +2184,16 @@ public:
         server->clangdMemoryUsage(this, h);
     }
 
+    void showServerStats()
+    {
+        if (!m_statsView) {
+            m_statsView = new LSPClientStatsView(m_mainWindow, m_serverManager);
+            m_tabWidget->addTab(m_statsView, i18nc("@title:tab", "Performance"));
+        }
+        m_tabWidget->setCurrentWidget(m_statsView);
+        m_mainWindow->showToolView(m_toolView.data());
+    }
+
     void gotoWorkSpaceSymbol()
     {
         KTextEditor::View *activeView = m_mainWindow->activeView();
@@ -7,14 +7,19 @@
 #include "lspclientserver.h"
 
 #include "lspclient_debug.h"
+#include "lsptrafficrecord.h"
 
 #include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QProcess>
 
+#include <algorithm>
 #include <utility>
 
 // good/bad old school; allows easier concatenate
@@ -52,6 +57,9 @@ static const QString MEMBER_TARGET_RANGE = QStringLiteral("targetRange");
 static const QString MEMBER_TARGET_SELECTION_RANGE = QStringLiteral("targetSelectionRange");
 static const QString MEMBER_PREVIOUS_RESULT_ID = QStringLiteral("previousResultId");
 static const QString MEMBER_QUERY = QStringLiteral("query");
+static const QString MEMBER_PARTIAL_RESULT_TOKEN = QStringLiteral("partialResultToken");
+static const QString MEMBER_TOKEN = QStringLiteral("token");
+static const QString MEMBER_VALUE = QStringLiteral("value");
 
 // message construction helpers
 static QJsonObject to_json(const LSPPosition &pos)
@@ -994,6 +1002,37 @@ class LSPClientServer::LSPClientServerPrivate
     static constexpr int MAX_REQUESTS = 5;
     QVector<int> m_requests{MAX_REQUESTS + 1};
 
+    // request scheduling
+    // background requests (symbols, semantic tokens, ...) are throttled,
+    // interactive ones are always sent right away
+    // requests of a kind that only make sense for the latest state
+    // supersede (and cancel) an outstanding one for the same document
+    static constexpr int MAX_BACKGROUND_REQUESTS = 2;
+    struct RequestInfo {
+        QString method;
+        // (method, document) key if supersedable, empty otherwise
+        QString supersedeKey;
+        bool background = false;
+        // message to send if still queued, empty once written
+        QJsonObject msg;
+        QElapsedTimer timer;
+    };
+    QHash<int, RequestInfo> m_requestInfo;
+    QHash<QString, int> m_supersede;
+    QVector<int> m_backgroundQueue;
+    int m_backgroundInFlight = 0;
+    QHash<QString, LSPRequestStats> m_stats;
+
+    // partial result handlers, by progress token
+    QHash<QString, GenericReplyHandler> m_partialHandlers;
+    // request id -> partial result token
+    QHash<int, QString> m_partialTokens;
+    int m_partialToken = 0;
+
+    // optional traffic recording
+    QFile m_record;
+    QElapsedTimer m_recordTimer;
+
 public:
     LSPClientServerPrivate(LSPClientServer *_q,
                            const QStringList &server,
@@ -1046,12 +1085,50 @@ public:
     int cancel(int reqid)
     {
         if (m_handlers.remove(reqid) > 0) {
-            auto params = QJsonObject{{MEMBER_ID, reqid}};
-            write(init_request(QStringLiteral("$/cancelRequest"), params));
+            // no need to bother server with something it has not seen yet
+            const bool queued = m_backgroundQueue.removeOne(reqid);
+            finishRequest(reqid, true);
+            if (!queued) {
+                auto params = QJsonObject{{MEMBER_ID, reqid}};
+                write(init_request(QStringLiteral("$/cancelRequest"), params));
+            }
         }
         return -1;
     }
 
+    QHash<QString, LSPRequestStats> requestStats() const
+    {
+        return m_stats;
+    }
+
+    bool startRecording(const QString &fileName)
+    {
+        stopRecording();
+        m_record.setFileName(fileName);
+        if (!m_record.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCWarning(LSPCLIENT) << "failed to open recording" << fileName;
+            return false;
+        }
+        qCInfo(LSPCLIENT) << "recording traffic of" << m_server << "to" << fileName;
+        m_recordTimer.start();
+        return true;
+    }
+
+    void stopRecording()
+    {
+        if (m_record.isOpen()) {
+            m_record.close();
+        }
+    }
+
+    void record(LSPTrafficEntry::Direction direction, const QByteArray &payload)
+    {
+        if (m_record.isOpen()) {
+            writeTrafficEntry(m_record, direction, m_recordTimer.elapsed(), payload);
+            m_record.flush();
+        }
+    }
+
 private:
     void setState(State s)
     {
@@ -1077,14 +1154,141 @@ private:
             ob.insert(MEMBER_ID, ++m_id);
             ret.m_id = m_id;
             m_handlers[m_id] = {h, eh};
+            scheduleRequest(m_id, ob);
+            return ret;
         } else if (id) {
             ob.insert(MEMBER_ID, *id);
         }
 
+        writeMessage(ob);
+        return ret;
+    }
+
+    static bool isBackgroundMethod(const QString &method)
+    {
+        return method == QLatin1String("textDocument/documentSymbol") || method.startsWith(QLatin1String("textDocument/semanticTokens"));
+    }
+
+    static bool isSupersedableMethod(const QString &method)
+    {
+        return method == QLatin1String("textDocument/hover") || method == QLatin1String("textDocument/documentHighlight")
+            || method == QLatin1String("textDocument/completion") || method == QLatin1String("textDocument/signatureHelp")
+            || method == QLatin1String("textDocument/documentSymbol") || method.startsWith(QLatin1String("textDocument/semanticTokens"))
+            || method == QLatin1String("workspace/symbol");
+    }
+
+    void scheduleRequest(int reqid, const QJsonObject &msg)
+    {
+        const auto method = msg[MEMBER_METHOD].toString();
+        QString supersedeKey;
+        if (isSupersedableMethod(method)) {
+            const auto uri = msg[MEMBER_PARAMS].toObject().value(QStringLiteral("textDocument")).toObject().value(MEMBER_URI).toString();
+            supersedeKey = method + QLatin1Char('|') + uri;
+            const int previous = m_supersede.value(supersedeKey, -1);
+            if (previous >= 0) {
+                qCDebug(LSPCLIENT) << "superseding request" << previous << method;
+                cancel(previous);
+            }
+            m_supersede[supersedeKey] = reqid;
+        }
+
+        auto &info = m_requestInfo[reqid];
+        info.method = method;
+        info.supersedeKey = supersedeKey;
+        info.background = isBackgroundMethod(method);
+        info.timer.start();
+
+        if (info.background && m_backgroundInFlight >= MAX_BACKGROUND_REQUESTS) {
+            info.msg = msg;
+            m_backgroundQueue.push_back(reqid);
+            ++m_stats[method].queued;
+            return;
+        }
+        dispatchRequest(reqid, msg);
+    }
+
+    void dispatchRequest(int reqid, const QJsonObject &msg)
+    {
+        auto &info = m_requestInfo[reqid];
+        info.msg = QJsonObject();
+        if (info.background) {
+            ++m_backgroundInFlight;
+        }
+        ++m_stats[info.method].inFlight;
+        writeMessage(msg);
+    }
+
+    void dispatchQueued()
+    {
+        while (!m_backgroundQueue.isEmpty() && m_backgroundInFlight < MAX_BACKGROUND_REQUESTS) {
+            const int reqid = m_backgroundQueue.takeFirst();
+            const auto it = m_requestInfo.constFind(reqid);
+            if (it == m_requestInfo.constEnd()) {
+                continue;
+            }
+            const auto msg = it->msg;
+            --m_stats[it->method].queued;
+            dispatchRequest(reqid, msg);
+        }
+    }
+
+    // request no longer pending, either by reply or cancel
+    void finishRequest(int reqid, bool cancelled)
+    {
+        const auto it = m_requestInfo.find(reqid);
+        if (it == m_requestInfo.end()) {
+            return;
+        }
+        auto &stats = m_stats[it->method];
+        if (!it->msg.isEmpty()) {
+            --stats.queued;
+        } else {
+            --stats.inFlight;
+            if (it->background) {
+                --m_backgroundInFlight;
+            }
+        }
+        if (cancelled) {
+            ++stats.cancelled;
+        } else {
+            stats.addCompleted(it->timer.elapsed());
+        }
+        const auto token = m_partialTokens.take(reqid);
+        if (!token.isEmpty()) {
+            m_partialHandlers.remove(token);
+        }
+        if (!it->supersedeKey.isEmpty() && m_supersede.value(it->supersedeKey, -1) == reqid) {
+            m_supersede.remove(it->supersedeKey);
+        }
+        m_requestInfo.erase(it);
+        dispatchQueued();
+    }
+
+    void clearRequests()
+    {
+        m_handlers.clear();
+        m_requestInfo.clear();
+        m_supersede.clear();
+        m_backgroundQueue.clear();
+        m_backgroundInFlight = 0;
+        m_partialHandlers.clear();
+        m_partialTokens.clear();
+        for (auto &stats : m_stats) {
+            stats.queued = stats.inFlight = 0;
+        }
+    }
+
+    void writeMessage(const QJsonObject &ob)
+    {
         QJsonDocument json(ob);
         auto sjson = json.toJson();
 
-        qCInfo(LSPCLIENT) << "calling" << msg[MEMBER_METHOD].toString();
+        // replies to server requests are accounted separately
+        auto &stats = m_stats[ob.contains(MEMBER_METHOD) ? ob[MEMBER_METHOD].toString() : QStringLiteral("$/response")];
+        ++stats.messagesOut;
+        stats.bytesOut += sjson.size();
+
+        qCInfo(LSPCLIENT) << "calling" << ob[MEMBER_METHOD].toString();
         qCDebug(LSPCLIENT) << "sending message:\n" << QString::fromUtf8(sjson);
         // some simple parsers expect length header first
         auto hdr = QStringLiteral(CONTENT_LENGTH ": %1\r\n").arg(sjson.length());
@@ -1092,8 +1296,7 @@ private:
         m_sproc.write(hdr.toLatin1());
         m_sproc.write("\r\n");
         m_sproc.write(sjson);
-
-        return ret;
+        record(LSPTrafficEntry::ToServer, sjson);
     }
 
     RequestHandle send(const QJsonObject &msg, const GenericReplyHandler &h = nullptr, const GenericReplyHandler &eh = nullptr)
@@ -1155,14 +1358,37 @@ private:
             auto payload = buffer.mid(msgstart, length);
             buffer.remove(0, msgstart + length);
             qCInfo(LSPCLIENT) << "got message payload size " << length;
+            record(LSPTrafficEntry::FromServer, payload);
             qCDebug(LSPCLIENT) << "message payload:\n" << payload;
+            QElapsedTimer timer;
+            timer.start();
             QJsonParseError error{};
             auto msg = QJsonDocument::fromJson(payload, &error);
+            const qint64 parseTime = timer.nsecsElapsed() / 1000;
             if (error.error != QJsonParseError::NoError || !msg.isObject()) {
                 qCWarning(LSPCLIENT) << "invalid response payload";
                 continue;
             }
             auto result = msg.object();
+
+            // account to method of request for replies
+            QString method = result.value(MEMBER_METHOD).toString();
+            if (method.isEmpty() && result.contains(MEMBER_ID)) {
+                method = m_requestInfo.value(result.value(MEMBER_ID).toVariant().toInt()).method;
+                if (method.isEmpty()) {
+                    method = QStringLiteral("$/cancelled");
+                }
+            }
+            auto &stats = m_stats[method];
+            ++stats.messagesIn;
+            stats.bytesIn += length;
+            stats.parseTimeUs += parseTime;
+            // time spent processing, whichever way that goes below
+            timer.restart();
+            auto accountHandler = [this, &timer, &method]() {
+                m_stats[method].handlerTimeUs += timer.nsecsElapsed() / 1000;
+            };
+
             // check if it is the expected result
             int msgid = -1;
             if (result.contains(MEMBER_ID)) {
@@ -1175,11 +1401,13 @@ private:
                 }
             } else {
                 processNotification(result);
+                accountHandler();
                 continue;
             }
             // could be request
             if (result.contains(MEMBER_METHOD)) {
                 processRequest(result);
+                accountHandler();
                 continue;
             }
 
@@ -1191,6 +1419,7 @@ private:
 
                 // remove handler from our set, do this pre handler execution to avoid races
                 m_handlers.erase(it);
+                finishRequest(msgid, false);
 
                 // run handler, might e.g. trigger some new LSP actions for this server
                 // process and provide error if caller interested,
@@ -1202,6 +1431,7 @@ private:
                 } else {
                     h(result.value(MEMBER_RESULT));
                 }
+                accountHandler();
             } else {
                 // could have been canceled
                 qCDebug(LSPCLIENT) << "unexpected reply id" << msgid;
@@ -1232,6 +1462,7 @@ private:
     void onStateChanged(QProcess::ProcessState nstate)
     {
         if (nstate == QProcess::NotRunning) {
+            clearRequests();
             setState(State::None);
         }
     }
@@ -1241,7 +1472,7 @@ private:
         if (m_state == State::Running) {
             qCInfo(LSPCLIENT) << "shutting down" << m_server;
             // cancel all pending
-            m_handlers.clear();
+            clearRequests();
             // shutdown sequence
             send(init_request(QStringLiteral("shutdown")));
             // maybe we will get/see reply on the above, maybe not
@@ -1335,6 +1566,15 @@ public:
         // at least we see some errors somewhere then
         m_sproc.setProcessChannelMode(QProcess::ForwardedErrorChannel);
         m_sproc.setReadChannel(QProcess::QProcess::StandardOutput);
+        const auto recordDir = qEnvironmentVariable("KATE_LSP_RECORD_DIR");
+        if (!recordDir.isEmpty() && !m_record.isOpen()) {
+            const auto name = QStringLiteral("%1-%2-%3.lsprec")
+                                  .arg(QFileInfo(program).fileName())
+                                  .arg(QCoreApplication::applicationPid())
+                                  .arg(reinterpret_cast<quintptr>(this), 0, 16);
+            startRecording(QDir(recordDir).absoluteFilePath(name));
+        }
+
         m_sproc.start(program, args);
         const bool result = m_sproc.waitForStarted();
         if (result) {
@@ -1526,10 +1766,20 @@ public:
         send(init_request(QStringLiteral("workspace/didChangeWorkspaceFolders"), params));
     }
 
-    void workspaceSymbol(const QString &symbol, const GenericReplyHandler &h)
+    RequestHandle workspaceSymbol(const QString &symbol, const GenericReplyHandler &h, const GenericReplyHandler &partial)
     {
         auto params = QJsonObject{{MEMBER_QUERY, symbol}};
-        send(init_request(QStringLiteral("workspace/symbol"), params), h);
+        QString token;
+        if (partial) {
+            token = QStringLiteral("kate-partial-%1").arg(++m_partialToken);
+            params[MEMBER_PARTIAL_RESULT_TOKEN] = token;
+        }
+        auto handle = send(init_request(QStringLiteral("workspace/symbol"), params), h);
+        if (partial && handle.m_id >= 0) {
+            m_partialHandlers[token] = partial;
+            m_partialTokens[handle.m_id] = token;
+        }
+        return handle;
     }
 
     void processNotification(const QJsonObject &msg)
@@ -1542,7 +1792,17 @@ public:
         } else if (method == QLatin1String("window/logMessage")) {
             Q_EMIT q->logMessage(parseMessage(msg[MEMBER_PARAMS].toObject()));
         } else if (method == QLatin1String("$/progress")) {
-            Q_EMIT q->workDoneProgress(parseWorkDone(msg[MEMBER_PARAMS].toObject()));
+            const auto params = msg[MEMBER_PARAMS].toObject();
+            // partial result or work done progress
+            const auto token = params.value(MEMBER_TOKEN);
+            const auto it = token.isString() ? m_partialHandlers.constFind(token.toString()) : m_partialHandlers.constEnd();
+            if (it != m_partialHandlers.constEnd()) {
+                // copy, handler might trigger new requests
+                const auto handler = *it;
+                handler(params.value(MEMBER_VALUE));
+            } else {
+                Q_EMIT q->workDoneProgress(parseWorkDone(params));
+            }
         } else {
             qCWarning(LSPCLIENT) << "discarding notification" << method;
         }
@@ -1666,6 +1926,21 @@ const LSPServerCapabilities &LSPClientServer::capabilities() const
     return d->capabilities();
 }
 
+QHash<QString, LSPRequestStats> LSPClientServer::requestStats() const
+{
+    return d->requestStats();
+}
+
+bool LSPClientServer::startRecording(const QString &fileName)
+{
+    return d->startRecording(fileName);
+}
+
+void LSPClientServer::stopRecording()
+{
+    d->stopRecording();
+}
+
 bool LSPClientServer::start()
 {
     return d->start();
@@ -1855,7 +2130,10 @@ void LSPClientServer::didChangeWorkspaceFolders(const QList<LSPWorkspaceFolder>
     return d->didChangeWorkspaceFolders(added, removed);
 }
 
-void LSPClientServer::workspaceSymbol(const QString &symbol, const QObject *context, const WorkspaceSymbolsReplyHandler &h)
+LSPClientServer::RequestHandle LSPClientServer::workspaceSymbol(const QString &symbol,
+                                                                const QObject *context,
+                                                                const WorkspaceSymbolsReplyHandler &h,
+                                                                const WorkspaceSymbolsReplyHandler &partial)
 {
-    return d->workspaceSymbol(symbol, make_handler(h, context, parseWorkspaceSymbols));
+    return d->workspaceSymbol(symbol, make_handler(h, context, parseWorkspaceSymbols), make_handler(partial, context, parseWorkspaceSymbols));
 }
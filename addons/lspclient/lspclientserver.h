@@ -9,6 +9,7 @@
 
 #include "lspclientprotocol.h"
 
+#include <QHash>
 #include <QJsonValue>
 #include <QList>
 #include <QObject>
@@ -17,6 +18,7 @@
 #include <QUrl>
 #include <QVector>
 
+#include <algorithm>
 #include <functional>
 #include <optional>
 
@@ -72,6 +74,56 @@ using WorkspaceSymbolsReplyHandler = ReplyHandler<std::vector<LSPSymbolInformati
 
 class LSPClientPlugin;
 
+// per method bookkeeping of the request scheduler and message traffic
+struct LSPRequestStats {
+    // requests currently waiting for a background slot
+    int queued = 0;
+    // requests sent to the server and awaiting reply
+    int inFlight = 0;
+    int completed = 0;
+    // explicitly cancelled or superseded by a newer request
+    int cancelled = 0;
+    // submit-to-reply latency (including queueing) of completed requests
+    qint64 totalLatencyMs = 0;
+    qint64 maxLatencyMs = 0;
+    // latency of most recently completed requests (ring buffer)
+    static constexpr int MAX_LATENCY_SAMPLES = 256;
+    QVector<qint64> latencySamples;
+    // messages and payload size (excluding framing) in either direction
+    int messagesOut = 0;
+    int messagesIn = 0;
+    qint64 bytesOut = 0;
+    qint64 bytesIn = 0;
+    // time spent (on GUI thread) parsing incoming messages and in their handlers
+    qint64 parseTimeUs = 0;
+    qint64 handlerTimeUs = 0;
+
+    // the only place to account a completed request
+    void addCompleted(qint64 latencyMs)
+    {
+        if (latencySamples.size() < MAX_LATENCY_SAMPLES) {
+            latencySamples.push_back(latencyMs);
+        } else {
+            latencySamples[completed % MAX_LATENCY_SAMPLES] = latencyMs;
+        }
+        ++completed;
+        totalLatencyMs += latencyMs;
+        maxLatencyMs = std::max(maxLatencyMs, latencyMs);
+    }
+
+    // percentile (0 - 100) of recent latencies
+    qint64 latencyPercentile(int percentile) const
+    {
+        if (latencySamples.isEmpty()) {
+            return 0;
+        }
+        auto samples = latencySamples;
+        const int index = std::min<int>(samples.size() - 1, samples.size() * percentile / 100);
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+};
+
 class LSPClientServer : public QObject
 {
     Q_OBJECT
@@ -121,6 +173,14 @@ public:
 
     const LSPServerCapabilities &capabilities() const;
 
+    // request scheduling statistics, keyed by method
+    QHash<QString, LSPRequestStats> requestStats() const;
+
+    // record all traffic with this server to fileName (see lsptrafficrecord.h)
+    // also enabled for every server if KATE_LSP_RECORD_DIR is set
+    bool startRecording(const QString &fileName);
+    void stopRecording();
+
     // language
     RequestHandle documentSymbols(const QUrl &document, const QObject *context, const DocumentSymbolsReplyHandler &h, const ErrorReplyHandler &eh = nullptr);
     RequestHandle documentDefinition(const QUrl &document, const LSPPosition &pos, const QObject *context, const DocumentDefinitionReplyHandler &h);
@@ -178,7 +238,12 @@ public:
     // workspace
     void didChangeConfiguration(const QJsonValue &settings);
     void didChangeWorkspaceFolders(const QList<LSPWorkspaceFolder> &added, const QList<LSPWorkspaceFolder> &removed);
-    void workspaceSymbol(const QString &symbol, const QObject *context, const WorkspaceSymbolsReplyHandler &h);
+    // if a partial handler is given, results may be streamed to it (as partial results)
+    // before the final reply (which then only holds any remaining results)
+    RequestHandle workspaceSymbol(const QString &symbol,
+                                  const QObject *context,
+                                  const WorkspaceSymbolsReplyHandler &h,
+                                  const WorkspaceSymbolsReplyHandler &partial = nullptr);
 
     // notification = signal
 Q_SIGNALS:
@@ -397,6 +397,19 @@ public:
         restart(servers, server == nullptr);
     }
 
+    QVector<QSharedPointer<LSPClientServer>> servers() override
+    {
+        ServerList result;
+        for (const auto &el : qAsConst(m_servers)) {
+            for (const auto &si : el) {
+                if (si.server) {
+                    result.push_back(si.server);
+                }
+            }
+        }
+        return result;
+    }
+
     qint64 revision(KTextEditor::Document *doc) override
     {
         auto it = m_docs.find(doc);
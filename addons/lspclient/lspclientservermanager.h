@@ -51,6 +51,9 @@ public:
 
     virtual void setIncrementalSync(bool inc) = 0;
 
+    // all currently known servers
+    virtual QVector<QSharedPointer<LSPClientServer>> servers() = 0;
+
     // latest sync'ed revision of doc (-1 if N/A)
     virtual qint64 revision(KTextEditor::Document *doc) = 0;
 
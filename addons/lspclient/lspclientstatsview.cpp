@@ -0,0 +1,231 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "lspclientstatsview.h"
+
+#include <KLocalizedString>
+#include <KTextEditor/Document>
+#include <KTextEditor/MainWindow>
+#include <KTextEditor/View>
+
+#include <QHeaderView>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocale>
+#include <QMenu>
+#include <QSet>
+#include <QStandardItemModel>
+
+#include <algorithm>
+#include <utility>
+
+// what a row stands for, the server or the method
+static constexpr int KeyRole = Qt::UserRole + 1;
+
+static QStringList statsTexts(const QString &name, const LSPRequestStats &stats)
+{
+    const QLocale locale;
+    return {name,
+            QString::number(stats.completed),
+            QString::number(stats.queued + stats.inFlight),
+            QString::number(stats.cancelled),
+            QString::number(stats.latencyPercentile(50)),
+            QString::number(stats.latencyPercentile(99)),
+            QString::number(stats.maxLatencyMs),
+            locale.formattedDataSize(stats.bytesOut),
+            locale.formattedDataSize(stats.bytesIn),
+            QString::number(stats.parseTimeUs / 1000),
+            QString::number(stats.handlerTimeUs / 1000)};
+}
+
+// update the row of @p parent for @p key in place, so selection, expansion and scroll position survive
+static QStandardItem *updateRow(QStandardItem *parent, const QVariant &key, const QStringList &texts, bool &added)
+{
+    for (int row = 0; row < parent->rowCount(); ++row) {
+        if (parent->child(row)->data(KeyRole) != key) {
+            continue;
+        }
+        for (int column = 0; column < texts.size(); ++column) {
+            auto item = parent->child(row, column);
+            if (item->text() != texts.at(column)) {
+                item->setText(texts.at(column));
+            }
+        }
+        return parent->child(row);
+    }
+
+    QList<QStandardItem *> items;
+    for (const auto &text : texts) {
+        auto item = new QStandardItem(text);
+        if (!items.isEmpty()) {
+            item->setData(Qt::AlignRight, Qt::TextAlignmentRole);
+        }
+        items.append(item);
+    }
+    items.front()->setData(key, KeyRole);
+    parent->appendRow(items);
+    added = true;
+    return items.front();
+}
+
+LSPClientStatsView::LSPClientStatsView(KTextEditor::MainWindow *mainWin, QSharedPointer<LSPClientServerManager> manager, QWidget *parent)
+    : QTreeView(parent)
+    , m_mainWindow(mainWin)
+    , m_serverManager(std::move(manager))
+    , m_model(new QStandardItemModel(this))
+{
+    m_model->setHorizontalHeaderLabels({i18n("Method"),
+                                        i18n("Requests"),
+                                        i18n("Pending"),
+                                        i18n("Cancelled"),
+                                        i18n("p50 (ms)"),
+                                        i18n("p99 (ms)"),
+                                        i18n("Max (ms)"),
+                                        i18n("Sent"),
+                                        i18n("Received"),
+                                        i18n("Parsing (ms)"),
+                                        i18n("Handling (ms)")});
+    setModel(m_model);
+    setAlternatingRowColors(true);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setUniformRowHeights(true);
+    setSortingEnabled(true);
+    sortByColumn(0, Qt::AscendingOrder);
+    header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(this, &QTreeView::customContextMenuRequested, this, &LSPClientStatsView::showContextMenu);
+
+    m_refreshTimer.setInterval(1000);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &LSPClientStatsView::refresh);
+}
+
+QJsonArray LSPClientStatsView::toJson(const QVector<QSharedPointer<LSPClientServer>> &servers)
+{
+    QJsonArray result;
+    for (const auto &server : servers) {
+        QJsonObject methods;
+        const auto stats = server->requestStats();
+        for (auto it = stats.begin(); it != stats.end(); ++it) {
+            const auto &s = it.value();
+            const auto averageLatency = s.completed ? s.totalLatencyMs / s.completed : 0;
+            methods[it.key()] = QJsonObject{{QStringLiteral("requests"), s.completed},
+                                            {QStringLiteral("queued"), s.queued},
+                                            {QStringLiteral("inFlight"), s.inFlight},
+                                            {QStringLiteral("cancelled"), s.cancelled},
+                                            {QStringLiteral("latencyAvgMs"), averageLatency},
+                                            {QStringLiteral("latencyP50Ms"), s.latencyPercentile(50)},
+                                            {QStringLiteral("latencyP99Ms"), s.latencyPercentile(99)},
+                                            {QStringLiteral("latencyMaxMs"), s.maxLatencyMs},
+                                            {QStringLiteral("messagesOut"), s.messagesOut},
+                                            {QStringLiteral("messagesIn"), s.messagesIn},
+                                            {QStringLiteral("bytesOut"), s.bytesOut},
+                                            {QStringLiteral("bytesIn"), s.bytesIn},
+                                            {QStringLiteral("parseTimeUs"), s.parseTimeUs},
+                                            {QStringLiteral("handlerTimeUs"), s.handlerTimeUs}};
+        }
+        // several servers may share a description, e.g. the same server for two projects
+        result.append(QJsonObject{{QStringLiteral("server"), LSPClientServerManager::serverDescription(server.data())},
+                                  {QStringLiteral("methods"), methods}});
+    }
+    return result;
+}
+
+void LSPClientStatsView::refresh()
+{
+    QStandardItem *root = m_model->invisibleRootItem();
+    QSet<quintptr> current;
+    QVector<QStandardItem *> newServers;
+    bool added = false;
+
+    const auto servers = m_serverManager->servers();
+    for (const auto &server : servers) {
+        LSPRequestStats total;
+        const auto stats = server->requestStats();
+        for (auto it = stats.begin(); it != stats.end(); ++it) {
+            const auto &s = it.value();
+            total.completed += s.completed;
+            total.queued += s.queued;
+            total.inFlight += s.inFlight;
+            total.cancelled += s.cancelled;
+            total.maxLatencyMs = std::max(total.maxLatencyMs, s.maxLatencyMs);
+            total.bytesOut += s.bytesOut;
+            total.bytesIn += s.bytesIn;
+            total.parseTimeUs += s.parseTimeUs;
+            total.handlerTimeUs += s.handlerTimeUs;
+        }
+
+        // percentiles do not add up, so leave those out of the server summary
+        auto serverTexts = statsTexts(LSPClientServerManager::serverDescription(server.data()), total);
+        serverTexts[4].clear();
+        serverTexts[5].clear();
+
+        const auto key = quintptr(server.data());
+        current.insert(key);
+        bool serverAdded = false;
+        auto serverItem = updateRow(root, QVariant::fromValue(key), serverTexts, serverAdded);
+        if (serverAdded) {
+            newServers.push_back(serverItem);
+            added = true;
+        }
+        for (auto it = stats.begin(); it != stats.end(); ++it) {
+            updateRow(serverItem, it.key(), statsTexts(it.key(), it.value()), added);
+        }
+    }
+
+    // servers gone meanwhile
+    for (int row = root->rowCount() - 1; row >= 0; --row) {
+        if (!current.contains(root->child(row)->data(KeyRole).value<quintptr>())) {
+            root->removeRow(row);
+        }
+    }
+
+    if (added) {
+        m_model->sort(header()->sortIndicatorSection(), header()->sortIndicatorOrder());
+    }
+    for (auto item : qAsConst(newServers)) {
+        expand(item->index());
+    }
+}
+
+void LSPClientStatsView::exportJson()
+{
+    auto view = m_mainWindow->openUrl(QUrl());
+    if (view) {
+        QJsonDocument json(toJson(m_serverManager->servers()));
+        auto doc = view->document();
+        doc->setText(QString::fromUtf8(json.toJson()));
+        // position at top
+        view->setCursorPosition({0, 0});
+        // adjust mode
+        const QString mode = QStringLiteral("JSON");
+        doc->setHighlightingMode(mode);
+        doc->setMode(mode);
+        // no save file dialog when closing
+        doc->setModified(false);
+    }
+}
+
+void LSPClientStatsView::showEvent(QShowEvent *event)
+{
+    refresh();
+    m_refreshTimer.start();
+    QTreeView::showEvent(event);
+}
+
+void LSPClientStatsView::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer.stop();
+    QTreeView::hideEvent(event);
+}
+
+void LSPClientStatsView::showContextMenu(const QPoint &pos)
+{
+    QMenu menu(this);
+    menu.addAction(i18n("Refresh"), this, &LSPClientStatsView::refresh);
+    menu.addAction(i18n("Export as JSON"), this, &LSPClientStatsView::exportJson);
+    menu.exec(viewport()->mapToGlobal(pos));
+}
@@ -0,0 +1,49 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#ifndef LSPCLIENTSTATSVIEW_H
+#define LSPCLIENTSTATSVIEW_H
+
+#include "lspclientservermanager.h"
+
+#include <QJsonArray>
+#include <QTimer>
+#include <QTreeView>
+
+class QStandardItemModel;
+
+/*
+ * Shows per server and per method request statistics (latency, traffic,
+ * time spent handling replies), to tell apart a slow server from slow handling.
+ */
+class LSPClientStatsView : public QTreeView
+{
+    Q_OBJECT
+
+public:
+    LSPClientStatsView(KTextEditor::MainWindow *mainWin, QSharedPointer<LSPClientServerManager> manager, QWidget *parent = nullptr);
+
+    // statistics of all servers, one entry per server
+    static QJsonArray toJson(const QVector<QSharedPointer<LSPClientServer>> &servers);
+
+    void refresh();
+    void exportJson();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void showContextMenu(const QPoint &pos);
+
+    KTextEditor::MainWindow *m_mainWindow;
+    QSharedPointer<LSPClientServerManager> m_serverManager;
+    QStandardItemModel *m_model;
+    // periodic refresh while visible
+    QTimer m_refreshTimer;
+};
+
+#endif
@@ -23,8 +23,13 @@
 #include <QTimer>
 #include <QTreeView>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <kfts_fuzzy_match.h>
 
@@ -201,6 +206,22 @@ class LSPClientSymbolViewImpl : public QObject, public LSPClientSymbolView
     // filter model, setup once
     LSPClientSymbolViewFilterProxyModel m_filterModel;
 
+    // line -> (deepest) outline item lookup for the current outline;
+    // each segment covers lines from its start up to the start of the next one
+    struct LineSegment {
+        int startLine;
+        QStandardItem *item;
+    };
+    std::vector<LineSegment> m_lineIndex;
+
+    // outline item as determined from symbols, applied to model items later on
+    struct OutlineNode {
+        QString text;
+        const QIcon *icon;
+        KTextEditor::Range range;
+        QList<OutlineNode> children;
+    };
+
     // cached icons for model
     const QIcon m_icon_pkg = QIcon::fromTheme(QStringLiteral("code-block"));
     const QIcon m_icon_class = QIcon::fromTheme(QStringLiteral("code-class"));
@@ -287,6 +308,10 @@ public:
     void displayOptionChanged()
     {
         m_expandOn->setEnabled(m_treeOn->isChecked());
+        // cached outlines no longer match the display options
+        for (auto &model : m_models) {
+            model.model.reset();
+        }
         refresh(false, false);
     }
 
@@ -319,7 +344,12 @@ public:
         }
     }
 
-    void makeNodes(const QList<LSPSymbolInformation> &symbols, bool tree, bool show_detail, QStandardItemModel *model, QStandardItem *parent, bool &details)
+    void makeNodes(const QList<LSPSymbolInformation> &symbols,
+                   bool tree,
+                   bool show_detail,
+                   QList<OutlineNode> &nodes,
+                   const QIcon *parentIcon,
+                   bool &details) const
     {
         const QIcon *icon = nullptr;
         for (const auto &symbol : symbols) {
@@ -355,34 +385,139 @@ public:
             default:
                 // skip local variable
                 // property, field, etc unlikely in such case anyway
-                if (parent && parent->icon().cacheKey() == m_icon_function.cacheKey()) {
+                if (parentIcon == &m_icon_function) {
                     continue;
                 }
                 icon = &m_icon_var;
             }
 
-            auto node = new QStandardItem();
-            auto line = new QStandardItem();
-            if (parent && tree) {
-                parent->appendRow({node, line});
-            } else {
-                model->appendRow({node, line});
-            }
-
             if (!symbol.detail.isEmpty()) {
                 details = true;
             }
             auto detail = show_detail && !symbol.detail.isEmpty() ? QStringLiteral(" [%1]").arg(symbol.detail) : QString();
-            node->setText(symbol.name + detail);
-            node->setIcon(*icon);
-            node->setData(QVariant::fromValue<KTextEditor::Range>(symbol.range), Qt::UserRole);
-            static const QChar prefix = QChar::fromLatin1('0');
-            line->setText(QStringLiteral("%1").arg(symbol.range.start().line(), 7, 10, prefix));
-            // recurse children
-            makeNodes(symbol.children, tree, show_detail, model, node, details);
+            nodes.push_back({symbol.name + detail, icon, symbol.range, {}});
+            // recurse children, which end up next to their parent if no tree is wanted
+            auto &node = nodes.back();
+            if (tree) {
+                makeNodes(symbol.children, tree, show_detail, node.children, icon, details);
+            } else {
+                makeNodes(symbol.children, tree, show_detail, nodes, icon, details);
+            }
+        }
+    }
+
+    static void setItemRange(QStandardItem *node, QStandardItem *line, const KTextEditor::Range &range)
+    {
+        if (node->data(Qt::UserRole).value<KTextEditor::Range>() == range) {
+            return;
+        }
+        node->setData(QVariant::fromValue<KTextEditor::Range>(range), Qt::UserRole);
+        static const QChar prefix = QChar::fromLatin1('0');
+        line->setText(QStringLiteral("%1").arg(range.start().line(), 7, 10, prefix));
+    }
+
+    static bool matches(const QStandardItem *item, const OutlineNode &node)
+    {
+        return item->text() == node.text && item->icon().cacheKey() == node.icon->cacheKey();
+    }
+
+    // update rows of parent to match nodes, only touching what changed
+    // (so expansion and selection state of untouched items is kept)
+    void syncNodes(QStandardItem *parent, const QList<OutlineNode> &nodes)
+    {
+        // how far to look for a match before assuming a node is new
+        static constexpr int MAX_LOOKAHEAD = 32;
+
+        int row = 0;
+        for (const auto &node : nodes) {
+            // drop existing items that no longer have a counterpart
+            int match = -1;
+            for (int i = row; i < std::min(parent->rowCount(), row + MAX_LOOKAHEAD); ++i) {
+                if (matches(parent->child(i, 0), node)) {
+                    match = i;
+                    break;
+                }
+            }
+            if (match > row) {
+                parent->removeRows(row, match - row);
+            }
+
+            QStandardItem *item = nullptr;
+            QStandardItem *line = nullptr;
+            if (match < 0) {
+                item = new QStandardItem(node.text);
+                item->setIcon(*node.icon);
+                line = new QStandardItem();
+                parent->insertRow(row, {item, line});
+            } else {
+                item = parent->child(row, 0);
+                line = parent->child(row, 1);
+            }
+            setItemRange(item, line, node.range);
+            syncNodes(item, node.children);
+            ++row;
+        }
+
+        if (parent->rowCount() > row) {
+            parent->removeRows(row, parent->rowCount() - row);
         }
     }
 
+    // (re)build line index for current outline
+    void updateLineIndex()
+    {
+        struct Interval {
+            int start;
+            int end;
+            int depth;
+            QStandardItem *item;
+        };
+        std::vector<Interval> intervals;
+        std::function<void(QStandardItem *, int)> collect = [&](QStandardItem *parent, int depth) {
+            for (int i = 0; i < parent->rowCount(); ++i) {
+                auto item = parent->child(i, 0);
+                const auto range = item->data(Qt::UserRole).value<KTextEditor::Range>();
+                if (range.isValid()) {
+                    intervals.push_back({range.start().line(), range.end().line(), depth, item});
+                }
+                collect(item, depth + 1);
+            }
+        };
+        collect(m_outline->invisibleRootItem(), 0);
+
+        // outer intervals first, so inner ones win for the lines they cover
+        std::sort(intervals.begin(), intervals.end(), [](const Interval &l, const Interval &r) {
+            return std::tie(l.start, r.end, l.depth) < std::tie(r.start, l.end, r.depth);
+        });
+
+        m_lineIndex.clear();
+        auto addSegment = [this](int startLine, QStandardItem *item) {
+            if (!m_lineIndex.empty() && m_lineIndex.back().startLine == startLine) {
+                m_lineIndex.back().item = item;
+            } else {
+                m_lineIndex.push_back({startLine, item});
+            }
+        };
+        // sweep over intervals, keeping the stack of those covering the current line
+        std::vector<const Interval *> active;
+        auto expire = [&](int line) {
+            while (!active.empty() && active.back()->end < line) {
+                const int next = active.back()->end + 1;
+                active.pop_back();
+                while (!active.empty() && active.back()->end < next) {
+                    active.pop_back();
+                }
+                addSegment(next, active.empty() ? nullptr : active.back()->item);
+            }
+        };
+        for (const auto &interval : intervals) {
+            expire(interval.start);
+            active.push_back(&interval);
+            addSegment(interval.start, interval.item);
+        }
+        expire(std::numeric_limits<int>::max());
+    }
+
     void onDocumentSymbols(const QList<LSPSymbolInformation> &outline)
     {
         onDocumentSymbolsOrProblem(outline, QString(), true);
@@ -394,13 +529,30 @@ public:
             return;
         }
 
+        // if we have some problem, just report that, else construct nodes
+        bool details = false;
+        QList<OutlineNode> nodes;
+        if (problem.isEmpty()) {
+            makeNodes(outline, m_treeOn->isChecked(), m_detailsOn->isChecked(), nodes, nullptr, details);
+
+            // if the current outline is that of this document, update it in place
+            if (cache && !m_models.isEmpty() && m_models[0].model && m_models[0].model == m_outline) {
+                syncNodes(m_outline->invisibleRootItem(), nodes);
+                m_outline->invisibleRootItem()->setData(details);
+                m_detailsOn->setEnabled(details);
+                if (m_expandOn->isChecked()) {
+                    m_symbols->expandAll();
+                }
+                updateLineIndex();
+                updateCurrentTreeItem();
+                return;
+            }
+        }
+
         // construct new model for data
         auto newModel = std::make_shared<QStandardItemModel>();
-
-        // if we have some problem, just report that, else construct model
-        bool details = false;
         if (problem.isEmpty()) {
-            makeNodes(outline, m_treeOn->isChecked(), m_detailsOn->isChecked(), newModel.get(), nullptr, details);
+            syncNodes(newModel->invisibleRootItem(), nodes);
             if (cache) {
                 // last request has been placed at head of model list
                 Q_ASSERT(!m_models.isEmpty());
@@ -429,6 +581,7 @@ public:
 
         // delete old outline if there, keep our new one alive
         m_outline = newModel;
+        updateLineIndex();
 
         // fixup sorting
         if (m_sortOn->isChecked()) {
@@ -546,20 +699,24 @@ public:
         onDocumentSymbolsOrProblem(QList<LSPSymbolInformation>(), i18n("No LSP server for this document."));
     }
 
-    QStandardItem *getCurrentItem(QStandardItem *item, int line)
+    QStandardItem *getCurrentItem(int line)
     {
-        // first traverse the child items to have deepest match!
-        // only do this if our stuff is expanded
-        if (item == m_outline->invisibleRootItem() || m_symbols->isExpanded(m_filterModel.mapFromSource(m_outline->indexFromItem(item)))) {
-            for (int i = 0; i < item->rowCount(); i++) {
-                if (auto citem = getCurrentItem(item->child(i), line)) {
-                    return citem;
-                }
-            }
+        // deepest item covering line
+        auto it = std::upper_bound(m_lineIndex.begin(), m_lineIndex.end(), line, [](int l, const LineSegment &segment) {
+            return l < segment.startLine;
+        });
+        if (it == m_lineIndex.begin()) {
+            return nullptr;
         }
+        auto item = std::prev(it)->item;
 
-        // does the line match our item?
-        return item->data(Qt::UserRole).value<KTextEditor::Range>().overlapsLine(line) ? item : nullptr;
+        // but do not pick something hidden in a collapsed part of the tree
+        for (auto parent = item ? item->parent() : nullptr; parent; parent = parent->parent()) {
+            if (!m_symbols->isExpanded(m_filterModel.mapFromSource(m_outline->indexFromItem(parent)))) {
+                item = parent;
+            }
+        }
+        return item;
     }
 
     void updateCurrentTreeItem()
@@ -572,7 +729,7 @@ public:
         /**
          * get item if any
          */
-        QStandardItem *item = getCurrentItem(m_outline->invisibleRootItem(), editView->cursorPositionVirtual().line());
+        QStandardItem *item = getCurrentItem(editView->cursorPositionVirtual().line());
         if (!item) {
             return;
         }
@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#ifndef LSPTRAFFICRECORD_H
+#define LSPTRAFFICRECORD_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+
+// Recorded LSP traffic, as written by LSPClientServer in recording mode
+// and played back by the replay server used in tests and benchmarks.
+//
+// Each message is stored as a header line
+//   <direction> <msecs since start> <payload length>
+// followed by the (unframed) JSON payload and a newline.
+// Direction is '>' for client to server and '<' for server to client.
+struct LSPTrafficEntry {
+    enum Direction : char { ToServer = '>', FromServer = '<' };
+
+    Direction direction = ToServer;
+    qint64 timestamp = 0;
+    QByteArray payload;
+};
+
+inline void writeTrafficEntry(QIODevice &device, LSPTrafficEntry::Direction direction, qint64 timestamp, const QByteArray &payload)
+{
+    QByteArray header;
+    header.append(static_cast<char>(direction));
+    header.append(' ');
+    header.append(QByteArray::number(timestamp));
+    header.append(' ');
+    header.append(QByteArray::number(payload.size()));
+    header.append('\n');
+    device.write(header);
+    device.write(payload);
+    device.write("\n");
+}
+
+inline QList<LSPTrafficEntry> readTrafficEntries(QIODevice &device)
+{
+    QList<LSPTrafficEntry> entries;
+    const QByteArray data = device.readAll();
+    int pos = 0;
+    while (pos < data.size()) {
+        const int eol = data.indexOf('\n', pos);
+        if (eol < 0) {
+            break;
+        }
+        const auto header = data.mid(pos, eol - pos).split(' ');
+        if (header.size() != 3 || header[0].size() != 1) {
+            break;
+        }
+        bool ok = false;
+        const int length = header[2].toInt(&ok);
+        if (!ok || eol + 1 + length > data.size()) {
+            break;
+        }
+        LSPTrafficEntry entry;
+        entry.direction = header[0][0] == LSPTrafficEntry::FromServer ? LSPTrafficEntry::FromServer : LSPTrafficEntry::ToServer;
+        entry.timestamp = header[1].toLongLong();
+        entry.payload = data.mid(eol + 1, length);
+        entries.push_back(entry);
+        // skip payload and trailing newline
+        pos = eol + 1 + length + 1;
+    }
+    return entries;
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+// Minimal LSP "server" that plays back a recording made by LSPClientServer.
+//
+// Every message received from the client is matched (by method, in order) against
+// the client messages of the recording. All server messages that followed the
+// matched one in the recording are then sent back, with reply ids mapped onto the
+// id used by the client. Once all recorded occurrences of a method are consumed,
+// matching starts over, so a recording can be replayed for many iterations.
+//
+// usage: lspreplayserver [--realtime] <recording>
+
+#include "../lsptrafficrecord.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QVector>
+
+#include <cstdio>
+
+static const QString MEMBER_ID = QStringLiteral("id");
+static const QString MEMBER_METHOD = QStringLiteral("method");
+
+// read one framed message from stdin, blocking
+static bool readMessage(QFile &in, QByteArray &payload)
+{
+    int length = -1;
+    while (true) {
+        const auto line = in.readLine();
+        if (line.isEmpty()) {
+            return false;
+        }
+        const auto trimmed = line.trimmed();
+        if (trimmed.isEmpty()) {
+            if (length >= 0) {
+                break;
+            }
+            continue;
+        }
+        if (trimmed.startsWith("Content-Length:")) {
+            length = trimmed.mid(15).trimmed().toInt();
+        }
+    }
+
+    payload.clear();
+    while (payload.size() < length) {
+        const auto chunk = in.read(length - payload.size());
+        // blocking read, so nothing means end of input
+        if (chunk.isEmpty()) {
+            return false;
+        }
+        payload.append(chunk);
+    }
+    return true;
+}
+
+static void writeMessage(QFile &out, const QByteArray &payload)
+{
+    out.write("Content-Length: " + QByteArray::number(payload.size()) + "\r\n\r\n");
+    out.write(payload);
+    out.flush();
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    auto args = app.arguments();
+    args.pop_front();
+    const bool realtime = args.removeAll(QStringLiteral("--realtime")) > 0;
+    if (args.size() != 1) {
+        fprintf(stderr, "usage: lspreplayserver [--realtime] <recording>\n");
+        return -1;
+    }
+
+    QFile recording(args.front());
+    if (!recording.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "failed to open %s\n", qPrintable(args.front()));
+        return -1;
+    }
+    const auto entries = readTrafficEntries(recording);
+
+    // method -> indices of recorded client messages
+    QHash<QString, QVector<int>> clientMessages;
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries[i].direction == LSPTrafficEntry::ToServer) {
+            const auto method = QJsonDocument::fromJson(entries[i].payload).object().value(MEMBER_METHOD).toString();
+            if (!method.isEmpty()) {
+                clientMessages[method].push_back(i);
+            }
+        }
+    }
+    QHash<QString, int> cursors;
+
+    QFile in;
+    QFile out;
+    if (!in.open(stdin, QIODevice::ReadOnly | QIODevice::Unbuffered) || !out.open(stdout, QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        return -1;
+    }
+
+    QByteArray payload;
+    while (readMessage(in, payload)) {
+        const auto msg = QJsonDocument::fromJson(payload).object();
+        const auto method = msg.value(MEMBER_METHOD).toString();
+        if (method == QLatin1String("exit")) {
+            break;
+        }
+        const auto it = clientMessages.constFind(method);
+        if (method.isEmpty() || it == clientMessages.constEnd()) {
+            // replies to server requests or unrecorded methods
+            continue;
+        }
+
+        int &cursor = cursors[method];
+        const int index = it->at(cursor);
+        cursor = (cursor + 1) % it->size();
+
+        const auto recorded = QJsonDocument::fromJson(entries[index].payload).object();
+        const auto recordedId = recorded.value(MEMBER_ID);
+        const auto isReply = [&recordedId](const QJsonObject &reply) {
+            return !recordedId.isUndefined() && !reply.contains(MEMBER_METHOD) && reply.value(MEMBER_ID) == recordedId;
+        };
+        const auto sendReply = [&out, &msg](QJsonObject reply) {
+            reply[MEMBER_ID] = msg.value(MEMBER_ID);
+            writeMessage(out, QJsonDocument(reply).toJson(QJsonDocument::Compact));
+        };
+
+        // server messages directly following the client message
+        bool replied = false;
+        qint64 previous = entries[index].timestamp;
+        for (int i = index + 1; i < entries.size() && entries[i].direction == LSPTrafficEntry::FromServer; ++i) {
+            const auto &entry = entries[i];
+            if (realtime && entry.timestamp > previous) {
+                QThread::msleep(entry.timestamp - previous);
+                previous = entry.timestamp;
+            }
+            const auto reply = QJsonDocument::fromJson(entry.payload).object();
+            if (isReply(reply)) {
+                sendReply(reply);
+                replied = true;
+            } else if (reply.contains(MEMBER_METHOD)) {
+                // notification or server request
+                writeMessage(out, entry.payload);
+            }
+            // else reply to some other request, sent when that one is replayed
+        }
+
+        // reply may also have arrived after some later client message
+        for (int i = index + 1; !replied && !recordedId.isUndefined() && i < entries.size(); ++i) {
+            if (entries[i].direction == LSPTrafficEntry::FromServer) {
+                const auto reply = QJsonDocument::fromJson(entries[i].payload).object();
+                if (isReply(reply)) {
+                    sendReply(reply);
+                    replied = true;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
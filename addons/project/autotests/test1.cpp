@@ -6,9 +6,27 @@
  */
 
 #include "test1.h"
+#include "filehistorymodel.h"
 #include "fileutil.h"
+#include "gitbatch.h"
+#include "gitchangemarks.h"
+#include "git/gitrefs.h"
+#include "git/gitstatus.h"
+#include "gitstatusmodel.h"
+#include "kateprojectcodeanalysisrunner.h"
+#include "kateprojectcodeanalysistool.h"
 #include "tools/shellcheck.h"
 
+#include <gitdiffprovider.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
 #include <QTest>
 
 #include <QString>
@@ -39,4 +57,525 @@ void Test1::testShellCheckParsing()
     QCOMPARE(outList.size(), 4);
 }
 
+void Test1::testCodeAnalysisShards()
+{
+    QStringList files;
+    for (int i = 0; i < 100; ++i) {
+        files.append(QStringLiteral("/src/file%1.cpp").arg(i));
+    }
+
+    // 4 shards per process, all files exactly once in their order
+    auto shards = KateProjectCodeAnalysisRunner::shards(files, 5, 0);
+    QCOMPARE(int(shards.size()), 20);
+    QStringList all;
+    for (const auto &shard : shards) {
+        QCOMPARE(shard.size(), 5);
+        all += shard;
+    }
+    QCOMPARE(all, files);
+
+    // limited by the tool, e.g. one translation unit per clazy process
+    shards = KateProjectCodeAnalysisRunner::shards(files, 5, 1);
+    QCOMPARE(int(shards.size()), 100);
+
+    // less files than processes
+    shards = KateProjectCodeAnalysisRunner::shards(files.mid(0, 3), 8, 0);
+    QCOMPARE(int(shards.size()), 3);
+    QVERIFY(KateProjectCodeAnalysisRunner::shards(QStringList(), 8, 0).empty());
+}
+
+static QByteArrayList files(const QVector<GitUtils::StatusItem> &items)
+{
+    QByteArrayList result;
+    for (const auto &item : items) {
+        result.append(item.file);
+    }
+    return result;
+}
+
+void Test1::testGitStatusMerge()
+{
+    const QByteArray raw(" M a.txt\0 M src/b.cpp\0M  src/c.cpp\0?? src/sub/d.cpp\0?? src/e.cpp\0", 65);
+    auto status = GitUtils::parseStatus(raw);
+    GitUtils::sortStatus(status);
+    QCOMPARE(files(status.changed), (QByteArrayList{"a.txt", "src/b.cpp"}));
+    QCOMPARE(files(status.staged), (QByteArrayList{"src/c.cpp"}));
+    QCOMPARE(files(status.untracked), (QByteArrayList{"src/e.cpp", "src/sub/d.cpp"}));
+
+    // src/b.cpp reverted, src/e.cpp added, src/f.cpp new, src/sub untouched
+    const QByteArray update("M  src/c.cpp\0A  src/e.cpp\0?? src/f.cpp\0", 39);
+    GitUtils::mergeStatus(status, GitUtils::parseStatus(update), {}, {"src"});
+    QCOMPARE(files(status.changed), (QByteArrayList{"a.txt"}));
+    QCOMPARE(files(status.staged), (QByteArrayList{"src/c.cpp", "src/e.cpp"}));
+    QCOMPARE(files(status.untracked), (QByteArrayList{"src/f.cpp", "src/sub/d.cpp"}));
+
+    // a single file
+    GitUtils::mergeStatus(status, GitUtils::parseStatus(QByteArray("MM a.txt\0", 9)), {"a.txt"}, {});
+    QCOMPARE(files(status.changed), (QByteArrayList{"a.txt"}));
+    QCOMPARE(files(status.staged), (QByteArrayList{"a.txt", "src/c.cpp", "src/e.cpp"}));
+
+    // an untracked tree with everything below it, src/sub/d.cpp deleted, a new subdirectory
+    GitUtils::mergeStatus(status, GitUtils::parseStatus(QByteArray("?? src/sub/new/g.cpp\0", 21)), {}, {}, {"src/sub"});
+    QCOMPARE(files(status.untracked), (QByteArrayList{"src/f.cpp", "src/sub/new/g.cpp"}));
+    QCOMPARE(files(status.staged), (QByteArrayList{"a.txt", "src/c.cpp", "src/e.cpp"}));
+
+    const QByteArray numStat("3\t1\ta.txt\0" "10\t0\tsrc/e.cpp\0", 25);
+    GitUtils::parseDiffNumStat(status.staged, numStat);
+    QCOMPARE(status.staged.at(0).linesAdded, 3);
+    QCOMPARE(status.staged.at(0).linesRemoved, 1);
+    QCOMPARE(status.staged.at(1).linesAdded, 0);
+    QCOMPARE(status.staged.at(2).linesAdded, 10);
+}
+
+void Test1::testGitStatusModelUpdate()
+{
+    GitStatusModel model(nullptr);
+
+    auto status = GitUtils::parseStatus(QByteArray(" M a\0 M b\0 M c\0", 15));
+    model.setStatusItems(status, false);
+    QCOMPARE(files(model.changedFiles()), (QByteArrayList{"a", "b", "c"}));
+
+    // no reset, just the rows that differ
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+
+    status = GitUtils::parseStatus(QByteArray(" D a\0 M c\0 M d\0", 15));
+    model.setStatusItems(status, false);
+    QCOMPARE(files(model.changedFiles()), (QByteArrayList{"a", "c", "d"}));
+    QCOMPARE(model.changedFiles().at(0).statusChar, 'D');
+    QCOMPARE(reset.count(), 0);
+    QCOMPARE(removed.count(), 1);
+    QCOMPARE(inserted.count(), 1);
+    // a + the unchanged count
+    QCOMPARE(changed.count(), 1);
+}
+
+void Test1::testGitDiffParse()
+{
+    const QByteArray diff =
+        "diff --git a/a.txt b/a.txt\n"
+        "index 1111111111111111111111111111111111111111..2222222222222222222222222222222222222222 100644\n"
+        "--- a/a.txt\n"
+        "+++ b/a.txt\n"
+        "@@ -1,2 +1,2 @@\n"
+        "-x\n"
+        "+y\n"
+        " z\n"
+        "@@ -10 +10,0 @@ context\n"
+        "-w\n"
+        "diff --git a/gone.txt b/gone.txt\n"
+        "deleted file mode 100644\n"
+        "index 3333333333333333333333333333333333333333..0000000000000000000000000000000000000000\n"
+        "--- a/gone.txt\n"
+        "+++ /dev/null\n"
+        "@@ -1 +0,0 @@\n"
+        "-gone\n"
+        "diff --git a/old name b/new name\n"
+        "similarity index 100%\n"
+        "rename from old name\n"
+        "rename to new name\n";
+
+    const auto diffs = GitDiffProvider::parse(diff);
+    QCOMPARE(int(diffs.size()), 3);
+
+    QCOMPARE(diffs[0].path, QStringLiteral("a.txt"));
+    QCOMPARE(diffs[0].blobs, QByteArray("1111111111111111111111111111111111111111..2222222222222222222222222222222222222222"));
+    QVERIFY(diffs[0].patch.startsWith("diff --git a/a.txt"));
+    QVERIFY(diffs[0].patch.endsWith("-w\n"));
+    QCOMPARE(int(diffs[0].hunks.size()), 2);
+    QCOMPARE(diffs[0].hunks[0].oldStart, 1);
+    QCOMPARE(diffs[0].hunks[0].oldCount, 2);
+    QCOMPARE(diffs[0].hunks[0].newCount, 2);
+    QCOMPARE(diffs[0].patch.mid(diffs[0].hunks[0].offset, diffs[0].hunks[0].length), QByteArray("@@ -1,2 +1,2 @@\n-x\n+y\n z\n"));
+    QCOMPARE(diffs[0].hunks[1].oldStart, 10);
+    QCOMPARE(diffs[0].hunks[1].oldCount, 1);
+    QCOMPARE(diffs[0].hunks[1].newStart, 10);
+    QCOMPARE(diffs[0].hunks[1].newCount, 0);
+
+    QCOMPARE(diffs[1].path, QStringLiteral("gone.txt"));
+    QCOMPARE(int(diffs[1].hunks.size()), 1);
+
+    QCOMPARE(diffs[2].path, QStringLiteral("new name"));
+    QVERIFY(diffs[2].blobs.isEmpty());
+    QVERIFY(diffs[2].hunks.empty());
+
+    // git show of a merge
+    const QByteArray merge =
+        "diff --cc m.txt\n"
+        "index 1111111,2222222..3333333\n"
+        "--- a/m.txt\n"
+        "+++ b/m.txt\n"
+        "@@@ -1,2 -1,3 +1,4 @@@\n"
+        "  x\n"
+        "+ y\n"
+        " +z\n"
+        "@@@ -8 -9 +10 @@@\n"
+        "- w\n"
+        "diff --combined n.txt\n"
+        "index 4444444,5555555..6666666\n";
+    const auto mergeDiffs = GitDiffProvider::parse(merge);
+    QCOMPARE(int(mergeDiffs.size()), 2);
+    QCOMPARE(mergeDiffs[0].path, QStringLiteral("m.txt"));
+    QCOMPARE(mergeDiffs[0].blobs, QByteArray("1111111,2222222..3333333"));
+    QCOMPARE(int(mergeDiffs[0].hunks.size()), 2);
+    QCOMPARE(mergeDiffs[0].hunks[0].oldStart, 1);
+    QCOMPARE(mergeDiffs[0].hunks[0].oldCount, 2);
+    QCOMPARE(mergeDiffs[0].hunks[0].newStart, 1);
+    QCOMPARE(mergeDiffs[0].hunks[0].newCount, 4);
+    QCOMPARE(mergeDiffs[0].hunks[1].newStart, 10);
+    QVERIFY(mergeDiffs[0].patch.endsWith("- w\n"));
+    QCOMPARE(mergeDiffs[1].path, QStringLiteral("n.txt"));
+}
+
+static void writeFile(const QString &path, const QByteArray &content, const QDateTime &modified = QDateTime())
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QFile::WriteOnly));
+    file.write(content);
+    file.flush();
+    if (modified.isValid()) {
+        QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+    }
+}
+
+/**
+ * Reports one result per file it gets and one about a header, like cppcheck does for included ones.
+ */
+class FakeAnalysisTool : public KateProjectCodeAnalysisTool
+{
+public:
+    FakeAnalysisTool(const QStringList &files, const QString &header)
+        : m_files(files)
+        , m_header(header)
+    {
+    }
+
+    QString name() const override
+    {
+        return QStringLiteral("fake");
+    }
+    QString description() const override
+    {
+        return QString();
+    }
+    QString fileExtensions() const override
+    {
+        return QStringLiteral("cpp");
+    }
+    QStringList filter(const QStringList &files) const override
+    {
+        return files;
+    }
+    QString path() const override
+    {
+        return QStringLiteral("sh");
+    }
+    QStringList analyzedFiles() override
+    {
+        return m_files;
+    }
+    QStringList arguments(const QStringList &files) override
+    {
+        const QString script = QStringLiteral("for f in \"$@\"; do echo \"$f////1////warning////checked\"; echo \"%1////2////warning////in header\"; done").arg(m_header);
+        return QStringList{QStringLiteral("-c"), script, QStringLiteral("sh")} + files;
+    }
+    QString notInstalledMessage() const override
+    {
+        return QString();
+    }
+    QStringList parseLine(const QString &line) const override
+    {
+        return line.trimmed().split(QStringLiteral("////"));
+    }
+    QString stdinMessages(const QStringList &) override
+    {
+        return QString();
+    }
+
+private:
+    const QStringList m_files;
+    const QString m_header;
+};
+
+void Test1::testCodeAnalysisCache()
+{
+    if (QStandardPaths::findExecutable(QStringLiteral("sh")).isEmpty()) {
+        QSKIP("sh not found");
+    }
+
+    qRegisterMetaType<QVector<QStringList>>();
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString a = tmp.filePath(QStringLiteral("a.cpp"));
+    const QString b = tmp.filePath(QStringLiteral("b.cpp"));
+    const QString header = tmp.filePath(QStringLiteral("header.h"));
+    writeFile(a, "a\n");
+    writeFile(b, "b\n");
+    writeFile(header, "h\n");
+
+    FakeAnalysisTool tool({a, b}, header);
+    KateProjectCodeAnalysisRunner runner;
+    QSignalSpy finished(&runner, &KateProjectCodeAnalysisRunner::finished);
+    QSignalSpy results(&runner, &KateProjectCodeAnalysisRunner::resultsReady);
+    auto run = [&]() {
+        finished.clear();
+        results.clear();
+        if (!runner.start(&tool) || !finished.wait()) {
+            return -1;
+        }
+        int count = 0;
+        for (const auto &ready : qAsConst(results)) {
+            count += ready.at(0).value<QVector<QStringList>>().size();
+        }
+        // all results every time, the header one once
+        return count == 3 ? finished.at(0).at(2).toInt() : -2;
+    };
+
+    // nothing cached at first, then all
+    QCOMPARE(run(), 2);
+    QVERIFY(finished.at(0).at(0).toBool());
+    QCOMPARE(run(), 0);
+
+    // a changed file is analyzed again, alone
+    writeFile(a, "changed\n");
+    QCOMPARE(run(), 1);
+    QCOMPARE(run(), 0);
+
+    // a changed header invalidates the results of all files reporting about it
+    writeFile(header, "changed\n");
+    QCOMPARE(run(), 2);
+    QCOMPARE(run(), 0);
+}
+
+void Test1::testGitRefs()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString gitDir = tmp.path() + QStringLiteral("/main/.git");
+
+    const QByteArray hash = "1111111111111111111111111111111111111111\n";
+    const QDateTime now = QDateTime::currentDateTime();
+    writeFile(gitDir + QStringLiteral("/refs/heads/old"), hash, now.addSecs(-3600));
+    writeFile(gitDir + QStringLiteral("/refs/heads/feature/new"), hash, now);
+    writeFile(gitDir + QStringLiteral("/refs/heads/new.lock"), hash);
+    writeFile(gitDir + QStringLiteral("/packed-refs"),
+              "# pack-refs with: peeled fully-peeled sorted\n"
+              "2222222222222222222222222222222222222222 refs/heads/old\n"
+              "2222222222222222222222222222222222222222 refs/heads/packed\n"
+              "2222222222222222222222222222222222222222 refs/stash\n"
+              "2222222222222222222222222222222222222222 refs/tags/v1\n"
+              "^3333333333333333333333333333333333333333\n");
+
+    // recently changed loose ones first, loose ones win
+    QStringList watched;
+    const QStringList refs = GitUtils::readRefNames(gitDir, &watched);
+    QCOMPARE(refs,
+             (QStringList{QStringLiteral("refs/heads/feature/new"),
+                          QStringLiteral("refs/heads/old"),
+                          QStringLiteral("refs/heads/packed"),
+                          QStringLiteral("refs/tags/v1")}));
+    QVERIFY(watched.contains(gitDir + QStringLiteral("/refs/heads/feature")));
+    QVERIFY(watched.contains(gitDir + QStringLiteral("/packed-refs")));
+
+    // worktrees use the refs of the main repository
+    writeFile(tmp.path() + QStringLiteral("/wt/.git"), "gitdir: ../main/.git/worktrees/wt\n");
+    writeFile(gitDir + QStringLiteral("/worktrees/wt/commondir"), "../..\n");
+    QDir().mkpath(tmp.path() + QStringLiteral("/wt/sub"));
+    QCOMPARE(GitUtils::commonGitDir(tmp.path() + QStringLiteral("/wt/sub")), QDir::cleanPath(gitDir));
+    QCOMPARE(GitUtils::commonGitDir(tmp.path() + QStringLiteral("/main")), QDir::cleanPath(gitDir));
+}
+
+void Test1::testGitChangeMarks()
+{
+    const QStringList base{QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("d")};
+    const QStringList text{QStringLiteral("a"), QStringLiteral("B"), QStringLiteral("new"), QStringLiteral("c")};
+
+    // b => B + new is modified, d is gone after the last line
+    const auto marks = GitChangeMarker::marksForHunks(LineDiff::diff(base, text), text.size());
+    const std::vector<std::pair<int, uint>> expected{{1, GitChangeMarker::ModifiedMark}, {2, GitChangeMarker::ModifiedMark}, {3, GitChangeMarker::DeletedMark}};
+    QCOMPARE(marks, expected);
+
+    const auto added = GitChangeMarker::marksForHunks({LineDiff::Hunk{1, 0, 1, 2}}, 5);
+    const std::vector<std::pair<int, uint>> expectedAdded{{1, GitChangeMarker::AddedMark}, {2, GitChangeMarker::AddedMark}};
+    QCOMPARE(added, expectedAdded);
+
+    QVERIFY(GitChangeMarker::marksForHunks({LineDiff::Hunk{0, 3, 0, 0}}, 0).empty());
+}
+
+static QByteArray runGit(const QString &workTree, const QStringList &args)
+{
+    QProcess git;
+    git.setWorkingDirectory(workTree);
+    git.start(QStringLiteral("git"), args);
+    if (!git.waitForFinished() || git.exitCode() != 0) {
+        return QByteArray("failed: ") + git.readAllStandardError();
+    }
+    return git.readAllStandardOutput();
+}
+
+void Test1::testGitBatch()
+{
+    QCOMPARE(GitBatch::pathSpecs({QStringLiteral("a"), QStringLiteral("dir/b")}), QByteArray(":(top,literal)a\0:(top,literal)dir/b\0", 30));
+
+    // 15 chars for ":(top,literal)" + separator per path, too long ones get a chunk of their own
+    const QString longPath(40, QLatin1Char('x'));
+    const auto chunks = GitBatch::pathSpecChunks({QStringLiteral("a"), QStringLiteral("bb"), QStringLiteral("c"), longPath}, 33);
+    QCOMPARE(chunks,
+             (QVector<QStringList>{{QStringLiteral("a"), QStringLiteral("bb")}, {QStringLiteral("c")}, {longPath}}));
+
+    if (QStandardPaths::findExecutable(QStringLiteral("git")).isEmpty()) {
+        QSKIP("git not found");
+    }
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString workTree = tmp.path() + QStringLiteral("/");
+    QCOMPARE(runGit(workTree, {QStringLiteral("init"), QStringLiteral("-q")}), QByteArray());
+    writeFile(workTree + QStringLiteral("base"), "base\n");
+    QCOMPARE(runGit(workTree, {QStringLiteral("add"), QStringLiteral("base")}), QByteArray());
+    QCOMPARE(runGit(workTree,
+                    {QStringLiteral("-c"),
+                     QStringLiteral("user.name=Test"),
+                     QStringLiteral("-c"),
+                     QStringLiteral("user.email=test@example.org"),
+                     QStringLiteral("commit"),
+                     QStringLiteral("-q"),
+                     QStringLiteral("-m"),
+                     QStringLiteral("base")}),
+             QByteArray());
+    writeFile(workTree + QStringLiteral("a"), "a\n");
+    writeFile(workTree + QStringLiteral("b"), "b\n");
+    writeFile(workTree + QStringLiteral("c"), "c\n");
+
+    // all requested in a row => one batch, the missing file doesn't stop the others
+    GitBatch batch(workTree, nullptr);
+    QSignalSpy finished(&batch, &GitBatch::finished);
+    QSignalSpy failed(&batch, &GitBatch::failed);
+    batch.add(GitBatch::Stage, {QStringLiteral("a")});
+    batch.add(GitBatch::Stage, {workTree + QStringLiteral("b"), QStringLiteral("missing"), QStringLiteral("a")});
+    QVERIFY(finished.wait());
+
+    QCOMPARE(finished.count(), 1);
+    QCOMPARE(finished.at(0).at(0).toStringList(),
+             (QStringList{workTree + QStringLiteral("a"), workTree + QStringLiteral("b"), workTree + QStringLiteral("missing")}));
+    QCOMPARE(failed.count(), 1);
+    QCOMPARE(failed.at(0).at(0).value<GitBatch::Operation>(), GitBatch::Stage);
+    QCOMPARE(runGit(workTree, {QStringLiteral("diff"), QStringLiteral("--cached"), QStringLiteral("--name-only")}), QByteArray("a\nb\n"));
+
+    // different kinds keep their order
+    batch.add(GitBatch::Unstage, {QStringLiteral("a")});
+    batch.add(GitBatch::Stage, {QStringLiteral("c")});
+    QVERIFY(finished.wait());
+    QCOMPARE(finished.count(), 2);
+    QCOMPARE(runGit(workTree, {QStringLiteral("diff"), QStringLiteral("--cached"), QStringLiteral("--name-only")}), QByteArray("b\nc\n"));
+
+    // a locked index fails every path the same way, that is one error, not one per path
+    writeFile(workTree + QStringLiteral("d"), "d\n");
+    writeFile(workTree + QStringLiteral("e"), "e\n");
+    writeFile(workTree + QStringLiteral(".git/index.lock"), QByteArray());
+    batch.add(GitBatch::Stage, {QStringLiteral("d"), QStringLiteral("e")});
+    QVERIFY(finished.wait());
+    QCOMPARE(failed.count(), 2);
+    QVERIFY(QFile::remove(workTree + QStringLiteral(".git/index.lock")));
+    QCOMPARE(runGit(workTree, {QStringLiteral("diff"), QStringLiteral("--cached"), QStringLiteral("--name-only")}), QByteArray("b\nc\n"));
+}
+
+void Test1::testGitRefsCache()
+{
+    if (QStandardPaths::findExecutable(QStringLiteral("git")).isEmpty()) {
+        QSKIP("git not found");
+    }
+
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString workTree = tmp.path() + QStringLiteral("/");
+    QCOMPARE(runGit(workTree, {QStringLiteral("init"), QStringLiteral("-q")}), QByteArray());
+    QCOMPARE(runGit(workTree,
+                    {QStringLiteral("-c"),
+                     QStringLiteral("user.name=Test"),
+                     QStringLiteral("-c"),
+                     QStringLiteral("user.email=test@example.org"),
+                     QStringLiteral("commit"),
+                     QStringLiteral("-q"),
+                     QStringLiteral("--allow-empty"),
+                     QStringLiteral("-m"),
+                     QStringLiteral("base")}),
+             QByteArray());
+    QCOMPARE(runGit(workTree, {QStringLiteral("branch"), QStringLiteral("-m"), QStringLiteral("c")}), QByteArray());
+    QCOMPARE(runGit(workTree, {QStringLiteral("branch"), QStringLiteral("a")}), QByteArray());
+    QCOMPARE(runGit(workTree, {QStringLiteral("branch"), QStringLiteral("b")}), QByteArray());
+
+    // the files say c, a, b; git sorts the same commit date by name
+    const QDateTime now = QDateTime::currentDateTime();
+    const std::pair<const char *, int> ages[] = {{"c", 0}, {"a", 60}, {"b", 120}};
+    for (const auto &[branch, age] : ages) {
+        QFile file(workTree + QStringLiteral(".git/refs/heads/") + QLatin1String(branch));
+        QVERIFY(file.open(QFile::ReadWrite));
+        QVERIFY(file.setFileTime(now.addSecs(-age), QFileDevice::FileModificationTime));
+    }
+
+    // no waiting for git, the file order comes at once, the one of git once it is done
+    const QStringList byFiles{QStringLiteral("refs/heads/c"), QStringLiteral("refs/heads/a"), QStringLiteral("refs/heads/b")};
+    const QStringList byGit{QStringLiteral("refs/heads/a"), QStringLiteral("refs/heads/b"), QStringLiteral("refs/heads/c")};
+    QCOMPARE(GitUtils::cachedRefNames(workTree), std::optional<QStringList>(byFiles));
+    QTRY_COMPARE(GitUtils::cachedRefNames(workTree), std::optional<QStringList>(byGit));
+}
+
+void Test1::testFileHistoryModel()
+{
+    std::vector<std::pair<int, int>> requests;
+    CommitListModel model([&requests](int skip, int count) {
+        requests.emplace_back(skip, count);
+    });
+    auto commit = [](int i) {
+        return QStringLiteral("hash%1\nAuthor\nauthor@kde.org\n100\n200\nsubject %1").arg(i).toUtf8();
+    };
+
+    // nothing is read before the view asks for it
+    QVERIFY(model.canFetchMore(QModelIndex()));
+    QCOMPARE(model.rowCount(QModelIndex()), 0);
+    model.fetchMore(QModelIndex());
+    QCOMPARE(requests.size(), size_t(1));
+    QCOMPARE(requests.back(), std::make_pair(0, CommitListModel::PageSize));
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    // a full page, git output arrives in pieces
+    QByteArray page;
+    for (int i = 0; i < CommitListModel::PageSize; ++i) {
+        page += commit(i) + '\0';
+    }
+    model.addData(page.left(50));
+    QCOMPARE(model.rowCount(QModelIndex()), 1);
+    model.addData(page.mid(50));
+    model.pageDone(true);
+    QCOMPARE(model.rowCount(QModelIndex()), CommitListModel::PageSize);
+    QCOMPARE(model.index(1).data(CommitListModel::CommitHash).toByteArray(), QByteArray("hash1"));
+    const auto first = model.index(0).data(CommitListModel::CommitRole).value<Commit>();
+    QCOMPARE(first.authorName, QStringLiteral("Author"));
+    QCOMPARE(first.commitDate, qint64(200));
+    QCOMPARE(first.msg, QStringLiteral("subject 0"));
+
+    // the next page starts after what we have, a short one is the last
+    QVERIFY(model.canFetchMore(QModelIndex()));
+    model.fetchMore(QModelIndex());
+    QCOMPARE(requests.back(), std::make_pair(CommitListModel::PageSize, CommitListModel::PageSize));
+    model.addData(commit(200) + '\0' + commit(201));
+    model.pageDone(true);
+    QCOMPARE(model.rowCount(QModelIndex()), CommitListModel::PageSize + 2);
+    QCOMPARE(model.index(CommitListModel::PageSize + 1).data(CommitListModel::CommitHash).toByteArray(), QByteArray("hash201"));
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(requests.size(), size_t(2));
+
+    // a failed run ends the history
+    CommitListModel failing([](int, int) {});
+    failing.fetchMore(QModelIndex());
+    failing.pageDone(false);
+    QVERIFY(!failing.canFetchMore(QModelIndex()));
+    QCOMPARE(failing.rowCount(QModelIndex()), 0);
+}
+
 // kate: space-indent on; indent-width 4; replace-tabs on;
@@ -21,6 +21,16 @@ public Q_SLOTS:
 private Q_SLOTS:
     void testCommonParent();
     void testShellCheckParsing();
+    void testCodeAnalysisShards();
+    void testCodeAnalysisCache();
+    void testGitStatusMerge();
+    void testGitStatusModelUpdate();
+    void testGitDiffParse();
+    void testGitRefs();
+    void testGitChangeMarks();
+    void testGitBatch();
+    void testGitRefsCache();
+    void testFileHistoryModel();
 };
 
 #endif
@@ -17,7 +17,7 @@
 #include <QTreeView>
 #include <QVBoxLayout>
 #include <QWidget>
-#include <QtConcurrentRun>
+#include <QtConcurrentMap>
 
 #include <KTextEditor/MainWindow>
 #include <KTextEditor/Message>
@@ -28,6 +28,8 @@
 #include <drawing_utils.h>
 #include <kfts_fuzzy_match.h>
 
+#include <algorithm>
+
 class BranchFilterModel : public QSortFilterProxyModel
 {
 public:
@@ -38,8 +40,34 @@ public:
 
     Q_SLOT void setFilterString(const QString &string)
     {
+        QHash<QString, Score> scores;
+        if (!string.isEmpty() && sourceModel()) {
+            // score all names up front, in parallel for the huge ref lists of some repositories
+            const int rows = sourceModel()->rowCount();
+            QVector<std::pair<QString, Score>> names;
+            names.reserve(rows);
+            for (int i = 0; i < rows; ++i) {
+                names.push_back({sourceModel()->index(i, 0).data().toString(), Score()});
+            }
+
+            auto match = [&string](std::pair<QString, Score> &name) {
+                name.second.matches = kfts::fuzzy_match(string, name.first, name.second.score);
+            };
+            if (names.size() >= ParallelMatchThreshold) {
+                QtConcurrent::blockingMap(names, match);
+            } else {
+                std::for_each(names.begin(), names.end(), match);
+            }
+
+            scores.reserve(names.size());
+            for (const auto &name : qAsConst(names)) {
+                scores.insert(name.first, name.second);
+            }
+        }
+
         beginResetModel();
         m_pattern = string;
+        m_scores = std::move(scores);
         endResetModel();
     }
 
@@ -51,8 +79,8 @@ protected:
             const int r = sourceRight.data(BranchesDialogModel::OriginalSorting).toInt();
             return l > r;
         }
-        const int l = sourceLeft.data(BranchesDialogModel::FuzzyScore).toInt();
-        const int r = sourceRight.data(BranchesDialogModel::FuzzyScore).toInt();
+        const int l = score(sourceLeft.data().toString()).score;
+        const int r = score(sourceRight.data().toString()).score;
         return l < r;
     }
 
@@ -62,16 +90,34 @@ protected:
             return true;
         }
 
-        int score = 0;
         const auto idx = sourceModel()->index(sourceRow, 0, sourceParent);
-        const QString string = idx.data().toString();
-        const bool res = kfts::fuzzy_match(m_pattern, string, score);
-        sourceModel()->setData(idx, score, BranchesDialogModel::FuzzyScore);
-        return res;
+        return score(idx.data().toString()).matches;
     }
 
 private:
+    struct Score {
+        int score = 0;
+        bool matches = false;
+    };
+
+    Score score(const QString &name) const
+    {
+        const auto it = m_scores.constFind(name);
+        if (it != m_scores.cend()) {
+            return it.value();
+        }
+
+        // added after the pattern changed
+        Score s;
+        s.matches = kfts::fuzzy_match(m_pattern, name, s.score);
+        return s;
+    }
+
+    // below that the threads cost more than they bring
+    static constexpr int ParallelMatchThreshold = 2000;
+
     QString m_pattern;
+    QHash<QString, Score> m_scores;
 };
 
 class StyleDelegate : public QStyledItemDelegate
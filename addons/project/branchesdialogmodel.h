@@ -17,7 +17,7 @@ class BranchesDialogModel : public QAbstractTableModel
 {
     Q_OBJECT
 public:
-    enum Role { FuzzyScore = Qt::UserRole + 1, OriginalSorting, CheckoutName, RefType, Creator, ItemTypeRole };
+    enum Role { OriginalSorting = Qt::UserRole + 1, CheckoutName, RefType, Creator, ItemTypeRole };
     enum ItemType { BranchItem, CreateBranch, CreateBranchFrom };
 
     explicit BranchesDialogModel(QObject *parent = nullptr);
@@ -28,24 +28,11 @@ public:
     void clear();
     void clearBranchCreationItems();
 
-    bool setData(const QModelIndex &index, const QVariant &value, int role) override
-    {
-        if (!index.isValid()) {
-            return false;
-        }
-        if (role == Role::FuzzyScore) {
-            auto row = index.row();
-            m_modelEntries[row].score = value.toInt();
-        }
-        return QAbstractTableModel::setData(index, value, role);
-    }
-
 private:
     struct Branch {
         QString name;
         QString remote;
         GitUtils::RefType refType;
-        int score;
         int dateSort;
         ItemType itemType;
     };
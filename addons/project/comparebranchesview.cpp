@@ -8,11 +8,8 @@
 #include "kateprojectpluginview.h"
 #include "kateprojectworker.h"
 
-#include <gitprocess.h>
-
 #include <QDir>
 #include <QPainter>
-#include <QProcess>
 #include <QStyledItemDelegate>
 #include <QVBoxLayout>
 
@@ -129,6 +126,7 @@ CompareBranchesView::CompareBranchesView(QWidget *parent, const QString &gitPath
     , m_gitDir(gitPath)
     , m_fromBr(fromB)
     , m_toBr(toBr)
+    , m_diffProvider(gitPath, {QStringLiteral("diff"), QStringLiteral("%1...%2").arg(fromB, toBr)})
 {
     setLayout(new QVBoxLayout);
 
@@ -152,21 +150,18 @@ CompareBranchesView::CompareBranchesView(QWidget *parent, const QString &gitPath
     m_tree.expandAll();
 
     connect(&m_tree, &QTreeView::clicked, this, &CompareBranchesView::showDiff);
+    connect(&m_diffProvider, &GitDiffProvider::diffReady, this, [this](const QString &, const QByteArray &patch) {
+        m_pluginView->showDiffInFixedView(patch);
+    });
 }
 
 void CompareBranchesView::showDiff(const QModelIndex &idx)
 {
-    auto file = idx.data(Qt::UserRole).toString().remove(m_gitDir + QLatin1Char('/'));
-    QProcess git;
-    if (!setupGitProcess(git, m_gitDir, {QStringLiteral("diff"), QStringLiteral("%1...%2").arg(m_fromBr).arg(m_toBr), QStringLiteral("--"), file})) {
+    if (idx.data(KateProjectItem::TypeRole).toInt() == KateProjectItem::Directory) {
+        m_diffProvider.cancel();
         return;
     }
-    git.start(QProcess::ReadOnly);
 
-    if (git.waitForStarted() && git.waitForFinished(-1)) {
-        if (git.exitStatus() != QProcess::NormalExit || git.exitCode() != 0) {
-            return;
-        }
-    }
-    m_pluginView->showDiffInFixedView(git.readAllStandardOutput());
+    // the whole range is fetched once, the next clicks are served from that
+    m_diffProvider.requestFile(QDir(m_gitDir).relativeFilePath(idx.data(Qt::UserRole).toString()));
 }
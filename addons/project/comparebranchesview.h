@@ -13,6 +13,8 @@
 
 #include "git/gitstatus.h"
 
+#include <gitdiffprovider.h>
+
 class KateProjectPluginView;
 class CompareBranchesView : public QWidget
 {
@@ -36,6 +38,7 @@ private:
     QString m_gitDir;
     QString m_fromBr;
     QString m_toBr;
+    GitDiffProvider m_diffProvider;
     KateProjectPluginView *m_pluginView;
 };
 
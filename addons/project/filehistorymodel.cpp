@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2021 Waqar Ahmed <waqar.17a@gmail.com>
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "filehistorymodel.h"
+
+#include <iterator>
+#include <optional>
+
+static std::optional<qint64> toLong(const QByteArray &input)
+{
+    bool ok = false;
+    qint64 ret = input.toLongLong(&ok);
+    if (ok) {
+        return ret;
+    }
+    return std::nullopt;
+}
+
+CommitListModel::CommitListModel(const FetchPage &fetchPage, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_fetchPage(fetchPage)
+{
+}
+
+int CommitListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_commits.size());
+}
+
+QVariant CommitListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return {};
+    }
+    auto row = index.row();
+    switch (role) {
+    case Role::CommitRole:
+        return QVariant::fromValue(m_commits.at(row));
+    case Role::CommitHash:
+        return m_commits.at(row).hash;
+    case Qt::ToolTipRole: {
+        QString ret = m_commits.at(row).authorName + QStringLiteral("<br>") + m_commits.at(row).email;
+        return ret;
+    }
+    }
+
+    return {};
+}
+
+bool CommitListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !m_fetching && !m_complete;
+}
+
+void CommitListModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+    m_fetching = true;
+    m_pageEntries = 0;
+    m_fetchPage(int(m_commits.size()), PageSize);
+}
+
+void CommitListModel::addData(const QByteArray &data)
+{
+    m_pending += data;
+
+    std::vector<Commit> commits;
+    int start = 0;
+    int end = m_pending.indexOf('\0', start);
+    while (end != -1) {
+        ++m_pageEntries;
+        parseCommit(m_pending.constData() + start, end - start, commits);
+        start = end + 1;
+        end = m_pending.indexOf('\0', start);
+    }
+    m_pending.remove(0, start);
+
+    if (commits.empty()) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), int(m_commits.size()), int(m_commits.size() + commits.size()) - 1);
+    m_commits.insert(m_commits.end(), std::make_move_iterator(commits.begin()), std::make_move_iterator(commits.end()));
+    endInsertRows();
+}
+
+void CommitListModel::pageDone(bool ok)
+{
+    // the last commit has no terminator
+    if (!m_pending.isEmpty()) {
+        addData(QByteArray(1, '\0'));
+    }
+    m_fetching = false;
+    m_complete = !ok || m_pageEntries < PageSize;
+}
+
+void CommitListModel::parseCommit(const char *data, int size, std::vector<Commit> &commits)
+{
+    // hash, author, email, author date, commit date, subject, one per line
+    const auto lines = QByteArray::fromRawData(data, size).split('\n');
+    if (lines.size() < 6) {
+        return;
+    }
+
+    const auto authorDate = toLong(lines.at(3));
+    const auto commitDate = toLong(lines.at(4));
+    if (!authorDate.has_value() || !commitDate.has_value()) {
+        return;
+    }
+
+    // mostly the same few people, share the strings
+    auto intern = [this](const QByteArray &utf8) {
+        auto it = m_strings.constFind(utf8);
+        if (it == m_strings.constEnd()) {
+            it = m_strings.insert(utf8, QString::fromUtf8(utf8));
+        }
+        return it.value();
+    };
+
+    commits.push_back(Commit{lines.at(0), intern(lines.at(1)), intern(lines.at(2)), authorDate.value(), commitDate.value(), QString::fromUtf8(lines.at(5))});
+}
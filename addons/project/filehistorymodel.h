@@ -0,0 +1,73 @@
+/*
+    SPDX-FileCopyrightText: 2021 Waqar Ahmed <waqar.17a@gmail.com>
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#ifndef FILEHISTORYMODEL_H
+#define FILEHISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+
+#include <functional>
+#include <vector>
+
+struct Commit {
+    QByteArray hash;
+    QString authorName;
+    QString email;
+    qint64 authorDate;
+    qint64 commitDate;
+    QString msg;
+};
+Q_DECLARE_METATYPE(Commit)
+
+/**
+ * Commits of a file history, git log is asked for one page at a time when the view scrolls to the end.
+ * The output is expected as of git log --format=%H%n%aN%n%aE%n%at%n%ct%n%s -z
+ */
+class CommitListModel : public QAbstractListModel
+{
+public:
+    // commits per git log run
+    static constexpr int PageSize = 200;
+
+    /**
+     * Starts git log for count commits after the first skip, the output goes to addData + pageDone.
+     */
+    using FetchPage = std::function<void(int skip, int count)>;
+
+    explicit CommitListModel(const FetchPage &fetchPage, QObject *parent = nullptr);
+
+    enum Role { CommitRole = Qt::UserRole + 1, CommitHash };
+
+    int rowCount(const QModelIndex &parent) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * Add the complete commits in data, git log output as it arrives.
+     */
+    void addData(const QByteArray &data);
+
+    /**
+     * The git log run is done, a short or failed page is the last one.
+     */
+    void pageDone(bool ok);
+
+private:
+    void parseCommit(const char *data, int size, std::vector<Commit> &commits);
+
+    const FetchPage m_fetchPage;
+    std::vector<Commit> m_commits;
+    // commits git gave us for the running page, a short page is the last one
+    int m_pageEntries = 0;
+    bool m_fetching = false;
+    bool m_complete = false;
+    QByteArray m_pending;
+    QHash<QByteArray, QString> m_strings;
+};
+
+#endif // FILEHISTORYMODEL_H
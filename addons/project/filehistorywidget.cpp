@@ -5,6 +5,7 @@
 */
 
 #include "filehistorywidget.h"
+#include "filehistorymodel.h"
 
 #include <gitprocess.h>
 
@@ -13,123 +14,10 @@
 #include <QPainter>
 #include <QStyledItemDelegate>
 #include <QVBoxLayout>
-#include <optional>
 
-#include <KLocalizedString>
-
-struct Commit {
-    QByteArray hash;
-    QString authorName;
-    QString email;
-    qint64 authorDate;
-    qint64 commitDate;
-    QByteArray parentHash;
-    QString msg;
-};
-Q_DECLARE_METATYPE(Commit)
-
-static std::optional<qint64> toLong(const QByteArray &input)
-{
-    bool ok = false;
-    qint64 ret = input.toLongLong(&ok);
-    if (ok) {
-        return ret;
-    }
-    return std::nullopt;
-}
-
-static QVector<Commit> parseCommits(const QList<QByteArray> &raw)
-{
-    QVector<Commit> commits;
-    commits.reserve(raw.size());
-
-    for (const auto &r : raw) {
-        const auto lines = r.split('\n');
-        if (lines.length() < 7) {
-            continue;
-        }
-        QByteArray hash = lines.at(0);
-        QString author = QString::fromUtf8(lines.at(1));
-        QString email = QString::fromUtf8(lines.at(2));
-
-        auto authDate = toLong(lines.at(3));
-        if (!authDate.has_value()) {
-            continue;
-        }
-        qint64 authorDate = authDate.value();
-
-        auto commtDate = toLong(lines.at(4));
-        if (!commtDate.has_value()) {
-            continue;
-        }
-        qint64 commitDate = commtDate.value();
-
-        QByteArray parent = lines.at(5);
-        QString msg = QString::fromUtf8(lines.at(6));
-        commits << Commit{hash, author, email, authorDate, commitDate, parent, msg};
-    }
-
-    return commits;
-}
-
-class CommitListModel : public QAbstractListModel
-{
-public:
-    CommitListModel(QObject *parent = nullptr)
-        : QAbstractListModel(parent)
-    {
-    }
-
-    enum Role { CommitRole = Qt::UserRole + 1, CommitHash };
-
-    int rowCount(const QModelIndex &) const override
-    {
-        return m_rows.count();
-    }
-    QVariant data(const QModelIndex &index, int role) const override
-    {
-        if (!index.isValid()) {
-            return {};
-        }
-        auto row = index.row();
-        switch (role) {
-        case Role::CommitRole:
-            return QVariant::fromValue(m_rows.at(row));
-        case Role::CommitHash:
-            return m_rows.at(row).hash;
-        case Qt::ToolTipRole: {
-            QString ret = m_rows.at(row).authorName + QStringLiteral("<br>") + m_rows.at(row).email;
-            return ret;
-        }
-        }
+#include <algorithm>
 
-        return {};
-    }
-
-    void refresh(const QVector<Commit> &cmts)
-    {
-        beginResetModel();
-        m_rows = cmts;
-        endResetModel();
-    }
-
-    void addCommit(Commit cmt)
-    {
-        beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size());
-        m_rows.push_back(cmt);
-        endInsertRows();
-    }
-
-    void addCommits(const QVector<Commit> &cmts)
-    {
-        for (const auto &commit : cmts) {
-            addCommit(commit);
-        }
-    }
-
-private:
-    QVector<Commit> m_rows;
-};
+#include <KLocalizedString>
 
 class CommitDelegate : public QStyledItemDelegate
 {
@@ -204,10 +92,28 @@ FileHistoryWidget::FileHistoryWidget(const QString &file, QWidget *parent)
     : QWidget(parent)
     , m_file(file)
 {
-    auto model = new CommitListModel(this);
+    auto model = new CommitListModel(
+        [this](int skip, int count) {
+            getFileHistory(skip, count);
+        },
+        this);
     m_listView = new QListView;
     m_listView->setModel(model);
-    getFileHistory(file);
+
+    connect(&m_git, &QProcess::readyReadStandardOutput, this, [this, model] {
+        model->addData(m_git.readAllStandardOutput());
+    });
+    connect(&m_git, &QProcess::finished, this, [this, model](int exitCode, QProcess::ExitStatus s) {
+        const bool ok = exitCode == 0 && s == QProcess::NormalExit;
+        model->addData(m_git.readAllStandardOutput());
+        model->pageDone(ok);
+        if (!ok) {
+            Q_EMIT errorMessage(i18n("Failed to get file history: %1", QString::fromUtf8(m_git.readAllStandardError())), true);
+        }
+    });
+
+    // the first page, the view asks for more when scrolled to the end
+    model->fetchMore(QModelIndex());
 
     setLayout(new QVBoxLayout);
 
@@ -226,53 +132,72 @@ FileHistoryWidget::~FileHistoryWidget()
 {
     m_git.kill();
     m_git.waitForFinished();
+
+    if (m_showProcess) {
+        m_showProcess->kill();
+        m_showProcess->waitForFinished();
+    }
 }
 
-// git log --format=%H%n%aN%n%aE%n%at%n%ct%n%P%n%B --author-date-order
-void FileHistoryWidget::getFileHistory(const QString &file)
+// git log --format=%H%n%aN%n%aE%n%at%n%ct%n%s, the body comes with the diff if needed
+void FileHistoryWidget::getFileHistory(int skip, int count)
 {
     if (!setupGitProcess(m_git,
-                         QFileInfo(file).absolutePath(),
-                         {QStringLiteral("log"), QStringLiteral("--format=%H%n%aN%n%aE%n%at%n%ct%n%P%n%B"), QStringLiteral("-z"), file})) {
+                         QFileInfo(m_file).absolutePath(),
+                         {QStringLiteral("log"),
+                          QStringLiteral("--format=%H%n%aN%n%aE%n%at%n%ct%n%s"),
+                          QStringLiteral("-z"),
+                          QStringLiteral("--skip=%1").arg(skip),
+                          QStringLiteral("--max-count=%1").arg(count),
+                          QStringLiteral("--"),
+                          m_file})) {
+        static_cast<CommitListModel *>(m_listView->model())->pageDone(false);
         Q_EMIT errorMessage(i18n("Failed to get file history: git executable not found in PATH"), true);
         return;
     }
 
-    connect(&m_git, &QProcess::readyReadStandardOutput, this, [this] {
-        auto commits = parseCommits(m_git.readAllStandardOutput().split(0x00));
-        if (!commits.isEmpty()) {
-            static_cast<CommitListModel *>(m_listView->model())->addCommits(commits);
-        }
-    });
-
-    connect(&m_git, &QProcess::finished, this, [this](int exitCode, QProcess::ExitStatus s) {
-        if (exitCode != 0 || s != QProcess::NormalExit) {
-            Q_EMIT errorMessage(i18n("Failed to get file history: %1", QString::fromUtf8(m_git.readAllStandardError())), true);
-        }
-    });
-
     m_git.start(QProcess::ReadOnly);
 }
 
 void FileHistoryWidget::itemClicked(const QModelIndex &idx)
 {
-    QProcess git;
-    QFileInfo fi(m_file);
+    const QByteArray hash = idx.data(CommitListModel::CommitHash).toByteArray();
+    if (hash.isEmpty()) {
+        return;
+    }
 
-    const auto commit = idx.data(CommitListModel::CommitRole).value<Commit>();
+    // recently looked at
+    if (const QByteArray *contents = m_diffCache.object(hash)) {
+        Q_EMIT commitClicked(*contents);
+        return;
+    }
+
+    // only the last click matters
+    if (m_showProcess) {
+        disconnect(m_showProcess, nullptr, this, nullptr);
+        m_showProcess->kill();
+        m_showProcess->deleteLater();
+    }
 
-    if (!setupGitProcess(git, fi.absolutePath(), {QStringLiteral("show"), QString::fromUtf8(commit.hash), QStringLiteral("--"), m_file})) {
+    auto git = new QProcess(this);
+    if (!setupGitProcess(*git, QFileInfo(m_file).absolutePath(), {QStringLiteral("show"), QString::fromUtf8(hash), QStringLiteral("--"), m_file})) {
+        delete git;
         return;
     }
+    m_showProcess = git;
 
-    git.start(QProcess::ReadOnly);
-    if (git.waitForStarted() && git.waitForFinished(-1)) {
-        if (git.exitStatus() != QProcess::NormalExit || git.exitCode() != 0) {
+    connect(git, &QProcess::finished, this, [this, git, hash](int exitCode, QProcess::ExitStatus es) {
+        git->deleteLater();
+        if (es != QProcess::NormalExit || exitCode != 0) {
             return;
         }
-        QByteArray contents(git.readAllStandardOutput());
+
+        const QByteArray contents = git->readAllStandardOutput();
+        m_diffCache.insert(hash, new QByteArray(contents), std::max(1, contents.size() / 1024));
+
         // we send this signal to the parent, which will pass it on to
         // the GitWidget from where a temporary file is opened
         Q_EMIT commitClicked(contents);
-    }
+    });
+    git->start(QProcess::ReadOnly);
 }
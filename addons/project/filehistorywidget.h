@@ -6,7 +6,9 @@
 #ifndef FILEHISTORYWIDGET_H
 #define FILEHISTORYWIDGET_H
 
+#include <QCache>
 #include <QListView>
+#include <QPointer>
 #include <QProcess>
 #include <QPushButton>
 #include <QWidget>
@@ -22,12 +24,18 @@ private Q_SLOTS:
     void itemClicked(const QModelIndex &idx);
 
 private:
-    void getFileHistory(const QString &file);
+    /**
+     * One page of the history, the model asks for them.
+     */
+    void getFileHistory(int skip, int count);
 
     QPushButton m_backBtn;
     QListView *m_listView;
     QString m_file;
     QProcess m_git;
+    QPointer<QProcess> m_showProcess;
+    // git show output of the last viewed commits, cost in KiB
+    QCache<QByteArray, QByteArray> m_diffCache{16 * 1024};
 
 Q_SIGNALS:
     void backClicked();
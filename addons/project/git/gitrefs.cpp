@@ -0,0 +1,276 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#include "gitrefs.h"
+
+#include <gitprocess.h>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QPointer>
+#include <QProcess>
+#include <QSet>
+
+#include <algorithm>
+#include <vector>
+
+// with more ref directories than that we rather read the refs each time
+static constexpr int MaxWatchedPaths = 1024;
+
+QString GitUtils::commonGitDir(const QString &path)
+{
+    QDir dir(path);
+    QString gitDir;
+    while (gitDir.isEmpty()) {
+        const QFileInfo dotGit(dir.filePath(QStringLiteral(".git")));
+        if (dotGit.isDir()) {
+            gitDir = dotGit.absoluteFilePath();
+        } else if (dotGit.isFile()) {
+            // worktree or submodule: "gitdir: <path>"
+            QFile file(dotGit.absoluteFilePath());
+            if (!file.open(QFile::ReadOnly)) {
+                return {};
+            }
+            const QByteArray content = file.readAll().trimmed();
+            if (!content.startsWith("gitdir: ")) {
+                return {};
+            }
+            gitDir = dir.absoluteFilePath(QString::fromUtf8(content.mid(8)));
+        } else if (!dir.cdUp()) {
+            return {};
+        }
+    }
+
+    // worktrees share the refs with the main repository
+    QFile commonDir(gitDir + QStringLiteral("/commondir"));
+    if (commonDir.open(QFile::ReadOnly)) {
+        gitDir = QDir(gitDir).absoluteFilePath(QString::fromUtf8(commonDir.readAll().trimmed()));
+    }
+
+    if (QFileInfo(gitDir + QStringLiteral("/reftable")).isDir()) {
+        return {};
+    }
+    return QDir::cleanPath(gitDir);
+}
+
+QStringList GitUtils::readRefNames(const QString &commonGitDir, QStringList *watchPaths)
+{
+    const QDir dir(commonGitDir);
+
+    struct LooseRef {
+        QString name;
+        QDateTime modified;
+    };
+    std::vector<LooseRef> looseRefs;
+
+    if (watchPaths) {
+        watchPaths->append(dir.filePath(QStringLiteral("refs")));
+    }
+    for (const auto &sub : {QStringLiteral("refs/heads"), QStringLiteral("refs/remotes"), QStringLiteral("refs/tags")}) {
+        const QString subDir = dir.filePath(sub);
+        if (watchPaths && QFileInfo(subDir).isDir()) {
+            watchPaths->append(subDir);
+        }
+
+        QDirIterator it(subDir, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo info = it.fileInfo();
+            if (info.isDir()) {
+                if (watchPaths) {
+                    watchPaths->append(it.filePath());
+                }
+                continue;
+            }
+            if (it.fileName().endsWith(QLatin1String(".lock"))) {
+                continue;
+            }
+            looseRefs.push_back({dir.relativeFilePath(it.filePath()), info.lastModified()});
+        }
+    }
+
+    // the file of a branch is written with each commit, close enough to --sort=-committerdate
+    std::stable_sort(looseRefs.begin(), looseRefs.end(), [](const LooseRef &l, const LooseRef &r) {
+        return l.modified > r.modified;
+    });
+
+    QStringList refs;
+    QSet<QString> loose;
+    refs.reserve(int(looseRefs.size()));
+    loose.reserve(int(looseRefs.size()));
+    for (const auto &ref : looseRefs) {
+        refs.append(ref.name);
+        loose.insert(ref.name);
+    }
+
+    QFile packedRefs(dir.filePath(QStringLiteral("packed-refs")));
+    if (!packedRefs.open(QFile::ReadOnly)) {
+        // packed-refs will be created in there
+        if (watchPaths) {
+            watchPaths->append(dir.path());
+        }
+        return refs;
+    }
+    if (watchPaths) {
+        watchPaths->append(packedRefs.fileName());
+    }
+
+    /**
+     * # pack-refs with: peeled fully-peeled sorted
+     * <hash> refs/heads/master
+     * ^<hash of the peeled tag>
+     */
+    const QByteArray content = packedRefs.readAll();
+    int pos = 0;
+    while (pos < content.size()) {
+        int end = content.indexOf('\n', pos);
+        if (end == -1) {
+            end = content.size();
+        }
+        const int space = content.indexOf(' ', pos);
+        if (content.at(pos) != '#' && content.at(pos) != '^' && space != -1 && space < end) {
+            const QString name = QString::fromUtf8(content.constData() + space + 1, end - space - 1).trimmed();
+            const bool wanted = name.startsWith(QLatin1String("refs/heads/")) || name.startsWith(QLatin1String("refs/remotes/"))
+                || name.startsWith(QLatin1String("refs/tags/"));
+            if (wanted && !loose.contains(name)) {
+                refs.append(name);
+            }
+        }
+        pos = end + 1;
+    }
+
+    return refs;
+}
+
+namespace
+{
+struct RefCache {
+    struct Entry {
+        QStringList refs;
+        QStringList watched;
+        // tells a late git for-each-ref for an older entry apart
+        quint64 id = 0;
+    };
+
+    // path asked for => its common git dir
+    QHash<QString, QString> commonDirs;
+    // common git dir => refs
+    QHash<QString, Entry> entries;
+    // watched path => common git dir
+    QHash<QString, QString> watchedBy;
+    QPointer<QFileSystemWatcher> watcher;
+    quint64 lastId = 0;
+
+    void invalidate(const QString &path)
+    {
+        const auto it = entries.find(watchedBy.value(path));
+        if (it == entries.end()) {
+            return;
+        }
+        for (const auto &watched : qAsConst(it->watched)) {
+            watchedBy.remove(watched);
+        }
+        if (watcher) {
+            watcher->removePaths(it->watched);
+        }
+        entries.erase(it);
+    }
+};
+}
+
+static RefCache &refCache()
+{
+    static RefCache cache;
+    if (!cache.watcher) {
+        cache.watcher = new QFileSystemWatcher(QCoreApplication::instance());
+        QObject::connect(cache.watcher, &QFileSystemWatcher::directoryChanged, [](const QString &path) {
+            refCache().invalidate(path);
+        });
+        QObject::connect(cache.watcher, &QFileSystemWatcher::fileChanged, [](const QString &path) {
+            refCache().invalidate(path);
+        });
+    }
+    return cache;
+}
+
+/**
+ * Sort the refs of the cache entry by date once git is done, tags by their own date first.
+ */
+static void sortRefNames(const QString &path, const QString &commonDir, quint64 id)
+{
+    auto git = new QProcess(refCache().watcher);
+    const QStringList args{QStringLiteral("for-each-ref"),
+                           QStringLiteral("--format=%(refname)"),
+                           QStringLiteral("--sort=-committerdate"),
+                           QStringLiteral("--sort=-taggerdate"),
+                           QStringLiteral("refs/heads"),
+                           QStringLiteral("refs/remotes"),
+                           QStringLiteral("refs/tags")};
+    if (!setupGitProcess(*git, path, args)) {
+        delete git;
+        return;
+    }
+
+    QObject::connect(git, &QProcess::finished, git, [git, commonDir, id](int exitCode, QProcess::ExitStatus es) {
+        git->deleteLater();
+        const auto it = refCache().entries.find(commonDir);
+        if (es != QProcess::NormalExit || exitCode != 0 || it == refCache().entries.end() || it->id != id) {
+            return;
+        }
+        it->refs = QString::fromUtf8(git->readAllStandardOutput()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    });
+    QObject::connect(git, &QProcess::errorOccurred, git, [git](QProcess::ProcessError pe) {
+        // no finished signal then
+        if (pe == QProcess::FailedToStart) {
+            git->deleteLater();
+        }
+    });
+    git->start(QProcess::ReadOnly);
+}
+
+std::optional<QStringList> GitUtils::cachedRefNames(const QString &path)
+{
+    RefCache &cache = refCache();
+
+    QString commonDir = cache.commonDirs.value(path);
+    if (commonDir.isEmpty()) {
+        commonDir = commonGitDir(path);
+        if (commonDir.isEmpty()) {
+            return std::nullopt;
+        }
+        cache.commonDirs.insert(path, commonDir);
+    }
+
+    const auto it = cache.entries.constFind(commonDir);
+    if (it != cache.entries.cend()) {
+        return it->refs;
+    }
+
+    // the ref files tell what to watch and give a first order, git the exact one later
+    QStringList watched;
+    const QStringList refs = readRefNames(commonDir, &watched);
+    if (watched.size() > MaxWatchedPaths) {
+        return refs;
+    }
+
+    // only cache what we are sure to notice changes of
+    if (!cache.watcher->addPaths(watched).isEmpty()) {
+        cache.watcher->removePaths(watched);
+        return refs;
+    }
+    for (const auto &watchedPath : qAsConst(watched)) {
+        cache.watchedBy.insert(watchedPath, commonDir);
+    }
+    const quint64 id = ++cache.lastId;
+    cache.entries.insert(commonDir, {refs, watched, id});
+    sortRefNames(path, commonDir, id);
+    return refs;
+}
@@ -0,0 +1,41 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#ifndef GITREFS_H
+#define GITREFS_H
+
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+
+namespace GitUtils
+{
+/**
+ * @brief the git dir holding the refs of the repository containing @p path
+ * For worktrees that is the dir of the main repository.
+ * Empty if there is none or the refs are not stored as files, e.g. with the reftable backend.
+ */
+QString commonGitDir(const QString &path);
+
+/**
+ * @brief read all refs/heads, refs/remotes and refs/tags from packed-refs and the loose ref files
+ * Loose refs come first, most recently updated first, then the packed ones in their order,
+ * the files don't tell the commit dates.
+ * @param watchPaths if given, receives the files + directories to watch for changes
+ */
+QStringList readRefNames(const QString &commonGitDir, QStringList *watchPaths = nullptr);
+
+/**
+ * @brief refs of the repository containing @p path, cached until a ref changes
+ * First in the order of readRefNames, once git is done in the background sorted like
+ * "git for-each-ref --sort=-committerdate --sort=-taggerdate", git runs once per change.
+ * Only to be used from the GUI thread.
+ * @return std::nullopt if the refs can't be read without git
+ */
+std::optional<QStringList> cachedRefNames(const QString &path);
+}
+
+#endif // GITREFS_H
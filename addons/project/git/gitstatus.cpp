@@ -5,36 +5,16 @@
 */
 #include "gitstatus.h"
 
-#include <gitprocess.h>
-
 #include <KLocalizedString>
 #include <QByteArray>
-#include <QProcess>
+#include <QHash>
 #include <QScopeGuard>
 
+#include <algorithm>
 #include <charconv>
 #include <optional>
 
-static void numStatForStatus(QVector<GitUtils::StatusItem> &list, const QString &workDir, bool modified)
-{
-    const auto args = modified ? QStringList{QStringLiteral("diff"), QStringLiteral("--numstat"), QStringLiteral("-z")}
-                               : QStringList{QStringLiteral("diff"), QStringLiteral("--numstat"), QStringLiteral("--staged"), QStringLiteral("-z")};
-
-    QProcess git;
-    if (!setupGitProcess(git, workDir, args)) {
-        return;
-    }
-    git.start(QProcess::ReadOnly);
-    if (git.waitForStarted() && git.waitForFinished(-1)) {
-        if (git.exitStatus() != QProcess::NormalExit || git.exitCode() != 0) {
-            return;
-        }
-    }
-
-    GitUtils::parseDiffNumStat(list, git.readAllStandardOutput());
-}
-
-GitUtils::GitParsedStatus GitUtils::parseStatus(const QByteArray &raw, bool withNumStat, const QString &workingDir)
+GitUtils::GitParsedStatus GitUtils::parseStatus(const QByteArray &raw)
 {
     QVector<GitUtils::StatusItem> untracked;
     QVector<GitUtils::StatusItem> unmerge;
@@ -126,11 +106,6 @@ GitUtils::GitParsedStatus GitUtils::parseStatus(const QByteArray &raw, bool with
         }
     }
 
-    if (withNumStat) {
-        numStatForStatus(changed, workingDir, true);
-        numStatForStatus(staged, workingDir, false);
-    }
-
     return {untracked, unmerge, staged, changed};
 }
 
@@ -166,19 +141,6 @@ QString GitUtils::statusString(GitUtils::GitStatus s)
     return QString();
 }
 
-static void addNumStat(QVector<GitUtils::StatusItem> &items, int add, int sub, std::string_view file)
-{
-    // look in modified first, then staged
-    auto item = std::find_if(items.begin(), items.end(), [file](const GitUtils::StatusItem &si) {
-        return file.compare(0, si.file.size(), si.file.data()) == 0;
-    });
-    if (item != items.end()) {
-        item->linesAdded = add;
-        item->linesRemoved = sub;
-        return;
-    }
-}
-
 static std::optional<int> toInt(std::string_view s)
 {
     int value{};
@@ -191,6 +153,13 @@ static std::optional<int> toInt(std::string_view s)
 
 void GitUtils::parseDiffNumStat(QVector<GitUtils::StatusItem> &items, const QByteArray &raw)
 {
+    // one lookup per line, the lists can be huge
+    QHash<QByteArray, int> itemForFile;
+    itemForFile.reserve(items.size());
+    for (int i = 0; i < items.size(); ++i) {
+        itemForFile.insert(items.at(i).file, i);
+    }
+
     int start = 0;
     int next = raw.indexOf(char(0), start);
     const char *r = raw.constData();
@@ -229,14 +198,15 @@ void GitUtils::parseDiffNumStat(QVector<GitUtils::StatusItem> &items, const QByt
         auto add = toInt(addStr);
         auto sub = toInt(subStr);
 
-        if (!add.has_value()) {
-            continue;
-        }
-        if (!add.has_value()) {
+        if (!add.has_value() || !sub.has_value()) {
             continue;
         }
 
-        addNumStat(items, add.value(), sub.value(), fileStr);
+        const auto it = itemForFile.constFind(QByteArray::fromRawData(fileStr.data(), fileStr.size()));
+        if (it != itemForFile.constEnd()) {
+            items[it.value()].linesAdded = add.value();
+            items[it.value()].linesRemoved = sub.value();
+        }
     }
 }
 
@@ -259,3 +229,55 @@ QVector<GitUtils::StatusItem> GitUtils::parseDiffNameStatus(const QByteArray &ra
     }
     return out;
 }
+
+static bool lessByFile(const GitUtils::StatusItem &l, const GitUtils::StatusItem &r)
+{
+    return l.file < r.file;
+}
+
+void GitUtils::sortStatus(GitParsedStatus &status)
+{
+    for (auto *list : {&status.untracked, &status.unmerge, &status.staged, &status.changed}) {
+        std::sort(list->begin(), list->end(), lessByFile);
+    }
+}
+
+void GitUtils::mergeStatus(GitParsedStatus &status,
+                           GitParsedStatus update,
+                           const QSet<QByteArray> &files,
+                           const QSet<QByteArray> &dirs,
+                           const QSet<QByteArray> &trees)
+{
+    auto inScope = [&files, &dirs, &trees](const StatusItem &item) {
+        if (files.contains(item.file)) {
+            return true;
+        }
+        const int slash = item.file.lastIndexOf('/');
+        if (dirs.contains(slash == -1 ? QByteArray() : item.file.left(slash))) {
+            return true;
+        }
+        if (trees.isEmpty()) {
+            return false;
+        }
+        for (int i = item.file.indexOf('/'); i != -1; i = item.file.indexOf('/', i + 1)) {
+            if (trees.contains(item.file.left(i))) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto merge = [&inScope](QVector<StatusItem> &list, QVector<StatusItem> &&updated) {
+        list.erase(std::remove_if(list.begin(), list.end(), inScope), list.end());
+        std::sort(updated.begin(), updated.end(), lessByFile);
+        QVector<StatusItem> merged;
+        merged.reserve(list.size() + updated.size());
+        std::merge(list.cbegin(), list.cend(), updated.cbegin(), updated.cend(), std::back_inserter(merged), lessByFile);
+        list = std::move(merged);
+    };
+
+    merge(status.untracked, std::move(update.untracked));
+    merge(status.unmerge, std::move(update.unmerge));
+    merge(status.staged, std::move(update.staged));
+    merge(status.changed, std::move(update.changed));
+}
@@ -6,6 +6,7 @@
 #ifndef GITSTATUS_H
 #define GITSTATUS_H
 
+#include <QSet>
 #include <QString>
 #include <QVector>
 
@@ -64,10 +65,30 @@ struct GitParsedStatus {
     QVector<StatusItem> changed;
 };
 
-GitParsedStatus parseStatus(const QByteArray &raw, bool withNumStat, const QString &workingDir);
+GitParsedStatus parseStatus(const QByteArray &raw);
 
+/**
+ * Fill in linesAdded/linesRemoved of the items from "git diff --numstat -z" output
+ */
 void parseDiffNumStat(QVector<GitUtils::StatusItem> &items, const QByteArray &raw);
 
+/**
+ * Sort all lists by file name, mergeStatus relies on that
+ */
+void sortStatus(GitParsedStatus &status);
+
+/**
+ * Replace the entries of the given files, of the direct children of the given
+ * directories and of everything below the given trees (all relative, no trailing slash)
+ * by the ones in @p update.
+ * @p update is the status limited to exactly these paths.
+ */
+void mergeStatus(GitParsedStatus &status,
+                 GitParsedStatus update,
+                 const QSet<QByteArray> &files,
+                 const QSet<QByteArray> &dirs,
+                 const QSet<QByteArray> &trees = QSet<QByteArray>());
+
 QVector<StatusItem> parseDiffNameStatus(const QByteArray &raw);
 
 QString statusString(GitStatus s);
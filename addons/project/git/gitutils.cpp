@@ -5,6 +5,7 @@
 */
 
 #include "gitutils.h"
+#include "gitrefs.h"
 
 #include <gitprocess.h>
 
@@ -131,8 +132,33 @@ static GitUtils::Branch parseRemoteBranch(const QString &raw)
     return GitUtils::Branch{raw.mid(len), raw.mid(len, indexofRemote - len), GitUtils::Remote, QString()};
 }
 
+static QVector<GitUtils::Branch> branchesFromRefs(const QStringList &refs, GitUtils::RefType ref)
+{
+    using namespace GitUtils;
+    QVector<Branch> branches;
+    branches.reserve(refs.size());
+    // clang-format off
+    for (const auto &o : refs) {
+        if (ref & Head && o.startsWith(QLatin1String("refs/heads"))) {
+            branches.append(parseLocalBranch(o));
+        } else if (ref & Remote && o.startsWith(QLatin1String("refs/remotes"))) {
+            branches.append(parseRemoteBranch(o));
+        } else if (ref & Tag && o.startsWith(QLatin1String("refs/tags/"))) {
+            static const int len = QStringLiteral("refs/tags/").length();
+            branches.append({o.mid(len), {}, RefType::Tag, QString()});
+        }
+    }
+    // clang-format on
+    return branches;
+}
+
 QVector<GitUtils::Branch> GitUtils::getAllBranchesAndTags(const QString &repo, RefType ref)
 {
+    // for-each-ref sorting tens of thousands of refs by date takes a while, only do it once per change
+    if (const auto refs = cachedRefNames(repo)) {
+        return branchesFromRefs(*refs, ref);
+    }
+
     // git for-each-ref --format '%(refname)' --sort=-committerdate ...
     QProcess git;
 
@@ -153,27 +179,12 @@ QVector<GitUtils::Branch> GitUtils::getAllBranchesAndTags(const QString &repo, R
     }
 
     git.start(QProcess::ReadOnly);
-    QVector<Branch> branches;
     if (git.waitForStarted() && git.waitForFinished(-1)) {
-        QString gitout = QString::fromUtf8(git.readAllStandardOutput());
-        QStringList out = gitout.split(QLatin1Char('\n'));
-
-        branches.reserve(out.size());
-        // clang-format off
-        for (const auto &o : out) {
-            if (ref & Head && o.startsWith(QLatin1String("refs/heads"))) {
-                branches.append(parseLocalBranch(o));
-            } else if (ref & Remote && o.startsWith(QLatin1String("refs/remotes"))) {
-                branches.append(parseRemoteBranch(o));
-            } else if (ref & Tag && o.startsWith(QLatin1String("refs/tags/"))) {
-                static const int len = QStringLiteral("refs/tags/").length();
-                branches.append({o.mid(len), {}, RefType::Tag, QString()});
-            }
-        }
-        // clang-format on
+        const QString gitout = QString::fromUtf8(git.readAllStandardOutput());
+        return branchesFromRefs(gitout.split(QLatin1Char('\n')), ref);
     }
 
-    return branches;
+    return {};
 }
 
 QVector<GitUtils::Branch> GitUtils::getAllLocalBranchesWithLastCommitSubject(const QString &repo)
@@ -86,6 +86,7 @@ QVector<Branch> getAllBranches(const QString &repo);
 
 /**
  * @brief get all local and remote branches + tags
+ * Read from the ref files if possible, cached per repository, only to be used from the GUI thread.
  */
 QVector<Branch> getAllBranchesAndTags(const QString &repo, RefType ref = RefType::All);
 
@@ -0,0 +1,288 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#include "gitbatch.h"
+#include "gitstatusservice.h"
+
+#include <gitdiffprovider.h>
+#include <gitprocess.h>
+
+#include <QProcess>
+
+#include <algorithm>
+#include <utility>
+
+// git clean and git < 2.25 have no --pathspec-from-file, keep the command line short enough for Windows
+static constexpr int MaxCommandLine = 30000;
+
+GitBatch::GitBatch(const QString &workTree, std::shared_ptr<GitStatusService> statusService, QObject *parent)
+    : QObject(parent)
+    , m_workTree(workTree)
+    , m_statusService(std::move(statusService))
+{
+    // collect what is requested in one go, e.g. from a context menu action per selected file
+    m_startTimer.setSingleShot(true);
+    m_startTimer.setInterval(0);
+    connect(&m_startTimer, &QTimer::timeout, this, &GitBatch::runNext);
+}
+
+GitBatch::~GitBatch()
+{
+    // the running git gets killed with us, it might have changed the index already
+    for (QObject *child : children()) {
+        if (auto git = qobject_cast<QProcess *>(child)) {
+            disconnect(git, nullptr, this, nullptr);
+        }
+    }
+
+    if (m_running && m_statusService) {
+        m_statusService->endIndexWrite(m_touched);
+    }
+}
+
+GitBatch::Step &GitBatch::stepFor(Operation operation)
+{
+    // merge with the last one of the same kind, the order of different kinds is kept
+    if (m_steps.empty() || m_steps.back().operation != operation) {
+        m_steps.push_back(Step{operation, {}, {}, {}, {}});
+    }
+    if (!m_running) {
+        m_startTimer.start();
+    }
+    return m_steps.back();
+}
+
+QString GitBatch::relativePath(const QString &path) const
+{
+    return path.startsWith(m_workTree) ? path.mid(m_workTree.size()) : path;
+}
+
+void GitBatch::add(Operation operation, const QStringList &paths)
+{
+    if (paths.isEmpty()) {
+        return;
+    }
+
+    Step &step = stepFor(operation);
+    for (const auto &path : paths) {
+        const QString relative = relativePath(path);
+        if (!step.seen.contains(relative)) {
+            step.seen.insert(relative);
+            step.paths.append(relative);
+        }
+    }
+}
+
+void GitBatch::apply(const QByteArray &patch, const std::function<void()> &applied)
+{
+    if (patch.isEmpty()) {
+        return;
+    }
+
+    // the files to update the status of
+    Step &step = stepFor(ApplyCached);
+    const auto fileDiffs = GitDiffProvider::parse(patch);
+    for (const auto &fileDiff : fileDiffs) {
+        if (!step.seen.contains(fileDiff.path)) {
+            step.seen.insert(fileDiff.path);
+            step.paths.append(fileDiff.path);
+        }
+    }
+
+    // each patch is against the state before the former ones, git apply finds moved hunks by their context
+    step.patch += patch;
+    if (!step.patch.endsWith('\n')) {
+        step.patch += '\n';
+    }
+    if (applied) {
+        step.applied.push_back(applied);
+    }
+}
+
+QByteArray GitBatch::pathSpecs(const QStringList &relativePaths)
+{
+    QByteArray specs;
+    for (const auto &path : relativePaths) {
+        specs += ":(top,literal)" + path.toUtf8() + '\0';
+    }
+    return specs;
+}
+
+QVector<QStringList> GitBatch::pathSpecChunks(const QStringList &relativePaths, int maxLength)
+{
+    QVector<QStringList> chunks;
+    int length = 0;
+    for (const auto &path : relativePaths) {
+        // :(top,literal)path + separator, at least one path per chunk
+        const int specLength = path.size() + 15;
+        if (chunks.isEmpty() || (length > 0 && length + specLength > maxLength)) {
+            chunks.append(QStringList());
+            length = 0;
+        }
+        chunks.last().append(path);
+        length += specLength;
+    }
+    return chunks;
+}
+
+void GitBatch::runNext()
+{
+    if (m_steps.empty()) {
+        if (m_running) {
+            m_running = false;
+            m_touchedSet.clear();
+            const QStringList touched = std::exchange(m_touched, {});
+            Q_EMIT finished(touched);
+            if (m_statusService) {
+                m_statusService->endIndexWrite(touched);
+            }
+        }
+        return;
+    }
+
+    if (!m_running) {
+        m_running = true;
+        if (m_statusService) {
+            m_statusService->beginIndexWrite();
+        }
+    }
+
+    Step step = std::move(m_steps.front());
+    m_steps.pop_front();
+
+    for (const auto &path : qAsConst(step.paths)) {
+        if (!m_touchedSet.contains(path)) {
+            m_touchedSet.insert(path);
+            m_touched.append(m_workTree + path);
+        }
+    }
+
+    const Operation operation = step.operation;
+    if (operation == ApplyCached) {
+        auto applied = std::move(step.applied);
+        runGit({QStringLiteral("apply"), QStringLiteral("--index"), QStringLiteral("--cached"), QStringLiteral("-")},
+               step.patch,
+               [this, applied](bool ok, const QByteArray &error) {
+                   if (ok) {
+                       for (const auto &callback : applied) {
+                           callback();
+                       }
+                   } else {
+                       Q_EMIT failed(ApplyCached, QString::fromUtf8(error));
+                   }
+                   runNext();
+               });
+        return;
+    }
+
+    QStringList args;
+    switch (operation) {
+    case Stage:
+        args = QStringList{QStringLiteral("add"), QStringLiteral("-A")};
+        break;
+    case Unstage:
+        args = QStringList{QStringLiteral("reset"), QStringLiteral("-q"), QStringLiteral("HEAD")};
+        break;
+    case Discard:
+        args = QStringList{QStringLiteral("checkout"), QStringLiteral("-q")};
+        break;
+    case Clean:
+        args = QStringList{QStringLiteral("clean"), QStringLiteral("-q"), QStringLiteral("-f")};
+        break;
+    case ApplyCached:
+        break;
+    }
+
+    const QStringList paths = step.paths;
+    if (operation != Clean && m_pathSpecFromFile) {
+        args += QStringList{QStringLiteral("--pathspec-from-file=-"), QStringLiteral("--pathspec-file-nul")};
+        runGit(args, pathSpecs(paths), [this, operation, paths](bool ok, const QByteArray &error) {
+            // git < 2.25, once more on the command line
+            if (!ok && error.contains("pathspec-from-file")) {
+                m_pathSpecFromFile = false;
+                m_steps.push_front(Step{operation, paths, {}, {}, {}});
+                runNext();
+                return;
+            }
+            pathsDone(operation, paths, ok, error);
+        });
+        return;
+    }
+
+    // split the paths over as few command lines as possible, the rest become the next steps
+    const auto chunks = pathSpecChunks(paths, MaxCommandLine);
+    for (int i = chunks.size() - 1; i > 0; --i) {
+        m_steps.push_front(Step{operation, chunks.at(i), {}, {}, {}});
+    }
+
+    const QStringList chunk = chunks.value(0);
+    args.append(QStringLiteral("--"));
+    for (const auto &path : chunk) {
+        args.append(QStringLiteral(":(top,literal)") + path);
+    }
+    runGit(args, QByteArray(), [this, operation, chunk](bool ok, const QByteArray &error) {
+        pathsDone(operation, chunk, ok, error);
+    });
+}
+
+void GitBatch::pathsDone(Operation operation, const QStringList &paths, bool ok, const QByteArray &error)
+{
+    if (ok) {
+        runNext();
+        return;
+    }
+
+    // e.g. one of the files is gone meanwhile, that shouldn't fail the others
+    const bool pathError = error.contains("did not match any") || error.contains("pathspec");
+    if (pathError && paths.size() > 1) {
+        for (auto it = paths.crbegin(); it != paths.crend(); ++it) {
+            m_steps.push_front(Step{operation, {*it}, {}, {}, {}});
+        }
+        runNext();
+        return;
+    }
+
+    // anything else, e.g. a stale index.lock, fails the rest of the operation the same way, tell once
+    if (!pathError) {
+        m_steps.erase(std::remove_if(m_steps.begin(),
+                                     m_steps.end(),
+                                     [operation](const Step &step) {
+                                         return step.operation == operation;
+                                     }),
+                      m_steps.end());
+    }
+    Q_EMIT failed(operation, QString::fromUtf8(error));
+    runNext();
+}
+
+void GitBatch::runGit(const QStringList &args, const QByteArray &input, const std::function<void(bool ok, const QByteArray &error)> &done)
+{
+    auto git = new QProcess(this);
+    if (!setupGitProcess(*git, m_workTree, args)) {
+        delete git;
+        // no git, no need to try the rest
+        m_steps.clear();
+        done(false, QByteArray());
+        return;
+    }
+
+    connect(git, &QProcess::finished, this, [git, done](int exitCode, QProcess::ExitStatus es) {
+        git->deleteLater();
+        done(es == QProcess::NormalExit && exitCode == 0, git->readAllStandardError());
+    });
+    connect(git, &QProcess::errorOccurred, this, [this, git, done](QProcess::ProcessError pe) {
+        // no finished signal then, no need to try the rest either
+        if (pe == QProcess::FailedToStart) {
+            git->deleteLater();
+            m_steps.clear();
+            done(false, QByteArray());
+        }
+    });
+    git->start(input.isEmpty() ? QProcess::ReadOnly : QProcess::ReadWrite);
+    if (!input.isEmpty()) {
+        git->write(input);
+        git->closeWriteChannel();
+    }
+}
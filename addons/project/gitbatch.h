@@ -0,0 +1,108 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#ifndef GITBATCH_H
+#define GITBATCH_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class GitStatusService;
+
+/**
+ * Runs stage, unstage, discard, clean and partial stage operations with as few git processes as possible.
+ *
+ * Operations requested in a row, or while others still run, are merged per kind:
+ * all paths go to one git add/reset/checkout via --pathspec-from-file, all patches are
+ * concatenated to one git apply --cached. Git before 2.25 gets the paths on as few command
+ * lines as possible, like git clean always does. If a command fails for several paths, e.g.
+ * one file is gone meanwhile, each path is tried on its own, only those failing are reported.
+ *
+ * While a batch runs, the status service ignores the index changes, once nothing is left to
+ * do, it updates the touched files, so only one status update is needed for the whole batch.
+ */
+class GitBatch : public QObject
+{
+    Q_OBJECT
+public:
+    enum Operation { Stage, Unstage, Discard, Clean, ApplyCached };
+    Q_ENUM(Operation)
+
+    /**
+     * @param workTree top level directory of the working tree, ending with "/"
+     * @param statusService to tell about the index writes, may be null
+     */
+    GitBatch(const QString &workTree, std::shared_ptr<GitStatusService> statusService, QObject *parent = nullptr);
+
+    /**
+     * The status service gets the touched files also if we are gone before the batch is done.
+     */
+    ~GitBatch() override;
+
+    /**
+     * Paths absolute or relative to the working tree.
+     */
+    void add(Operation operation, const QStringList &paths);
+
+    /**
+     * Apply a patch to the index, @p applied is called once that worked.
+     */
+    void apply(const QByteArray &patch, const std::function<void()> &applied = {});
+
+    /**
+     * The top level relative paths as literal pathspecs for --pathspec-file-nul.
+     */
+    static QByteArray pathSpecs(const QStringList &relativePaths);
+
+    /**
+     * Split the top level relative paths into chunks whose literal pathspecs fit on one command line.
+     */
+    static QVector<QStringList> pathSpecChunks(const QStringList &relativePaths, int maxLength);
+
+Q_SIGNALS:
+    /**
+     * Nothing more to do.
+     * @param files absolute paths of all touched files
+     */
+    void finished(const QStringList &files);
+
+    void failed(GitBatch::Operation operation, const QString &error);
+
+private:
+    struct Step {
+        Operation operation;
+        QStringList paths;
+        QSet<QString> seen;
+        QByteArray patch;
+        std::vector<std::function<void()>> applied;
+    };
+
+    Step &stepFor(Operation operation);
+    QString relativePath(const QString &path) const;
+    void runNext();
+    void pathsDone(Operation operation, const QStringList &paths, bool ok, const QByteArray &error);
+    void runGit(const QStringList &args, const QByteArray &input, const std::function<void(bool ok, const QByteArray &error)> &done);
+
+    const QString m_workTree;
+    const std::shared_ptr<GitStatusService> m_statusService;
+    std::deque<Step> m_steps;
+    QTimer m_startTimer;
+    bool m_running = false;
+    // false once git told it doesn't know --pathspec-from-file
+    bool m_pathSpecFromFile = true;
+    QStringList m_touched;
+    QSet<QString> m_touchedSet;
+};
+
+#endif // GITBATCH_H
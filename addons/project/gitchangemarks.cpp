@@ -0,0 +1,314 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#include "gitchangemarks.h"
+
+#include <gitprocess.h>
+
+#include <KLocalizedString>
+#include <KTextEditor/Document>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QIcon>
+#include <QProcess>
+#include <QTextCodec>
+#include <QtConcurrentRun>
+
+// typing should not cause a diff per key press
+static constexpr int DiffDelay = 500;
+
+// git writes the index a few times in a row, e.g. for a commit
+static constexpr int IndexDelay = 200;
+
+static constexpr uint AllMarks = GitChangeMarker::AddedMark | GitChangeMarker::ModifiedMark | GitChangeMarker::DeletedMark;
+
+std::vector<std::pair<int, uint>> GitChangeMarker::marksForHunks(const std::vector<LineDiff::Hunk> &hunks, int lines)
+{
+    std::vector<std::pair<int, uint>> marks;
+    if (lines <= 0) {
+        return marks;
+    }
+
+    for (const auto &hunk : hunks) {
+        // lines got removed before this line
+        if (hunk.newCount == 0) {
+            marks.push_back({qMin(hunk.newStart, lines - 1), DeletedMark});
+            continue;
+        }
+
+        const uint type = hunk.oldCount == 0 ? AddedMark : ModifiedMark;
+        const int end = qMin(hunk.newStart + hunk.newCount, lines);
+        for (int line = hunk.newStart; line < end; ++line) {
+            marks.push_back({line, type});
+        }
+    }
+    return marks;
+}
+
+GitChangeMarker::GitChangeMarker(KTextEditor::Document *document, QObject *parent)
+    : QObject(parent)
+    , m_document(document)
+{
+    m_diffTimer.setSingleShot(true);
+    m_diffTimer.setInterval(DiffDelay);
+    connect(&m_diffTimer, &QTimer::timeout, this, &GitChangeMarker::startDiff);
+    connect(&m_baseWatcher, &QFutureWatcher<IndexVersion>::finished, this, &GitChangeMarker::baseLoaded);
+    connect(&m_diffWatcher, &QFutureWatcher<std::vector<LineDiff::Hunk>>::finished, this, &GitChangeMarker::diffDone);
+
+    connect(document, &KTextEditor::Document::textChanged, this, [this] {
+        ++m_revision;
+        if (!m_blob.isEmpty()) {
+            m_diffTimer.start();
+        }
+    });
+
+    if (auto iface = qobject_cast<KTextEditor::MarkInterfaceV2 *>(document)) {
+        iface->setMarkDescription(AddedMark, i18n("Added line"));
+        iface->setMarkIcon(AddedMark, QIcon::fromTheme(QStringLiteral("vcs-added")));
+        iface->setMarkDescription(ModifiedMark, i18n("Modified line"));
+        iface->setMarkIcon(ModifiedMark, QIcon::fromTheme(QStringLiteral("vcs-locally-modified")));
+        iface->setMarkDescription(DeletedMark, i18n("Deleted lines"));
+        iface->setMarkIcon(DeletedMark, QIcon::fromTheme(QStringLiteral("vcs-removed")));
+    }
+}
+
+GitChangeMarker::~GitChangeMarker()
+{
+    clearMarks();
+}
+
+GitChangeMarker::IndexVersion GitChangeMarker::readIndexVersion(const QString &filePath, const QString &gitDir, const QByteArray &blob, const QByteArray &encoding)
+{
+    IndexVersion version;
+    version.gitDir = gitDir;
+
+    const QFileInfo info(filePath);
+    const QString workingDir = info.absolutePath();
+
+    // where the index is, to notice changes of it
+    if (version.gitDir.isEmpty()) {
+        QProcess git;
+        if (!setupGitProcess(git, workingDir, {QStringLiteral("rev-parse"), QStringLiteral("--absolute-git-dir")})) {
+            return version;
+        }
+        git.start(QProcess::ReadOnly);
+        if (!git.waitForFinished(-1) || git.exitStatus() != QProcess::NormalExit || git.exitCode() != 0) {
+            return version;
+        }
+        version.gitDir = QString::fromUtf8(git.readAllStandardOutput().trimmed());
+    }
+
+    // <mode> <blob> <stage>\t<file>
+    QProcess ls;
+    if (!setupGitProcess(ls, workingDir, {QStringLiteral("ls-files"), QStringLiteral("--stage"), QStringLiteral("-z"), QStringLiteral("--"), info.fileName()})) {
+        return version;
+    }
+    ls.start(QProcess::ReadOnly);
+    if (!ls.waitForFinished(-1) || ls.exitStatus() != QProcess::NormalExit || ls.exitCode() != 0) {
+        return version;
+    }
+    const QByteArray entry = ls.readAllStandardOutput();
+    const QList<QByteArray> fields = entry.left(entry.indexOf('\t')).split(' ');
+    // not tracked or unmerged, nothing to compare with
+    if (fields.size() != 3 || fields.at(2) != "0") {
+        return version;
+    }
+
+    version.blob = fields.at(1);
+    if (version.blob == blob) {
+        version.unchanged = true;
+        return version;
+    }
+
+    QProcess cat;
+    if (!setupGitProcess(cat, workingDir, {QStringLiteral("cat-file"), QStringLiteral("blob"), QString::fromLatin1(version.blob)})) {
+        version.blob.clear();
+        return version;
+    }
+    cat.start(QProcess::ReadOnly);
+    if (!cat.waitForFinished(-1) || cat.exitStatus() != QProcess::NormalExit || cat.exitCode() != 0) {
+        version.blob.clear();
+        return version;
+    }
+    QTextCodec *codec = QTextCodec::codecForName(encoding);
+    if (!codec) {
+        codec = QTextCodec::codecForName("UTF-8");
+    }
+    version.lines = LineDiff::splitLines(codec->toUnicode(cat.readAllStandardOutput()));
+    return version;
+}
+
+void GitChangeMarker::loadBase()
+{
+    if (!m_document) {
+        return;
+    }
+
+    // url changed => another file, maybe in another repository
+    const QString filePath = m_document->url().toLocalFile();
+    if (filePath != m_filePath) {
+        m_filePath = filePath;
+        m_gitDir.clear();
+        m_blob.clear();
+    }
+
+    if (m_baseWatcher.isRunning()) {
+        m_basePending = true;
+        return;
+    }
+    m_baseWatcher.setFuture(QtConcurrent::run(&GitChangeMarker::readIndexVersion, m_filePath, m_gitDir, m_blob, m_document->encoding().toLatin1()));
+}
+
+void GitChangeMarker::baseLoaded()
+{
+    if (m_basePending) {
+        m_basePending = false;
+        loadBase();
+        return;
+    }
+
+    IndexVersion version = m_baseWatcher.result();
+    if (!version.gitDir.isEmpty() && version.gitDir != m_gitDir) {
+        m_gitDir = version.gitDir;
+        Q_EMIT gitDirFound(m_gitDir);
+    }
+
+    if (version.unchanged) {
+        return;
+    }
+
+    m_blob = version.blob;
+    m_baseLines = std::move(version.lines);
+    if (m_blob.isEmpty()) {
+        m_diffTimer.stop();
+        clearMarks();
+        return;
+    }
+
+    startDiff();
+}
+
+void GitChangeMarker::startDiff()
+{
+    if (!m_document || m_blob.isEmpty()) {
+        return;
+    }
+
+    if (m_diffWatcher.isRunning()) {
+        m_diffPending = true;
+        return;
+    }
+
+    m_diffRevision = m_revision;
+    m_diffWatcher.setFuture(QtConcurrent::run([base = m_baseLines, text = m_document->text()] {
+        return LineDiff::diff(base, LineDiff::splitLines(text));
+    }));
+}
+
+void GitChangeMarker::diffDone()
+{
+    if (m_diffPending) {
+        m_diffPending = false;
+        startDiff();
+        return;
+    }
+
+    // edited meanwhile, another diff will follow
+    if (m_diffRevision != m_revision) {
+        return;
+    }
+
+    setMarks(m_diffWatcher.result());
+}
+
+void GitChangeMarker::setMarks(const std::vector<LineDiff::Hunk> &hunks)
+{
+    clearMarks();
+
+    auto iface = qobject_cast<KTextEditor::MarkInterface *>(m_document.data());
+    if (!iface) {
+        return;
+    }
+
+    const auto marks = marksForHunks(hunks, m_document->lines());
+    for (const auto &mark : marks) {
+        iface->addMark(mark.first, mark.second);
+    }
+}
+
+void GitChangeMarker::clearMarks()
+{
+    auto iface = qobject_cast<KTextEditor::MarkInterface *>(m_document.data());
+    if (!iface) {
+        return;
+    }
+
+    const QHash<int, KTextEditor::Mark *> marks = iface->marks();
+    for (const auto *mark : marks) {
+        if (mark->type & AllMarks) {
+            iface->removeMark(mark->line, AllMarks);
+        }
+    }
+}
+
+GitChangeMarks::GitChangeMarks(QObject *parent)
+    : QObject(parent)
+{
+    m_indexTimer.setSingleShot(true);
+    m_indexTimer.setInterval(IndexDelay);
+    connect(&m_indexTimer, &QTimer::timeout, this, &GitChangeMarks::reloadChangedIndexes);
+    connect(&m_indexWatcher, &QFileSystemWatcher::fileChanged, this, &GitChangeMarks::indexChanged);
+}
+
+void GitChangeMarks::setDocument(KTextEditor::Document *document, bool inProject)
+{
+    if (!inProject || !document->url().isLocalFile()) {
+        removeDocument(document);
+        return;
+    }
+
+    GitChangeMarker *marker = m_markers.value(document);
+    if (!marker) {
+        marker = new GitChangeMarker(document, this);
+        connect(marker, &GitChangeMarker::gitDirFound, this, &GitChangeMarks::watchIndex);
+        m_markers.insert(document, marker);
+    }
+    marker->loadBase();
+}
+
+void GitChangeMarks::removeDocument(QObject *document)
+{
+    delete m_markers.take(document);
+}
+
+void GitChangeMarks::watchIndex(const QString &gitDir)
+{
+    const QString index = gitDir + QStringLiteral("/index");
+    if (!m_indexWatcher.files().contains(index)) {
+        m_indexWatcher.addPath(index);
+    }
+}
+
+void GitChangeMarks::indexChanged(const QString &path)
+{
+    // git replaces the index, that can remove the watch
+    if (!m_indexWatcher.files().contains(path) && QFile::exists(path)) {
+        m_indexWatcher.addPath(path);
+    }
+
+    m_changedGitDirs.insert(QFileInfo(path).absolutePath());
+    m_indexTimer.start();
+}
+
+void GitChangeMarks::reloadChangedIndexes()
+{
+    for (auto *marker : qAsConst(m_markers)) {
+        if (m_changedGitDirs.contains(marker->gitDir())) {
+            marker->loadBase();
+        }
+    }
+    m_changedGitDirs.clear();
+}
@@ -0,0 +1,125 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#ifndef GITCHANGEMARKS_H
+#define GITCHANGEMARKS_H
+
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+#include <KTextEditor/MarkInterface>
+
+#include <linediff.h>
+
+#include <utility>
+#include <vector>
+
+namespace KTextEditor
+{
+class Document;
+}
+
+/**
+ * Marks added, modified and deleted lines of one document compared to the version in the git index.
+ *
+ * The index version is read once on a worker thread when the document is added or the index changes.
+ * After edits the document text is diffed against it in-process, debounced, on a worker thread, too.
+ */
+class GitChangeMarker : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr auto AddedMark = KTextEditor::MarkInterface::markType27;
+    static constexpr auto ModifiedMark = KTextEditor::MarkInterface::markType28;
+    static constexpr auto DeletedMark = KTextEditor::MarkInterface::markType29;
+
+    /**
+     * Line + mark type for the changes of a document with the given number of lines.
+     */
+    static std::vector<std::pair<int, uint>> marksForHunks(const std::vector<LineDiff::Hunk> &hunks, int lines);
+
+    GitChangeMarker(KTextEditor::Document *document, QObject *parent);
+    ~GitChangeMarker() override;
+
+    /**
+     * (Re)read the version of the file in the index, e.g. because it changed.
+     */
+    void loadBase();
+
+    const QString &gitDir() const
+    {
+        return m_gitDir;
+    }
+
+Q_SIGNALS:
+    void gitDirFound(const QString &gitDir);
+
+private:
+    struct IndexVersion {
+        QString gitDir;
+        // empty if the file is not in the index
+        QByteArray blob;
+        QStringList lines;
+        bool unchanged = false;
+    };
+    // encoding: the one of the document, the index has the file as it is on disk
+    static IndexVersion readIndexVersion(const QString &filePath, const QString &gitDir, const QByteArray &blob, const QByteArray &encoding);
+
+    void baseLoaded();
+    void startDiff();
+    void diffDone();
+    void setMarks(const std::vector<LineDiff::Hunk> &hunks);
+    void clearMarks();
+
+    QPointer<KTextEditor::Document> m_document;
+    QString m_filePath;
+
+    QString m_gitDir;
+    QByteArray m_blob;
+    QStringList m_baseLines;
+    QFutureWatcher<IndexVersion> m_baseWatcher;
+    bool m_basePending = false;
+
+    // edits since the document was added, to notice outdated diffs
+    quint64 m_revision = 0;
+    quint64 m_diffRevision = 0;
+    QTimer m_diffTimer;
+    QFutureWatcher<std::vector<LineDiff::Hunk>> m_diffWatcher;
+    bool m_diffPending = false;
+};
+
+/**
+ * The change markers of all documents in projects, updated if the index of their repository changes.
+ */
+class GitChangeMarks : public QObject
+{
+    Q_OBJECT
+public:
+    explicit GitChangeMarks(QObject *parent = nullptr);
+
+    /**
+     * Add the document or update it after its url changed, removes it if it is no longer part of a project.
+     */
+    void setDocument(KTextEditor::Document *document, bool inProject);
+    void removeDocument(QObject *document);
+
+private:
+    void watchIndex(const QString &gitDir);
+    void indexChanged(const QString &path);
+    void reloadChangedIndexes();
+
+    QHash<QObject *, GitChangeMarker *> m_markers;
+    QFileSystemWatcher m_indexWatcher;
+    QSet<QString> m_changedGitDirs;
+    QTimer m_indexTimer;
+};
+
+#endif // GITCHANGEMARKS_H
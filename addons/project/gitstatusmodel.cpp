@@ -164,11 +164,83 @@ QVariant GitStatusModel::data(const QModelIndex &index, int role) const
 }
 void GitStatusModel::setStatusItems(GitUtils::GitParsedStatus status, bool numStat)
 {
-    beginResetModel();
-    m_nodes[Staged] = std::move(status.staged);
-    m_nodes[Changed] = std::move(status.changed);
-    m_nodes[Conflict] = std::move(status.unmerge);
-    m_nodes[Untrack] = std::move(status.untracked);
-    m_showNumStat = numStat;
-    endResetModel();
+    if (m_showNumStat != numStat) {
+        m_showNumStat = numStat;
+        for (int node = Staged; node <= Untrack; ++node) {
+            if (!m_nodes[node].isEmpty()) {
+                const auto parent = getModelIndex(ItemType(node));
+                Q_EMIT dataChanged(index(0, 1, parent), index(m_nodes[node].size() - 1, 1, parent));
+            }
+        }
+    }
+
+    updateNode(Staged, std::move(status.staged));
+    updateNode(Changed, std::move(status.changed));
+    updateNode(Conflict, std::move(status.unmerge));
+    updateNode(Untrack, std::move(status.untracked));
+}
+
+static bool sameItem(const GitUtils::StatusItem &l, const GitUtils::StatusItem &r)
+{
+    return l.status == r.status && l.statusChar == r.statusChar && l.linesAdded == r.linesAdded && l.linesRemoved == r.linesRemoved;
+}
+
+void GitStatusModel::updateNode(int node, QVector<GitUtils::StatusItem> items)
+{
+    // both lists are sorted by file, walk them in parallel, invariant: current[0, row) == items[0, next)
+    // only the differences are announced, views keep selection, expansion and scroll position
+    auto &current = m_nodes[node];
+    const auto parent = getModelIndex(ItemType(node));
+    const int oldCount = current.size();
+
+    int row = 0;
+    int next = 0;
+    while (row < current.size() || next < items.size()) {
+        // run of rows that are gone
+        if (row < current.size() && (next == items.size() || current.at(row).file < items.at(next).file)) {
+            int last = row;
+            while (last + 1 < current.size() && (next == items.size() || current.at(last + 1).file < items.at(next).file)) {
+                ++last;
+            }
+            beginRemoveRows(parent, row, last);
+            current.erase(current.begin() + row, current.begin() + last + 1);
+            endRemoveRows();
+            continue;
+        }
+
+        // run of new rows
+        if (row == current.size() || items.at(next).file < current.at(row).file) {
+            int last = next;
+            while (last + 1 < items.size() && (row == current.size() || items.at(last + 1).file < current.at(row).file)) {
+                ++last;
+            }
+            beginInsertRows(parent, row, row + last - next);
+            current.insert(row, last - next + 1, GitUtils::StatusItem{});
+            std::copy(items.cbegin() + next, items.cbegin() + last + 1, current.begin() + row);
+            endInsertRows();
+            row += last - next + 1;
+            next = last + 1;
+            continue;
+        }
+
+        // same file, run of changed rows
+        int changed = row;
+        while (row < current.size() && next < items.size() && current.at(row).file == items.at(next).file && !sameItem(current.at(row), items.at(next))) {
+            current[row] = items.at(next);
+            ++row;
+            ++next;
+        }
+        if (changed < row) {
+            Q_EMIT dataChanged(index(changed, 0, parent), index(row - 1, 1, parent));
+        } else {
+            ++row;
+            ++next;
+        }
+    }
+
+    // the count in the node row
+    if (oldCount != current.size()) {
+        const auto countIndex = createIndex(node, 1, Root);
+        Q_EMIT dataChanged(countIndex, countIndex);
+    }
 }
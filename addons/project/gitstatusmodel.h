@@ -33,6 +33,10 @@ public:
     int columnCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
 
+    /**
+     * Update to the new status, the lists must be sorted by file.
+     * Only the rows that changed are removed, inserted or updated, no reset.
+     */
     void setStatusItems(GitUtils::GitParsedStatus status, bool numStat);
 
     const QVector<GitUtils::StatusItem> &untrackedFiles() const
@@ -56,6 +60,8 @@ public:
     }
 
 private:
+    void updateNode(int node, QVector<GitUtils::StatusItem> items);
+
     QVector<GitUtils::StatusItem> m_nodes[4];
     bool m_showNumStat = false;
 };
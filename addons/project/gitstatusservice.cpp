@@ -0,0 +1,497 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#include "gitstatusservice.h"
+
+#include <gitprocess.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QProcess>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+#include <utility>
+
+// more paths and a full update is cheaper, the command line stays short, too
+static constexpr int MaxPartialPaths = 256;
+
+// inotify watches are a limited resource per user, shared with everybody else, this is for all repositories together
+static constexpr int MaxWatches = 4096;
+
+// the working tree can change unnoticed, e.g. in place edits of clean files, a status older than this gets updated
+static constexpr int MaxStatusAge = 2000;
+
+static int &watchesInUse()
+{
+    static int watches = 0;
+    return watches;
+}
+
+static QHash<QString, std::weak_ptr<GitStatusService>> &services()
+{
+    static QHash<QString, std::weak_ptr<GitStatusService>> services;
+    return services;
+}
+
+std::shared_ptr<GitStatusService> GitStatusService::forRepository(const QString &workTree)
+{
+    auto &all = services();
+    if (auto service = all.value(workTree).lock()) {
+        return service;
+    }
+
+    std::shared_ptr<GitStatusService> service(new GitStatusService(workTree));
+    all.insert(workTree, service);
+    return service;
+}
+
+void GitStatusService::fileSaved(const QString &absolutePath)
+{
+    for (const auto &weak : std::as_const(services())) {
+        if (auto service = weak.lock()) {
+            service->fileChanged(absolutePath);
+        }
+    }
+}
+
+GitStatusService::GitStatusService(const QString &workTree)
+    : m_workTree(workTree)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &GitStatusService::start);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &GitStatusService::directoryChanged);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &GitStatusService::watchedFileChanged);
+    connect(&m_parseWatcher, &QFutureWatcher<GitUtils::GitParsedStatus>::finished, this, &GitStatusService::statusReady);
+
+    // the git dir is not always below the working tree, e.g. for worktrees
+    auto git = new QProcess(this);
+    if (!setupGitProcess(*git, m_workTree, {QStringLiteral("rev-parse"), QStringLiteral("--absolute-git-dir")})) {
+        delete git;
+        return;
+    }
+    connect(git, &QProcess::finished, this, [this, git](int exitCode, QProcess::ExitStatus es) {
+        if (es == QProcess::NormalExit && exitCode == 0) {
+            m_gitDir = QString::fromUtf8(git->readAllStandardOutput()).trimmed();
+            m_index = signature(m_gitDir + QStringLiteral("/index"));
+            m_head = signature(m_gitDir + QStringLiteral("/HEAD"));
+            updateWatches();
+            listTrackedDirs();
+        }
+        git->deleteLater();
+    });
+    git->start(QProcess::ReadOnly);
+}
+
+GitStatusService::~GitStatusService()
+{
+    services().remove(m_workTree);
+    watchesInUse() -= m_watches;
+}
+
+void GitStatusService::refresh()
+{
+    m_fullPending = true;
+    schedule(0);
+}
+
+void GitStatusService::update()
+{
+    // without the watch on the git dir we can't know if we are up to date
+    // directory watches miss in place edits of clean files, the status is only good for a short while
+    const bool watching = !m_gitDir.isEmpty() && m_watcher.directories().contains(m_gitDir);
+    const bool recent = m_updated.isValid() && m_updated.elapsed() < MaxStatusAge;
+    if (m_valid && watching && recent && !m_running && !m_fullPending && m_pendingFiles.isEmpty() && m_pendingDirs.isEmpty()) {
+        Q_EMIT statusChanged(m_status);
+        return;
+    }
+
+    if (!watching || !recent) {
+        m_fullPending = true;
+    }
+    schedule(0);
+}
+
+void GitStatusService::fileChanged(const QString &absolutePath)
+{
+    if (!absolutePath.startsWith(m_workTree)) {
+        return;
+    }
+
+    m_pendingFiles.insert(relativePath(absolutePath));
+    schedule(100);
+}
+
+void GitStatusService::beginIndexWrite()
+{
+    ++m_indexWrites;
+}
+
+void GitStatusService::endIndexWrite(const QStringList &absolutePaths)
+{
+    if (m_indexWrites > 0) {
+        --m_indexWrites;
+    }
+
+    // the watch on the git dir might not have noticed our change yet, it's known now
+    if (!m_gitDir.isEmpty()) {
+        m_index = signature(m_gitDir + QStringLiteral("/index"));
+    }
+
+    for (const auto &path : absolutePaths) {
+        if (path.startsWith(m_workTree)) {
+            m_pendingFiles.insert(relativePath(path));
+        }
+    }
+    schedule(0);
+}
+
+void GitStatusService::setNumStat(bool numStat)
+{
+    if (m_numStat == numStat) {
+        return;
+    }
+
+    m_numStat = numStat;
+    refresh();
+}
+
+GitStatusService::Signature GitStatusService::signature(const QString &file) const
+{
+    const QFileInfo info(file);
+    if (!info.exists()) {
+        return {};
+    }
+    return {info.lastModified(), info.size()};
+}
+
+void GitStatusService::schedule(int delay)
+{
+    // a later trigger doesn't delay an earlier one
+    if (m_timer.isActive() && m_timer.remainingTime() <= delay) {
+        return;
+    }
+    m_timer.start(delay);
+}
+
+static QString escapeGlob(const QByteArray &path)
+{
+    QString escaped;
+    const QString p = QString::fromUtf8(path);
+    escaped.reserve(p.size());
+    for (const QChar c : p) {
+        if (c == QLatin1Char('*') || c == QLatin1Char('?') || c == QLatin1Char('[') || c == QLatin1Char('\\')) {
+            escaped.append(QLatin1Char('\\'));
+        }
+        escaped.append(c);
+    }
+    return escaped;
+}
+
+void GitStatusService::start()
+{
+    // never two in parallel, statusReady looks for new work
+    if (m_running) {
+        return;
+    }
+    if (!m_fullPending && m_pendingFiles.isEmpty() && m_pendingDirs.isEmpty()) {
+        return;
+    }
+
+    m_running = true;
+    m_failed = false;
+    m_runningFiles = std::exchange(m_pendingFiles, {});
+    m_runningDirs = std::exchange(m_pendingDirs, {});
+    m_runningTrees.clear();
+
+    // files in new untracked subdirectories are not direct children, look at everything below them
+    if (!m_fullPending && m_trackedDirsListed) {
+        for (const auto &dir : std::as_const(m_runningDirs)) {
+            const QString absoluteDir = dir.isEmpty() ? m_workTree : m_workTree + QString::fromUtf8(dir) + QLatin1Char('/');
+            const QStringList subDirs = QDir(absoluteDir).entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
+            for (const auto &subDir : subDirs) {
+                const QByteArray path = dir.isEmpty() ? subDir.toUtf8() : dir + '/' + subDir.toUtf8();
+                if (path != ".git" && !m_trackedDirSet.contains(path)) {
+                    m_runningTrees.insert(path);
+                }
+            }
+        }
+    }
+
+    m_runningFull = m_fullPending || (m_runningFiles.size() + m_runningDirs.size() + m_runningTrees.size() > MaxPartialPaths);
+    m_fullPending = false;
+
+    QStringList pathSpecs;
+    if (!m_runningFull) {
+        pathSpecs.append(QStringLiteral("--"));
+        for (const auto &file : std::as_const(m_runningFiles)) {
+            pathSpecs.append(QStringLiteral(":(top,literal)") + QString::fromUtf8(file));
+        }
+        // * doesn't match / with glob magic, just the files directly in the directory
+        for (const auto &dir : std::as_const(m_runningDirs)) {
+            pathSpecs.append(QStringLiteral(":(top,glob)") + (dir.isEmpty() ? QString() : escapeGlob(dir) + QLatin1Char('/')) + QLatin1Char('*'));
+        }
+        // a directory matches everything below it
+        for (const auto &tree : std::as_const(m_runningTrees)) {
+            pathSpecs.append(QStringLiteral(":(top,literal)") + QString::fromUtf8(tree));
+        }
+    } else {
+        m_runningFiles.clear();
+        m_runningDirs.clear();
+        m_runningTrees.clear();
+    }
+
+    m_statusOutput.clear();
+    m_changedNumStat.clear();
+    m_stagedNumStat.clear();
+
+    // git may write the index, that way a configured untracked cache and the refreshed stat data are kept
+    startGit(QStringList{QStringLiteral("status"), QStringLiteral("-z"), QStringLiteral("-u"), QStringLiteral("--ignore-submodules")} + pathSpecs,
+             &m_statusOutput);
+
+    if (m_numStat) {
+        const QStringList diff{QStringLiteral("--no-optional-locks"), QStringLiteral("diff"), QStringLiteral("--numstat"), QStringLiteral("-z")};
+        startGit(diff + pathSpecs, &m_changedNumStat);
+        startGit(diff + QStringList{QStringLiteral("--staged")} + pathSpecs, &m_stagedNumStat);
+    }
+}
+
+void GitStatusService::startGit(const QStringList &args, QByteArray *output)
+{
+    auto git = new QProcess(this);
+    if (!setupGitProcess(*git, m_workTree, args)) {
+        delete git;
+        m_failed = true;
+        if (m_runningProcesses == 0) {
+            m_runningProcesses = 1;
+            gitFinished();
+        }
+        return;
+    }
+
+    ++m_runningProcesses;
+    const bool isStatus = output == &m_statusOutput;
+    connect(git, &QProcess::finished, this, [this, git, output, isStatus](int exitCode, QProcess::ExitStatus es) {
+        if (es == QProcess::NormalExit && exitCode == 0) {
+            *output = git->readAllStandardOutput();
+        } else if (isStatus) {
+            m_failed = true;
+        }
+        git->deleteLater();
+        gitFinished();
+    });
+    connect(git, &QProcess::errorOccurred, this, [this, git](QProcess::ProcessError pe) {
+        // no finished signal then
+        if (pe == QProcess::FailedToStart) {
+            m_failed = true;
+            git->deleteLater();
+            gitFinished();
+        }
+    });
+    git->start(QProcess::ReadOnly);
+}
+
+void GitStatusService::gitFinished()
+{
+    if (--m_runningProcesses > 0) {
+        return;
+    }
+
+    if (m_failed) {
+        // e.g. no repository (any longer), try again on the next trigger
+        m_running = false;
+        if (!m_runningFull) {
+            m_pendingFiles.unite(m_runningFiles);
+            m_pendingDirs.unite(m_runningDirs);
+        }
+        return;
+    }
+
+    // parse + merge in the background, the lists can have 100k entries
+    m_parseWatcher.setFuture(QtConcurrent::run([status = m_status,
+                                                full = m_runningFull,
+                                                files = m_runningFiles,
+                                                dirs = m_runningDirs,
+                                                trees = m_runningTrees,
+                                                output = std::exchange(m_statusOutput, {}),
+                                                changedNumStat = std::exchange(m_changedNumStat, {}),
+                                                stagedNumStat = std::exchange(m_stagedNumStat, {})]() mutable {
+        auto update = GitUtils::parseStatus(output);
+        GitUtils::parseDiffNumStat(update.changed, changedNumStat);
+        GitUtils::parseDiffNumStat(update.staged, stagedNumStat);
+        if (full) {
+            GitUtils::sortStatus(update);
+            return update;
+        }
+        GitUtils::mergeStatus(status, std::move(update), files, dirs, trees);
+        return status;
+    }));
+}
+
+void GitStatusService::statusReady()
+{
+    m_status = m_parseWatcher.result();
+    m_valid = true;
+    if (m_runningFull) {
+        m_updated.start();
+    }
+    m_running = false;
+
+    // our own index writes are no changes
+    if (!m_gitDir.isEmpty()) {
+        m_index = signature(m_gitDir + QStringLiteral("/index"));
+        m_head = signature(m_gitDir + QStringLiteral("/HEAD"));
+    }
+    updateWatches();
+
+    // a new HEAD, e.g. after a checkout, has other directories
+    if (m_trackedDirsListed && !(m_head == m_trackedDirsHead)) {
+        listTrackedDirs();
+    }
+
+    Q_EMIT statusChanged(m_status);
+
+    // changes during the run
+    if (m_fullPending || !m_pendingFiles.isEmpty() || !m_pendingDirs.isEmpty()) {
+        schedule(100);
+    }
+}
+
+void GitStatusService::updateWatches()
+{
+    if (m_gitDir.isEmpty()) {
+        return;
+    }
+
+    // index + HEAD are replaced by rename, that is a change of their directory
+    QSet<QString> dirs{m_gitDir, QDir::cleanPath(m_workTree)};
+    QSet<QString> files;
+
+    // the budget is shared with the other repositories, what we watch now is ours to reuse
+    const int budget = MaxWatches - (watchesInUse() - m_watches);
+
+    // directories of all files with a status, files get new siblings, are reverted, deleted, ...
+    // modified files are watched themselves, too, not all editors save by rename
+    auto watch = [this, &dirs, &files, budget](const QVector<GitUtils::StatusItem> &items, bool watchFiles) {
+        for (const auto &item : items) {
+            if (dirs.size() + files.size() >= budget) {
+                return;
+            }
+            const QString file = m_workTree + QString::fromUtf8(item.file);
+            dirs.insert(file.left(file.lastIndexOf(QLatin1Char('/'))));
+            if (watchFiles) {
+                files.insert(file);
+            }
+        }
+    };
+    watch(m_status.unmerge, true);
+    watch(m_status.changed, true);
+    watch(m_status.staged, false);
+    watch(m_status.untracked, false);
+
+    // new files in clean directories, the rest of the budget goes to the shallow ones
+    for (const auto &dir : std::as_const(m_trackedDirs)) {
+        if (dirs.size() + files.size() >= budget) {
+            break;
+        }
+        dirs.insert(m_workTree + QString::fromUtf8(dir));
+    }
+
+    const QStringList watchedDirs = m_watcher.directories();
+    const QStringList watchedFiles = m_watcher.files();
+    QStringList remove;
+    for (const auto &path : watchedDirs) {
+        if (!dirs.remove(path)) {
+            remove.append(path);
+        }
+    }
+    for (const auto &path : watchedFiles) {
+        if (!files.remove(path)) {
+            remove.append(path);
+        }
+    }
+    if (!remove.isEmpty()) {
+        m_watcher.removePaths(remove);
+    }
+
+    // deleted files and directories won't be watched, that is fine
+    QStringList add(dirs.cbegin(), dirs.cend());
+    for (const auto &file : std::as_const(files)) {
+        add.append(file);
+    }
+    if (!add.isEmpty()) {
+        m_watcher.addPaths(add);
+    }
+
+    const int watches = m_watcher.directories().size() + m_watcher.files().size();
+    watchesInUse() += watches - m_watches;
+    m_watches = watches;
+}
+
+void GitStatusService::listTrackedDirs()
+{
+    auto git = new QProcess(this);
+    if (!setupGitProcess(*git,
+                         m_workTree,
+                         {QStringLiteral("ls-tree"), QStringLiteral("-r"), QStringLiteral("-d"), QStringLiteral("-z"), QStringLiteral("--name-only"), QStringLiteral("HEAD")})) {
+        delete git;
+        return;
+    }
+
+    m_trackedDirsHead = m_head;
+    connect(git, &QProcess::finished, this, [this, git](int exitCode, QProcess::ExitStatus es) {
+        // no commit yet => nothing is tracked
+        m_trackedDirs.clear();
+        m_trackedDirSet.clear();
+        if (es == QProcess::NormalExit && exitCode == 0) {
+            const QByteArrayList dirs = git->readAllStandardOutput().split('\0');
+            for (const auto &dir : dirs) {
+                if (!dir.isEmpty()) {
+                    m_trackedDirs.append(dir);
+                    m_trackedDirSet.insert(dir);
+                }
+            }
+            std::stable_sort(m_trackedDirs.begin(), m_trackedDirs.end(), [](const QByteArray &l, const QByteArray &r) {
+                return l.count('/') < r.count('/');
+            });
+        }
+        m_trackedDirsListed = true;
+        git->deleteLater();
+        updateWatches();
+    });
+    git->start(QProcess::ReadOnly);
+}
+
+void GitStatusService::directoryChanged(const QString &path)
+{
+    if (path == m_gitDir) {
+        // lots of things change in the git dir, only index + HEAD matter for the status
+        // our own index writes are handled by endIndexWrite
+        const bool indexChanged = m_indexWrites == 0 && !(signature(m_gitDir + QStringLiteral("/index")) == m_index);
+        if (!indexChanged && signature(m_gitDir + QStringLiteral("/HEAD")) == m_head) {
+            return;
+        }
+        m_fullPending = true;
+        schedule(100);
+        return;
+    }
+
+    if (path.startsWith(m_workTree) || path == QDir::cleanPath(m_workTree)) {
+        m_pendingDirs.insert(relativePath(path));
+        schedule(300);
+    }
+}
+
+void GitStatusService::watchedFileChanged(const QString &path)
+{
+    // the watch is gone if the file got replaced, updateWatches adds it again
+    fileChanged(path);
+}
+
+QByteArray GitStatusService::relativePath(const QString &absolutePath) const
+{
+    return absolutePath.mid(m_workTree.size()).toUtf8();
+}
@@ -0,0 +1,168 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+#ifndef GITSTATUSSERVICE_H
+#define GITSTATUSSERVICE_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+#include <memory>
+
+#include "git/gitstatus.h"
+
+class QProcess;
+
+/**
+ * Keeps the git status of one repository up to date, shared by all git widgets showing it.
+ *
+ * Changes are picked up by watching the git dir (index + HEAD), the working tree directories
+ * that contain changed files and, as far as the watch budget allows, the tracked directories.
+ * Triggers are coalesced and never run in parallel.
+ * A change of the index or HEAD updates everything, a change in the working tree only runs
+ * "git status" for the files in the touched directories and below their untracked
+ * subdirectories and merges the result.
+ *
+ * Watches are a budget shared by all repositories. Directory watches miss in place edits of clean
+ * files, so update() runs a full update if the status is older than a few seconds.
+ *
+ * git status honors core.untrackedCache and core.fsmonitor if configured.
+ */
+class GitStatusService : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * The service for the repository with the given working tree, created on first use.
+     * @param workTree top level directory of the working tree, ending with "/"
+     */
+    static std::shared_ptr<GitStatusService> forRepository(const QString &workTree);
+
+    /**
+     * Tell the services of the repositories containing the file that it got saved.
+     * Not needed for files in watched directories, but most files are not.
+     */
+    static void fileSaved(const QString &absolutePath);
+
+    ~GitStatusService() override;
+
+    /**
+     * Full update, coalesced with other requests.
+     */
+    void refresh();
+
+    /**
+     * Make sure a status arrives via statusChanged: the current one if it is up to date and recent, else after an update.
+     */
+    void update();
+
+    /**
+     * The file changed, e.g. a document got saved, update it soon.
+     */
+    void fileChanged(const QString &absolutePath);
+
+    /**
+     * We are about to change the index ourselves, e.g. stage files, that alone doesn't need a full update.
+     */
+    void beginIndexWrite();
+
+    /**
+     * Done with changing the index, update the given files.
+     */
+    void endIndexWrite(const QStringList &absolutePaths);
+
+    /**
+     * Compute lines added/removed, costs an additional git diff per update.
+     */
+    void setNumStat(bool numStat);
+
+    const GitUtils::GitParsedStatus &status() const
+    {
+        return m_status;
+    }
+
+Q_SIGNALS:
+    /**
+     * New status, lists are sorted by file.
+     */
+    void statusChanged(const GitUtils::GitParsedStatus &status);
+
+private:
+    explicit GitStatusService(const QString &workTree);
+
+    struct Signature {
+        QDateTime modified;
+        qint64 size = -1;
+        bool operator==(const Signature &other) const
+        {
+            return modified == other.modified && size == other.size;
+        }
+    };
+    Signature signature(const QString &file) const;
+
+    void schedule(int delay);
+    void start();
+    void startGit(const QStringList &args, QByteArray *output);
+    void gitFinished();
+    void statusReady();
+    void updateWatches();
+    void listTrackedDirs();
+
+    void directoryChanged(const QString &path);
+    void watchedFileChanged(const QString &path);
+    QByteArray relativePath(const QString &absolutePath) const;
+
+    const QString m_workTree;
+    QString m_gitDir;
+    bool m_numStat = false;
+
+    QFileSystemWatcher m_watcher;
+    // our part of the watch budget
+    int m_watches = 0;
+    QTimer m_timer;
+
+    // what to update on the next run
+    bool m_fullPending = true;
+    QSet<QByteArray> m_pendingFiles;
+    QSet<QByteArray> m_pendingDirs;
+
+    // the running update, its scope and outputs
+    bool m_running = false;
+    int m_runningProcesses = 0;
+    bool m_runningFull = false;
+    QSet<QByteArray> m_runningFiles;
+    QSet<QByteArray> m_runningDirs;
+    QSet<QByteArray> m_runningTrees;
+    QByteArray m_statusOutput;
+    QByteArray m_changedNumStat;
+    QByteArray m_stagedNumStat;
+    bool m_failed = false;
+    QFutureWatcher<GitUtils::GitParsedStatus> m_parseWatcher;
+
+    GitUtils::GitParsedStatus m_status;
+    bool m_valid = false;
+    // since the last full update
+    QElapsedTimer m_updated;
+
+    // state of index and HEAD as of our last update, git status itself may write the index
+    Signature m_index;
+    Signature m_head;
+    int m_indexWrites = 0;
+
+    // directories of HEAD, shallow ones first, and the HEAD they were listed for
+    QVector<QByteArray> m_trackedDirs;
+    QSet<QByteArray> m_trackedDirSet;
+    bool m_trackedDirsListed = false;
+    Signature m_trackedDirsHead;
+};
+
+#endif // GITSTATUSSERVICE_H
@@ -12,6 +12,7 @@
 #include "git/gitdiff.h"
 #include "gitcommitdialog.h"
 #include "gitstatusmodel.h"
+#include "gitstatusservice.h"
 #include "kateproject.h"
 #include "kateprojectplugin.h"
 #include "kateprojectpluginview.h"
@@ -40,7 +41,6 @@
 #include <QToolButton>
 #include <QTreeView>
 #include <QVBoxLayout>
-#include <QtConcurrentRun>
 
 #include <KLocalizedString>
 #include <KMessageBox>
@@ -138,13 +138,9 @@ public:
     {
         // top level node
         auto index = sourceModel()->index(sourceRow, 0, parent);
+        // top level nodes are hidden in the view if empty, see GitWidget::hideEmptyTreeNodes
         if (isTopLevel(parent)) {
-            // Staged are always visible
-            if (index.row() == GitStatusModel::ItemType::NodeStage)
-                return true;
-
-            // otherwise visible only if rowCount > 0
-            return sourceModel()->rowCount(index) > 0;
+            return true;
         }
 
         if (!index.isValid()) {
@@ -271,7 +267,10 @@ GitWidget::GitWidget(KateProject *project, KTextEditor::MainWindow *mainWindow,
     auto proxy = new StatusProxyModel(this);
     proxy->setSourceModel(m_model);
 
-    connect(m_filterLineEdit, &QLineEdit::textChanged, proxy, &StatusProxyModel::setFilterText);
+    connect(m_filterLineEdit, &QLineEdit::textChanged, this, [this, proxy](const QString &text) {
+        proxy->setFilterText(text);
+        hideEmptyTreeNodes();
+    });
     connect(m_filterLineEdit, &QLineEdit::textChanged, m_treeView, &QTreeView::expandAll);
 
     m_treeView->setUniformRowHeights(true);
@@ -294,7 +293,15 @@ GitWidget::GitWidget(KateProject *project, KTextEditor::MainWindow *mainWindow,
     // our main view - status view + btns
     m_mainView->setLayout(layout);
 
-    connect(&m_gitStatusWatcher, &QFutureWatcher<GitUtils::GitParsedStatus>::finished, this, &GitWidget::parseStatusReady);
+    m_statusService = GitStatusService::forRepository(m_gitPath);
+    connect(m_statusService.get(), &GitStatusService::statusChanged, this, &GitWidget::parseStatusReady);
+
+    // one status update for the files of all batched operations
+    m_batch = new GitBatch(m_gitPath, m_statusService, this);
+    connect(m_batch, &GitBatch::finished, this, [this]() {
+        m_statusService->setNumStat(m_pluginView->plugin()->showGitStatusWithNumStat());
+    });
+    connect(m_batch, &GitBatch::failed, this, &GitWidget::batchFailed);
     connect(m_commitBtn, &QPushButton::clicked, this, &GitWidget::openCommitChangesDialog);
 
     // single / double click
@@ -366,45 +373,16 @@ QProcess *GitWidget::gitp(const QStringList &arguments)
     return git;
 }
 
-void GitWidget::getStatus(bool untracked, bool submodules)
+void GitWidget::getStatus()
 {
-    auto args = QStringList{QStringLiteral("status"), QStringLiteral("-z")};
-    if (!untracked) {
-        args.append(QStringLiteral("-uno"));
-    } else {
-        args.append(QStringLiteral("-u"));
-    }
-    if (!submodules) {
-        args.append(QStringLiteral("--ignore-submodules"));
-    }
-
-    auto git = gitp(args);
-    connect(git, &QProcess::finished, this, [this, git](int exitCode, QProcess::ExitStatus es) {
-        if (es != QProcess::NormalExit || exitCode != 0) {
-            // no error on status failure
-            //            sendMessage(QString::fromUtf8(git->readAllStandardError()), true);
-        } else {
-            const bool withNumStat = m_pluginView->plugin()->showGitStatusWithNumStat();
-            auto future = QtConcurrent::run(GitUtils::parseStatus, git->readAllStandardOutput(), withNumStat, m_gitPath);
-            m_gitStatusWatcher.setFuture(future);
-        }
-        git->deleteLater();
-    });
-    git->start(QProcess::ReadOnly);
+    m_statusService->setNumStat(m_pluginView->plugin()->showGitStatusWithNumStat());
+    m_statusService->refresh();
 }
 
-void GitWidget::runGitCmd(const QStringList &args, const QString &i18error)
+void GitWidget::updateStatus()
 {
-    auto git = gitp(args);
-    connect(git, &QProcess::finished, this, [this, i18error, git](int exitCode, QProcess::ExitStatus es) {
-        if (es != QProcess::NormalExit || exitCode != 0) {
-            sendMessage(i18error + QStringLiteral(": ") + QString::fromUtf8(git->readAllStandardError()), true);
-        } else {
-            getStatus();
-        }
-        git->deleteLater();
-    });
-    git->start(QProcess::ReadOnly);
+    m_statusService->setNumStat(m_pluginView->plugin()->showGitStatusWithNumStat());
+    m_statusService->update();
 }
 
 void GitWidget::runPushPullCmd(const QStringList &args)
@@ -433,49 +411,45 @@ void GitWidget::runPushPullCmd(const QStringList &args)
 
 void GitWidget::stage(const QStringList &files, bool)
 {
-    if (files.isEmpty()) {
-        return;
-    }
-
-    auto args = QStringList{QStringLiteral("add"), QStringLiteral("-A"), QStringLiteral("--")};
-    args.append(files);
-
-    runGitCmd(args, i18n("Failed to stage file. Error:"));
+    m_batch->add(GitBatch::Stage, files);
 }
 
 void GitWidget::unstage(const QStringList &files)
 {
-    if (files.isEmpty()) {
-        return;
-    }
-
-    // git reset -q HEAD --
-    auto args = QStringList{QStringLiteral("reset"), QStringLiteral("-q"), QStringLiteral("HEAD"), QStringLiteral("--")};
-    args.append(files);
-
-    runGitCmd(args, i18n("Failed to unstage file. Error:"));
+    m_batch->add(GitBatch::Unstage, files);
 }
 
 void GitWidget::discard(const QStringList &files)
 {
-    if (files.isEmpty()) {
-        return;
-    }
-    // discard=>git checkout -q -- xx.cpp
-    auto args = QStringList{QStringLiteral("checkout"), QStringLiteral("-q"), QStringLiteral("--")};
-    args.append(files);
-    runGitCmd(args, i18n("Failed to discard changes. Error:"));
+    m_batch->add(GitBatch::Discard, files);
 }
 
 void GitWidget::clean(const QStringList &files)
 {
-    if (files.isEmpty()) {
-        return;
+    m_batch->add(GitBatch::Clean, files);
+}
+
+void GitWidget::batchFailed(GitBatch::Operation operation, const QString &error)
+{
+    QString message;
+    switch (operation) {
+    case GitBatch::Stage:
+        message = i18n("Failed to stage file. Error:");
+        break;
+    case GitBatch::Unstage:
+        message = i18n("Failed to unstage file. Error:");
+        break;
+    case GitBatch::Discard:
+        message = i18n("Failed to discard changes. Error:");
+        break;
+    case GitBatch::Clean:
+        message = i18n("Failed to remove. Error:");
+        break;
+    case GitBatch::ApplyCached:
+        message = i18n("Failed to stage selection. Error:");
+        break;
     }
-    // discard=>git clean -q -f -- xx.cpp
-    auto args = QStringList{QStringLiteral("clean"), QStringLiteral("-q"), QStringLiteral("-f"), QStringLiteral("--")};
-    args.append(files);
-    runGitCmd(args, i18n("Failed to remove. Error:"));
+    sendMessage(message + QStringLiteral(": ") + error, true);
 }
 
 void GitWidget::openAtHEAD(const QString &file)
@@ -645,33 +619,14 @@ void GitWidget::applyDiff(const QString &fileName, bool staged, bool hunk, KText
         return;
     }
 
-    QTemporaryFile *file = new QTemporaryFile(this);
-    if (!file->open()) {
-        sendMessage(i18n("Failed to stage selection"), true);
-        return;
-    }
-    file->write(diff.toUtf8());
-    file->close();
-
-    auto git = gitp({QStringLiteral("apply"), QStringLiteral("--index"), QStringLiteral("--cached"), file->fileName()});
-
-    connect(git, &QProcess::finished, this, [=](int exitCode, QProcess::ExitStatus es) {
-        if (es != QProcess::NormalExit || exitCode != 0) {
-            sendMessage(i18n("Failed to stage: %1", QString::fromUtf8(git->readAllStandardError())), true);
-        } else {
-            // close and reopen doc to show updated diff
-            if (v && v->document()) {
-                showDiff(fileName, staged);
-            }
-            // must come at the end
-            QTimer::singleShot(10, this, [this] {
-                getStatus();
-            });
+    // staging more hunks while this runs gets them applied together
+    QPointer<KTextEditor::View> view(v);
+    m_batch->apply(diff.toUtf8(), [this, view, fileName, staged] {
+        // close and reopen doc to show updated diff
+        if (view && view->document()) {
+            showDiff(fileName, staged);
         }
-        delete file;
-        git->deleteLater();
     });
-    git->start(QProcess::ReadOnly);
 }
 
 void GitWidget::openCommitChangesDialog(bool amend)
@@ -743,6 +698,14 @@ void GitWidget::treeViewDoubleClicked(const QModelIndex &idx)
 
 void GitWidget::hideEmptyTreeNodes()
 {
+    // staged is always visible, the others only if not empty
+    for (int node : {GitStatusModel::NodeChanges, GitStatusModel::NodeConflict, GitStatusModel::NodeUntrack}) {
+        const bool empty = m_model->rowCount(m_model->getModelIndex(GitStatusModel::ItemType(node))) == 0;
+        if (m_treeView->isRowHidden(node, QModelIndex()) != empty) {
+            m_treeView->setRowHidden(node, QModelIndex(), empty);
+        }
+    }
+
     auto expand = [this](GitStatusModel::ItemType t) {
         auto *model = m_treeView->model();
         auto index = model->index(t, 0);
@@ -762,11 +725,9 @@ void GitWidget::hideEmptyTreeNodes()
     m_treeView->resizeColumnToContents(1);
 }
 
-void GitWidget::parseStatusReady()
+void GitWidget::parseStatusReady(const GitUtils::GitParsedStatus &status)
 {
-    GitUtils::GitParsedStatus s = m_gitStatusWatcher.result();
-
-    m_model->setStatusItems(std::move(s), m_pluginView->plugin()->showGitStatusWithNumStat());
+    m_model->setStatusItems(status, m_pluginView->plugin()->showGitStatusWithNumStat());
     hideEmptyTreeNodes();
 }
 
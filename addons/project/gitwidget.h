@@ -6,21 +6,23 @@
 #ifndef GITWIDGET_H
 #define GITWIDGET_H
 
-#include <QFutureWatcher>
 #include <QPointer>
 #include <QProcess>
 #include <QWidget>
 
+#include <memory>
+
 #include "git/gitstatus.h"
+#include "gitbatch.h"
 
 class QTreeView;
 class QStringListModel;
 class GitStatusModel;
+class GitStatusService;
 class KateProject;
 class QItemSelection;
 class QMenu;
 class QToolButton;
-class QTemporaryFile;
 class KateProjectPluginView;
 class GitWidgetTreeView;
 class QStackedWidget;
@@ -44,7 +46,15 @@ public:
     ~GitWidget();
 
     bool eventFilter(QObject *o, QEvent *e) override;
-    void getStatus(bool untracked = true, bool submodules = false);
+    /**
+     * Update the status now, e.g. after running some git command
+     */
+    void getStatus();
+
+    /**
+     * Show the current status, only updates it if something changed since the last update
+     */
+    void updateStatus();
     KTextEditor::MainWindow *mainWindow();
 
     // will just proxy the message to the plugin view
@@ -67,7 +77,8 @@ private:
     QLineEdit *m_filterLineEdit;
     /** This ends with "/", always remember this */
     QString m_gitPath;
-    QFutureWatcher<GitUtils::GitParsedStatus> m_gitStatusWatcher;
+    std::shared_ptr<GitStatusService> m_statusService;
+    GitBatch *m_batch;
     QString m_commitMessage;
     KTextEditor::MainWindow *m_mainWin;
     QMenu *m_gitMenu;
@@ -83,12 +94,12 @@ private:
 
     void buildMenu();
     void setDotGitPath();
-    void runGitCmd(const QStringList &args, const QString &i18error);
     void runPushPullCmd(const QStringList &args);
     void stage(const QStringList &files, bool = false);
     void unstage(const QStringList &files);
     void discard(const QStringList &files);
     void clean(const QStringList &files);
+    void batchFailed(GitBatch::Operation operation, const QString &error);
     void openAtHEAD(const QString &file);
     void showDiff(const QString &file, bool staged);
     void launchExternalDiffTool(const QString &file, bool staged);
@@ -109,7 +120,7 @@ private:
     void hideCancel();
 
 private Q_SLOTS:
-    void parseStatusReady();
+    void parseStatusReady(const GitUtils::GitParsedStatus &status);
     void openCommitChangesDialog(bool amend = false);
     void handleClick(const QModelIndex &idx, ClickAction clickAction);
     void treeViewSingleClicked(const QModelIndex &idx);
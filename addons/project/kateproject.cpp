@@ -14,6 +14,7 @@
 #include <ktexteditor/document.h>
 
 #include <json_utils.h>
+#include <katetrace.h>
 
 #include <QDir>
 #include <QFile>
@@ -177,6 +178,8 @@ bool KateProject::loadFromData(const QVariantMap &globalProject, const QString &
 
 bool KateProject::load(const QVariantMap &globalProject, bool force)
 {
+    KateTraceZone zone("load project", m_baseDir);
+
     /**
      * no name, bad => bail out
      */
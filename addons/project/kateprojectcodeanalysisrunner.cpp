@@ -0,0 +1,334 @@
+/*  This file is part of the Kate project.
+ *
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#include "kateprojectcodeanalysisrunner.h"
+#include "kateprojectcodeanalysistool.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QThread>
+#include <QtConcurrentMap>
+
+#include <iterator>
+
+// shards per process, a process done early takes another one
+static constexpr int ShardsPerProcess = 4;
+
+static QByteArray hashFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result();
+}
+
+KateProjectCodeAnalysisRunner::KateProjectCodeAnalysisRunner(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_hashWatcher, &QFutureWatcher<QByteArray>::finished, this, &KateProjectCodeAnalysisRunner::hashesReady);
+}
+
+KateProjectCodeAnalysisRunner::~KateProjectCodeAnalysisRunner()
+{
+    m_hashWatcher.cancel();
+    m_hashWatcher.waitForFinished();
+
+    const auto processes = m_processes.keys();
+    for (QProcess *process : processes) {
+        process->blockSignals(true);
+        process->kill();
+        process->waitForFinished();
+        delete process;
+    }
+}
+
+std::vector<QStringList> KateProjectCodeAnalysisRunner::shards(const QStringList &files, int processes, int maxFilesPerProcess)
+{
+    const int count = qMax(1, processes) * ShardsPerProcess;
+    int size = qMax(1, (files.size() + count - 1) / count);
+    if (maxFilesPerProcess > 0) {
+        size = qMin(size, maxFilesPerProcess);
+    }
+
+    std::vector<QStringList> result;
+    for (int i = 0; i < files.size(); i += size) {
+        result.push_back(files.mid(i, size));
+    }
+    return result;
+}
+
+bool KateProjectCodeAnalysisRunner::start(KateProjectCodeAnalysisTool *tool)
+{
+    if (isRunning()) {
+        return true;
+    }
+
+    // ensure we only run the code analyzer from PATH
+    m_executable = QStandardPaths::findExecutable(tool->path());
+    if (m_executable.isEmpty()) {
+        return false;
+    }
+
+    m_running = true;
+    m_tool = tool;
+    m_files = tool->analyzedFiles();
+    // the results depend on how the tool is run, too
+    m_options = m_executable + QLatin1Char('\n') + tool->arguments(QStringList()).join(QLatin1Char('\n'));
+    m_keys.clear();
+    m_reported.clear();
+    m_analyzedFiles = 0;
+    m_success = true;
+    m_exitCode = 0;
+
+    // the cached results about e.g. headers are only valid as long as those are unchanged, too
+    m_hashedFiles = m_files;
+    const QSet<QString> files(m_files.cbegin(), m_files.cend());
+    QSet<QString> others;
+    for (const auto &entry : qAsConst(m_cache[m_options])) {
+        for (auto it = entry.others.keyBegin(); it != entry.others.keyEnd(); ++it) {
+            if (!files.contains(*it) && !others.contains(*it)) {
+                others.insert(*it);
+                m_hashedFiles.append(*it);
+            }
+        }
+    }
+
+    // reading all files takes a while for big projects
+    m_hashWatcher.setFuture(QtConcurrent::mapped(m_hashedFiles, hashFile));
+    return true;
+}
+
+void KateProjectCodeAnalysisRunner::hashesReady()
+{
+    if (!m_tool) {
+        finish();
+        return;
+    }
+
+    for (int i = 0; i < m_hashedFiles.size(); ++i) {
+        m_keys.insert(m_hashedFiles.at(i), m_hashWatcher.resultAt(i));
+    }
+
+    auto &cache = m_cache[m_options];
+    QVector<QStringList> cached;
+    QStringList changed;
+    for (const auto &file : qAsConst(m_files)) {
+        const QByteArray key = m_keys.value(file);
+        const auto it = cache.constFind(file);
+        if (!key.isEmpty() && it != cache.cend() && it->key == key && othersUnchanged(*it)) {
+            cached += it->results;
+        } else {
+            changed.append(file);
+        }
+    }
+
+    // files no longer part of the project
+    const QSet<QString> files(m_files.cbegin(), m_files.cend());
+    for (auto it = cache.begin(); it != cache.end();) {
+        it = files.contains(it.key()) ? std::next(it) : cache.erase(it);
+    }
+
+    emitResults(cached);
+
+    m_analyzedFiles = changed.size();
+    const auto newShards = shards(changed, QThread::idealThreadCount(), m_tool->maxFilesPerProcess());
+    m_pendingShards.assign(newShards.cbegin(), newShards.cend());
+    startShards();
+}
+
+bool KateProjectCodeAnalysisRunner::othersUnchanged(const CacheEntry &entry) const
+{
+    for (auto it = entry.others.cbegin(); it != entry.others.cend(); ++it) {
+        if (m_keys.value(it.key()) != it.value()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void KateProjectCodeAnalysisRunner::startShards()
+{
+    while (m_tool && !m_pendingShards.empty() && m_processes.size() < QThread::idealThreadCount()) {
+        const QStringList files = std::move(m_pendingShards.front());
+        m_pendingShards.pop_front();
+
+        auto process = new QProcess(this);
+        process->setProcessChannelMode(QProcess::MergedChannels);
+        m_processes.insert(process, Shard{files, {}});
+
+        connect(process, &QProcess::readyRead, this, [this, process]() {
+            readOutput(process);
+        });
+        connect(process, &QProcess::finished, this, [this, process](int exitCode, QProcess::ExitStatus es) {
+            shardFinished(process, es == QProcess::NormalExit, exitCode);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError pe) {
+            // no finished signal then
+            if (pe == QProcess::FailedToStart) {
+                shardFinished(process, false, -1);
+            }
+        });
+
+        process->start(m_executable, m_tool->arguments(files));
+
+        /**
+         * write files list and close write channel
+         */
+        const QString stdinMessage = m_tool->stdinMessages(files);
+        if (!stdinMessage.isEmpty()) {
+            process->write(stdinMessage.toLocal8Bit());
+        }
+        process->closeWriteChannel();
+    }
+
+    if (m_processes.isEmpty() && m_hashingShards == 0) {
+        finish();
+    }
+}
+
+void KateProjectCodeAnalysisRunner::readOutput(QProcess *process)
+{
+    const auto it = m_processes.find(process);
+    if (it == m_processes.end() || !m_tool) {
+        return;
+    }
+
+    QVector<QStringList> results;
+    while (process->canReadLine()) {
+        /**
+         * get one line, split it, skip it, if too few elements
+         */
+        const QString line = QString::fromLocal8Bit(process->readLine());
+        const QStringList elements = m_tool->parseLine(line);
+        if (elements.size() < 4) {
+            continue;
+        }
+        results.append(elements);
+    }
+
+    it->results += results;
+    emitResults(results);
+}
+
+void KateProjectCodeAnalysisRunner::shardFinished(QProcess *process, bool normalExit, int exitCode)
+{
+    readOutput(process);
+    const Shard shard = m_processes.take(process);
+    process->deleteLater();
+
+    const bool success = normalExit && m_tool && m_tool->isSuccessfulExitCode(exitCode);
+    if (!success) {
+        // no idea which of the files made it fail, cache none of them
+        m_success = false;
+        m_exitCode = exitCode;
+    } else {
+        // results about other files, e.g. headers, belong to all files of the shard
+        const QSet<QString> files(shard.files.cbegin(), shard.files.cend());
+        QHash<QString, QVector<QStringList>> perFile;
+        QVector<QStringList> others;
+        QHash<QString, QByteArray> otherKeys;
+        QStringList unhashed;
+        for (const auto &result : shard.results) {
+            if (files.contains(result.at(0))) {
+                perFile[result.at(0)].append(result);
+            } else {
+                const QString absolutePath = QFileInfo(result.at(0)).absoluteFilePath();
+                if (files.contains(absolutePath)) {
+                    perFile[absolutePath].append(result);
+                } else {
+                    others.append(result);
+                    // a fixed header must not keep its results, usually it's hashed already
+                    if (!otherKeys.contains(absolutePath)) {
+                        const auto it = m_keys.constFind(absolutePath);
+                        if (it != m_keys.cend()) {
+                            otherKeys.insert(absolutePath, it.value());
+                        } else if (!unhashed.contains(absolutePath)) {
+                            unhashed.append(absolutePath);
+                        }
+                    }
+                }
+            }
+        }
+
+        QHash<QString, CacheEntry> entries;
+        for (const auto &file : shard.files) {
+            const QByteArray key = m_keys.value(file);
+            if (!key.isEmpty()) {
+                entries.insert(file, CacheEntry{key, perFile.value(file) + others, otherKeys});
+            }
+        }
+
+        if (!unhashed.isEmpty()) {
+            // the other headers are read in the background, too, the run is done once they are cached
+            auto watcher = new QFutureWatcher<QByteArray>(this);
+            connect(watcher, &QFutureWatcher<QByteArray>::finished, this, [this, watcher, unhashed, entries, options = m_options]() mutable {
+                watcher->deleteLater();
+                --m_hashingShards;
+                for (int i = 0; i < unhashed.size(); ++i) {
+                    // the next shards about the same header don't need to read it again
+                    const QByteArray key = watcher->resultAt(i);
+                    m_keys.insert(unhashed.at(i), key);
+                    for (auto &entry : entries) {
+                        entry.others.insert(unhashed.at(i), key);
+                    }
+                }
+                cacheResults(options, entries);
+                startShards();
+            });
+            ++m_hashingShards;
+            watcher->setFuture(QtConcurrent::mapped(unhashed, hashFile));
+        } else {
+            cacheResults(m_options, entries);
+        }
+    }
+
+    startShards();
+}
+
+void KateProjectCodeAnalysisRunner::cacheResults(const QString &options, const QHash<QString, CacheEntry> &entries)
+{
+    auto &cache = m_cache[options];
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        cache.insert(it.key(), it.value());
+    }
+}
+
+void KateProjectCodeAnalysisRunner::emitResults(const QVector<QStringList> &results)
+{
+    QVector<QStringList> newResults;
+    for (const auto &result : results) {
+        const QString key = result.join(QLatin1Char('\n'));
+        if (!m_reported.contains(key)) {
+            m_reported.insert(key);
+            newResults.append(result);
+        }
+    }
+
+    if (!newResults.isEmpty()) {
+        Q_EMIT resultsReady(newResults);
+    }
+}
+
+void KateProjectCodeAnalysisRunner::finish()
+{
+    // a process failing to start right away gets here twice
+    if (!m_running) {
+        return;
+    }
+
+    m_running = false;
+    m_tool.clear();
+    m_keys.clear();
+    m_reported.clear();
+    Q_EMIT finished(m_success, m_exitCode, m_analyzedFiles);
+}
@@ -0,0 +1,122 @@
+/*  This file is part of the Kate project.
+ *
+ *  SPDX-FileCopyrightText: 2026 agent <agent@local>
+ *
+ *  SPDX-License-Identifier: LGPL-2.0-or-later
+ */
+
+#ifndef KATE_PROJECT_CODE_ANALYSIS_RUNNER_H
+#define KATE_PROJECT_CODE_ANALYSIS_RUNNER_H
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include <deque>
+#include <vector>
+
+class KateProjectCodeAnalysisTool;
+
+/**
+ * Runs a code analysis tool on its files.
+ *
+ * The files are split into shards that run in parallel, one process per CPU.
+ * The results are cached per file, keyed by the file content and the tool options,
+ * so a rerun only analyzes the files that changed since.
+ */
+class KateProjectCodeAnalysisRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KateProjectCodeAnalysisRunner(QObject *parent = nullptr);
+    ~KateProjectCodeAnalysisRunner() override;
+
+    /**
+     * Start analyzing the files of the tool.
+     * @param tool tool to run, bound to its project already
+     * @return false if the tool is not installed
+     */
+    bool start(KateProjectCodeAnalysisTool *tool);
+
+    bool isRunning() const
+    {
+        return m_running;
+    }
+
+    /**
+     * Split the files into shards, a few per process to keep all busy till the end.
+     * @param files files to analyze
+     * @param processes number of processes to run in parallel
+     * @param maxFilesPerProcess at most that many files per shard, 0 for no limit
+     */
+    static std::vector<QStringList> shards(const QStringList &files, int processes, int maxFilesPerProcess);
+
+Q_SIGNALS:
+    /**
+     * New results, cached ones come first.
+     * @param results file, line, severity, message per result
+     */
+    void resultsReady(const QVector<QStringList> &results);
+
+    /**
+     * Analysis done.
+     * @param exitCode an exit code the tool considers to be a failure or the one of the last process
+     * @param analyzedFiles number of files the tool had to analyze, the rest was cached
+     */
+    void finished(bool success, int exitCode, int analyzedFiles);
+
+private:
+    struct CacheEntry {
+        QByteArray key;
+        QVector<QStringList> results;
+        // the other files the results are about, e.g. headers, and their hash
+        QHash<QString, QByteArray> others;
+    };
+
+    struct Shard {
+        QStringList files;
+        QVector<QStringList> results;
+    };
+
+    void hashesReady();
+    bool othersUnchanged(const CacheEntry &entry) const;
+    void startShards();
+    void readOutput(QProcess *process);
+    void shardFinished(QProcess *process, bool normalExit, int exitCode);
+    void cacheResults(const QString &options, const QHash<QString, CacheEntry> &entries);
+    void emitResults(const QVector<QStringList> &results);
+    void finish();
+
+    QPointer<KateProjectCodeAnalysisTool> m_tool;
+    QString m_executable;
+    QString m_options;
+    QStringList m_files;
+    // the files + the other files of the cached results
+    QStringList m_hashedFiles;
+    QFutureWatcher<QByteArray> m_hashWatcher;
+
+    // tool options => file => results
+    QHash<QString, QHash<QString, CacheEntry>> m_cache;
+    // hashes of the hashed files as of the start
+    QHash<QString, QByteArray> m_keys;
+
+    bool m_running = false;
+    std::deque<QStringList> m_pendingShards;
+    QHash<QProcess *, Shard> m_processes;
+    // finished shards whose results wait for other files to be hashed
+    int m_hashingShards = 0;
+    int m_analyzedFiles = 0;
+    bool m_success = true;
+    int m_exitCode = 0;
+
+    // the same result reported for several files, e.g. for a header, is shown once
+    QSet<QString> m_reported;
+};
+
+#endif
@@ -6,6 +6,7 @@
  */
 
 #include "kateprojectcodeanalysistool.h"
+#include "kateproject.h"
 
 KateProjectCodeAnalysisTool::KateProjectCodeAnalysisTool(QObject *parent)
     : QObject(parent)
@@ -21,6 +22,22 @@ void KateProjectCodeAnalysisTool::setProject(KateProject *project)
     m_project = project;
 }
 
+QStringList KateProjectCodeAnalysisTool::analyzedFiles()
+{
+    if (!m_project) {
+        return {};
+    }
+
+    const QStringList files = filter(m_project->files());
+    setActualFilesCount(files.size());
+    return files;
+}
+
+int KateProjectCodeAnalysisTool::maxFilesPerProcess() const
+{
+    return 0;
+}
+
 bool KateProjectCodeAnalysisTool::isSuccessfulExitCode(int exitCode) const
 {
     return exitCode == 0;
@@ -75,10 +75,16 @@ public:
     virtual QString path() const = 0;
 
     /**
+     * @return the files to analyze, by default the project files that pass filter()
+     * NOTE that this method is not const because here setActualFilesCount is called
+     */
+    virtual QStringList analyzedFiles();
+
+    /**
+     * @param files the files one tool process shall analyze
      * @return arguments required for the tool
-     * NOTE that this method is not const because here setActualFilesCount might be called
      */
-    virtual QStringList arguments() = 0;
+    virtual QStringList arguments(const QStringList &files) = 0;
 
     /**
      * @return warning message when the tool is not installed
@@ -105,12 +111,21 @@ public:
     virtual bool isSuccessfulExitCode(int exitCode) const;
 
     /**
+     * @param files the files one tool process shall analyze
      * @return messages passed to the tool through stdin
      * This is used when the files are not passed as arguments to the tool.
+     */
+    virtual QString stdinMessages(const QStringList &files) = 0;
+
+    /**
+     * The files are analyzed by several processes in parallel and the results
+     * are cached per file. A tool that reports about other files than the ones
+     * it got, e.g. included headers, can be limited to one file per process,
+     * so those results are attributed to the right file.
      *
-     * NOTE that this method is not const because here setActualFilesCount might be called
+     * The default implementation returns 0, no limit.
      */
-    virtual QString stdinMessages() = 0;
+    virtual int maxFilesPerProcess() const;
 
     /**
      * @returns the number of files to be processed after the filter
@@ -7,13 +7,13 @@
 
 #include "kateprojectinfoviewcodeanalysis.h"
 #include "kateproject.h"
+#include "kateprojectcodeanalysisrunner.h"
 #include "kateprojectcodeanalysistool.h"
 #include "kateprojectpluginview.h"
 #include "tools/codeanalysisselector.h"
 
 #include <QFileInfo>
 #include <QHBoxLayout>
-#include <QStandardPaths>
 #include <QToolTip>
 #include <QVBoxLayout>
 
@@ -30,7 +30,7 @@ KateProjectInfoViewCodeAnalysis::KateProjectInfoViewCodeAnalysis(KateProjectPlug
     , m_startStopAnalysis(new QPushButton(i18n("Start Analysis...")))
     , m_treeView(new QTreeView(this))
     , m_model(new QStandardItemModel(m_treeView))
-    , m_analyzer(nullptr)
+    , m_analyzer(new KateProjectCodeAnalysisRunner(this))
     , m_analysisTool(nullptr)
     , m_toolSelector(new QComboBox())
 {
@@ -91,16 +91,12 @@ KateProjectInfoViewCodeAnalysis::KateProjectInfoViewCodeAnalysis(KateProjectPlug
      */
     connect(m_startStopAnalysis, &QPushButton::clicked, this, &KateProjectInfoViewCodeAnalysis::slotStartStopClicked);
     connect(m_treeView, &QTreeView::clicked, this, &KateProjectInfoViewCodeAnalysis::slotClicked);
+    connect(m_analyzer, &KateProjectCodeAnalysisRunner::resultsReady, this, &KateProjectInfoViewCodeAnalysis::slotResultsReady);
+    connect(m_analyzer, &KateProjectCodeAnalysisRunner::finished, this, &KateProjectInfoViewCodeAnalysis::finished);
 }
 
 KateProjectInfoViewCodeAnalysis::~KateProjectInfoViewCodeAnalysis()
 {
-    if (m_analyzer && m_analyzer->state() != QProcess::NotRunning) {
-        m_analyzer->kill();
-        m_analyzer->blockSignals(true);
-        m_analyzer->waitForFinished();
-    }
-    delete m_analyzer;
 }
 
 void KateProjectInfoViewCodeAnalysis::slotToolSelectionChanged(int)
@@ -126,27 +122,16 @@ void KateProjectInfoViewCodeAnalysis::slotStartStopClicked()
     m_model->removeRows(0, m_model->rowCount(), QModelIndex());
 
     /**
-     * launch selected tool
+     * launch selected tool, only changed files are analyzed again
      */
-    delete m_analyzer;
-    m_analyzer = new QProcess;
-    m_analyzer->setProcessChannelMode(QProcess::MergedChannels);
-
-    connect(m_analyzer, &QProcess::readyRead, this, &KateProjectInfoViewCodeAnalysis::slotReadyRead);
-    connect(m_analyzer, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this, &KateProjectInfoViewCodeAnalysis::finished);
-
-    // ensure we only run the code analyzer from PATH
-    const QString fullExecutable = QStandardPaths::findExecutable(m_analysisTool->path());
-    if (!fullExecutable.isEmpty()) {
-        m_analyzer->start(fullExecutable, m_analysisTool->arguments());
-    }
+    const bool started = m_analyzer->start(m_analysisTool);
 
     if (m_messageWidget) {
         delete m_messageWidget;
         m_messageWidget = nullptr;
     }
 
-    if (fullExecutable.isEmpty() || !m_analyzer->waitForStarted()) {
+    if (!started) {
         m_messageWidget = new KMessageWidget(this);
         m_messageWidget->setCloseButtonVisible(true);
         m_messageWidget->setMessageType(KMessageWidget::Warning);
@@ -158,32 +143,14 @@ void KateProjectInfoViewCodeAnalysis::slotStartStopClicked()
     }
 
     m_startStopAnalysis->setEnabled(false);
-
-    /**
-     * write files list and close write channel
-     */
-    const QString stdinMessage = m_analysisTool->stdinMessages();
-    if (!stdinMessage.isEmpty()) {
-        m_analyzer->write(stdinMessage.toLocal8Bit());
-    }
-    m_analyzer->closeWriteChannel();
 }
 
-void KateProjectInfoViewCodeAnalysis::slotReadyRead()
+void KateProjectInfoViewCodeAnalysis::slotResultsReady(const QVector<QStringList> &results)
 {
     /**
      * get results of analysis
      */
-    while (m_analyzer->canReadLine()) {
-        /**
-         * get one line, split it, skip it, if too few elements
-         */
-        QString line = QString::fromLocal8Bit(m_analyzer->readLine());
-        QStringList elements = m_analysisTool->parseLine(line);
-        if (elements.size() < 4) {
-            continue;
-        }
-
+    for (const QStringList &elements : results) {
         /**
          * feed into model
          */
@@ -235,14 +202,14 @@ void KateProjectInfoViewCodeAnalysis::slotClicked(const QModelIndex &index)
     }
 }
 
-void KateProjectInfoViewCodeAnalysis::finished(int exitCode, QProcess::ExitStatus)
+void KateProjectInfoViewCodeAnalysis::finished(bool success, int exitCode)
 {
     m_startStopAnalysis->setEnabled(true);
     m_messageWidget = new KMessageWidget(this);
     m_messageWidget->setCloseButtonVisible(true);
     m_messageWidget->setWordWrap(false);
 
-    if (m_analysisTool->isSuccessfulExitCode(exitCode)) {
+    if (success) {
         // normally 0 is successful but there are exceptions
         m_messageWidget->setMessageType(KMessageWidget::Information);
         m_messageWidget->setText(i18np("Analysis on %1 file finished.", "Analysis on %1 files finished.", m_analysisTool->getActualFilesCount()));
@@ -254,7 +221,7 @@ void KateProjectInfoViewCodeAnalysis::finished(int exitCode, QProcess::ExitStatu
             }
         });
     } else {
-        // unfortunately, output was eaten by slotReadyRead()
+        // unfortunately, output was eaten by the runner
         // TODO: get stderr output, show it here
         m_messageWidget->setMessageType(KMessageWidget::Warning);
         m_messageWidget->setText(i18np("Analysis on %1 file failed with exit code %2.",
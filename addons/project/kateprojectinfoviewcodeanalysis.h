@@ -11,12 +11,12 @@
 #include <QComboBox>
 #include <QLabel>
 #include <QPointer>
-#include <QProcess>
 #include <QPushButton>
 #include <QTreeView>
 #include <QWidget>
 
 class KateProjectPluginView;
+class KateProjectCodeAnalysisRunner;
 class KateProjectCodeAnalysisTool;
 class KMessageWidget;
 class KateProject;
@@ -64,9 +64,10 @@ private Q_SLOTS:
     void slotStartStopClicked();
 
     /**
-     * More checker output is available
+     * More checker results are available
+     * @param results file, line, severity, message per result
      */
-    void slotReadyRead();
+    void slotResultsReady(const QVector<QStringList> &results);
 
     /**
      * item got clicked, do stuff, like open document
@@ -76,10 +77,10 @@ private Q_SLOTS:
 
     /**
      * Analysis finished
+     * @param success did all analyzer processes succeed
      * @param exitCode analyzer process exit code
-     * @param exitStatus analyzer process exit status
      */
-    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+    void finished(bool success, int exitCode);
 
 private:
     /**
@@ -113,9 +114,9 @@ private:
     QStandardItemModel *m_model;
 
     /**
-     * running analyzer process
+     * runs the analyzer processes, keeps the results of unchanged files
      */
-    QProcess *m_analyzer;
+    KateProjectCodeAnalysisRunner *m_analyzer;
 
     /**
      * currently selected tool
@@ -7,6 +7,7 @@
 
 #include "kateprojectplugin.h"
 
+#include "gitstatusservice.h"
 #include "kateproject.h"
 #include "kateprojectconfigpage.h"
 #include "kateprojectpluginview.h"
@@ -274,6 +275,11 @@ void KateProjectPlugin::slotDocumentCreated(KTextEditor::Document *document)
 {
     connect(document, &KTextEditor::Document::documentUrlChanged, this, &KateProjectPlugin::slotDocumentUrlChanged);
     connect(document, &KTextEditor::Document::destroyed, this, &KateProjectPlugin::slotDocumentDestroyed);
+    connect(document, &KTextEditor::Document::documentSavedOrUploaded, this, [](KTextEditor::Document *document) {
+        if (document->url().isLocalFile()) {
+            GitStatusService::fileSaved(document->url().toLocalFile());
+        }
+    });
 
     slotDocumentUrlChanged(document);
 }
@@ -285,6 +291,7 @@ void KateProjectPlugin::slotDocumentDestroyed(QObject *document)
     }
 
     m_document2Project.remove(document);
+    m_changeMarks.removeDocument(document);
 }
 
 void KateProjectPlugin::slotDocumentUrlChanged(KTextEditor::Document *document)
@@ -304,6 +311,8 @@ void KateProjectPlugin::slotDocumentUrlChanged(KTextEditor::Document *document)
     if (KateProject *project = m_document2Project.value(document)) {
         project->registerDocument(document);
     }
+
+    m_changeMarks.setDocument(document, m_document2Project.contains(document));
 }
 
 void KateProjectPlugin::slotDirectoryChanged(const QString &path)
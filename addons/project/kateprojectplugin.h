@@ -18,6 +18,7 @@
 
 #include <KXMLGUIClient>
 
+#include "gitchangemarks.h"
 #include "kateprojectcompletion.h"
 
 class KateProject;
@@ -237,6 +238,9 @@ private:
      * thread pool for our workers
      */
     QThreadPool m_threadPool;
+
+    // added/modified/deleted lines of the documents in projects
+    GitChangeMarks m_changeMarks;
 };
 
 #endif
@@ -468,7 +468,7 @@ void KateProjectPluginView::slotCurrentChanged(int index)
     // update git focus proxy + update status
     if (QWidget *current = m_stackedgitViews->currentWidget()) {
         m_stackedgitViews->setFocusProxy(current);
-        static_cast<GitWidget *>(current)->getStatus();
+        static_cast<GitWidget *>(current)->updateStatus();
     }
 
     // project file name might have changed
@@ -715,7 +715,7 @@ void KateProjectPluginView::slotUpdateStatus(bool visible)
     }
 
     if (auto widget = m_stackedgitViews->currentWidget()) {
-        static_cast<GitWidget *>(widget)->getStatus();
+        static_cast<GitWidget *>(widget)->updateStatus();
     }
 }
 
@@ -68,9 +68,11 @@ void KateProjectTreeViewContextMenu::exec(const QString &filename, const QModelI
 
     QAction *addFile = nullptr;
     QAction *addFolder = nullptr;
+    QAction *openAll = nullptr;
     if (index.data(KateProjectItem::TypeRole).toInt() == KateProjectItem::Directory) {
         addFile = menu.addAction(QIcon::fromTheme(QStringLiteral("document-new")), i18n("Add File"));
         addFolder = menu.addAction(QIcon::fromTheme(QStringLiteral("folder-new")), i18n("Add Folder"));
+        openAll = menu.addAction(QIcon::fromTheme(QStringLiteral("document-open")), i18n("Open All Files"));
     }
 
     // we can ATM only handle file renames
@@ -219,6 +221,8 @@ void KateProjectTreeViewContextMenu::exec(const QString &filename, const QModelI
             if (!name.isEmpty()) {
                 parent->addFile(index, name);
             }
+        } else if (openAll && action == openAll) {
+            parent->openAllFiles(index);
         } else if (addFolder && action == addFolder) {
             QString name = getName();
             if (!name.isEmpty()) {
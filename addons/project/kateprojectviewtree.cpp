@@ -18,6 +18,8 @@
 #include <QContextMenuEvent>
 #include <QDir>
 
+#include <functional>
+
 #include <KLocalizedString>
 
 KateProjectViewTree::KateProjectViewTree(KateProjectPluginView *pluginView, KateProject *project)
@@ -112,6 +114,35 @@ void KateProjectViewTree::openSelectedDocument()
     }
 }
 
+void KateProjectViewTree::openAllFiles(const QModelIndex &index)
+{
+    /**
+     * the files as shown, filtered and sorted
+     */
+    QList<QUrl> urls;
+    std::function<void(const QModelIndex &)> collect = [this, &urls, &collect](const QModelIndex &parent) {
+        for (int row = 0; row < model()->rowCount(parent); ++row) {
+            const QModelIndex child = model()->index(row, 0, parent);
+            if (child.data(KateProjectItem::TypeRole).toInt() == KateProjectItem::File) {
+                urls.push_back(QUrl::fromLocalFile(child.data(Qt::UserRole).toString()));
+            } else {
+                collect(child);
+            }
+        }
+    };
+    collect(index);
+
+    /**
+     * one batch for the main window, it reads the files ahead and updates its views once,
+     * open one by one if it can't
+     */
+    if (!QMetaObject::invokeMethod(m_pluginView->mainWindow()->window(), "openUrls", Q_ARG(QList<QUrl>, urls))) {
+        for (const auto &url : qAsConst(urls)) {
+            m_pluginView->mainWindow()->openUrl(url);
+        }
+    }
+}
+
 void KateProjectViewTree::addFile(const QModelIndex &idx, const QString &fileName)
 {
     auto proxyModel = static_cast<QSortFilterProxyModel *>(model());
@@ -53,6 +53,11 @@ public:
      */
     void openSelectedDocument();
 
+    /**
+     * Open all files shown below the directory at @p index in one go.
+     */
+    void openAllFiles(const QModelIndex &index);
+
     /**
      * Add a new file
      */
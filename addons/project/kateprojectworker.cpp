@@ -9,6 +9,7 @@
 #include "kateprojectitem.h"
 
 #include <gitprocess.h>
+#include <katetrace.h>
 
 #include <QDir>
 #include <QDirIterator>
@@ -38,6 +39,8 @@ KateProjectWorker::KateProjectWorker(const QString &baseDir, const QString &inde
 
 void KateProjectWorker::run()
 {
+    KateTraceZone zone("KateProjectWorker", m_baseDir);
+
     /**
      * Create dummy top level parent item and empty map inside shared pointers
      * then load the project recursively
@@ -92,6 +95,7 @@ void KateProjectWorker::run()
      * create new index, this will do the loading in the constructor
      * wrap it into shared pointer for transfer to main thread
      */
+    KateTraceZone indexZone("KateProjectIndex", m_baseDir);
     KateProjectSharedProjectIndex index(new KateProjectIndex(m_baseDir, m_indexDir, files, ctagsMap, m_force));
     Q_EMIT loadIndexDone(index);
 }
@@ -51,7 +51,7 @@ static QString buildDirectory(const QVariantMap &projectMap)
     return buildDir;
 }
 
-QStringList KateProjectCodeAnalysisToolClazy::arguments()
+QStringList KateProjectCodeAnalysisToolClazy::arguments(const QStringList &files)
 {
     if (!m_project) {
         return {};
@@ -64,10 +64,7 @@ QStringList KateProjectCodeAnalysisToolClazy::arguments()
         args = QStringList{QStringLiteral("-p"), compileCommandsDir};
     }
 
-    const QStringList fileList = filter(m_project->files());
-    setActualFilesCount(fileList.size());
-
-    return args << fileList;
+    return args << files;
 }
 
 QString KateProjectCodeAnalysisToolClazy::notInstalledMessage() const
@@ -106,11 +103,17 @@ QStringList KateProjectCodeAnalysisToolClazy::parseLine(const QString &line) con
     return {file, lineNo, severity, msg};
 }
 
-QString KateProjectCodeAnalysisToolClazy::stdinMessages()
+QString KateProjectCodeAnalysisToolClazy::stdinMessages(const QStringList &)
 {
     return QString();
 }
 
+int KateProjectCodeAnalysisToolClazy::maxFilesPerProcess() const
+{
+    // warnings in headers belong to the file that includes them
+    return 1;
+}
+
 QString KateProjectCodeAnalysisToolClazy::compileCommandsDirectory() const
 {
     QString buildDir = buildDirectory(m_project->projectMap());
@@ -26,13 +26,15 @@ public:
 
     QString path() const override;
 
-    QStringList arguments() override;
+    QStringList arguments(const QStringList &files) override;
 
     QString notInstalledMessage() const override;
 
     QStringList parseLine(const QString &line) const override;
 
-    QString stdinMessages() override;
+    QString stdinMessages(const QStringList &files) override;
+
+    int maxFilesPerProcess() const override;
 
     QString compileCommandsDirectory() const;
 };
@@ -25,22 +25,12 @@ QString KateProjectCodeAnalysisToolClazyCurrent::description() const
     return i18n("clang-tidy is a clang-based C++ “linter” tool");
 }
 
-QStringList KateProjectCodeAnalysisToolClazyCurrent::arguments()
+QStringList KateProjectCodeAnalysisToolClazyCurrent::analyzedFiles()
 {
     if (!m_project || !m_mainWindow || !m_mainWindow->activeView()) {
         return {};
     }
 
-    QString compileCommandsDir = compileCommandsDirectory();
-
-    QStringList args;
-    if (!compileCommandsDir.isEmpty()) {
-        args << QStringList{QStringLiteral("-p"), compileCommandsDir};
-    }
     setActualFilesCount(1);
-
-    const QString file = m_mainWindow->activeView()->document()->url().toLocalFile();
-    args.append(file);
-
-    return args;
+    return {m_mainWindow->activeView()->document()->url().toLocalFile()};
 }
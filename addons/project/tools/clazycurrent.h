@@ -16,7 +16,7 @@ public:
 
     QString name() const override;
     QString description() const override;
-    QStringList arguments() override;
+    QStringList analyzedFiles() override;
 };
 
 #endif // KATEPROJECTCODEANALYSISTOOLCLANGTIDY_H
@@ -10,7 +10,6 @@
 
 #include <KLocalizedString>
 #include <QRegularExpression>
-#include <QThread>
 
 KateProjectCodeAnalysisToolCppcheck::KateProjectCodeAnalysisToolCppcheck(QObject *parent)
     : KateProjectCodeAnalysisTool(parent)
@@ -48,12 +47,14 @@ QString KateProjectCodeAnalysisToolCppcheck::path() const
     return QStringLiteral("cppcheck");
 }
 
-QStringList KateProjectCodeAnalysisToolCppcheck::arguments()
+QStringList KateProjectCodeAnalysisToolCppcheck::arguments(const QStringList &)
 {
     QStringList _args;
 
-    _args << QStringLiteral("-q") << QStringLiteral("-f") << QStringLiteral("-j") + QString::number(QThread::idealThreadCount())
-          << QStringLiteral("--inline-suppr") << QStringLiteral("--enable=all") << QStringLiteral("--template={file}////{line}////{severity}////{message}")
+    // no -j, there is one process per CPU already
+    // no whole program checks like unusedFunction, each process sees only some of the files and the results are cached per file
+    _args << QStringLiteral("-q") << QStringLiteral("-f") << QStringLiteral("--inline-suppr")
+          << QStringLiteral("--enable=warning,style,performance,portability,information") << QStringLiteral("--template={file}////{line}////{severity}////{message}")
           << QStringLiteral("--file-list=-");
 
     return _args;
@@ -69,15 +70,8 @@ QStringList KateProjectCodeAnalysisToolCppcheck::parseLine(const QString &line)
     return line.split(QLatin1String("////"), Qt::SkipEmptyParts);
 }
 
-QString KateProjectCodeAnalysisToolCppcheck::stdinMessages()
+QString KateProjectCodeAnalysisToolCppcheck::stdinMessages(const QStringList &files)
 {
     // filenames are written to stdin (--file-list=-)
-
-    if (!m_project) {
-        return QString();
-    }
-
-    auto &&fileList = filter(m_project->files());
-    setActualFilesCount(fileList.size());
-    return fileList.join(QLatin1Char('\n'));
+    return files.join(QLatin1Char('\n'));
 }
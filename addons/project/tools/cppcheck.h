@@ -30,13 +30,13 @@ public:
 
     QString path() const override;
 
-    QStringList arguments() override;
+    QStringList arguments(const QStringList &files) override;
 
     QString notInstalledMessage() const override;
 
     QStringList parseLine(const QString &line) const override;
 
-    QString stdinMessages() override;
+    QString stdinMessages(const QStringList &files) override;
 };
 
 #endif // KATE_PROJECT_CODE_ANALYSIS_TOOL_CPPCHECK_H
@@ -52,7 +52,7 @@ QString KateProjectCodeAnalysisToolFlake8::path() const
     return QStringLiteral("flake8");
 }
 
-QStringList KateProjectCodeAnalysisToolFlake8::arguments()
+QStringList KateProjectCodeAnalysisToolFlake8::arguments(const QStringList &files)
 {
     QStringList _args;
 
@@ -63,13 +63,7 @@ QStringList KateProjectCodeAnalysisToolFlake8::arguments()
            */
           << QStringLiteral("--format=%(path)s////%(row)d////%(code)s////%(text)s");
 
-    if (m_project) {
-        auto &&fileList = filter(m_project->files());
-        setActualFilesCount(fileList.size());
-        _args.append(fileList);
-    }
-
-    return _args;
+    return _args << files;
 }
 
 QString KateProjectCodeAnalysisToolFlake8::notInstalledMessage() const
@@ -82,7 +76,7 @@ QStringList KateProjectCodeAnalysisToolFlake8::parseLine(const QString &line) co
     return line.split(QLatin1String("////"), Qt::SkipEmptyParts);
 }
 
-QString KateProjectCodeAnalysisToolFlake8::stdinMessages()
+QString KateProjectCodeAnalysisToolFlake8::stdinMessages(const QStringList &)
 {
     return QString();
 }
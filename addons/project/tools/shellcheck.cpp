@@ -47,7 +47,7 @@ QString KateProjectCodeAnalysisToolShellcheck::path() const
     return QStringLiteral("shellcheck");
 }
 
-QStringList KateProjectCodeAnalysisToolShellcheck::arguments()
+QStringList KateProjectCodeAnalysisToolShellcheck::arguments(const QStringList &files)
 {
     QStringList _args;
 
@@ -60,13 +60,7 @@ QStringList KateProjectCodeAnalysisToolShellcheck::arguments()
 
     _args << QStringLiteral("--format=gcc");
 
-    if (m_project) {
-        auto &&fileList = filter(m_project->files());
-        setActualFilesCount(fileList.size());
-        _args.append(fileList);
-    }
-
-    return _args;
+    return _args << files;
 }
 
 QString KateProjectCodeAnalysisToolShellcheck::notInstalledMessage() const
@@ -102,7 +96,7 @@ bool KateProjectCodeAnalysisToolShellcheck::isSuccessfulExitCode(int exitCode) c
     return exitCode == 0 || exitCode == 1;
 }
 
-QString KateProjectCodeAnalysisToolShellcheck::stdinMessages()
+QString KateProjectCodeAnalysisToolShellcheck::stdinMessages(const QStringList &)
 {
     return QString();
 }
@@ -29,7 +29,7 @@ public:
 
     QString path() const override;
 
-    QStringList arguments() override;
+    QStringList arguments(const QStringList &files) override;
 
     QString notInstalledMessage() const override;
 
@@ -37,5 +37,5 @@ public:
 
     bool isSuccessfulExitCode(int exitCode) const override;
 
-    QString stdinMessages() override;
+    QString stdinMessages(const QStringList &files) override;
 };
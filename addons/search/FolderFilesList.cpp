@@ -12,6 +12,8 @@
 #include <QFileInfoList>
 #include <QtConcurrent>
 
+#include <katetrace.h>
+
 #include <unordered_set>
 #include <vector>
 
@@ -30,6 +32,8 @@ FolderFilesList::~FolderFilesList()
 
 void FolderFilesList::run()
 {
+    KateTraceZone zone("FolderFilesList", m_folder);
+
     m_files.clear();
 
     /**
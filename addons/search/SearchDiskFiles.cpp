@@ -7,6 +7,8 @@
 
 #include "SearchDiskFiles.h"
 
+#include <katetrace.h>
+
 #include <QDir>
 #include <QElapsedTimer>
 #include <QTextStream>
@@ -23,6 +25,8 @@ SearchDiskFiles::SearchDiskFiles(SearchDiskFilesWorkList &worklist, const QRegul
 
 void SearchDiskFiles::run()
 {
+    KateTraceZone zone("SearchDiskFiles");
+
     // do we need to search multiple lines?
     const bool multiLineSearch = m_regExp.pattern().contains(QLatin1String("\\n"));
 
@@ -0,0 +1,123 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "compiledb_test.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <compiledb.h>
+
+QTEST_MAIN(CompileDBTest)
+
+static bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        return false;
+    }
+    return file.write(content) == content.size();
+}
+
+void CompileDBTest::parse()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString a = CompileDB::canonicalPath(dir.filePath(QStringLiteral("a.cpp")));
+    const QString b = CompileDB::canonicalPath(dir.filePath(QStringLiteral("b.cpp")));
+    const QString c = CompileDB::canonicalPath(dir.filePath(QStringLiteral("c.cpp")));
+
+    const QByteArray json = QStringLiteral(
+                                "[\n"
+                                "  {\"directory\": \"%1\", \"command\": \"g++ -c a.cpp\", \"file\": \"%1/a.cpp\"},\n"
+                                "  {\"directory\": \"%1\", \"command\": \"g++ -DX=\\\"}{\\\" -c b.cpp\", \"file\": \"b.cpp\"},\n"
+                                "  {\"directory\": \"%1\", \"arguments\": [\"clang++\", \"-c\", \"c.cpp\"], \"file\": \"c.cpp\"},\n"
+                                "  {\"directory\": \"%1\", \"command\": \"g++ -O2 -c a.cpp\", \"file\": \"a.cpp\"}\n"
+                                "]\n")
+                                .arg(dir.path())
+                                .toUtf8();
+
+    const auto commands = CompileDB::parse(json);
+    QCOMPARE(commands.size(), 3);
+    // the first entry of a file wins
+    QCOMPARE(commands.value(a), QStringLiteral("g++ -c a.cpp"));
+    // braces in strings don't end the entry
+    QCOMPARE(commands.value(b), QStringLiteral("g++ -DX=\"}{\" -c b.cpp"));
+    QCOMPARE(commands.value(c), QStringLiteral("clang++ -c c.cpp"));
+
+    QVERIFY(CompileDB::parse(QByteArray()).isEmpty());
+    QVERIFY(CompileDB::parse(QByteArrayLiteral("{\"file\": \"a.cpp\"}")).isEmpty());
+}
+
+void CompileDBTest::canonicalPath()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkdir(QStringLiteral("sub")));
+
+    // the file itself needs not exist
+    const QString path = CompileDB::canonicalPath(dir.filePath(QStringLiteral("sub/../a.cpp")));
+    QCOMPARE(path, CompileDB::canonicalPath(dir.filePath(QStringLiteral("a.cpp"))));
+    QVERIFY(path.endsWith(QLatin1String("/a.cpp")));
+    QVERIFY(!path.contains(QLatin1String("..")));
+}
+
+void CompileDBTest::reloadChanged()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString compileCommands = dir.filePath(QStringLiteral("compile_commands.json"));
+    const QString file = dir.filePath(QStringLiteral("a.cpp"));
+    const QByteArray entry = "[{\"directory\": \"" + dir.path().toUtf8() + "\", \"command\": \"%1\", \"file\": \"a.cpp\"}]";
+    QVERIFY(writeFile(compileCommands, QByteArray(entry).replace("%1", "g++ -c a.cpp")));
+
+    QObject context;
+    QString command;
+    int calls = 0;
+    auto done = [&command, &calls](const QString &c) {
+        command = c;
+        ++calls;
+    };
+
+    // loaded on a worker
+    CompileDB::commandForFile(compileCommands, file, &context, done);
+    QTRY_COMPARE(calls, 1);
+    QCOMPARE(command, QStringLiteral("g++ -c a.cpp"));
+
+    // answered right away once loaded
+    CompileDB::commandForFile(compileCommands, dir.filePath(QStringLiteral("b.cpp")), &context, done);
+    QCOMPARE(calls, 2);
+    QVERIFY(command.isEmpty());
+
+    // a changed database is read again
+    QVERIFY(writeFile(compileCommands, QByteArray(entry).replace("%1", "clang++ -c a.cpp")));
+    {
+        QFile f(compileCommands);
+        QVERIFY(f.open(QFile::ReadWrite));
+        QVERIFY(f.setFileTime(QDateTime::currentDateTime().addSecs(10), QFileDevice::FileModificationTime));
+    }
+    CompileDB::commandForFile(compileCommands, file, &context, done);
+    QTRY_COMPARE(calls, 3);
+    QCOMPARE(command, QStringLiteral("clang++ -c a.cpp"));
+
+    // nothing for a context gone meanwhile
+    QVERIFY(writeFile(compileCommands, QByteArray(entry).replace("%1", "g++ -c a.cpp")));
+    {
+        QFile f(compileCommands);
+        QVERIFY(f.open(QFile::ReadWrite));
+        QVERIFY(f.setFileTime(QDateTime::currentDateTime().addSecs(20), QFileDevice::FileModificationTime));
+    }
+    {
+        QObject gone;
+        CompileDB::commandForFile(compileCommands, file, &gone, done);
+    }
+    CompileDB::commandForFile(compileCommands, file, &context, done);
+    QTRY_COMPARE(calls, 4);
+    QCOMPARE(command, QStringLiteral("g++ -c a.cpp"));
+}
@@ -0,0 +1,19 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+
+class CompileDBTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void parse();
+    void canonicalPath();
+    void reloadChanged();
+};
@@ -0,0 +1,164 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "instanceregistry_test.h"
+#include "kateinstanceregistry.h"
+
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QFile>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QTest>
+
+QTEST_MAIN(InstanceRegistryTest)
+
+/**
+ * Entry for some process that is alive, but not us, our own entry is never returned.
+ */
+static KateInstanceRegistry::Entry entry(const QString &serviceName, qint64 pid, const QString &session)
+{
+    KateInstanceRegistry::Entry entry;
+    entry.serviceName = serviceName;
+    entry.pid = pid;
+    entry.sessionName = session;
+    entry.desktop = 2;
+    entry.activities = QStringList{QStringLiteral("work")};
+    entry.currentActivity = QStringLiteral("work");
+    entry.updated = 42;
+    return entry;
+}
+
+void InstanceRegistryTest::writeAndRead()
+{
+    QTemporaryDir dir;
+    QProcess sleeper;
+    sleeper.start(QStringLiteral("sleep"), {QStringLiteral("30")});
+    if (!sleeper.waitForStarted()) {
+        QSKIP("no sleep to have some other process around");
+    }
+
+    const QString directory = dir.filePath(QStringLiteral("instances"));
+    QVERIFY(KateInstanceRegistry::runningInstances(directory).empty());
+    QVERIFY(KateInstanceRegistry::writeEntry(directory, entry(QStringLiteral("org.kde.kate-1"), sleeper.processId(), QStringLiteral("project"))));
+
+    const auto entries = KateInstanceRegistry::runningInstances(directory);
+    QCOMPARE(entries.size(), size_t(1));
+    QCOMPARE(entries[0].serviceName, QStringLiteral("org.kde.kate-1"));
+    QCOMPARE(entries[0].pid, sleeper.processId());
+    QCOMPARE(entries[0].sessionName, QStringLiteral("project"));
+    QCOMPARE(entries[0].desktop, 2);
+    QCOMPARE(entries[0].activities, QStringList{QStringLiteral("work")});
+    QCOMPARE(entries[0].currentActivity, QStringLiteral("work"));
+    QCOMPARE(entries[0].updated, qint64(42));
+
+    // updates replace the entry
+    QVERIFY(KateInstanceRegistry::writeEntry(directory, entry(QStringLiteral("org.kde.kate-1"), sleeper.processId(), QStringLiteral("other"))));
+    QCOMPARE(KateInstanceRegistry::runningInstances(directory).at(0).sessionName, QStringLiteral("other"));
+
+    sleeper.kill();
+    sleeper.waitForFinished();
+}
+
+void InstanceRegistryTest::staleEntries()
+{
+    QTemporaryDir dir;
+    QProcess finished;
+    finished.start(QStringLiteral("true"), QStringList());
+    if (!finished.waitForStarted()) {
+        QSKIP("no true to have some process that exited");
+    }
+    const qint64 pid = finished.processId();
+    QVERIFY(finished.waitForFinished());
+
+    // left behind by a crashed instance
+    const QString directory = dir.filePath(QStringLiteral("instances"));
+    QVERIFY(KateInstanceRegistry::writeEntry(directory, entry(QStringLiteral("org.kde.kate-2"), pid, QStringLiteral("crashed"))));
+    QVERIFY(QFile::exists(directory + QStringLiteral("/org.kde.kate-2")));
+
+    QVERIFY(KateInstanceRegistry::runningInstances(directory).empty());
+    QVERIFY(!QFile::exists(directory + QStringLiteral("/org.kde.kate-2")));
+}
+
+void InstanceRegistryTest::benchmarkLookup()
+{
+    // what a "kate file.cpp" does with a few instances around, compare with one DBus round trip per instance
+    QTemporaryDir dir;
+    QProcess sleeper;
+    sleeper.start(QStringLiteral("sleep"), {QStringLiteral("30")});
+    if (!sleeper.waitForStarted()) {
+        QSKIP("no sleep to have some other process around");
+    }
+
+    const QString directory = dir.filePath(QStringLiteral("instances"));
+    for (int i = 0; i < 8; ++i) {
+        QVERIFY(KateInstanceRegistry::writeEntry(directory, entry(QStringLiteral("org.kde.kate-%1").arg(i), sleeper.processId(), QString::number(i))));
+    }
+
+    QBENCHMARK {
+        QCOMPARE(KateInstanceRegistry::runningInstances(directory).size(), size_t(8));
+    }
+
+    sleeper.kill();
+    sleeper.waitForFinished();
+}
+
+void InstanceRegistryTest::benchmarkHandoff()
+{
+    // open-to-visible latency of "kate file.cpp", the launcher exits once the running instance opened and activated it
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        QSKIP("no session bus to hand over files");
+    }
+    const QStringList services = QDBusConnection::sessionBus().interface()->registeredServiceNames();
+    for (const QString &service : services) {
+        if (service.startsWith(QLatin1String("org.kde.kate"))) {
+            QSKIP("another Kate instance would get the files");
+        }
+    }
+
+    // a private runtime directory for the registry, private config for the instance
+    QTemporaryDir dir;
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("QT_QPA_PLATFORM"), QStringLiteral("offscreen"));
+    env.insert(QStringLiteral("XDG_RUNTIME_DIR"), dir.path());
+    env.insert(QStringLiteral("XDG_CONFIG_HOME"), dir.filePath(QStringLiteral("config")));
+    env.insert(QStringLiteral("XDG_DATA_HOME"), dir.filePath(QStringLiteral("data")));
+    env.remove(QStringLiteral("KATE_PID"));
+
+    QProcess instance;
+    instance.setProcessEnvironment(env);
+    instance.start(QStringLiteral(KATE_EXECUTABLE), {QStringLiteral("--startanon")});
+    if (!instance.waitForStarted()) {
+        QSKIP("could not start a Kate instance");
+    }
+    const QString directory = dir.filePath(QStringLiteral("kate-instances"));
+    QTRY_VERIFY_WITH_TIMEOUT(!KateInstanceRegistry::runningInstances(directory).empty(), 30000);
+
+    int count = 0;
+    QBENCHMARK {
+        const QString fileName = dir.filePath(QStringLiteral("file%1.cpp").arg(++count));
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.close();
+
+        QProcess launcher;
+        launcher.setProcessEnvironment(env);
+        launcher.start(QStringLiteral(KATE_EXECUTABLE), {fileName});
+        const bool handedOver = launcher.waitForFinished(10000);
+        if (!handedOver) {
+            launcher.kill();
+            launcher.waitForFinished();
+        }
+        QVERIFY2(handedOver, "the file was not handed over to the running instance");
+        QCOMPARE(launcher.exitCode(), 0);
+    }
+
+    instance.terminate();
+    if (!instance.waitForFinished(5000)) {
+        instance.kill();
+        instance.waitForFinished();
+    }
+}
@@ -0,0 +1,20 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+
+class InstanceRegistryTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void writeAndRead();
+    void staleEntries();
+    void benchmarkLookup();
+    void benchmarkHandoff();
+};
@@ -0,0 +1,72 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "lazypluginview_test.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+#include <QXmlStreamReader>
+
+QTEST_MAIN(LazyPluginViewTest)
+
+static QJsonObject lazyActivation(const QString &metaDataFile)
+{
+    QFile file(metaDataFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return QJsonDocument::fromJson(file.readAll()).object().value(QStringLiteral("X-Kate-LazyActivation")).toObject();
+}
+
+void LazyPluginViewTest::placeholderActions_data()
+{
+    QTest::addColumn<QString>("metaDataFile");
+
+    QDirIterator it(QStringLiteral(KATE_ADDONS_DIR), {QStringLiteral("*.json")}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString metaDataFile = it.next();
+        if (!lazyActivation(metaDataFile).value(QStringLiteral("XmlGui")).isUndefined()) {
+            QTest::newRow(qPrintable(QFileInfo(metaDataFile).fileName())) << metaDataFile;
+        }
+    }
+}
+
+void LazyPluginViewTest::placeholderActions()
+{
+    QFETCH(QString, metaDataFile);
+
+    // the placeholders stand in for every action the menus of the plugin's ui.rc show
+    const QJsonObject lazy = lazyActivation(metaDataFile);
+    QStringList declared;
+    const QJsonArray actions = lazy.value(QStringLiteral("Actions")).toArray();
+    for (const auto &action : actions) {
+        declared.push_back(action.toObject().value(QStringLiteral("Name")).toString());
+    }
+
+    const QString uiFile = lazy.value(QStringLiteral("XmlGui")).toObject().value(QStringLiteral("File")).toString();
+    QFile file(QFileInfo(metaDataFile).dir().filePath(uiFile));
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(file.fileName()));
+
+    QStringList used;
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement && xml.name() == QLatin1String("Action")) {
+            used.push_back(xml.attributes().value(QStringLiteral("name")).toString());
+        }
+    }
+    QVERIFY(!xml.hasError());
+
+    declared.sort();
+    used.sort();
+    used.removeDuplicates();
+    QCOMPARE(declared, used);
+}
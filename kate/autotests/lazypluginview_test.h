@@ -0,0 +1,18 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+
+class LazyPluginViewTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void placeholderActions_data();
+    void placeholderActions();
+};
@@ -0,0 +1,129 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "linediff_test.h"
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <linediff.h>
+
+QTEST_MAIN(LineDiffTest)
+
+static QStringList lines(const char *text)
+{
+    return LineDiff::splitLines(QString::fromLatin1(text));
+}
+
+void LineDiffTest::identical()
+{
+    QVERIFY(LineDiff::diff(lines("a\nb\nc"), lines("a\nb\nc")).empty());
+    QVERIFY(LineDiff::diff(QStringList(), QStringList()).empty());
+
+    // \r\n is the same line end
+    QVERIFY(LineDiff::diff(lines("a\r\nb"), lines("a\nb")).empty());
+}
+
+void LineDiffTest::hunks()
+{
+    // insertion
+    auto hunks = LineDiff::diff(lines("a\nb\nc"), lines("a\nx\nb\nc"));
+    QCOMPARE(hunks.size(), size_t(1));
+    QCOMPARE(hunks[0].oldStart, 1);
+    QCOMPARE(hunks[0].oldCount, 0);
+    QCOMPARE(hunks[0].newStart, 1);
+    QCOMPARE(hunks[0].newCount, 1);
+
+    // deletion
+    hunks = LineDiff::diff(lines("a\nb\nc"), lines("a\nc"));
+    QCOMPARE(hunks.size(), size_t(1));
+    QCOMPARE(hunks[0].oldStart, 1);
+    QCOMPARE(hunks[0].oldCount, 1);
+    QCOMPARE(hunks[0].newCount, 0);
+
+    // two separate changes
+    hunks = LineDiff::diff(lines("a\nb\nc\nd\ne"), lines("A\nb\nc\nd\nE\nF"));
+    QCOMPARE(hunks.size(), size_t(2));
+    QCOMPARE(hunks[0].oldStart, 0);
+    QCOMPARE(hunks[0].oldCount, 1);
+    QCOMPARE(hunks[0].newCount, 1);
+    QCOMPARE(hunks[1].oldStart, 4);
+    QCOMPARE(hunks[1].oldCount, 1);
+    QCOMPARE(hunks[1].newStart, 4);
+    QCOMPARE(hunks[1].newCount, 2);
+}
+
+void LineDiffTest::ignoreWhitespaceAmount()
+{
+    const auto oldLines = lines("int a;\n  if (x)  {\nreturn;");
+    const auto newLines = lines("int a;\n  if (x) {   \nreturn;");
+    QCOMPARE(LineDiff::diff(oldLines, newLines).size(), size_t(1));
+    QVERIFY(LineDiff::diff(oldLines, newLines, LineDiff::IgnoreWhitespaceAmount).empty());
+
+    // white space vanishing completely is a change
+    QCOMPARE(LineDiff::diff(lines("if (x)"), lines("if(x)"), LineDiff::IgnoreWhitespaceAmount).size(), size_t(1));
+    QCOMPARE(LineDiff::diff(lines("  x"), lines("x"), LineDiff::IgnoreWhitespaceAmount).size(), size_t(1));
+}
+
+void LineDiffTest::unifiedDiff()
+{
+    const auto oldLines = lines("1\n2\n3\n4\n5\n6\n7\n8\n9\n10");
+    const auto newLines = lines("1\n2\nthree\n4\n5\n6\n7\n8\n9\n10\n11");
+    const auto diff = LineDiff::unifiedDiff(oldLines, newLines, LineDiff::diff(oldLines, newLines), QStringLiteral("old"), QStringLiteral("new"), 1);
+    QCOMPARE(diff,
+             QStringLiteral("--- old\n+++ new\n"
+                            "@@ -2,3 +2,3 @@\n 2\n-3\n+three\n 4\n"
+                            "@@ -10 +10,2 @@\n 10\n+11\n"));
+
+    // changes with overlapping context get joined
+    const auto joined = LineDiff::unifiedDiff(oldLines, newLines, LineDiff::diff(oldLines, newLines), QStringLiteral("old"), QStringLiteral("new"), 4);
+    QCOMPARE(joined.count(QStringLiteral("@@ -")), 1);
+
+    QVERIFY(LineDiff::unifiedDiff(oldLines, oldLines, {}, QStringLiteral("old"), QStringLiteral("new")).isEmpty());
+}
+
+void LineDiffTest::applyHunks()
+{
+    // random edits of a larger text, the hunks must turn the old into the new lines
+    QRandomGenerator random(42);
+    QStringList oldLines;
+    for (int i = 0; i < 20000; ++i) {
+        oldLines.push_back(QString::number(random.bounded(5000)));
+    }
+
+    QStringList newLines = oldLines;
+    for (int i = 0; i < 500; ++i) {
+        const int pos = random.bounded(newLines.size());
+        switch (random.bounded(3)) {
+        case 0:
+            newLines.removeAt(pos);
+            break;
+        case 1:
+            newLines.insert(pos, QStringLiteral("new %1").arg(i));
+            break;
+        default:
+            newLines[pos] = QString::number(random.bounded(5000));
+        }
+    }
+
+    const auto hunks = LineDiff::diff(oldLines, newLines);
+    QStringList applied;
+    int oldLine = 0;
+    for (const auto &hunk : hunks) {
+        QVERIFY(hunk.oldStart >= oldLine);
+        while (oldLine < hunk.oldStart) {
+            applied.push_back(oldLines[oldLine++]);
+        }
+        for (int l = hunk.newStart; l < hunk.newStart + hunk.newCount; ++l) {
+            applied.push_back(newLines[l]);
+        }
+        oldLine += hunk.oldCount;
+    }
+    while (oldLine < oldLines.size()) {
+        applied.push_back(oldLines[oldLine++]);
+    }
+    QCOMPARE(applied, newLines);
+}
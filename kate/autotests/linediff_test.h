@@ -0,0 +1,21 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+
+class LineDiffTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void identical();
+    void hunks();
+    void ignoreWhitespaceAmount();
+    void unifiedDiff();
+    void applyHunks();
+};
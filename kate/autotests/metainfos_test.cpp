@@ -0,0 +1,241 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "metainfos_test.h"
+#include "katemetainfos.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+QTEST_MAIN(MetaInfosTest)
+
+static KateMetaInfos::Record record(const QByteArray &checksum, const QDateTime &time = QDateTime::currentDateTimeUtc())
+{
+    KateMetaInfos::Record record;
+    record.checksum = checksum;
+    record.time = time;
+    record.config.insert(QStringLiteral("Mode"), QStringLiteral("C++"));
+    record.config.insert(QStringLiteral("Bookmarks"), QStringLiteral("1,5,42"));
+    return record;
+}
+
+void MetaInfosTest::insertFindRemove()
+{
+    QTemporaryDir dir;
+    KateMetaInfos store(dir.filePath(QStringLiteral("metainfos")));
+
+    KateMetaInfos::Record found;
+    QVERIFY(!store.find(QStringLiteral("file:///a.cpp"), found));
+
+    store.insert(QStringLiteral("file:///a.cpp"), record("aaaa"));
+    QVERIFY(store.find(QStringLiteral("file:///a.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("aaaa"));
+    QCOMPARE(found.config.value(QStringLiteral("Bookmarks")), QStringLiteral("1,5,42"));
+
+    // same result once written
+    store.sync();
+    QVERIFY(store.find(QStringLiteral("file:///a.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("aaaa"));
+    QCOMPARE(store.count(), 1);
+
+    store.remove(QStringLiteral("file:///a.cpp"));
+    QVERIFY(!store.find(QStringLiteral("file:///a.cpp"), found));
+    QCOMPARE(store.count(), 0);
+    store.sync();
+    QVERIFY(!store.find(QStringLiteral("file:///a.cpp"), found));
+}
+
+void MetaInfosTest::persistence()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(QStringLiteral("metainfos"));
+    {
+        KateMetaInfos store(fileName);
+        store.insert(QStringLiteral("file:///a.cpp"), record("aaaa"));
+        store.insert(QStringLiteral("file:///b.cpp"), record("bbbb"));
+        store.insert(QStringLiteral("file:///a.cpp"), record("cccc"));
+        store.remove(QStringLiteral("file:///b.cpp"));
+    }
+
+    KateMetaInfos store(fileName);
+    KateMetaInfos::Record found;
+    QVERIFY(store.find(QStringLiteral("file:///a.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("cccc"));
+    QCOMPARE(found.config.value(QStringLiteral("Mode")), QStringLiteral("C++"));
+    QVERIFY(!store.find(QStringLiteral("file:///b.cpp"), found));
+    QCOMPARE(store.count(), 1);
+}
+
+void MetaInfosTest::truncatedFile()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(QStringLiteral("metainfos"));
+    {
+        KateMetaInfos store(fileName);
+        store.insert(QStringLiteral("file:///a.cpp"), record("aaaa"));
+        store.sync();
+        store.insert(QStringLiteral("file:///b.cpp"), record("bbbb"));
+    }
+
+    // cut the last record in half, as a crash while writing would
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 10));
+    file.close();
+
+    KateMetaInfos store(fileName);
+    KateMetaInfos::Record found;
+    QVERIFY(store.find(QStringLiteral("file:///a.cpp"), found));
+    QVERIFY(!store.find(QStringLiteral("file:///b.cpp"), found));
+
+    // writing again replaces the broken tail
+    store.insert(QStringLiteral("file:///c.cpp"), record("cccc"));
+    store.sync();
+    KateMetaInfos reopened(fileName);
+    QVERIFY(reopened.find(QStringLiteral("file:///a.cpp"), found));
+    QVERIFY(reopened.find(QStringLiteral("file:///c.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("cccc"));
+}
+
+void MetaInfosTest::unknownFormat()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(QStringLiteral("metainfos"));
+    const QByteArray foreign("KMI9 written by some newer version");
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(foreign), qint64(foreign.size()));
+    }
+
+    KateMetaInfos store(fileName);
+    QCOMPARE(store.count(), 0);
+    store.insert(QStringLiteral("file:///a.cpp"), record("aaaa"));
+    store.sync();
+
+    // the foreign file is moved aside, not truncated
+    QFile aside(fileName + QStringLiteral(".unknown"));
+    QVERIFY(aside.open(QIODevice::ReadOnly));
+    QCOMPARE(aside.readAll(), foreign);
+
+    KateMetaInfos reopened(fileName);
+    KateMetaInfos::Record found;
+    QVERIFY(reopened.find(QStringLiteral("file:///a.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("aaaa"));
+}
+
+void MetaInfosTest::removeOlderThan()
+{
+    QTemporaryDir dir;
+    KateMetaInfos store(dir.filePath(QStringLiteral("metainfos")));
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    store.insert(QStringLiteral("file:///old.cpp"), record("aaaa", now.addDays(-60)));
+    store.insert(QStringLiteral("file:///new.cpp"), record("bbbb", now));
+    store.sync();
+
+    store.removeOlderThan(now.addDays(-30));
+    store.sync();
+
+    KateMetaInfos::Record found;
+    QVERIFY(!store.find(QStringLiteral("file:///old.cpp"), found));
+    QVERIFY(store.find(QStringLiteral("file:///new.cpp"), found));
+}
+
+void MetaInfosTest::compaction()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(QStringLiteral("metainfos"));
+    KateMetaInfos store(fileName);
+
+    // overwrite the same records over and over, file must not grow without bound
+    auto big = record("aaaa");
+    big.config.insert(QStringLiteral("Padding"), QString(1024, QLatin1Char('x')));
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            store.insert(QStringLiteral("file:///%1.cpp").arg(i), big);
+        }
+        store.sync();
+    }
+    QVERIFY(QFileInfo(fileName).size() < 2 * 1024 * 1024);
+
+    KateMetaInfos reopened(fileName);
+    QCOMPARE(reopened.count(), 100);
+    KateMetaInfos::Record found;
+    QVERIFY(reopened.find(QStringLiteral("file:///42.cpp"), found));
+    QCOMPARE(found.config.value(QStringLiteral("Padding")).size(), 1024);
+}
+
+void MetaInfosTest::sharedFile()
+{
+    QTemporaryDir dir;
+    const QString fileName = dir.filePath(QStringLiteral("metainfos"));
+    KateMetaInfos first(fileName);
+    KateMetaInfos second(fileName);
+
+    first.insert(QStringLiteral("file:///a.cpp"), record("aaaa"));
+    first.sync();
+    second.insert(QStringLiteral("file:///b.cpp"), record("bbbb"));
+    second.sync();
+
+    // appending reads what the other instance wrote first instead of cutting it off
+    first.insert(QStringLiteral("file:///c.cpp"), record("cccc"));
+    first.sync();
+    KateMetaInfos::Record found;
+    QVERIFY(first.find(QStringLiteral("file:///b.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("bbbb"));
+    QCOMPARE(KateMetaInfos(fileName).count(), 3);
+
+    // a compaction by the other instance moves all records
+    auto big = record("dddd");
+    big.config.insert(QStringLiteral("Padding"), QString(1024, QLatin1Char('x')));
+    for (int round = 0; round < 20; ++round) {
+        second.insert(QStringLiteral("file:///d.cpp"), big);
+        for (int i = 0; i < 100; ++i) {
+            second.insert(QStringLiteral("file:///%1.cpp").arg(i), big);
+        }
+        second.sync();
+    }
+    QVERIFY(QFileInfo(fileName).size() < 2 * 1024 * 1024);
+
+    first.insert(QStringLiteral("file:///e.cpp"), record("eeee"));
+    first.sync();
+    QVERIFY(first.find(QStringLiteral("file:///a.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("aaaa"));
+    QVERIFY(first.find(QStringLiteral("file:///d.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("dddd"));
+
+    KateMetaInfos reopened(fileName);
+    QCOMPARE(reopened.count(), 105);
+    QVERIFY(reopened.find(QStringLiteral("file:///e.cpp"), found));
+}
+
+void MetaInfosTest::importLegacyConfig()
+{
+    QTemporaryDir dir;
+    const QString legacy = dir.filePath(QStringLiteral("katemetainfos"));
+    {
+        KConfig config(legacy, KConfig::SimpleConfig);
+        KConfigGroup cg(&config, "file:///a.cpp");
+        cg.writeEntry("Checksum", QStringLiteral("aaaa"));
+        cg.writeEntry("Time", QDateTime::currentDateTimeUtc());
+        cg.writeEntry("Mode", QStringLiteral("C++"));
+    }
+
+    KateMetaInfos store(dir.filePath(QStringLiteral("metainfos")), legacy);
+    store.sync();
+
+    KateMetaInfos::Record found;
+    QVERIFY(store.find(QStringLiteral("file:///a.cpp"), found));
+    QCOMPARE(found.checksum, QByteArray("aaaa"));
+    QCOMPARE(found.config.value(QStringLiteral("Mode")), QStringLiteral("C++"));
+    QVERIFY(!found.config.contains(QStringLiteral("Checksum")));
+}
@@ -0,0 +1,24 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+
+class MetaInfosTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void insertFindRemove();
+    void persistence();
+    void truncatedFile();
+    void unknownFormat();
+    void removeOlderThan();
+    void compaction();
+    void sharedFile();
+    void importLegacyConfig();
+};
@@ -0,0 +1,137 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "outputmessagemodel_test.h"
+#include "kateoutputmessagemodel.h"
+
+#include <QAbstractItemModelTester>
+#include <QTest>
+
+QTEST_MAIN(OutputMessageModelTest)
+
+static QString body(const KateOutputMessageModel &model, int row)
+{
+    return model.index(row, KateOutputMessageModel::Column_Body).data().toString();
+}
+
+void OutputMessageModelTest::addMessages()
+{
+    KateOutputMessageModel model;
+    QAbstractItemModelTester tester(&model);
+
+    auto last = model.addMessage(QStringLiteral("single"), QStringLiteral("Git"), QIcon(), KateOutputMessageModel::Info);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(last, model.index(0, KateOutputMessageModel::Column_Body));
+    QCOMPARE(model.rowCount(model.index(0, 0)), 0);
+    QCOMPARE(model.index(0, KateOutputMessageModel::Column_Category).data().toString(), QStringLiteral("Git"));
+    QCOMPARE(model.index(0, KateOutputMessageModel::Column_LogType).data().toString(), KateOutputMessageModel::typeText(KateOutputMessageModel::Info));
+
+    // additional lines are children of the first one
+    last = model.addMessage(QStringLiteral("first\nsecond\nthird"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Error);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(body(model, 1), QStringLiteral("first"));
+    const auto parent = model.index(1, 0);
+    QCOMPARE(model.rowCount(parent), 2);
+    QCOMPARE(model.index(0, KateOutputMessageModel::Column_Body, parent).data().toString(), QStringLiteral("second"));
+    QCOMPARE(model.index(1, KateOutputMessageModel::Column_Body, parent).data().toString(), QStringLiteral("third"));
+    QCOMPARE(last, model.index(1, KateOutputMessageModel::Column_Body, parent));
+    QCOMPARE(last.parent(), parent);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.messageCount(), 0);
+}
+
+void OutputMessageModelTest::capacity()
+{
+    KateOutputMessageModel model;
+    QAbstractItemModelTester tester(&model);
+    model.setCapacity(3);
+
+    for (int i = 0; i < 10; ++i) {
+        model.addMessage(QStringLiteral("message %1\nline").arg(i), QStringLiteral("Test"), QIcon(), KateOutputMessageModel::Log);
+        QVERIFY(model.messageCount() <= 3);
+    }
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(body(model, 0), QStringLiteral("message 7"));
+    QCOMPARE(body(model, 2), QStringLiteral("message 9"));
+    QCOMPARE(model.index(0, KateOutputMessageModel::Column_Body, model.index(2, 0)).data().toString(), QStringLiteral("line"));
+
+    // shrinking keeps the newest ones
+    model.setCapacity(2);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(body(model, 0), QStringLiteral("message 8"));
+
+    // growing keeps all
+    model.setCapacity(5);
+    model.addMessage(QStringLiteral("message 10"), QStringLiteral("Test"), QIcon(), KateOutputMessageModel::Log);
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(body(model, 0), QStringLiteral("message 8"));
+    QCOMPARE(body(model, 2), QStringLiteral("message 10"));
+}
+
+void OutputMessageModelTest::replaceByToken()
+{
+    KateOutputMessageModel model;
+    QAbstractItemModelTester tester(&model);
+    model.setCapacity(3);
+
+    model.addMessage(QStringLiteral("progress 0%"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Log, QStringLiteral("token"));
+    model.addMessage(QStringLiteral("other"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Log);
+    model.addMessage(QStringLiteral("progress 50%\nindexing"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Log, QStringLiteral("token"));
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(body(model, 0), QStringLiteral("progress 50%"));
+    QCOMPARE(model.rowCount(model.index(0, 0)), 1);
+
+    model.addMessage(QStringLiteral("progress 100%"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Log, QStringLiteral("token"));
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.rowCount(model.index(0, 0)), 0);
+
+    // once dropped, the token starts a new message
+    model.addMessage(QStringLiteral("a"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Log);
+    model.addMessage(QStringLiteral("b"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Log);
+    model.addMessage(QStringLiteral("progress again"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Log, QStringLiteral("token"));
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(body(model, 2), QStringLiteral("progress again"));
+}
+
+void OutputMessageModelTest::filter()
+{
+    KateOutputMessageModel model;
+    QAbstractItemModelTester tester(&model);
+
+    model.addMessage(QStringLiteral("compiling foo.cpp"), QStringLiteral("Build"), QIcon(), KateOutputMessageModel::Info);
+    model.addMessage(QStringLiteral("fatal\nfoo.cpp:1: missing bar"), QStringLiteral("Build"), QIcon(), KateOutputMessageModel::Error);
+    model.addMessage(QStringLiteral("server started"), QStringLiteral("LSP"), QIcon(), KateOutputMessageModel::Info);
+
+    // category, fuzzy
+    model.setFilterString(QStringLiteral("bld"));
+    QCOMPARE(model.rowCount(), 2);
+
+    // any line of the text
+    model.setFilterString(QStringLiteral("bar"));
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(body(model, 0), QStringLiteral("fatal"));
+    QCOMPARE(model.rowCount(model.index(0, 0)), 1);
+
+    // narrowing and widening again
+    model.setFilterString(QStringLiteral("foo"));
+    QCOMPARE(model.rowCount(), 2);
+    model.setFilterString(QStringLiteral("foo.cpp:"));
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(body(model, 0), QStringLiteral("fatal"));
+
+    // new messages are filtered, too
+    auto last = model.addMessage(QStringLiteral("unrelated"), QStringLiteral("Git"), QIcon(), KateOutputMessageModel::Log);
+    QVERIFY(!last.isValid());
+    last = model.addMessage(QStringLiteral("bar.cpp\nfoo.cpp:2: more"), QStringLiteral("Build"), QIcon(), KateOutputMessageModel::Warning);
+    QVERIFY(last.isValid());
+    QCOMPARE(model.rowCount(), 2);
+
+    model.setFilterString(QString());
+    QCOMPARE(model.rowCount(), 5);
+    QCOMPARE(model.messageCount(), 5);
+}
@@ -0,0 +1,20 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QObject>
+
+class OutputMessageModelTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void addMessages();
+    void capacity();
+    void replaceByToken();
+    void filter();
+};
@@ -44,6 +44,7 @@
 #include <QTextCodec>
 #include <QUrlQuery>
 
+#include <katetrace.h>
 #include <urlinfo.h>
 
 /**
@@ -148,6 +149,8 @@ bool KateApp::init()
 
 void KateApp::restoreKate()
 {
+    KateTraceZone zone("KateApp::restoreKate");
+
     KConfig *sessionConfig = KConfigGui::sessionConfig();
 
     // activate again correct session!!!
@@ -173,6 +176,8 @@ void KateApp::restoreKate()
 
 bool KateApp::startupKate()
 {
+    KateTraceZone zone("KateApp::startupKate");
+
     // user specified session to open
     if (m_args.isSet(QStringLiteral("start"))) {
         sessionManager()->activateSession(m_args.value(QStringLiteral("start")), false);
@@ -205,6 +210,35 @@ bool KateApp::startupKate()
     KTextEditor::Document *doc = nullptr;
     const QString codec_name = codec ? QString::fromLatin1(codec->name()) : QString();
 
+    KateTraceZone openZone("open command line documents");
+
+    // local files are opened in batches, read ahead in parallel and added to the views at once
+    std::vector<UrlInfo> batch;
+    auto openBatch = [this, &batch, &doc, &codec_name, tempfileSet]() {
+        if (batch.empty()) {
+            return;
+        }
+
+        QList<QUrl> urls;
+        for (const auto &info : batch) {
+            urls.push_back(info.url);
+        }
+        auto viewManager = activeKateMainWindow()->viewManager();
+        const auto docs = viewManager->openUrls(urls, codec_name, tempfileSet);
+        for (size_t i = 0; i < docs.size(); ++i) {
+            if (batch[i].cursor.isValid()) {
+                viewManager->activateView(docs[i]);
+                setCursor(batch[i].cursor.line(), batch[i].cursor.column());
+            } else if (hasCursorInArgs()) {
+                setCursorFromArgs(viewManager->activateView(docs[i]));
+            }
+        }
+        if (!docs.empty()) {
+            doc = docs.back();
+        }
+        batch.clear();
+    };
+
     const auto args = m_args.positionalArguments();
     for (const auto &positionalArgument : args) {
         UrlInfo info(positionalArgument);
@@ -216,7 +250,11 @@ bool KateApp::startupKate()
 #endif
             || !QFileInfo(info.url.toLocalFile()).isDir();
 
-        if (noDir) {
+        if (noDir && info.url.isLocalFile()) {
+            batch.push_back(info);
+        } else if (noDir) {
+            // remote ones may need post load operations, in order with the local ones
+            openBatch();
             doc = openDocUrl(info.url, codec_name, tempfileSet);
             if (info.cursor.isValid()) {
                 setCursor(info.cursor.line(), info.cursor.column());
@@ -227,6 +265,7 @@ bool KateApp::startupKate()
             KMessageBox::sorry(activeKateMainWindow(), i18n("Folders can only be opened when the projects plugin is enabled"));
         }
     }
+    openBatch();
 
     // handle stdin input
     if (m_args.isSet(QStringLiteral("stdin"))) {
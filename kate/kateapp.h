@@ -304,7 +304,12 @@ public Q_SLOTS:
      */
     KTextEditor::Document *findUrl(const QUrl &url)
     {
-        return m_docManager.findDocument(url);
+        // whoever asks for a document restored on demand wants its content
+        KTextEditor::Document *doc = m_docManager.findDocument(url);
+        if (doc) {
+            m_docManager.loadDocument(doc);
+        }
+        return doc;
     }
 
     /**
@@ -92,6 +92,19 @@ void KateConfigDialog::addBehaviorPage()
     connect(m_messageTypes, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &KateConfigDialog::slotChanged);
     vbox->addLayout(hlayout);
 
+    hlayout = new QHBoxLayout;
+    label = new QLabel(i18n("&Limit number of messages in output view:"), buttonGroup);
+    hlayout->addWidget(label);
+    m_outputViewMessageLimit = new QSpinBox(buttonGroup);
+    hlayout->addWidget(m_outputViewMessageLimit);
+    label->setBuddy(m_outputViewMessageLimit);
+    m_outputViewMessageLimit->setRange(100, 1000000);
+    m_outputViewMessageLimit->setSingleStep(1000);
+    m_outputViewMessageLimit->setValue(cgGeneral.readEntry("Output View Message Limit", 10000));
+    m_outputViewMessageLimit->setToolTip(i18n("Older messages are removed once the output view holds that many."));
+    connect(m_outputViewMessageLimit, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &KateConfigDialog::slotChanged);
+    vbox->addLayout(hlayout);
+
     // modified files notification
     m_modNotifications = new QCheckBox(i18n("Use a separate &dialog for handling externally modified files"), buttonGroup);
     m_modNotifications->setChecked(m_mainWindow->modNotificationEnabled());
@@ -210,10 +223,20 @@ void KateConfigDialog::addSessionPage()
     connect(sessionConfigUi.loadLastUserSessionRadioButton, &QRadioButton::toggled, this, &KateConfigDialog::slotChanged);
     connect(sessionConfigUi.manuallyChooseSessionRadioButton, &QRadioButton::toggled, this, &KateConfigDialog::slotChanged);
 
+    sessionConfigUi.restoreDocumentsOnDemand->setChecked(cgGeneral.readEntry("Restore Documents On Demand", false));
+    connect(sessionConfigUi.restoreDocumentsOnDemand, &QCheckBox::toggled, this, &KateConfigDialog::slotChanged);
+
     // Closing last file closes Kate
     sessionConfigUi.modCloseAfterLast->setChecked(m_mainWindow->modCloseAfterLast());
     connect(sessionConfigUi.modCloseAfterLast, &QCheckBox::toggled, this, &KateConfigDialog::slotChanged);
 
+    // memory budget for documents
+    sessionConfigUi.documentMemoryBudget->setRange(0, 65536);
+    sessionConfigUi.documentMemoryBudget->setSpecialValueText(i18nc("No memory budget for documents", "(unlimited)"));
+    sessionConfigUi.documentMemoryBudget->setSuffix(i18nc("Memory budget unit", " MiB"));
+    sessionConfigUi.documentMemoryBudget->setValue(KateApp::self()->documentManager()->memoryBudget());
+    connect(sessionConfigUi.documentMemoryBudget, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &KateConfigDialog::slotChanged);
+
     // stash unsave changes
     sessionConfigUi.stashNewUnsavedFiles->setChecked(KateApp::self()->stashManager()->stashNewUnsavedFiles());
     sessionConfigUi.stashUnsavedFilesChanges->setChecked(KateApp::self()->stashManager()->stashUnsavedChanges());
@@ -336,6 +359,7 @@ void KateConfigDialog::slotApply()
         } else {
             cg.writeEntry("Startup Session", "manual");
         }
+        cg.writeEntry("Restore Documents On Demand", sessionConfigUi.restoreDocumentsOnDemand->isChecked());
 
         cg.writeEntry("Save Meta Infos", sessionConfigUi.saveMetaInfos->isChecked());
         KateApp::self()->documentManager()->setSaveMetaInfos(sessionConfigUi.saveMetaInfos->isChecked());
@@ -349,7 +373,11 @@ void KateConfigDialog::slotApply()
         cg.writeEntry("Close After Last", sessionConfigUi.modCloseAfterLast->isChecked());
         m_mainWindow->setModCloseAfterLast(sessionConfigUi.modCloseAfterLast->isChecked());
 
+        cg.writeEntry("Document Memory Budget", sessionConfigUi.documentMemoryBudget->value());
+        KateApp::self()->documentManager()->setMemoryBudget(sessionConfigUi.documentMemoryBudget->value());
+
         cg.writeEntry("Show output view for message type", m_messageTypes->currentIndex());
+        cg.writeEntry("Output View Message Limit", m_outputViewMessageLimit->value());
 
         cg.writeEntry("Stash unsaved file changes", sessionConfigUi.stashUnsavedFilesChanges->isChecked());
         KateApp::self()->stashManager()->setStashUnsavedChanges(sessionConfigUi.stashUnsavedFilesChanges->isChecked());
@@ -11,6 +11,7 @@
 #include "kateapp.h"
 #include "katedebug.h"
 #include "katemainwindow.h"
+#include "katemetainfos.h"
 #include "katesavemodifieddialog.h"
 #include "kateviewmanager.h"
 
@@ -18,6 +19,8 @@
 #include <ktexteditor/editor.h>
 #include <ktexteditor/view.h>
 
+#include <katetrace.h>
+
 #include <KConfigGroup>
 #include <KIO/DeleteJob>
 #include <KLocalizedString>
@@ -29,20 +32,43 @@
 #endif
 
 #include <QApplication>
+#include <QDir>
+#include <QFile>
 #include <QFileDialog>
 #include <QProgressDialog>
+#include <QStandardPaths>
 #include <QTextCodec>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
 KateDocManager::KateDocManager(QObject *parent)
     : QObject(parent)
-    , m_metaInfos(QStringLiteral("katemetainfos"), KConfig::NoGlobals)
     , m_saveMetaInfos(true)
     , m_daysMetaInfos(0)
 {
+    // meta infos of documents, imported from the old config file once
+    const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataPath);
+    m_metaInfos.reset(new KateMetaInfos(dataPath + QStringLiteral("/metainfos"), QStringLiteral("katemetainfos")));
+
     // set our application wrapper
     KTextEditor::Editor::instance()->setApplication(KateApp::self()->wrapper());
 
+    // prefetch documents restored on demand one by one, to keep the ui responsive
+    m_prefetchTimer.setSingleShot(true);
+    m_prefetchTimer.setInterval(50);
+    connect(&m_prefetchTimer, &QTimer::timeout, this, &KateDocManager::prefetchNextDocument);
+
+    // check from time to time if documents need to be hibernated
+    m_memoryBudgetTimer.setInterval(30000);
+    connect(&m_memoryBudgetTimer, &QTimer::timeout, this, &KateDocManager::checkMemoryBudget);
+
     // create one doc, we always have at least one around!
     createDoc();
 }
@@ -56,17 +82,12 @@ KateDocManager::~KateDocManager()
 
         // purge saved filesessions
         if (m_daysMetaInfos > 0) {
-            const QStringList groups = m_metaInfos.groupList();
-            QDateTime def(QDate(1970, 1, 1).startOfDay());
-
-            for (const auto &group : groups) {
-                QDateTime last = m_metaInfos.group(group).readEntry("Time", def);
-                if (last.daysTo(QDateTime::currentDateTimeUtc()) > m_daysMetaInfos) {
-                    m_metaInfos.deleteGroup(group);
-                }
-            }
+            m_metaInfos->removeOlderThan(QDateTime::currentDateTimeUtc().addDays(-m_daysMetaInfos));
         }
     }
+
+    // write everything before we are gone
+    m_metaInfos->sync();
 }
 
 KTextEditor::Document *KateDocManager::createDoc(const KateDocumentInfo &docInfo)
@@ -85,6 +106,12 @@ KTextEditor::Document *KateDocManager::createDoc(const KateDocumentInfo &docInfo
 
     // connect internal signals...
     connect(doc, &KTextEditor::Document::modifiedChanged, this, &KateDocManager::slotModChanged1);
+    connect(doc, &KTextEditor::Document::documentUrlChanged, this, &KateDocManager::updateDocumentIndex);
+    connect(doc, &KTextEditor::Document::viewCreated, this, [this](KTextEditor::Document *doc) {
+        if (KateDocumentInfo *info = documentInfo(doc)) {
+            info->hadView = true;
+        }
+    });
     // clang-format off
     connect(doc,
             SIGNAL(modifiedOnDisk(KTextEditor::Document*,bool,KTextEditor::ModificationInterface::ModifiedOnDiskReason)),
@@ -92,9 +119,19 @@ KTextEditor::Document *KateDocManager::createDoc(const KateDocumentInfo &docInfo
             SLOT(slotModifiedOnDisc(KTextEditor::Document*,bool,KTextEditor::ModificationInterface::ModifiedOnDiskReason)));
     // clang-format on
 
+    // not loaded yet, let plugins like the file tree know where it comes from
+    if (!docInfo.unloadedUrl.isEmpty()) {
+        doc->setProperty("unloadedUrl", docInfo.unloadedUrl);
+    }
+    updateDocumentIndex(doc);
+
     // we have a new document, show it the world
     Q_EMIT documentCreated(doc);
-    Q_EMIT documentCreatedViewManager(doc);
+    if (m_batchCreation) {
+        m_createdDocuments.push_back(doc);
+    } else {
+        Q_EMIT documentCreatedViewManager(doc);
+    }
 
     // return our new document
     return doc;
@@ -129,13 +166,277 @@ static QUrl normalizeUrl(const QUrl &url)
 
 KTextEditor::Document *KateDocManager::findDocument(const QUrl &url) const
 {
-    const QUrl u(normalizeUrl(url));
-    for (KTextEditor::Document *it : m_docList) {
-        if (it->url() == u) {
-            return it;
+    return m_docIndex.value(normalizeUrl(url));
+}
+
+void KateDocManager::updateDocumentIndex(KTextEditor::Document *doc)
+{
+    auto it = m_docInfos.find(doc);
+    if (it == m_docInfos.end()) {
+        return;
+    }
+
+    KateDocumentInfo &info = it->second;
+    const QUrl url = info.unloadedUrl.isEmpty() ? doc->url() : info.unloadedUrl;
+    if (url == info.indexedUrl) {
+        return;
+    }
+
+    removeFromDocumentIndex(doc, info.indexedUrl);
+    info.indexedUrl = url;
+
+    // if multiple documents have the same url, the first one wins
+    if (!url.isEmpty() && !m_docIndex.contains(url)) {
+        m_docIndex.insert(url, doc);
+    }
+}
+
+void KateDocManager::removeFromDocumentIndex(KTextEditor::Document *doc, const QUrl &url)
+{
+    auto it = m_docIndex.find(url);
+    if (it == m_docIndex.end() || it.value() != doc) {
+        return;
+    }
+    m_docIndex.erase(it);
+
+    // some other document with the same url takes over
+    for (KTextEditor::Document *other : qAsConst(m_docList)) {
+        auto info = m_docInfos.find(other);
+        if (other != doc && info != m_docInfos.end() && info->second.indexedUrl == url) {
+            m_docIndex.insert(url, other);
+            break;
         }
     }
-    return nullptr;
+}
+
+void KateDocManager::loadDocument(KTextEditor::Document *doc)
+{
+    auto it = m_docInfos.find(doc);
+    if (it == m_docInfos.end() || it->second.unloadedUrl.isEmpty()) {
+        return;
+    }
+
+    // rebuild the session config group the document was saved to
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup cg(&config, "Document");
+    const auto entries = std::exchange(it->second.unloadedSessionConfig, {});
+    for (auto entry = entries.begin(); entry != entries.end(); ++entry) {
+        cg.writeEntry(entry.key(), entry.value());
+    }
+
+    it->second.unloadedUrl.clear();
+    doc->setProperty("unloadedUrl", QVariant());
+    m_prefetchQueue.removeAll(doc);
+    updateDocumentIndex(doc);
+
+    restoreDocument(doc, cg);
+}
+
+void KateDocManager::prefetchDocuments(const QList<KTextEditor::Document *> &documents)
+{
+    for (KTextEditor::Document *doc : documents) {
+        if (m_prefetchQueue.size() >= m_prefetchBudget) {
+            break;
+        }
+        const KateDocumentInfo *info = documentInfo(doc);
+        if (info && !info->unloadedUrl.isEmpty() && !m_prefetchQueue.contains(doc)) {
+            m_prefetchQueue.push_back(doc);
+        }
+    }
+
+    if (!m_prefetchQueue.isEmpty()) {
+        m_prefetchTimer.start();
+    }
+}
+
+void KateDocManager::prefetchNextDocument()
+{
+    if (m_prefetchQueue.isEmpty()) {
+        return;
+    }
+
+    // budget is used up by loading, later restored view spaces don't queue more than that
+    --m_prefetchBudget;
+    loadDocument(m_prefetchQueue.takeFirst());
+
+    if (!m_prefetchQueue.isEmpty()) {
+        m_prefetchTimer.start();
+    }
+}
+
+QUrl KateDocManager::documentUrl(KTextEditor::Document *doc)
+{
+    const KateDocumentInfo *info = documentInfo(doc);
+    if (info && !info->unloadedUrl.isEmpty()) {
+        return info->unloadedUrl;
+    }
+    return doc->url();
+}
+
+QString KateDocManager::documentName(KTextEditor::Document *doc)
+{
+    const KateDocumentInfo *info = documentInfo(doc);
+    if (info && !info->unloadedUrl.isEmpty()) {
+        return info->unloadedUrl.fileName();
+    }
+    return doc->documentName();
+}
+
+void KateDocManager::documentUsed(KTextEditor::Document *doc)
+{
+    KateDocumentInfo *info = documentInfo(doc);
+    if (info) {
+        info->lastUsed = ++m_useCounter;
+    }
+}
+
+bool KateDocManager::hibernateDocument(KTextEditor::Document *doc)
+{
+    KateDocumentInfo *info = documentInfo(doc);
+    if (!info || !info->unloadedUrl.isEmpty() || !info->openSuccess || info->modifiedOnDisc) {
+        return false;
+    }
+
+    // plugins like the lsp client or search may still use documents they opened without a view
+    if (!info->hadView) {
+        return false;
+    }
+
+    // only unmodified local files can be loaded again without loss or delay
+    if (doc->isModified() || !doc->url().isLocalFile() || m_tempFiles.count(doc)) {
+        return false;
+    }
+
+    const auto views = doc->views();
+    for (KTextEditor::View *view : views) {
+        if (view->isVisible()) {
+            return false;
+        }
+    }
+
+    // remember what we need to load the document again and the state of its last view
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup cg(&config, "Document");
+    doc->writeSessionConfig(cg);
+    info->unloadedSessionConfig = cg.entryMap();
+    if (!views.isEmpty()) {
+        KConfigGroup viewGroup(&config, "View");
+        views.front()->writeSessionConfig(viewGroup);
+        info->hibernatedViewConfig = viewGroup.entryMap();
+    }
+    info->unloadedUrl = doc->url();
+    doc->setProperty("unloadedUrl", info->unloadedUrl);
+
+    // drop the views, view spaces keep the tabs around
+    for (KTextEditor::View *view : views) {
+        for (int i = 0; i < KateApp::self()->mainWindowsCount(); ++i) {
+            KateMainWindow *window = KateApp::self()->mainWindow(i);
+            if (window->wrapper() == view->mainWindow()) {
+                window->viewManager()->deleteView(view);
+                break;
+            }
+        }
+    }
+
+    // and the buffer
+    doc->closeUrl();
+    qCDebug(LOG_KATE) << "hibernated document" << info->unloadedUrl;
+    return true;
+}
+
+void KateDocManager::restoreViewConfig(KTextEditor::View *view)
+{
+    KateDocumentInfo *info = documentInfo(view->document());
+    if (!info || info->hibernatedViewConfig.isEmpty()) {
+        return;
+    }
+
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup cg(&config, "View");
+    const auto entries = std::exchange(info->hibernatedViewConfig, {});
+    for (auto entry = entries.begin(); entry != entries.end(); ++entry) {
+        cg.writeEntry(entry.key(), entry.value());
+    }
+    view->readSessionConfig(cg);
+}
+
+void KateDocManager::setMemoryBudget(int budget)
+{
+    m_memoryBudget = budget;
+    if (m_memoryBudget > 0) {
+        m_memoryBudgetTimer.start();
+    } else {
+        m_memoryBudgetTimer.stop();
+    }
+}
+
+/**
+ * Rough estimate of the memory a loaded document takes:
+ * the text as UTF-16 plus some overhead per line for attributes, folding and the like.
+ */
+static qint64 estimatedMemoryUsage(KTextEditor::Document *doc)
+{
+    return qint64(doc->totalCharacters()) * 2 + qint64(doc->lines()) * 64;
+}
+
+void KateDocManager::checkMemoryBudget()
+{
+    const qint64 budget = qint64(m_memoryBudget) * 1024 * 1024;
+    if (budget <= 0) {
+        return;
+    }
+
+    qint64 used = 0;
+    std::vector<std::pair<quint64, KTextEditor::Document *>> candidates;
+    for (KTextEditor::Document *doc : qAsConst(m_docList)) {
+        const KateDocumentInfo *info = documentInfo(doc);
+        if (info && info->unloadedUrl.isEmpty()) {
+            used += estimatedMemoryUsage(doc);
+            candidates.emplace_back(info->lastUsed, doc);
+        }
+    }
+
+    if (used <= budget) {
+        return;
+    }
+
+    // least recently used first
+    std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    for (const auto &candidate : candidates) {
+        const qint64 usage = estimatedMemoryUsage(candidate.second);
+        if (hibernateDocument(candidate.second)) {
+            used -= usage;
+            if (used <= budget) {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Read local files on worker threads, ahead of the documents loading them on the gui thread.
+ * The documents then find the content in the disk cache.
+ * Set the returned flag to stop reading.
+ */
+static std::shared_ptr<std::atomic<bool>> prefetchFiles(const QStringList &files)
+{
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    const int threads = std::min(std::max(QThread::idealThreadCount(), 1), 4);
+    for (int thread = 0; thread < threads && thread < files.size(); ++thread) {
+        QThreadPool::globalInstance()->start([files, thread, threads, cancelled]() {
+            QByteArray buffer(256 * 1024, Qt::Uninitialized);
+            for (int i = thread; i < files.size() && !*cancelled; i += threads) {
+                QFile file(files[i]);
+                if (file.open(QIODevice::ReadOnly)) {
+                    while (!*cancelled && file.read(buffer.data(), buffer.size()) > 0) { }
+                }
+            }
+        });
+    }
+    return cancelled;
 }
 
 std::vector<KTextEditor::Document *>
@@ -143,9 +444,34 @@ KateDocManager::openUrls(const QList<QUrl> &urls, const QString &encoding, bool
 {
     std::vector<KTextEditor::Document *> docs;
     docs.reserve(urls.size());
+
+    if (urls.size() < 2) {
+        for (const QUrl &url : urls) {
+            docs.push_back(openUrl(url, encoding, isTempFile, docInfo));
+        }
+        return docs;
+    }
+
+    QStringList localFiles;
+    for (const QUrl &url : urls) {
+        if (url.isLocalFile() && !findDocument(url)) {
+            localFiles.push_back(url.toLocalFile());
+        }
+    }
+    const auto cancelled = prefetchFiles(localFiles);
+
+    // the view managers get one update once all documents are there
+    const bool outerBatch = std::exchange(m_batchCreation, true);
     for (const QUrl &url : urls) {
         docs.push_back(openUrl(url, encoding, isTempFile, docInfo));
     }
+    m_batchCreation = outerBatch;
+    *cancelled = true;
+
+    if (!m_batchCreation && !m_createdDocuments.isEmpty()) {
+        Q_EMIT documentsCreatedViewManager(std::exchange(m_createdDocuments, {}));
+    }
+
     return docs;
 }
 
@@ -167,6 +493,9 @@ KTextEditor::Document *KateDocManager::openUrl(const QUrl &url, const QString &e
     // always new document if url is empty...
     if (!u.isEmpty()) {
         doc = findDocument(u);
+        if (doc) {
+            loadDocument(doc);
+        }
     }
 
     if (!doc) {
@@ -247,6 +576,9 @@ bool KateDocManager::closeDocuments(const QList<KTextEditor::Document *> &docume
         Q_EMIT documentWillBeDeleted(doc);
 
         // really delete the document and its infos
+        m_prefetchQueue.removeAll(doc);
+        m_createdDocuments.removeAll(doc);
+        removeFromDocumentIndex(doc, m_docInfos[doc].indexedUrl);
         m_docInfos.erase(doc);
         delete m_docList.takeAt(m_docList.indexOf(doc));
 
@@ -429,7 +761,16 @@ void KateDocManager::saveDocumentList(KConfig *config)
     for (KTextEditor::Document *doc : qAsConst(m_docList)) {
         const QString entryName = QStringLiteral("Document %1").arg(i);
         KConfigGroup cg(config, entryName);
-        doc->writeSessionConfig(cg);
+
+        // documents never loaded keep the config they were restored from
+        const KateDocumentInfo *info = documentInfo(doc);
+        if (info && !info->unloadedUrl.isEmpty()) {
+            for (auto it = info->unloadedSessionConfig.begin(); it != info->unloadedSessionConfig.end(); ++it) {
+                cg.writeEntry(it.key(), it.value());
+            }
+        } else {
+            doc->writeSessionConfig(cg);
+        }
 
         i++;
     }
@@ -437,6 +778,8 @@ void KateDocManager::saveDocumentList(KConfig *config)
 
 void KateDocManager::restoreDocumentList(KConfig *config)
 {
+    KateTraceZone zone("restore documents");
+
     KConfigGroup openDocGroup(config, "Open Documents");
     unsigned int count = openDocGroup.readEntry("Count", 0);
 
@@ -444,34 +787,57 @@ void KateDocManager::restoreDocumentList(KConfig *config)
         return;
     }
 
-    QProgressDialog progress;
-    progress.setWindowTitle(i18n("Starting Up"));
-    progress.setLabelText(i18n("Reopening files from the last session..."));
-    progress.setModal(true);
-    progress.setCancelButton(nullptr);
-    progress.setRange(0, count);
+    // on demand, documents are only loaded once shown or asked for by a plugin
+    const KConfigGroup generalGroup(KSharedConfig::openConfig(), "General");
+    const bool onDemand = generalGroup.readEntry("Restore Documents On Demand", false);
+    m_prefetchBudget = generalGroup.readEntry("Session Prefetch Count", 10);
+
+    std::unique_ptr<QProgressDialog> progress;
+    if (!onDemand) {
+        progress.reset(new QProgressDialog);
+        progress->setWindowTitle(i18n("Starting Up"));
+        progress->setLabelText(i18n("Reopening files from the last session..."));
+        progress->setModal(true);
+        progress->setCancelButton(nullptr);
+        progress->setRange(0, count);
+    }
 
     for (unsigned int i = 0; i < count; i++) {
         KConfigGroup cg(config, QStringLiteral("Document %1").arg(i));
-        KTextEditor::Document *doc = nullptr;
 
         if (i == 0) {
-            doc = m_docList.front();
-        } else {
-            doc = createDoc();
+            restoreDocument(m_docList.front(), cg);
+            continue;
         }
 
-        connect(doc, SIGNAL(completed()), this, SLOT(documentOpened()));
-        connect(doc, &KParts::ReadOnlyPart::canceled, this, &KateDocManager::documentOpened);
-
-        doc->readSessionConfig(cg);
+        // stashed changes and untitled documents have no file to come back to, load them now
+        const QUrl url(cg.readEntry("URL"));
+        if (onDemand && !url.isEmpty() && !cg.hasKey("stashedFile")) {
+            KateDocumentInfo docInfo;
+            docInfo.unloadedUrl = normalizeUrl(url);
+            docInfo.unloadedSessionConfig = cg.entryMap();
+            createDoc(docInfo);
+            continue;
+        }
 
-        KateApp::self()->stashManager()->popDocument(doc, cg);
+        restoreDocument(createDoc(), cg);
 
-        progress.setValue(i);
+        if (progress) {
+            progress->setValue(i);
+        }
     }
 }
 
+void KateDocManager::restoreDocument(KTextEditor::Document *doc, const KConfigGroup &cg)
+{
+    connect(doc, SIGNAL(completed()), this, SLOT(documentOpened()));
+    connect(doc, &KParts::ReadOnlyPart::canceled, this, &KateDocManager::documentOpened);
+
+    doc->readSessionConfig(cg);
+
+    KateApp::self()->stashManager()->popDocument(doc, cg);
+}
+
 void KateDocManager::slotModifiedOnDisc(KTextEditor::Document *doc, bool b, KTextEditor::ModificationInterface::ModifiedOnDiskReason reason)
 {
     auto it = m_docInfos.find(doc);
@@ -491,17 +857,22 @@ bool KateDocManager::loadMetaInfos(KTextEditor::Document *doc, const QUrl &url)
         return false;
     }
 
-    if (!m_metaInfos.hasGroup(url.toDisplayString())) {
+    const QString key = url.toString();
+    KateMetaInfos::Record record;
+    if (!m_metaInfos->find(key, record)) {
         return false;
     }
 
     const QByteArray checksum = doc->checksum().toHex();
     bool ok = true;
     if (!checksum.isEmpty()) {
-        KConfigGroup urlGroup(&m_metaInfos, url.toDisplayString());
-        const QString old_checksum = urlGroup.readEntry("Checksum");
+        if (checksum == record.checksum) {
+            KConfig config(QString(), KConfig::SimpleConfig);
+            KConfigGroup urlGroup(&config, key);
+            for (auto it = record.config.cbegin(); it != record.config.cend(); ++it) {
+                urlGroup.writeEntry(it.key(), it.value());
+            }
 
-        if (QString::fromLatin1(checksum) == old_checksum) {
             QSet<QString> flags;
             if (documentInfo(doc)->openedByUser) {
                 flags << QStringLiteral("SkipEncoding");
@@ -509,11 +880,9 @@ bool KateDocManager::loadMetaInfos(KTextEditor::Document *doc, const QUrl &url)
             flags << QStringLiteral("SkipUrl");
             doc->readSessionConfig(urlGroup, flags);
         } else {
-            urlGroup.deleteGroup();
+            m_metaInfos->remove(key);
             ok = false;
         }
-
-        m_metaInfos.sync();
     }
 
     return ok && doc->url() == url;
@@ -547,23 +916,18 @@ void KateDocManager::saveMetaInfos(const QList<KTextEditor::Document *> &documen
         const QByteArray checksum = doc->checksum().toHex();
         if (!checksum.isEmpty()) {
             /**
-             * write the group with checksum and time
+             * write document session config
              */
-            KConfigGroup urlGroup(&m_metaInfos, doc->url().toString());
-            urlGroup.writeEntry("Checksum", QString::fromLatin1(checksum));
-            urlGroup.writeEntry("Time", now);
+            KConfig config(QString(), KConfig::SimpleConfig);
+            KConfigGroup urlGroup(&config, "Document");
+            doc->writeSessionConfig(urlGroup);
 
             /**
-             * write document session config
+             * store it with checksum and time, written in the background
              */
-            doc->writeSessionConfig(urlGroup);
+            m_metaInfos->insert(doc->url().toString(), {checksum, now, urlGroup.entryMap()});
         }
     }
-
-    /**
-     * sync to not loose data
-     */
-    m_metaInfos.sync();
 }
 
 void KateDocManager::slotModChanged(KTextEditor::Document *doc)
@@ -12,14 +12,21 @@
 #include <ktexteditor/modificationinterface.h>
 
 #include <QDateTime>
+#include <QHash>
 #include <QList>
+#include <QMap>
 #include <QObject>
+#include <QTimer>
+#include <QUrl>
 
 #include <KConfig>
 
+#include <memory>
 #include <unordered_map>
 
 class KateMainWindow;
+class KateMetaInfos;
+class KConfigGroup;
 
 class KateDocumentInfo
 {
@@ -36,6 +43,33 @@ public:
     bool openSuccess = true;
     bool doPostLoadOperations = false;
     bool wasDocumentEverModified = false;
+
+    /**
+     * Documents restored on demand from a session are not loaded yet,
+     * we remember where they come from and their session config until then.
+     */
+    QUrl unloadedUrl;
+    QMap<QString, QString> unloadedSessionConfig;
+
+    /**
+     * Hibernated documents also remember the state of their last view.
+     */
+    QMap<QString, QString> hibernatedViewConfig;
+
+    /**
+     * Use counter value of the last activation, see KateDocManager::documentUsed().
+     */
+    quint64 lastUsed = 0;
+
+    /**
+     * Did the document ever have a view? Documents opened without one are used by plugins.
+     */
+    bool hadView = false;
+
+    /**
+     * Url the document is found by in the url index of KateDocManager.
+     */
+    QUrl indexedUrl;
 };
 
 class KateDocManager : public QObject
@@ -53,6 +87,43 @@ public:
     /** Returns the documentNumber of the doc with url URL or -1 if no such doc is found */
     KTextEditor::Document *findDocument(const QUrl &url) const;
 
+    /**
+     * Load a document restored on demand from the session, does nothing for loaded documents.
+     * Called before a view is created for it or if somebody opens its url.
+     */
+    void loadDocument(KTextEditor::Document *doc);
+
+    /**
+     * Queue documents to be loaded in the background, in the given order.
+     * At most "Session Prefetch Count" documents are prefetched after a session restore.
+     */
+    void prefetchDocuments(const QList<KTextEditor::Document *> &documents);
+
+    /**
+     * Url and name of a document, for documents not loaded yet the ones they will have once loaded.
+     */
+    QUrl documentUrl(KTextEditor::Document *doc);
+    QString documentName(KTextEditor::Document *doc);
+
+    /**
+     * Mark the document as most recently used, called on view activation.
+     */
+    void documentUsed(KTextEditor::Document *doc);
+
+    /**
+     * Drop buffer and views of an unmodified local document that had a view, but has no visible one now.
+     * Documents never shown are left alone, plugins opened them to work with their content.
+     * Url and session config, including bookmarks and the state of its last view, are kept
+     * to load it again on activation, see loadDocument().
+     * @return true if the document got hibernated
+     */
+    bool hibernateDocument(KTextEditor::Document *doc);
+
+    /**
+     * Apply the state a view had before its document got hibernated, if any.
+     */
+    void restoreViewConfig(KTextEditor::View *view);
+
     const QList<KTextEditor::Document *> &documentList() const
     {
         return m_docList;
@@ -85,6 +156,16 @@ public:
         m_saveMetaInfos = b;
     }
 
+    /**
+     * Memory budget for loaded documents in MiB, 0 for no limit.
+     * Least recently used documents are hibernated to stay within it.
+     */
+    inline int memoryBudget() const
+    {
+        return m_memoryBudget;
+    }
+    void setMemoryBudget(int budget);
+
     inline int getDaysMetaInfos()
     {
         return m_daysMetaInfos;
@@ -129,6 +210,12 @@ Q_SIGNALS:
      */
     void documentCreatedViewManager(KTextEditor::Document *document);
 
+    /**
+     * This signal is emitted once for all \p documents opened at once by openUrls(),
+     * instead of documentCreatedViewManager() per document.
+     */
+    void documentsCreatedViewManager(const QList<KTextEditor::Document *> &documents);
+
     /**
      * This signal is emitted before a \p document which should be closed is deleted
      * The document is still accessible and usable, but it will be deleted
@@ -166,21 +253,41 @@ private Q_SLOTS:
     void slotModifiedOnDisc(KTextEditor::Document *doc, bool b, KTextEditor::ModificationInterface::ModifiedOnDiskReason reason);
     void slotModChanged(KTextEditor::Document *doc);
     void slotModChanged1(KTextEditor::Document *doc);
+    void updateDocumentIndex(KTextEditor::Document *doc);
 
 private:
     bool loadMetaInfos(KTextEditor::Document *doc, const QUrl &url);
     void saveMetaInfos(const QList<KTextEditor::Document *> &docs);
+    void restoreDocument(KTextEditor::Document *doc, const KConfigGroup &cg);
+    void prefetchNextDocument();
+    void checkMemoryBudget();
+    void removeFromDocumentIndex(KTextEditor::Document *doc, const QUrl &url);
 
     QList<KTextEditor::Document *> m_docList;
     std::unordered_map<KTextEditor::Document *, KateDocumentInfo> m_docInfos;
 
-    KConfig m_metaInfos;
+    // url => document, for documents not loaded yet the url they will be loaded from
+    QHash<QUrl, KTextEditor::Document *> m_docIndex;
+
+    // documents created while opening many urls at once, see documentsCreatedViewManager()
+    bool m_batchCreation = false;
+    QList<KTextEditor::Document *> m_createdDocuments;
+
+    std::unique_ptr<KateMetaInfos> m_metaInfos;
     bool m_saveMetaInfos;
     int m_daysMetaInfos;
 
     typedef std::pair<QUrl, QDateTime> TPair;
     std::unordered_map<KTextEditor::Document *, TPair> m_tempFiles;
 
+    QList<KTextEditor::Document *> m_prefetchQueue;
+    QTimer m_prefetchTimer;
+    int m_prefetchBudget = 0;
+
+    QTimer m_memoryBudgetTimer;
+    int m_memoryBudget = 0;
+    quint64 m_useCounter = 0;
+
 private Q_SLOTS:
     void documentOpened();
 };
@@ -0,0 +1,206 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include "kateinstanceregistry.h"
+
+#include "kateapp.h"
+#include "katedebug.h"
+#include "katemainwindow.h"
+#include "katesessionmanager.h"
+
+#include <KWindowInfo>
+#include <KWindowSystem>
+
+#ifdef KF5Activities_FOUND
+#include <KActivities/Consumer>
+#endif
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <signal.h>
+#endif
+
+static bool isProcessAlive(qint64 pid)
+{
+#ifdef Q_OS_UNIX
+    // no signal sent, just the check if we could
+    return pid > 0 && (::kill(pid_t(pid), 0) == 0 || errno == EPERM);
+#else
+    return pid > 0;
+#endif
+}
+
+static QByteArray serializeEntry(const KateInstanceRegistry::Entry &entry)
+{
+    const QJsonObject object{{QStringLiteral("service"), entry.serviceName},
+                             {QStringLiteral("pid"), entry.pid},
+                             {QStringLiteral("session"), entry.sessionName},
+                             {QStringLiteral("desktop"), entry.desktop},
+                             {QStringLiteral("activities"), QJsonArray::fromStringList(entry.activities)},
+                             {QStringLiteral("currentActivity"), entry.currentActivity},
+                             {QStringLiteral("updated"), entry.updated}};
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+bool KateInstanceRegistry::isAvailable()
+{
+    return !QFileInfo::exists(QStringLiteral("/flatpak-info"));
+}
+
+QString KateInstanceRegistry::defaultDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation) + QStringLiteral("/kate-instances");
+}
+
+std::vector<KateInstanceRegistry::Entry> KateInstanceRegistry::runningInstances(const QString &directory)
+{
+    std::vector<Entry> entries;
+    const QFileInfoList files = QDir(directory).entryInfoList(QDir::Files);
+    for (const QFileInfo &info : files) {
+        QFile file(info.absoluteFilePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+        Entry entry;
+        entry.serviceName = object.value(QStringLiteral("service")).toString();
+        entry.pid = object.value(QStringLiteral("pid")).toVariant().toLongLong();
+        entry.sessionName = object.value(QStringLiteral("session")).toString();
+        entry.desktop = object.value(QStringLiteral("desktop")).toInt();
+        const QJsonArray activities = object.value(QStringLiteral("activities")).toArray();
+        for (const auto &activity : activities) {
+            entry.activities.push_back(activity.toString());
+        }
+        entry.currentActivity = object.value(QStringLiteral("currentActivity")).toString();
+        entry.updated = object.value(QStringLiteral("updated")).toVariant().toLongLong();
+
+        // left behind by some crashed instance
+        if (!isProcessAlive(entry.pid)) {
+            file.close();
+            QFile::remove(info.absoluteFilePath());
+            continue;
+        }
+
+        if (!entry.serviceName.isEmpty() && entry.pid != QCoreApplication::applicationPid()) {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+bool KateInstanceRegistry::writeEntry(const QString &directory, const Entry &entry)
+{
+    if (!QDir().mkpath(directory)) {
+        return false;
+    }
+
+    QSaveFile file(directory + QLatin1Char('/') + entry.serviceName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(serializeEntry(entry));
+    return file.commit();
+}
+
+KateInstanceRegistry::KateInstanceRegistry(const QString &serviceName, QObject *parent)
+    : QObject(parent)
+    , m_directory(defaultDirectory())
+{
+    m_entry.serviceName = serviceName;
+    m_entry.pid = QCoreApplication::applicationPid();
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(100);
+    connect(&m_updateTimer, &QTimer::timeout, this, &KateInstanceRegistry::update);
+
+    // all we publish: session, desktop + activities of our windows, the active window
+    connect(KateApp::self()->sessionManager(), &KateSessionManager::sessionChanged, &m_updateTimer, qOverload<>(&QTimer::start));
+    connect(qGuiApp, &QGuiApplication::focusWindowChanged, &m_updateTimer, qOverload<>(&QTimer::start));
+    connect(KWindowSystem::self(),
+            qOverload<WId, NET::Properties, NET::Properties2>(&KWindowSystem::windowChanged),
+            this,
+            [this](WId id, NET::Properties properties, NET::Properties2 properties2) {
+                if (!(properties & NET::WMDesktop) && !(properties2 & NET::WM2Activities)) {
+                    return;
+                }
+                for (int i = 0; i < KateApp::self()->mainWindowsCount(); ++i) {
+                    if (KateApp::self()->mainWindow(i)->winId() == id) {
+                        m_updateTimer.start();
+                        return;
+                    }
+                }
+            });
+
+#ifdef KF5Activities_FOUND
+    m_activities = new KActivities::Consumer(this);
+    connect(m_activities, &KActivities::Consumer::currentActivityChanged, &m_updateTimer, qOverload<>(&QTimer::start));
+    connect(m_activities, &KActivities::Consumer::serviceStatusChanged, &m_updateTimer, qOverload<>(&QTimer::start));
+#endif
+
+    update();
+}
+
+KateInstanceRegistry::~KateInstanceRegistry()
+{
+    QFile::remove(m_directory + QLatin1Char('/') + m_entry.serviceName);
+}
+
+void KateInstanceRegistry::update()
+{
+    KateApp *app = KateApp::self();
+    Entry entry = m_entry;
+    entry.sessionName = app->sessionManager()->activeSession() ? app->sessionManager()->activeSession()->name() : QString();
+
+    if (KateMainWindow *window = app->activeKateMainWindow()) {
+        entry.desktop = KWindowInfo(window->winId(), NET::WMDesktop).desktop();
+    }
+
+    // like KateApp::isOnActivity: usable if one window is on the activity or on all of them
+    entry.activities.clear();
+    for (int i = 0; i < app->mainWindowsCount(); ++i) {
+        const QStringList activities = KWindowInfo(app->mainWindow(i)->winId(), {}, NET::WM2Activities).activities();
+        if (activities.isEmpty()) {
+            entry.activities.clear();
+            break;
+        }
+        for (const QString &activity : activities) {
+            if (!entry.activities.contains(activity)) {
+                entry.activities.push_back(activity);
+            }
+        }
+    }
+
+#ifdef KF5Activities_FOUND
+    if (m_activities->serviceStatus() == KActivities::Consumer::Running) {
+        entry.currentActivity = m_activities->currentActivity();
+    }
+#endif
+
+    // nothing to tell if nothing changed
+    entry.updated = m_entry.updated;
+    if (m_entry.updated != 0 && serializeEntry(entry) == serializeEntry(m_entry)) {
+        return;
+    }
+
+    entry.updated = QDateTime::currentMSecsSinceEpoch();
+    if (!writeEntry(m_directory, entry)) {
+        qCWarning(LOG_KATE) << "Could not publish instance in" << m_directory;
+    }
+    m_entry = entry;
+}
@@ -0,0 +1,98 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#ifndef KATE_INSTANCEREGISTRY_H
+#define KATE_INSTANCEREGISTRY_H
+
+#include "config.h"
+#include "katetests_export.h"
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include <vector>
+
+#ifdef KF5Activities_FOUND
+namespace KActivities
+{
+class Consumer;
+}
+#endif
+
+/**
+ * Registry of the running Kate instances, one small file per instance in the runtime directory.
+ *
+ * Each instance publishes its DBus service, its session, the desktop of its active main window and
+ * the activities of its windows there and keeps them up to date. A new "kate file.cpp" can then
+ * pick the instance to hand over to without a blocking DBus call per running instance.
+ * Files of instances that died without cleanup are ignored and removed on lookup.
+ */
+class KATE_TESTS_EXPORT KateInstanceRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        QString serviceName;
+        qint64 pid = 0;
+        QString sessionName;
+        // desktop of the active main window, NET::OnAllDesktops for all
+        int desktop = 0;
+        // activities of the windows, empty if one of them is on all activities
+        QStringList activities;
+        // current activity as the instance knows it, empty if it doesn't know
+        QString currentActivity;
+        // msecs since epoch of the last update
+        qint64 updated = 0;
+    };
+
+    /**
+     * Not usable in sandboxes, they have their own pids + services, lookup via DBus then.
+     */
+    static bool isAvailable();
+
+    /**
+     * Default location, per user, in the runtime directory.
+     */
+    static QString defaultDirectory();
+
+    /**
+     * All running instances that published an entry.
+     */
+    static std::vector<Entry> runningInstances(const QString &directory = defaultDirectory());
+
+    /**
+     * Write the entry atomically, readers see either the old or the new one.
+     */
+    static bool writeEntry(const QString &directory, const Entry &entry);
+
+    /**
+     * Publish this instance under the given DBus service.
+     */
+    explicit KateInstanceRegistry(const QString &serviceName, QObject *parent = nullptr);
+
+    /**
+     * Removes the entry of this instance again.
+     */
+    ~KateInstanceRegistry() override;
+
+private:
+    void update();
+
+    const QString m_directory;
+    Entry m_entry;
+
+    // state changes come in bursts, e.g. on session switch, write once
+    QTimer m_updateTimer;
+
+#ifdef KF5Activities_FOUND
+    KActivities::Consumer *m_activities = nullptr;
+#endif
+};
+
+#endif
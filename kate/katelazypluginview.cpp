@@ -0,0 +1,181 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include "katelazypluginview.h"
+
+#include "katemainwindow.h"
+#include "katemdi.h"
+#include "katepluginmanager.h"
+
+#include <KActionCollection>
+#include <KConfigGroup>
+#include <KLocalizedString>
+#include <KTextEditor/Document>
+#include <KTextEditor/MainWindow>
+#include <KTextEditor/View>
+#include <KXMLGUIFactory>
+
+#include <QAction>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMimeDatabase>
+#include <QTimer>
+
+static QJsonObject lazyActivation(const KatePluginInfo *item)
+{
+    return item->metaData.rawData().value(QStringLiteral("X-Kate-LazyActivation")).toObject();
+}
+
+static KMultiTabBar::KMultiTabBarPosition toolViewPosition(const QString &position)
+{
+    if (position == QLatin1String("Left")) {
+        return KMultiTabBar::Left;
+    } else if (position == QLatin1String("Right")) {
+        return KMultiTabBar::Right;
+    } else if (position == QLatin1String("Top")) {
+        return KMultiTabBar::Top;
+    }
+    return KMultiTabBar::Bottom;
+}
+
+bool KateLazyPluginView::isLazy(const KatePluginInfo *item)
+{
+    return !lazyActivation(item).isEmpty();
+}
+
+KateLazyPluginView::KateLazyPluginView(KatePluginInfo *item, KateMainWindow *mainWindow)
+    : QObject(mainWindow)
+    , m_item(item)
+    , m_mainWindow(mainWindow)
+{
+    const QJsonObject lazy = lazyActivation(item);
+    const QJsonObject xmlGui = lazy.value(QStringLiteral("XmlGui")).toObject();
+    const QByteArray domain = xmlGui.value(QStringLiteral("TranslationDomain")).toString().toUtf8();
+    auto translate = [&domain](const QJsonValue &text) {
+        const QByteArray utf8 = text.toString().toUtf8();
+        return (domain.isEmpty() || utf8.isEmpty()) ? QString::fromUtf8(utf8) : ki18nd(domain.constData(), utf8.constData()).toString();
+    };
+
+    // placeholder tool views, session restore puts them where the real ones were
+    const QJsonArray toolViews = lazy.value(QStringLiteral("ToolViews")).toArray();
+    for (const auto &value : toolViews) {
+        const QJsonObject toolView = value.toObject();
+        const QString identifier = toolView.value(QStringLiteral("Id")).toString();
+        auto placeholder = mainWindow->KateMDI::MainWindow::createToolView(item->plugin,
+                                                                           identifier,
+                                                                           toolViewPosition(toolView.value(QStringLiteral("Position")).toString()),
+                                                                           QIcon::fromTheme(toolView.value(QStringLiteral("Icon")).toString()),
+                                                                           translate(toolView.value(QStringLiteral("Text"))));
+        if (!placeholder) {
+            continue;
+        }
+        connect(placeholder, &KateMDI::ToolView::toolVisibleChanged, this, [this](bool visible) {
+            if (visible) {
+                requestActivation();
+            }
+        });
+        m_toolViews.emplace_back(identifier, placeholder);
+    }
+
+    // placeholder actions, with the plugin's ui.rc they show up in the menus like the real ones
+    const QJsonArray actions = lazy.value(QStringLiteral("Actions")).toArray();
+    for (const auto &value : actions) {
+        const QJsonObject action = value.toObject();
+        const QString name = action.value(QStringLiteral("Name")).toString();
+        QAction *a = actionCollection()->addAction(name);
+        a->setText(translate(action.value(QStringLiteral("Text"))));
+        a->setIcon(QIcon::fromTheme(action.value(QStringLiteral("Icon")).toString()));
+        const QString shortcut = action.value(QStringLiteral("Shortcut")).toString();
+        if (!shortcut.isEmpty()) {
+            actionCollection()->setDefaultShortcut(a, QKeySequence::fromString(shortcut));
+        }
+        connect(a, &QAction::triggered, this, [this, name]() {
+            requestActivation(name);
+        });
+    }
+
+    if (!xmlGui.isEmpty()) {
+        KXMLGUIClient::setComponentName(xmlGui.value(QStringLiteral("Component")).toString(), item->metaData.name());
+        setXMLFile(xmlGui.value(QStringLiteral("File")).toString());
+    }
+    if (!xmlGui.isEmpty() || !actions.isEmpty()) {
+        m_mainWindow->guiFactory()->addClient(this);
+    }
+
+    // documents of the given types get the view once they are active
+    const QJsonArray mimeTypes = lazy.value(QStringLiteral("MimeTypes")).toArray();
+    for (const auto &value : mimeTypes) {
+        m_mimeTypes.push_back(value.toString());
+    }
+    if (!m_mimeTypes.isEmpty()) {
+        connect(m_mainWindow->wrapper(), &KTextEditor::MainWindow::viewChanged, this, &KateLazyPluginView::viewChanged);
+        QTimer::singleShot(0, this, [this]() {
+            viewChanged(m_mainWindow->wrapper()->activeView());
+        });
+    }
+}
+
+KateLazyPluginView::~KateLazyPluginView()
+{
+    if (factory()) {
+        factory()->removeClient(this);
+    }
+
+    for (const auto &toolView : m_toolViews) {
+        delete toolView.second.data();
+    }
+}
+
+void KateLazyPluginView::readSessionConfig(const KConfigGroup &config)
+{
+    m_sessionConfig = config.entryMap();
+}
+
+void KateLazyPluginView::writeSessionConfig(KConfigGroup &config) const
+{
+    for (auto it = m_sessionConfig.cbegin(); it != m_sessionConfig.cend(); ++it) {
+        config.writeEntry(it.key(), it.value());
+    }
+}
+
+std::vector<KateLazyPluginView::ToolViewPlacement> KateLazyPluginView::toolViewPlacements() const
+{
+    std::vector<ToolViewPlacement> placements;
+    for (const auto &[identifier, toolView] : m_toolViews) {
+        if (toolView) {
+            placements.push_back({identifier, m_mainWindow->toolViewPosition(toolView), toolView->toolVisible()});
+        }
+    }
+    return placements;
+}
+
+void KateLazyPluginView::requestActivation(const QString &action)
+{
+    if (m_activationRequested) {
+        return;
+    }
+    m_activationRequested = true;
+
+    // we get deleted on activation
+    QTimer::singleShot(0, m_mainWindow, [item = m_item, mainWindow = m_mainWindow, action]() {
+        KatePluginManager::activatePluginView(item, mainWindow, action);
+    });
+}
+
+void KateLazyPluginView::viewChanged(KTextEditor::View *view)
+{
+    if (!view) {
+        return;
+    }
+
+    const QMimeType mimeType = QMimeDatabase().mimeTypeForName(view->document()->mimeType());
+    for (const QString &name : qAsConst(m_mimeTypes)) {
+        if (mimeType.inherits(name)) {
+            requestActivation();
+            return;
+        }
+    }
+}
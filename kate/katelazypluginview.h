@@ -0,0 +1,102 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#ifndef KATE_LAZYPLUGINVIEW_H
+#define KATE_LAZYPLUGINVIEW_H
+
+#include <KMultiTabBar>
+#include <KXMLGUIClient>
+
+#include <QMap>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+
+#include <utility>
+#include <vector>
+
+class KConfigGroup;
+class KateMainWindow;
+class KatePluginInfo;
+
+namespace KateMDI
+{
+class ToolView;
+}
+
+namespace KTextEditor
+{
+class View;
+}
+
+/**
+ * Stand-in for the view of a plugin that declares lazy activation triggers in its metadata, e.g.
+ *
+ *   "X-Kate-LazyActivation": {
+ *       "ToolViews": [{ "Id": "kate_plugin_katesearch", "Position": "Bottom", "Icon": "edit-find", "Text": "Search and Replace" }],
+ *       "MimeTypes": ["text/x-c++src"],
+ *       "XmlGui": { "Component": "katesearch", "File": "ui.rc", "TranslationDomain": "katesearch" },
+ *       "Actions": [{ "Name": "search_in_files", "Text": "Search in Files", "Shortcut": "Ctrl+Shift+F" }]
+ *   }
+ *
+ * The declared tool views and actions are shown as placeholders, the actions merged into the menus
+ * of the plugin's ui.rc. The real view is created once a placeholder tool view gets shown, a placeholder
+ * action is triggered, a document of one of the MIME types gets active or someone asks for the view.
+ * Texts are translated with the translation domain of the plugin.
+ */
+class KateLazyPluginView : public QObject, public KXMLGUIClient
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Does the plugin declare any lazy activation triggers?
+     */
+    static bool isLazy(const KatePluginInfo *item);
+
+    KateLazyPluginView(KatePluginInfo *item, KateMainWindow *mainWindow);
+    ~KateLazyPluginView() override;
+
+    KatePluginInfo *pluginInfo() const
+    {
+        return m_item;
+    }
+
+    /**
+     * Session config of the view, kept until the view exists.
+     */
+    void readSessionConfig(const KConfigGroup &config);
+    void writeSessionConfig(KConfigGroup &config) const;
+
+    struct ToolViewPlacement {
+        QString identifier;
+        KMultiTabBar::KMultiTabBarPosition position;
+        bool visible;
+    };
+
+    /**
+     * Where the placeholder tool views are, the real ones shall take their place.
+     */
+    std::vector<ToolViewPlacement> toolViewPlacements() const;
+
+private:
+    /**
+     * Create the real view, later, as we might be called from one of our placeholders.
+     * @param action name of the action to trigger afterwards, if any
+     */
+    void requestActivation(const QString &action = QString());
+
+    void viewChanged(KTextEditor::View *view);
+
+    KatePluginInfo *const m_item;
+    KateMainWindow *const m_mainWindow;
+    QMap<QString, QString> m_sessionConfig;
+    std::vector<std::pair<QString, QPointer<KateMDI::ToolView>>> m_toolViews;
+    QStringList m_mimeTypes;
+    bool m_activationRequested = false;
+};
+
+#endif
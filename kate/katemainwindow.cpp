@@ -18,6 +18,7 @@
 #include "katedebug.h"
 #include "katedocmanager.h"
 #include "katefileactions.h"
+#include "katelazypluginview.h"
 #include "katemwmodonhddialog.h"
 #include "kateoutputview.h"
 #include "katepluginmanager.h"
@@ -68,6 +69,8 @@
 
 #include <ktexteditor/sessionconfiginterface.h>
 
+#include <katetrace.h>
+
 // END
 
 KateMwModOnHdDialog *KateMainWindow::s_modOnHdDialog = nullptr;
@@ -98,6 +101,8 @@ KateMainWindow::KateMainWindow(KConfig *sconfig, const QString &sgroup)
     , m_modignore(false)
     , m_wrapper(new KTextEditor::MainWindow(this))
 {
+    KateTraceZone zone("create main window");
+
     /**
      * we don't want any flicker here
      */
@@ -146,6 +151,7 @@ KateMainWindow::KateMainWindow(KConfig *sconfig, const QString &sgroup)
     readOptions();
 
     if (sconfig) {
+        KateTraceZone zone("restore view configuration");
         m_viewManager->restoreViewConfiguration(KConfigGroup(sconfig, sgroup));
     }
 
@@ -661,9 +667,12 @@ void KateMainWindow::readOptions()
     m_modCloseAfterLast = generalGroup.readEntry("Close After Last", false);
     KateApp::self()->documentManager()->setSaveMetaInfos(generalGroup.readEntry("Save Meta Infos", true));
     KateApp::self()->documentManager()->setDaysMetaInfos(generalGroup.readEntry("Days Meta Infos", 30));
+    KateApp::self()->documentManager()->setMemoryBudget(generalGroup.readEntry("Document Memory Budget", 0));
 
     KateApp::self()->stashManager()->setStashUnsavedChanges(generalGroup.readEntry("Stash unsaved file changes", false));
     KateApp::self()->stashManager()->setStashNewUnsavedFiles(generalGroup.readEntry("Stash new unsaved files", true));
+    KateApp::self()->stashManager()->setCompressStash(generalGroup.readEntry("Compress Stash", false));
+    KateApp::self()->stashManager()->setAutoStashInterval(generalGroup.readEntry("Auto Stash Interval", 60));
 
     m_paShowPath->setChecked(generalGroup.readEntry("Show Full Path in Title", false));
     m_paShowStatusBar->setChecked(generalGroup.readEntry("Show Status Bar", true));
@@ -846,14 +855,16 @@ void KateMainWindow::slotDropEvent(QDropEvent *event)
 void KateMainWindow::slotListRecursiveEntries(KIO::Job *job, const KIO::UDSEntryList &list)
 {
     const QUrl dir = static_cast<KIO::SimpleJob *>(job)->url();
+    QList<QUrl> urls;
     for (const KIO::UDSEntry &entry : list) {
         if (!entry.isDir()) {
             QUrl url(dir);
             url = url.adjusted(QUrl::StripTrailingSlash);
             url.setPath(url.path() + QLatin1Char('/') + entry.stringValue(KIO::UDSEntry::UDS_NAME));
-            m_viewManager->openUrl(url);
+            urls.push_back(url);
         }
     }
+    openUrls(urls);
 }
 
 void KateMainWindow::editKeys()
@@ -1082,6 +1093,10 @@ void KateMainWindow::saveProperties(KConfigGroup &config)
                 KConfigGroup group(config.config(), QStringLiteral("Plugin:%1:MainWindow:%2").arg(item.saveName()).arg(id));
                 interface->writeSessionConfig(group);
             }
+        } else if (auto lazyView = m_lazyPluginViews.value(item.plugin)) {
+            // keep the config of views never created in this session
+            KConfigGroup group(config.config(), QStringLiteral("Plugin:%1:MainWindow:%2").arg(item.saveName()).arg(id));
+            lazyView->writeSessionConfig(group);
         }
     }
 
@@ -1238,6 +1253,11 @@ QObject *KateMainWindow::pluginView(const QString &name)
         return nullptr;
     }
 
+    // someone needs the view of a lazily activated plugin, create it now
+    if (auto lazyView = m_lazyPluginViews.value(plugin)) {
+        KatePluginManager::activatePluginView(lazyView->pluginInfo(), this);
+    }
+
     return m_pluginViews.contains(plugin) ? m_pluginViews.value(plugin) : nullptr;
 }
 
@@ -1247,6 +1267,16 @@ void KateMainWindow::addWidgetAsTab(QWidget *widget)
     vs->addWidgetAsTab(widget);
 }
 
+void KateMainWindow::openUrls(const QList<QUrl> &urls)
+{
+    KateDocumentInfo docInfo;
+    docInfo.openedByUser = true;
+    const auto docs = m_viewManager->openUrls(urls, QString(), false, docInfo);
+    if (!docs.empty()) {
+        m_viewManager->activateView(docs.back());
+    }
+}
+
 void KateMainWindow::mousePressEvent(QMouseEvent *e)
 {
     switch (e->button()) {
@@ -40,6 +40,7 @@ typedef class QList<UDSEntry> UDSEntryList;
 class KFileItem;
 class KRecentFilesAction;
 
+class KateLazyPluginView;
 class KateOutputView;
 class KateViewManager;
 class KateMwModOnHdDialog;
@@ -231,6 +232,14 @@ public:
         return m_pluginViews;
     }
 
+    /**
+     * stand-ins for the views of lazily activated plugins, see KateLazyPluginView
+     */
+    QHash<KTextEditor::Plugin *, KateLazyPluginView *> &lazyPluginViews()
+    {
+        return m_lazyPluginViews;
+    }
+
     QWidget *bottomViewBarContainer()
     {
         return m_bottomViewBarContainer;
@@ -515,6 +524,13 @@ public Q_SLOTS:
 
     void addWidgetAsTab(QWidget *widget);
 
+    /**
+     * Open many documents at once, their files are read ahead in parallel
+     * and the views get one update for all of them. The last one gets activated.
+     * \param urls the documents' urls
+     */
+    void openUrls(const QList<QUrl> &urls);
+
 private Q_SLOTS:
     void slotUpdateBottomViewBar();
 
@@ -557,6 +573,7 @@ private:
 
     // all plugin views for this mainwindow, used by the pluginmanager
     QHash<KTextEditor::Plugin *, QObject *> m_pluginViews;
+    QHash<KTextEditor::Plugin *, KateLazyPluginView *> m_lazyPluginViews;
 
     // options: show statusbar + show path
     KToggleAction *m_paShowPath = nullptr;
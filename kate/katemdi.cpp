@@ -938,7 +938,7 @@ ToolView *MainWindow::createToolView(KTextEditor::Plugin *plugin,
                                      const QIcon &icon,
                                      const QString &text)
 {
-    if (m_idToWidget[identifier]) {
+    if (toolView(identifier)) {
         return nullptr;
     }
 
@@ -970,6 +970,11 @@ ToolView *MainWindow::toolView(const QString &identifier) const
     return nullptr;
 }
 
+KMultiTabBar::KMultiTabBarPosition MainWindow::toolViewPosition(ToolView *widget) const
+{
+    return widget->sidebar()->position();
+}
+
 void MainWindow::toolViewDeleted(ToolView *widget)
 {
     if (!widget) {
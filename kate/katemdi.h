@@ -307,6 +307,13 @@ public:
      */
     ToolView *toolView(const QString &identifier) const;
 
+    /**
+     * position of the given toolview
+     * @param widget toolview
+     * @return sidebar the toolview is in
+     */
+    KMultiTabBar::KMultiTabBarPosition toolViewPosition(ToolView *widget) const;
+
     /**
      * set the toolview's tabbar style.
      * @param style the tabbar style.
@@ -0,0 +1,422 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include "katemetainfos.h"
+
+#include "katedebug.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+#include <QDataStream>
+#include <QFile>
+#include <QLockFile>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <vector>
+
+// file starts with this and the number of compactions so far, followed by records of: quint32 size, size bytes of payload
+static constexpr quint32 MetaInfosMagic = 0x4b4d4932; // KMI2
+static constexpr qint64 MetaInfosHeaderSize = 8;
+
+// compact once the file is at least that large and holds more outdated than live records
+static constexpr qint64 MinCompactSize = 1024 * 1024;
+
+static QByteArray serializeHeader(quint32 compactions)
+{
+    QByteArray data;
+    QDataStream header(&data, QIODevice::WriteOnly);
+    header << MetaInfosMagic << compactions;
+    return data;
+}
+
+static QByteArray serializeRecord(const QString &url, const KateMetaInfos::Record &record)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << url << record.checksum << record.time.toMSecsSinceEpoch() << record.config;
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << quint32(payload.size());
+    data.append(payload);
+    return data;
+}
+
+/**
+ * Parse a record payload, the config only if record is given.
+ */
+static bool parseRecord(const QByteArray &payload, QString &url, QByteArray &checksum, qint64 &time, KateMetaInfos::Record *record)
+{
+    QDataStream stream(payload);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream >> url >> checksum >> time;
+    if (record) {
+        record->checksum = checksum;
+        record->time = QDateTime::fromMSecsSinceEpoch(time, Qt::UTC);
+        stream >> record->config;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+KateMetaInfos::KateMetaInfos(const QString &fileName, const QString &legacyConfig, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+{
+    m_writer.setMaxThreadCount(1);
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(1000);
+    connect(&m_flushTimer, &QTimer::timeout, this, &KateMetaInfos::flush);
+
+    // the index is small and quickly built, parsing the old config file is not
+    QFile file(m_fileName);
+    if (file.exists()) {
+        if (file.open(QIODevice::ReadOnly)) {
+            readChanges(file);
+        }
+    } else if (!legacyConfig.isEmpty()) {
+        m_writer.start([this, legacyConfig]() {
+            importLegacyConfig(legacyConfig);
+        });
+    }
+}
+
+KateMetaInfos::~KateMetaInfos()
+{
+    m_flushTimer.stop();
+    sync();
+}
+
+bool KateMetaInfos::readChanges(QFile &file)
+{
+    // a new or compacted file is read completely, otherwise only what got appended since
+    QDataStream header(file.read(MetaInfosHeaderSize));
+    quint32 magic = 0;
+    quint32 compactions = 0;
+    header >> magic >> compactions;
+    if (magic != MetaInfosMagic) {
+        // an empty file is created by the first write, anything else is not ours to overwrite
+        const bool foreign = header.status() == QDataStream::Ok;
+        if (foreign) {
+            qCWarning(LOG_KATE) << "Ignoring meta infos with unknown format" << m_fileName;
+        }
+        QMutexLocker lock(&m_mutex);
+        m_index.clear();
+        m_fileSize = 0;
+        m_liveSize = 0;
+        m_compactions = 0;
+        return !foreign;
+    }
+
+    const bool full = compactions != m_compactions || m_fileSize == 0 || file.size() < m_fileSize;
+    const qint64 start = full ? MetaInfosHeaderSize : m_fileSize;
+    if (!file.seek(start)) {
+        return true;
+    }
+    const QByteArray data = file.readAll();
+
+    // url => entry, an empty entry for a removal
+    std::vector<std::pair<QString, IndexEntry>> changes;
+    qint64 pos = 0;
+    while (pos + 4 <= data.size()) {
+        QDataStream sizeStream(QByteArray::fromRawData(data.constData() + pos, 4));
+        quint32 size = 0;
+        sizeStream >> size;
+        if (pos + 4 + size > data.size()) {
+            // truncated record, e.g. after a crash, gets overwritten on next write
+            break;
+        }
+
+        QString url;
+        QByteArray checksum;
+        qint64 time = 0;
+        if (!parseRecord(QByteArray::fromRawData(data.constData() + pos + 4, size), url, checksum, time, nullptr)) {
+            break;
+        }
+
+        changes.emplace_back(url, checksum.isEmpty() ? IndexEntry() : IndexEntry{start + pos, 4 + qint64(size), time});
+        pos += 4 + size;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    if (full) {
+        m_index.clear();
+        m_liveSize = 0;
+        m_compactions = compactions;
+    }
+    for (const auto &change : changes) {
+        const auto old = m_index.find(change.first);
+        if (old != m_index.end()) {
+            m_liveSize -= old->size;
+            m_index.erase(old);
+        }
+        if (change.second.size > 0) {
+            m_index.insert(change.first, change.second);
+            m_liveSize += change.second.size;
+        }
+    }
+    m_fileSize = start + pos;
+    return true;
+}
+
+void KateMetaInfos::importLegacyConfig(const QString &legacyConfig)
+{
+    KConfig config(legacyConfig, KConfig::NoGlobals);
+    const QStringList groups = config.groupList();
+    if (groups.isEmpty()) {
+        return;
+    }
+
+    QVector<Change> changes;
+    changes.reserve(groups.size());
+    for (const QString &group : groups) {
+        const KConfigGroup cg(&config, group);
+        Change change;
+        change.url = group;
+        change.record.checksum = cg.readEntry("Checksum").toLatin1();
+        change.record.time = cg.readEntry("Time", QDateTime());
+        change.record.config = cg.entryMap();
+        change.record.config.remove(QStringLiteral("Checksum"));
+        change.record.config.remove(QStringLiteral("Time"));
+        if (!change.record.checksum.isEmpty()) {
+            changes.push_back(change);
+        }
+    }
+
+    qCDebug(LOG_KATE) << "Importing" << changes.size() << "meta infos from" << legacyConfig;
+    write(changes);
+}
+
+bool KateMetaInfos::readRecord(const IndexEntry &entry, QString &url, Record &record) const
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(entry.offset + 4)) {
+        return false;
+    }
+
+    const QByteArray payload = file.read(entry.size - 4);
+    QByteArray checksum;
+    qint64 time = 0;
+    return payload.size() == entry.size - 4 && parseRecord(payload, url, checksum, time, &record);
+}
+
+bool KateMetaInfos::find(const QString &url, Record &record)
+{
+    QMutexLocker lock(&m_mutex);
+
+    const auto unwritten = m_unwritten.constFind(url);
+    if (unwritten != m_unwritten.constEnd()) {
+        if (unwritten->record.checksum.isEmpty()) {
+            return false;
+        }
+        record = unwritten->record;
+        return true;
+    }
+
+    const auto it = m_index.constFind(url);
+    if (it == m_index.constEnd()) {
+        return false;
+    }
+
+    QString storedUrl;
+    return readRecord(it.value(), storedUrl, record) && storedUrl == url;
+}
+
+void KateMetaInfos::insert(const QString &url, const Record &record)
+{
+    QMutexLocker lock(&m_mutex);
+    Change change{url, record, ++m_generation};
+    m_unwritten.insert(url, change);
+    m_pending.push_back(change);
+    m_flushTimer.start();
+}
+
+void KateMetaInfos::remove(const QString &url)
+{
+    insert(url, Record());
+}
+
+void KateMetaInfos::removeOlderThan(const QDateTime &time)
+{
+    QMutexLocker lock(&m_mutex);
+    const qint64 msecs = time.toMSecsSinceEpoch();
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        if (it->time < msecs && !m_unwritten.contains(it.key())) {
+            Change change{it.key(), Record(), ++m_generation};
+            m_unwritten.insert(it.key(), change);
+            m_pending.push_back(change);
+        }
+    }
+    m_flushTimer.start();
+}
+
+int KateMetaInfos::count()
+{
+    QMutexLocker lock(&m_mutex);
+    int count = m_index.size();
+    for (const Change &change : qAsConst(m_unwritten)) {
+        const bool indexed = m_index.contains(change.url);
+        if (change.record.checksum.isEmpty() && indexed) {
+            --count;
+        } else if (!change.record.checksum.isEmpty() && !indexed) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void KateMetaInfos::flush()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    m_writer.start([this, changes = std::move(m_pending)]() {
+        write(changes);
+        compactIfNeeded();
+    });
+    m_pending.clear();
+}
+
+void KateMetaInfos::sync()
+{
+    flush();
+    m_writer.waitForDone();
+}
+
+void KateMetaInfos::write(const QVector<Change> &changes)
+{
+    // all instances share the file, append to what it really holds now
+    QLockFile fileLock(lockFileName());
+    QFile file(m_fileName);
+    bool written = fileLock.lock() && file.open(QIODevice::ReadWrite);
+    if (written && !readChanges(file)) {
+        // a newer or foreign format, keep it around instead of truncating it
+        file.close();
+        const QString aside = m_fileName + QStringLiteral(".unknown");
+        QFile::remove(aside);
+        written = QFile::rename(m_fileName, aside) && file.open(QIODevice::ReadWrite);
+        if (written) {
+            qCWarning(LOG_KATE) << "Moved meta infos with unknown format to" << aside;
+        }
+    }
+
+    // only this thread changes the file size, no lock needed for that
+    QByteArray data;
+    if (m_fileSize == 0) {
+        data = serializeHeader(m_compactions);
+    }
+
+    std::vector<qint64> offsets;
+    offsets.reserve(changes.size());
+    for (const Change &change : changes) {
+        offsets.push_back(m_fileSize + data.size());
+        data.append(serializeRecord(change.url, change.record));
+    }
+
+    written = written && file.resize(m_fileSize) && file.seek(m_fileSize) && file.write(data) == data.size();
+    file.close();
+    if (!written) {
+        qCWarning(LOG_KATE) << "Could not write meta infos to" << m_fileName << file.errorString();
+    }
+
+    QMutexLocker lock(&m_mutex);
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        const Change &change = changes[i];
+
+        // written or not, the change is no longer pending unless overwritten meanwhile
+        const auto unwritten = m_unwritten.find(change.url);
+        if (unwritten != m_unwritten.end() && unwritten->generation == change.generation) {
+            m_unwritten.erase(unwritten);
+        }
+
+        if (!written) {
+            continue;
+        }
+
+        const auto old = m_index.find(change.url);
+        if (old != m_index.end()) {
+            m_liveSize -= old->size;
+            m_index.erase(old);
+        }
+
+        if (!change.record.checksum.isEmpty()) {
+            const qint64 end = (i + 1 < offsets.size()) ? offsets[i + 1] : m_fileSize + data.size();
+            m_index.insert(change.url, {offsets[i], end - offsets[i], change.record.time.toMSecsSinceEpoch()});
+            m_liveSize += end - offsets[i];
+        }
+    }
+
+    if (written) {
+        m_fileSize += data.size();
+    }
+}
+
+void KateMetaInfos::compactIfNeeded()
+{
+    // only this thread changes index and file, readers just read, no lock needed for that
+    if (m_fileSize < MinCompactSize || m_liveSize * 2 > m_fileSize) {
+        return;
+    }
+
+    // other instances may have appended or compacted meanwhile
+    QLockFile fileLock(lockFileName());
+    if (!fileLock.lock()) {
+        return;
+    }
+
+    QFile in(m_fileName);
+    if (!in.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    readChanges(in);
+    if (m_fileSize < MinCompactSize || m_liveSize * 2 > m_fileSize) {
+        return;
+    }
+
+    // the new number of compactions tells the other instances their offsets are outdated
+    QSaveFile out(m_fileName);
+    if (!out.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    out.write(serializeHeader(m_compactions + 1));
+
+    QHash<QString, IndexEntry> index;
+    index.reserve(m_index.size());
+    qint64 pos = MetaInfosHeaderSize;
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        if (!in.seek(it->offset)) {
+            return;
+        }
+        const QByteArray data = in.read(it->size);
+        if (data.size() != it->size || out.write(data) != data.size()) {
+            return;
+        }
+        index.insert(it.key(), {pos, it->size, it->time});
+        pos += it->size;
+    }
+    in.close();
+
+    // swap file and index at once for readers
+    QMutexLocker lock(&m_mutex);
+    if (!out.commit()) {
+        qCWarning(LOG_KATE) << "Could not compact meta infos" << m_fileName << out.errorString();
+        return;
+    }
+    m_index = index;
+    m_fileSize = pos;
+    m_liveSize = pos - MetaInfosHeaderSize;
+    ++m_compactions;
+}
+
+QString KateMetaInfos::lockFileName() const
+{
+    return m_fileName + QStringLiteral(".lock");
+}
@@ -0,0 +1,121 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#ifndef KATE_METAINFOS_H
+#define KATE_METAINFOS_H
+
+#include "katetests_export.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+/**
+ * Store for the meta infos of documents, like cursor position, bookmarks, encoding and mode.
+ *
+ * The store is a single append-only file of records, each with the url, the checksum
+ * of the document, the time of the last update and the session config of the document.
+ * On open, only an index url => record position is built, records themselves are read
+ * on lookup. Updates and removals are collected and appended in batches on a worker thread.
+ * Once the file holds more outdated than live data, it is compacted on that thread, too.
+ * All running instances share the file, appending and compacting happen with a lock file
+ * held and first read what the other instances wrote since.
+ *
+ * A missing store is initialized from the KConfig based "katemetainfos" file of older versions.
+ */
+class KATE_TESTS_EXPORT KateMetaInfos : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Record {
+        QByteArray checksum;
+        QDateTime time;
+        QMap<QString, QString> config;
+    };
+
+    /**
+     * Open the store in the given file, will be created on first write.
+     * @param legacyConfig KConfig file to import from if the store does not exist yet, empty for none
+     */
+    explicit KateMetaInfos(const QString &fileName, const QString &legacyConfig = QString(), QObject *parent = nullptr);
+
+    /**
+     * Writes all pending changes.
+     */
+    ~KateMetaInfos() override;
+
+    bool find(const QString &url, Record &record);
+    void insert(const QString &url, const Record &record);
+    void remove(const QString &url);
+
+    /**
+     * Remove all records last updated before the given time.
+     */
+    void removeOlderThan(const QDateTime &time);
+
+    /**
+     * Number of records in the store.
+     */
+    int count();
+
+    /**
+     * Block until all changes are written.
+     */
+    void sync();
+
+    /**
+     * Write pending changes in the background, done automatically shortly after changes.
+     */
+    void flush();
+
+private:
+    struct IndexEntry {
+        qint64 offset = 0;
+        qint64 size = 0;
+        qint64 time = 0;
+    };
+
+    struct Change {
+        QString url;
+        // empty checksum => removal
+        Record record;
+        quint64 generation = 0;
+    };
+
+    bool readChanges(QFile &file);
+    void importLegacyConfig(const QString &legacyConfig);
+    void write(const QVector<Change> &changes);
+    void compactIfNeeded();
+    bool readRecord(const IndexEntry &entry, QString &url, Record &record) const;
+    QString lockFileName() const;
+
+    const QString m_fileName;
+
+    // guards all members below, the worker thread writes with it held
+    QMutex m_mutex;
+    QHash<QString, IndexEntry> m_index;
+    // changes not yet written, by url, with their generation to know if they got overwritten meanwhile
+    QHash<QString, Change> m_unwritten;
+    QVector<Change> m_pending;
+    quint64 m_generation = 0;
+    qint64 m_fileSize = 0;
+    qint64 m_liveSize = 0;
+    quint32 m_compactions = 0;
+
+    // single thread, writes happen in order
+    QThreadPool m_writer;
+    QTimer m_flushTimer;
+};
+
+#endif
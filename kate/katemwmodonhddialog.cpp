@@ -16,19 +16,22 @@
 
 #include <KLocalizedString>
 #include <KMessageBox>
-#include <KProcess>
 
 #include <QDir>
+#include <QFile>
 #include <QHeaderView>
 #include <QLabel>
+#include <QPointer>
 #include <QPushButton>
-#include <QStandardPaths>
 #include <QStyle>
 #include <QTemporaryFile>
-#include <QTextStream>
+#include <QTextCodec>
+#include <QThreadPool>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 
+#include <linediff.h>
+
 class KateDocItem : public QTreeWidgetItem
 {
 public:
@@ -53,9 +56,6 @@ public:
 
 KateMwModOnHdDialog::KateMwModOnHdDialog(DocVector docs, QWidget *parent, const char *name)
     : QDialog(parent)
-    , m_fullDiffPath(QStandardPaths::findExecutable(QStringLiteral("diff")))
-    , m_proc(nullptr)
-    , m_diffFile(nullptr)
     , m_blockAddDocument(false)
 {
     setWindowTitle(i18n("Documents Modified on Disk"));
@@ -108,9 +108,8 @@ KateMwModOnHdDialog::KateMwModOnHdDialog(DocVector docs, QWidget *parent, const
     btnDiff->setWhatsThis(
         i18n("Calculates the difference between the editor contents and the disk "
              "file for the selected document, and shows the difference with the "
-             "default application. Requires diff(1)."));
+             "default application."));
     hb->addWidget(btnDiff);
-    btnDiff->setEnabled(!m_fullDiffPath.isEmpty());
     connect(btnDiff, &QPushButton::clicked, this, &KateMwModOnHdDialog::slotDiff);
 
     // Dialog buttons
@@ -144,19 +143,6 @@ KateMwModOnHdDialog::KateMwModOnHdDialog(DocVector docs, QWidget *parent, const
 KateMwModOnHdDialog::~KateMwModOnHdDialog()
 {
     KateMainWindow::unsetModifiedOnDiscDialogIfIf(this);
-
-    if (m_proc) {
-        m_proc->kill();
-        m_proc->waitForFinished();
-        delete m_proc;
-        m_proc = Q_NULLPTR;
-    }
-
-    if (m_diffFile) {
-        m_diffFile->setAutoRemove(true);
-        delete m_diffFile;
-        m_diffFile = Q_NULLPTR;
-    }
 }
 
 void KateMwModOnHdDialog::slotIgnore()
@@ -264,11 +250,9 @@ void KateMwModOnHdDialog::slotCheckedFilesChanged(QTreeWidgetItem *, int column)
     dlgButtons->setEnabled(false);
 }
 
-// ### the code below is slightly modified from kdelibs/kate/part/katedialogs,
-// class KateModOnHdPrompt.
 void KateMwModOnHdDialog::slotDiff()
 {
-    if (!btnDiff->isEnabled()) { // diff button already pressed, proc not finished yet
+    if (!btnDiff->isEnabled()) { // diff button already pressed, diff not finished yet
         return;
     }
 
@@ -283,73 +267,72 @@ void KateMwModOnHdDialog::slotDiff()
         return;
     }
 
-    if (m_diffFile) {
+    if (m_diffRunning) {
         return;
     }
-
-    m_diffFile = new QTemporaryFile();
-    m_diffFile->open();
-
-    // Start a KProcess that creates a diff
-    // We use the full path to don't launch some random "diff" in current working directory
-    m_proc = new KProcess(this);
-    m_proc->setOutputChannelMode(KProcess::MergedChannels);
-    *m_proc << m_fullDiffPath << QStringLiteral("-ub") << QStringLiteral("-") << doc->url().toLocalFile();
-    connect(m_proc, &KProcess::readyRead, this, &KateMwModOnHdDialog::slotDataAvailable);
-    connect(m_proc, static_cast<void (KProcess::*)(int, QProcess::ExitStatus)>(&KProcess::finished), this, &KateMwModOnHdDialog::slotPDone);
+    m_diffRunning = true;
 
     setCursor(Qt::WaitCursor);
     btnDiff->setEnabled(false);
 
-    m_proc->start();
-
-    QTextStream ts(m_proc);
-    int lastln = doc->lines() - 1;
-    for (int l = 0; l < lastln; ++l) {
-        ts << doc->line(l) << QLatin1Char('\n');
+    // the buffer must be read here, reading + decoding the file and the diff itself happen on a worker thread
+    QStringList documentLines;
+    documentLines.reserve(doc->lines());
+    for (int l = 0; l < doc->lines(); ++l) {
+        documentLines.push_back(doc->line(l));
     }
-    ts << doc->line(lastln);
-    ts.flush();
-    m_proc->closeWriteChannel();
-}
 
-void KateMwModOnHdDialog::slotDataAvailable()
-{
-    m_diffFile->write(m_proc->readAll());
+    QPointer<KateMwModOnHdDialog> dialog(this);
+    QThreadPool::globalInstance()->start([dialog, documentLines, fileName = doc->url().toLocalFile(), encoding = doc->encoding().toLatin1()]() {
+        QString diff;
+        bool readable = false;
+        QFile file(fileName);
+        if (file.open(QIODevice::ReadOnly)) {
+            readable = true;
+            QTextCodec *codec = QTextCodec::codecForName(encoding);
+            const QByteArray data = file.readAll();
+            const QStringList diskLines = LineDiff::splitLines(codec ? codec->toUnicode(data) : QString::fromUtf8(data));
+
+            // like diff -ub, buffer against disk file
+            const auto hunks = LineDiff::diff(documentLines, diskLines, LineDiff::IgnoreWhitespaceAmount);
+            diff = LineDiff::unifiedDiff(documentLines, diskLines, hunks, QStringLiteral("-"), fileName);
+        }
+
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [dialog, diff, readable]() {
+                if (dialog) {
+                    dialog->diffDone(diff, readable);
+                }
+            },
+            Qt::QueuedConnection);
+    });
 }
 
-void KateMwModOnHdDialog::slotPDone()
+void KateMwModOnHdDialog::diffDone(const QString &diff, bool readable)
 {
+    m_diffRunning = false;
     setCursor(Qt::ArrowCursor);
     slotSelectionChanged(twDocuments->currentItem(), nullptr);
 
-    const QProcess::ExitStatus es = m_proc->exitStatus();
-    delete m_proc;
-    m_proc = nullptr;
-
-    if (es != QProcess::NormalExit) {
-        KMessageBox::sorry(this,
-                           i18n("The diff command failed. Please make sure that "
-                                "diff(1) is installed and in your PATH."),
-                           i18n("Error Creating Diff"));
-        delete m_diffFile;
-        m_diffFile = nullptr;
+    if (!readable) {
+        KMessageBox::sorry(this, i18n("The file on disk could not be read."), i18n("Error Creating Diff"));
         return;
     }
 
-    if (m_diffFile->size() == 0) {
+    if (diff.isEmpty()) {
         KMessageBox::information(this, i18n("Ignoring amount of white space changed, the files are identical."), i18n("Diff Output"));
-        delete m_diffFile;
-        m_diffFile = nullptr;
         return;
     }
 
-    m_diffFile->setAutoRemove(false);
-    const QUrl url = QUrl::fromLocalFile(m_diffFile->fileName());
-    delete m_diffFile;
-    m_diffFile = nullptr;
+    QTemporaryFile diffFile(QDir::tempPath() + QStringLiteral("/kate-XXXXXX.diff"));
+    if (!diffFile.open() || diffFile.write(diff.toUtf8()) < 0) {
+        KMessageBox::sorry(this, i18n("The difference could not be written to a temporary file."), i18n("Error Creating Diff"));
+        return;
+    }
+    diffFile.setAutoRemove(false);
 
-    Q_EMIT requestOpenDiffDocument(url);
+    Q_EMIT requestOpenDiffDocument(QUrl::fromLocalFile(diffFile.fileName()));
 }
 
 void KateMwModOnHdDialog::addDocument(KTextEditor::Document *doc)
@@ -13,8 +13,6 @@
 #include <QDialog>
 #include <QVector>
 
-class KProcess;
-class QTemporaryFile;
 class QTreeWidget;
 class QTreeWidgetItem;
 
@@ -51,20 +49,22 @@ private Q_SLOTS:
     void slotDiff();
     void slotSelectionChanged(QTreeWidgetItem *current, QTreeWidgetItem *);
     void slotCheckedFilesChanged(QTreeWidgetItem *, int column);
-    void slotDataAvailable();
-    void slotPDone();
 
 private:
     enum Action { Ignore, Overwrite, Reload };
     void handleSelected(int action);
+
+    /**
+     * The diff of buffer against disk file is there, empty if there is no difference.
+     */
+    void diffDone(const QString &diff, bool readable);
+
     class QTreeWidget *twDocuments;
     class QDialogButtonBox *dlgButtons;
     class QPushButton *btnDiff;
-    QString m_fullDiffPath;
-    KProcess *m_proc;
-    QTemporaryFile *m_diffFile;
     QStringList m_stateTexts;
     bool m_blockAddDocument;
+    bool m_diffRunning = false;
     bool m_showOnWindowActivation = false;
 
 protected:
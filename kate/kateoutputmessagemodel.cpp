@@ -0,0 +1,422 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#include "kateoutputmessagemodel.h"
+
+#include <KLocalizedString>
+
+#include <algorithm>
+
+#include <kfts_fuzzy_match.h>
+
+KateOutputMessageModel::KateOutputMessageModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+    // one icon + text per type, not per message
+    m_typeIcons[Error] = QIcon::fromTheme(QStringLiteral("data-error"));
+    m_typeIcons[Warning] = QIcon::fromTheme(QStringLiteral("data-warning"));
+    m_typeIcons[Info] = QIcon::fromTheme(QStringLiteral("data-information"));
+    m_typeIcons[Log] = QIcon::fromTheme(QStringLiteral("dialog-messages"));
+    for (int type = Error; type <= Log; ++type) {
+        m_typeTexts[type] = typeText(Type(type));
+    }
+}
+
+QString KateOutputMessageModel::typeText(Type type)
+{
+    switch (type) {
+    case Error:
+        return i18nc("@info", "Error");
+    case Warning:
+        return i18nc("@info", "Warning");
+    case Info:
+        return i18nc("@info", "Info");
+    case Log:
+        break;
+    }
+    return i18nc("@info", "Log");
+}
+
+void KateOutputMessageModel::setCapacity(int capacity)
+{
+    capacity = std::max(1, capacity);
+    if (capacity == m_capacity) {
+        return;
+    }
+
+    // keep the newest messages, linearized, the ring grows from there again
+    const int keep = std::min(m_size, capacity);
+    const int dropped = m_size - keep;
+    if (dropped > 0) {
+        beginResetModel();
+    }
+
+    std::vector<Message> ring;
+    ring.reserve(keep);
+    for (int i = 0; i < m_size; ++i) {
+        const quint64 serial = m_firstSerial + i;
+        Message &message = messageBySerial(serial);
+        if (i >= dropped) {
+            ring.push_back(std::move(message));
+            continue;
+        }
+
+        const auto token = m_tokens.find(message.token);
+        if (token != m_tokens.end() && token.value() == serial) {
+            m_tokens.erase(token);
+        }
+    }
+
+    m_ring = std::move(ring);
+    m_first = 0;
+    m_size = keep;
+    m_firstSerial += dropped;
+    m_capacity = capacity;
+
+    if (dropped > 0) {
+        rebuildVisible();
+        endResetModel();
+    }
+}
+
+QModelIndex KateOutputMessageModel::addMessage(const QString &text, const QString &category, const QIcon &categoryIcon, Type type, const QString &token)
+{
+    Message message;
+    message.text = text;
+    message.token = token;
+    message.time = QTime::currentTime();
+    message.category = categoryFor(category, categoryIcon);
+    message.lineCount = text.count(QLatin1Char('\n')) + 1;
+    message.type = type;
+
+    quint64 serial = 0;
+    const auto former = token.isEmpty() ? m_tokens.constEnd() : m_tokens.constFind(token);
+    if (former != m_tokens.constEnd()) {
+        serial = former.value();
+        replace(serial, std::move(message));
+    } else {
+        if (m_size == m_capacity) {
+            dropOldest();
+        }
+
+        serial = m_firstSerial + m_size;
+        const bool visible = !isFiltered() || accepts(message);
+        const int row = isFiltered() ? int(m_visible.size()) : m_size;
+        if (visible) {
+            beginInsertRows(QModelIndex(), row, row);
+        }
+
+        // the ring only wraps once it has reached its capacity
+        if (int(m_ring.size()) < m_capacity) {
+            m_ring.push_back(std::move(message));
+        } else {
+            m_ring[(m_first + m_size) % m_ring.size()] = std::move(message);
+        }
+        ++m_size;
+
+        if (!token.isEmpty()) {
+            m_tokens.insert(token, serial);
+        }
+
+        if (visible) {
+            if (isFiltered()) {
+                m_visible.push_back(serial);
+            }
+            endInsertRows();
+        }
+    }
+
+    // the last line, to scroll to
+    const int row = rowForSerial(serial);
+    if (row < 0) {
+        return QModelIndex();
+    }
+    const int lineCount = messageBySerial(serial).lineCount;
+    if (lineCount > 1) {
+        return index(lineCount - 2, Column_Body, index(row, 0));
+    }
+    return index(row, Column_Body);
+}
+
+void KateOutputMessageModel::clear()
+{
+    beginResetModel();
+    std::vector<Message>().swap(m_ring);
+    m_firstSerial += m_size;
+    m_first = 0;
+    m_size = 0;
+    m_tokens.clear();
+    m_visible.clear();
+    endResetModel();
+}
+
+void KateOutputMessageModel::setFilterString(const QString &pattern)
+{
+    if (pattern == m_pattern) {
+        return;
+    }
+
+    // a longer pattern can only match less, only the shown messages need a check
+    if (isFiltered() && pattern.contains(m_pattern, Qt::CaseInsensitive)) {
+        m_pattern = pattern;
+        int end = int(m_visible.size());
+        while (end > 0) {
+            if (accepts(messageBySerial(m_visible[end - 1]))) {
+                --end;
+                continue;
+            }
+
+            int begin = end - 1;
+            while (begin > 0 && !accepts(messageBySerial(m_visible[begin - 1]))) {
+                --begin;
+            }
+            beginRemoveRows(QModelIndex(), begin, end - 1);
+            m_visible.erase(m_visible.begin() + begin, m_visible.begin() + end);
+            endRemoveRows();
+            end = begin;
+        }
+        return;
+    }
+
+    beginResetModel();
+    m_pattern = pattern;
+    rebuildVisible();
+    endResetModel();
+}
+
+QModelIndex KateOutputMessageModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent)) {
+        return QModelIndex();
+    }
+
+    // top-level rows have id 0, the lines below a message have the serial of the message + 1
+    if (!parent.isValid()) {
+        return createIndex(row, column, quintptr(0));
+    }
+    return createIndex(row, column, quintptr(serialForRow(parent.row()) + 1));
+}
+
+QModelIndex KateOutputMessageModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == 0) {
+        return QModelIndex();
+    }
+
+    const int row = rowForSerial(child.internalId() - 1);
+    return (row < 0) ? QModelIndex() : createIndex(row, 0, quintptr(0));
+}
+
+int KateOutputMessageModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) {
+        return isFiltered() ? int(m_visible.size()) : m_size;
+    }
+
+    if (parent.internalId() != 0 || parent.column() != 0) {
+        return 0;
+    }
+    return messageBySerial(serialForRow(parent.row())).lineCount - 1;
+}
+
+int KateOutputMessageModel::columnCount(const QModelIndex &) const
+{
+    return Column_Count;
+}
+
+QVariant KateOutputMessageModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::DecorationRole)) {
+        return QVariant();
+    }
+
+    // additional lines, only the body is filled
+    if (index.internalId() != 0) {
+        const quint64 serial = index.internalId() - 1;
+        if (role != Qt::DisplayRole || index.column() != Column_Body || serial < m_firstSerial || serial >= m_firstSerial + m_size) {
+            return QVariant();
+        }
+        return line(messageBySerial(serial), index.row() + 1);
+    }
+
+    const Message &message = messageBySerial(serialForRow(index.row()));
+    switch (index.column()) {
+    case Column_Time:
+        if (role == Qt::DisplayRole) {
+            return message.time.toString(Qt::TextDate);
+        }
+        break;
+    case Column_Category:
+        if (role == Qt::DisplayRole) {
+            return m_categories[message.category].name;
+        }
+        return m_categories[message.category].icon;
+    case Column_LogType:
+        if (role == Qt::DisplayRole) {
+            return m_typeTexts[message.type];
+        }
+        return m_typeIcons[message.type];
+    case Column_Body:
+        if (role == Qt::DisplayRole) {
+            return message.text.left(message.text.indexOf(QLatin1Char('\n')));
+        }
+        break;
+    }
+    return QVariant();
+}
+
+quint64 KateOutputMessageModel::serialForRow(int row) const
+{
+    return isFiltered() ? m_visible[row] : m_firstSerial + row;
+}
+
+int KateOutputMessageModel::rowForSerial(quint64 serial) const
+{
+    if (serial < m_firstSerial || serial >= m_firstSerial + m_size) {
+        return -1;
+    }
+
+    if (!isFiltered()) {
+        return int(serial - m_firstSerial);
+    }
+
+    const auto it = std::lower_bound(m_visible.begin(), m_visible.end(), serial);
+    return (it != m_visible.end() && *it == serial) ? int(it - m_visible.begin()) : -1;
+}
+
+int KateOutputMessageModel::categoryFor(const QString &name, const QIcon &icon)
+{
+    // by name only, senders tend to create a new icon per message
+    const auto it = m_categoryIndex.constFind(name);
+    if (it != m_categoryIndex.constEnd()) {
+        Category &category = m_categories[it.value()];
+        if (category.customIcon || icon.isNull()) {
+            return it.value();
+        }
+        category.icon = icon;
+        category.customIcon = true;
+        return it.value();
+    }
+
+    m_categories.push_back({name, icon.isNull() ? QIcon::fromTheme(QStringLiteral("dialog-scripts")) : icon, !icon.isNull()});
+    m_categoryIndex.insert(name, int(m_categories.size()) - 1);
+    return int(m_categories.size()) - 1;
+}
+
+bool KateOutputMessageModel::accepts(const Message &message) const
+{
+    return kfts::fuzzy_match_simple(m_pattern, m_categories[message.category].name) || kfts::fuzzy_match_simple(m_pattern, m_typeTexts[message.type])
+        || message.text.contains(m_pattern, Qt::CaseInsensitive);
+}
+
+QString KateOutputMessageModel::line(const Message &message, int line) const
+{
+    if (message.lineStarts.empty()) {
+        message.lineStarts.reserve(message.lineCount);
+        message.lineStarts.push_back(0);
+        for (int pos = message.text.indexOf(QLatin1Char('\n')); pos >= 0; pos = message.text.indexOf(QLatin1Char('\n'), pos + 1)) {
+            message.lineStarts.push_back(pos + 1);
+        }
+    }
+
+    if (line < 0 || line >= int(message.lineStarts.size())) {
+        return QString();
+    }
+    const int start = message.lineStarts[line];
+    const int end = (line + 1 < int(message.lineStarts.size())) ? message.lineStarts[line + 1] - 1 : message.text.size();
+    return message.text.mid(start, end - start);
+}
+
+void KateOutputMessageModel::dropOldest()
+{
+    const quint64 serial = m_firstSerial;
+    const bool visible = !isFiltered() || (!m_visible.empty() && m_visible.front() == serial);
+    if (visible) {
+        beginRemoveRows(QModelIndex(), 0, 0);
+    }
+
+    Message &message = m_ring[m_first];
+    const auto token = message.token.isEmpty() ? m_tokens.end() : m_tokens.find(message.token);
+    if (token != m_tokens.end() && token.value() == serial) {
+        m_tokens.erase(token);
+    }
+
+    // the slot gets reused, free the text already
+    message = Message();
+    m_first = (m_first + 1) % int(m_ring.size());
+    --m_size;
+    ++m_firstSerial;
+
+    if (visible) {
+        if (isFiltered()) {
+            m_visible.pop_front();
+        }
+        endRemoveRows();
+    }
+}
+
+void KateOutputMessageModel::replace(quint64 serial, Message &&message)
+{
+    Message &former = messageBySerial(serial);
+    const int row = rowForSerial(serial);
+    const bool visible = !isFiltered() || accepts(message);
+
+    if (row < 0 && !visible) {
+        former = std::move(message);
+        return;
+    }
+
+    // shown or hidden now, without further ado
+    if (row >= 0 && !visible) {
+        beginRemoveRows(QModelIndex(), row, row);
+        former = std::move(message);
+        m_visible.erase(m_visible.begin() + row);
+        endRemoveRows();
+        return;
+    }
+    if (row < 0) {
+        const auto it = std::lower_bound(m_visible.begin(), m_visible.end(), serial);
+        const int newRow = int(it - m_visible.begin());
+        beginInsertRows(QModelIndex(), newRow, newRow);
+        former = std::move(message);
+        m_visible.insert(it, serial);
+        endInsertRows();
+        return;
+    }
+
+    // update in place, the row stays, the lines below it might change
+    const QModelIndex parent = index(row, 0);
+    if (former.lineCount > 1) {
+        beginRemoveRows(parent, 0, former.lineCount - 2);
+        former.lineCount = 1;
+        endRemoveRows();
+    }
+
+    const int lineCount = message.lineCount;
+    message.lineCount = 1;
+    former = std::move(message);
+    Q_EMIT dataChanged(index(row, 0), index(row, Column_Count - 1));
+
+    if (lineCount > 1) {
+        beginInsertRows(parent, 0, lineCount - 2);
+        former.lineCount = lineCount;
+        endInsertRows();
+    }
+}
+
+void KateOutputMessageModel::rebuildVisible()
+{
+    m_visible.clear();
+    if (!isFiltered()) {
+        return;
+    }
+
+    for (int i = 0; i < m_size; ++i) {
+        if (accepts(messageBySerial(m_firstSerial + i))) {
+            m_visible.push_back(m_firstSerial + i);
+        }
+    }
+}
@@ -0,0 +1,164 @@
+/* This file is part of the KDE project
+   SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+   SPDX-License-Identifier: LGPL-2.0-only
+*/
+
+#ifndef KATE_OUTPUTMESSAGEMODEL_H
+#define KATE_OUTPUTMESSAGEMODEL_H
+
+#include "katetests_export.h"
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QIcon>
+#include <QString>
+#include <QTime>
+
+#include <deque>
+#include <vector>
+
+/**
+ * Messages of the output view, as a tree of: message => additional lines of its text.
+ *
+ * The model keeps at most capacity() messages in a ring buffer, the oldest ones get dropped,
+ * so memory and the cost of adding a message stay constant however much output arrives.
+ * A message is stored once, with its whole text, the rows for the additional lines are
+ * only looked up if some view asks for them. Categories and their icons are shared.
+ *
+ * The filter is part of the model, a longer pattern only re-checks the messages shown so far,
+ * new messages only get checked themselves.
+ */
+class KATE_TESTS_EXPORT KateOutputMessageModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        Column_Time = 0,
+        Column_Category,
+        Column_LogType,
+        Column_Body,
+        Column_Count,
+    };
+
+    /**
+     * Message types, as the MessageType of LSP.
+     */
+    enum Type : quint8 {
+        Error = 0,
+        Warning,
+        Info,
+        Log,
+    };
+
+    explicit KateOutputMessageModel(QObject *parent = nullptr);
+
+    /**
+     * Maximal number of messages kept.
+     */
+    int capacity() const
+    {
+        return m_capacity;
+    }
+    void setCapacity(int capacity);
+
+    /**
+     * Add a message or replace the former message with the same non-empty token.
+     * @param text trimmed, non-empty text, might span multiple lines
+     * @return index of the row showing the last line of the message, invalid if filtered out
+     */
+    QModelIndex addMessage(const QString &text, const QString &category, const QIcon &categoryIcon, Type type, const QString &token = QString());
+
+    /**
+     * Remove all messages.
+     */
+    void clear();
+
+    /**
+     * Number of messages kept, filtered out or not.
+     */
+    int messageCount() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Only show messages with the pattern fuzzy matching category or type or contained in the text.
+     */
+    void setFilterString(const QString &pattern);
+
+    static QString typeText(Type type);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Category {
+        QString name;
+        QIcon icon;
+        bool customIcon = false;
+    };
+
+    struct Message {
+        QString text;
+        QString token;
+        QTime time;
+        int category = 0;
+        int lineCount = 1;
+        Type type = Log;
+        // start of each line, filled on first access of the additional lines
+        mutable std::vector<int> lineStarts;
+    };
+
+    // messages are numbered in order of arrival, the oldest kept one is m_firstSerial
+    const Message &messageBySerial(quint64 serial) const
+    {
+        return m_ring[(m_first + (serial - m_firstSerial)) % m_ring.size()];
+    }
+    Message &messageBySerial(quint64 serial)
+    {
+        return m_ring[(m_first + (serial - m_firstSerial)) % m_ring.size()];
+    }
+
+    bool isFiltered() const
+    {
+        return !m_pattern.isEmpty();
+    }
+
+    quint64 serialForRow(int row) const;
+    int rowForSerial(quint64 serial) const;
+
+    int categoryFor(const QString &name, const QIcon &icon);
+    bool accepts(const Message &message) const;
+    QString line(const Message &message, int line) const;
+
+    void dropOldest();
+    void replace(quint64 serial, Message &&message);
+    void rebuildVisible();
+
+    int m_capacity = 10000;
+
+    // ring of m_size messages, starting at m_first, grows up to m_capacity
+    std::vector<Message> m_ring;
+    int m_first = 0;
+    int m_size = 0;
+    quint64 m_firstSerial = 0;
+
+    // token => serial of the message to replace
+    QHash<QString, quint64> m_tokens;
+
+    std::vector<Category> m_categories;
+    QHash<QString, int> m_categoryIndex;
+    QIcon m_typeIcons[Log + 1];
+    QString m_typeTexts[Log + 1];
+
+    // with a filter: serials of the messages shown, ascending
+    QString m_pattern;
+    std::deque<quint64> m_visible;
+};
+
+#endif
@@ -16,18 +16,15 @@
 #include <KTextEditor/Editor>
 
 #include <QClipboard>
-#include <QDateTime>
 #include <QGuiApplication>
 #include <QMenu>
 #include <QPainter>
-#include <QSortFilterProxyModel>
 #include <QTextDocument>
 #include <QTimer>
 #include <QToolButton>
 #include <QTreeView>
 #include <QVBoxLayout>
 
-#include <kfts_fuzzy_match.h>
 #include <ktexteditor_utils.h>
 
 class KateOutputTreeView : public QTreeView
@@ -111,67 +108,10 @@ private:
     QAction *m_copyAction = nullptr;
 };
 
-class OutputSortFilterProxyModel final : public QSortFilterProxyModel
-{
-public:
-    OutputSortFilterProxyModel(QObject *parent = nullptr)
-        : QSortFilterProxyModel(parent)
-    {
-    }
-
-    void setFilterString(const QString &string)
-    {
-        beginResetModel();
-        m_pattern = string;
-        endResetModel();
-    }
-
-protected:
-    bool lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const override
-    {
-        const int l = sourceLeft.data(WeightRole).toInt();
-        const int r = sourceRight.data(WeightRole).toInt();
-        return l < r;
-    }
-
-    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override
-    {
-        if (m_pattern.isEmpty()) {
-            return true;
-        }
-
-        const auto idxCat = sourceModel()->index(sourceRow, KateOutputView::Column_Category, sourceParent);
-        const auto idxType = sourceModel()->index(sourceRow, KateOutputView::Column_LogType, sourceParent);
-        const auto idxBody = sourceModel()->index(sourceRow, KateOutputView::Column_Body, sourceParent);
-
-        const QString cat = idxCat.data().toString();
-        const QString type = idxType.data().toString();
-        const QString body = idxBody.data().toString();
-
-        int scorec = 0;
-        int scoret = 0;
-        const bool resc = kfts::fuzzy_match(m_pattern, cat, scorec);
-        const bool rest = kfts::fuzzy_match(m_pattern, type, scoret);
-        const bool resb = body.contains(m_pattern, Qt::CaseInsensitive);
-
-        const auto idx = sourceModel()->index(sourceRow, KateOutputView::Column_Time, sourceParent);
-        sourceModel()->setData(idx, scorec + scoret, WeightRole);
-        return resc || rest || resb;
-    }
-
-private:
-    QString m_pattern;
-    static constexpr int WeightRole = Qt::UserRole + 1;
-};
-
 KateOutputView::KateOutputView(KateMainWindow *mainWindow, QWidget *parent)
     : QWidget(parent)
     , m_mainWindow(mainWindow)
 {
-    m_proxyModel = new OutputSortFilterProxyModel(this);
-    m_proxyModel->setSourceModel(&m_messagesModel);
-    m_proxyModel->setRecursiveFilteringEnabled(true);
-
     QVBoxLayout *layout = new QVBoxLayout(this);
     layout->setContentsMargins(0, 0, 0, 0);
     m_messagesTreeView = new KateOutputTreeView(this);
@@ -181,14 +121,14 @@ KateOutputView::KateOutputView(KateMainWindow *mainWindow, QWidget *parent)
     m_messagesTreeView->setUniformRowHeights(true);
     m_messagesTreeView->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_messagesTreeView->setSelectionMode(QAbstractItemView::ContiguousSelection);
-    m_messagesTreeView->setModel(m_proxyModel);
+    m_messagesTreeView->setModel(&m_messagesModel);
     m_messagesTreeView->setIndentation(0);
 
     // filter line edit
     m_filterLine.installEventFilter(this);
     m_filterLine.setPlaceholderText(i18n("Type to filter..."));
     connect(&m_filterLine, &QLineEdit::textChanged, this, [this](const QString &text) {
-        static_cast<OutputSortFilterProxyModel *>(m_proxyModel)->setFilterString(text);
+        m_messagesModel.setFilterString(text);
         m_messagesTreeView->expandAll();
     });
 
@@ -229,6 +169,7 @@ void KateOutputView::readConfig()
     KSharedConfig::Ptr config = KSharedConfig::openConfig();
     KConfigGroup cgGeneral = KConfigGroup(config, "General");
     m_showOutputViewForMessageType = cgGeneral.readEntry("Show output view for message type", 1);
+    m_messagesModel.setCapacity(cgGeneral.readEntry("Output View Message Limit", 10000));
 
     // use editor fonts
     const auto theme = KTextEditor::Editor::instance()->theme();
@@ -256,108 +197,67 @@ void KateOutputView::slotMessage(const QVariantMap &message)
      */
     const auto token = message.value(QStringLiteral("token")).toString();
 
-    /**
-     * date time column: we want to know when a message arrived
-     * TODO: perhaps store full date time for more stuff later
-     */
-    auto dateTimeColumn = new QStandardItem();
-    const QDateTime current = QDateTime::currentDateTime();
-    dateTimeColumn->setText(current.time().toString(Qt::TextDate));
-    if (!token.isEmpty()) {
-        dateTimeColumn->setData(token, Qt::UserRole);
-    }
-
     /**
      * category
      * provided by sender to better categorize the output into stuff like: lsp, git, ...
      * optional icon support
      */
-    auto categoryColumn = new QStandardItem();
-    categoryColumn->setText(message.value(QStringLiteral("category")).toString().trimmed());
+    const auto category = message.value(QStringLiteral("category")).toString().trimmed();
     const auto categoryIcon = message.value(QStringLiteral("categoryIcon")).value<QIcon>();
-    if (categoryIcon.isNull()) {
-        categoryColumn->setIcon(QIcon::fromTheme(QStringLiteral("dialog-scripts")));
-    } else {
-        categoryColumn->setIcon(categoryIcon);
-    }
 
     /**
-     * type column: shows the type, icons for some types only
+     * type: shows the type, icons for some types only
      */
     bool shouldShowOutputToolView = false;
-    auto typeColumn = new QStandardItem();
+    KateOutputMessageModel::Type type = KateOutputMessageModel::Log;
     const auto typeString = message.value(QStringLiteral("type")).toString();
     if (typeString == QLatin1String("Error")) {
         shouldShowOutputToolView = (m_showOutputViewForMessageType >= 1);
-        typeColumn->setText(i18nc("@info", "Error"));
-        typeColumn->setIcon(QIcon::fromTheme(QStringLiteral("data-error")));
+        type = KateOutputMessageModel::Error;
     } else if (typeString == QLatin1String("Warning")) {
         shouldShowOutputToolView = (m_showOutputViewForMessageType >= 2);
-        typeColumn->setText(i18nc("@info", "Warning"));
-        typeColumn->setIcon(QIcon::fromTheme(QStringLiteral("data-warning")));
+        type = KateOutputMessageModel::Warning;
     } else if (typeString == QLatin1String("Info")) {
         shouldShowOutputToolView = (m_showOutputViewForMessageType >= 3);
-        typeColumn->setText(i18nc("@info", "Info"));
-        typeColumn->setIcon(QIcon::fromTheme(QStringLiteral("data-information")));
+        type = KateOutputMessageModel::Info;
     } else {
         shouldShowOutputToolView = (m_showOutputViewForMessageType >= 4);
-        typeColumn->setText(i18nc("@info", "Log"));
-        typeColumn->setIcon(QIcon::fromTheme(QStringLiteral("dialog-messages")));
-    }
-
-    /**
-     * body column, plain text
-     * we ensured above that we have some
-     * split it into lines, we want nice fixed-height parts
-     * we will add extra rows for everything below the first line
-     */
-    const auto textLines = text.split(QLatin1Char('\n'));
-    Q_ASSERT(!textLines.empty());
-    auto bodyColumn = new QStandardItem(textLines.at(0));
-    auto lastItemForScrolling = bodyColumn;
-    for (int i = 1; i < textLines.size(); ++i) {
-        lastItemForScrolling = new QStandardItem(textLines.at(i));
-        dateTimeColumn->appendRow({new QStandardItem(), new QStandardItem(), new QStandardItem(), lastItemForScrolling});
     }
 
     /**
      * add message to model or replace previous one with matching token
+     * the model drops the oldest messages once its limit is reached
+     * all lines below the first one become child rows
      */
-    auto indices = m_messagesModel.match(m_messagesModel.index(0, 0, QModelIndex()), Qt::UserRole, token, 1, Qt::MatchExactly);
-    auto items = {dateTimeColumn, categoryColumn, typeColumn, bodyColumn};
-    if (indices.length()) {
-        const auto index = indices.at(0);
-        const auto row = index.row();
-        int column = 0;
-        for (auto item : items) {
-            m_messagesModel.setItem(row, column++, item);
-        }
-    } else {
-        m_messagesModel.appendRow(items);
-    }
+    const QModelIndex lastLine = m_messagesModel.addMessage(text, category, categoryIcon, type, token);
 
     /**
      * expand the new thingy
      */
-    m_messagesTreeView->expand(m_proxyModel->mapFromSource(dateTimeColumn->index()));
+    if (lastLine.parent().isValid()) {
+        m_messagesTreeView->expand(lastLine.parent());
+    }
 
     /**
      * ensure correct sizing
      */
-    if (!m_seenCategories.contains(categoryColumn->text())) {
-        m_seenCategories << categoryColumn->text();
-        m_messagesTreeView->resizeColumnToContents(Column_Category);
+    if (!m_seenCategories.contains(category)) {
+        m_seenCategories << category;
+        m_messagesTreeView->resizeColumnToContents(KateOutputMessageModel::Column_Category);
     }
 
-    if (!m_seenLogTypes.contains(typeColumn->text())) {
-        m_seenLogTypes << typeColumn->text();
-        m_messagesTreeView->resizeColumnToContents(Column_LogType);
+    const auto typeText = KateOutputMessageModel::typeText(type);
+    if (!m_seenLogTypes.contains(typeText)) {
+        m_seenLogTypes << typeText;
+        m_messagesTreeView->resizeColumnToContents(KateOutputMessageModel::Column_LogType);
     }
 
     /**
      * ensure last item is visible
      */
-    m_messagesTreeView->scrollTo(m_proxyModel->mapFromSource(lastItemForScrolling->index()));
+    if (lastLine.isValid()) {
+        m_messagesTreeView->scrollTo(lastLine);
+    }
 
     /**
      * if message requires it => show the tool view if hidden
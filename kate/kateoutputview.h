@@ -7,14 +7,14 @@
 #ifndef KATE_OUTPUT_VIEW_H
 #define KATE_OUTPUT_VIEW_H
 
+#include "kateoutputmessagemodel.h"
+
 #include <QLineEdit>
-#include <QStandardItemModel>
 #include <QStyledItemDelegate>
 #include <QWidget>
 
 class KateMainWindow;
 class KateOutputTreeView;
-class QSortFilterProxyModel;
 
 /**
  * Widget to output stuff e.g. for plugins.
@@ -24,12 +24,6 @@ class KateOutputView : public QWidget
     Q_OBJECT
 
 public:
-    enum Column {
-        Column_Time = 0,
-        Column_Category,
-        Column_LogType,
-        Column_Body,
-    };
     /**
      * Construct new output, we do that once per main window
      * @param mainWindow parent main window
@@ -97,14 +91,9 @@ private:
     KateOutputTreeView *m_messagesTreeView = nullptr;
 
     /**
-     * Our message model, at the moment a standard item model
-     */
-    QStandardItemModel m_messagesModel;
-
-    /**
-     * Our proxy model for filtering
+     * Our message model, bounded, does the filtering, too
      */
-    QSortFilterProxyModel *m_proxyModel = nullptr;
+    KateOutputMessageModel m_messagesModel;
 
     /**
      * fuzzy filter line edit
@@ -10,20 +10,25 @@
 
 #include "kateapp.h"
 #include "katedebug.h"
+#include "katelazypluginview.h"
 #include "katemainwindow.h"
 #include "kateoutputview.h"
 
+#include <KActionCollection>
 #include <KConfig>
 #include <KConfigGroup>
 #include <KPluginFactory>
 #include <KPluginLoader>
 
+#include <QAction>
 #include <QFile>
 #include <QFileInfo>
 #include <QMetaObject>
 
 #include <ktexteditor/sessionconfiginterface.h>
 
+#include <katetrace.h>
+
 QString KatePluginInfo::saveName() const
 {
     return QFileInfo(metaData.fileName()).baseName();
@@ -184,6 +189,8 @@ void KatePluginManager::disableAllPluginsGUI(KateMainWindow *win)
 
 bool KatePluginManager::loadPlugin(KatePluginInfo *item)
 {
+    KateTraceZone zone("load plugin", item->saveName());
+
     /**
      * try to load the plugin
      */
@@ -220,6 +227,65 @@ void KatePluginManager::enablePluginGUI(KatePluginInfo *item, KateMainWindow *wi
         return;
     }
 
+    // plugins with lazy activation triggers get a stand-in until one fires
+    if (!win->pluginViews().contains(item->plugin) && KateLazyPluginView::isLazy(item)) {
+        auto lazyView = win->lazyPluginViews().value(item->plugin);
+        if (!lazyView) {
+            lazyView = new KateLazyPluginView(item, win);
+            win->lazyPluginViews().insert(item->plugin, lazyView);
+        }
+        if (config) {
+            lazyView->readSessionConfig(KConfigGroup(config, QStringLiteral("Plugin:%1:MainWindow:0").arg(item->saveName())));
+        }
+        return;
+    }
+
+    createPluginView(item, win, config);
+}
+
+void KatePluginManager::activatePluginView(KatePluginInfo *item, KateMainWindow *win, const QString &action)
+{
+    // stand-in might be gone meanwhile, e.g. plugin got unloaded
+    KateLazyPluginView *lazyView = item->plugin ? win->lazyPluginViews().take(item->plugin) : nullptr;
+    if (!lazyView) {
+        return;
+    }
+
+    KateTraceZone zone("activate plugin view", item->saveName());
+
+    KConfig config(QString(), KConfig::SimpleConfig);
+    KConfigGroup group(&config, QStringLiteral("Plugin:%1:MainWindow:0").arg(item->saveName()));
+    lazyView->writeSessionConfig(group);
+    const auto placements = lazyView->toolViewPlacements();
+    delete lazyView;
+
+    createPluginView(item, win, &config);
+
+    // real tool views take the place of the stand-ins
+    for (const auto &placement : placements) {
+        auto toolView = win->toolView(placement.identifier);
+        if (!toolView) {
+            continue;
+        }
+        if (win->toolViewPosition(toolView) != placement.position) {
+            win->KateMDI::MainWindow::moveToolView(toolView, placement.position);
+        }
+        if (placement.visible) {
+            win->KateMDI::MainWindow::showToolView(toolView);
+        }
+    }
+
+    // forward the action that was triggered on the stand-in
+    auto client = dynamic_cast<KXMLGUIClient *>(win->pluginViews().value(item->plugin));
+    if (!action.isEmpty() && client) {
+        if (QAction *a = client->actionCollection()->action(action)) {
+            a->trigger();
+        }
+    }
+}
+
+void KatePluginManager::createPluginView(KatePluginInfo *item, KateMainWindow *win, KConfigBase *config)
+{
     // lookup if there is already a view for it..
     QObject *createdView = nullptr;
     if (!win->pluginViews().contains(item->plugin)) {
@@ -229,6 +295,7 @@ void KatePluginManager::enablePluginGUI(KatePluginInfo *item, KateMainWindow *wi
         }
 
         // create the view + try to correctly load shortcuts, if it's a GUI Client
+        KateTraceZone zone("create plugin view", item->saveName());
         createdView = item->plugin->createView(win->wrapper());
         if (createdView) {
             win->pluginViews().insert(item->plugin, createdView);
@@ -282,6 +349,9 @@ void KatePluginManager::disablePluginGUI(KatePluginInfo *item, KateMainWindow *w
         return;
     }
 
+    // view not yet created, just drop the stand-in
+    delete win->lazyPluginViews().take(item->plugin);
+
     // lookup if there is a view for it..
     if (!win->pluginViews().contains(item->plugin)) {
         return;
@@ -54,9 +54,19 @@ public:
     bool loadPlugin(KatePluginInfo *item);
     void unloadPlugin(KatePluginInfo *item);
 
+    /**
+     * Create the view of the plugin for the window, for plugins with lazy activation triggers,
+     * see KateLazyPluginView, only a stand-in is created until one of them fires.
+     */
     static void enablePluginGUI(KatePluginInfo *item, KateMainWindow *win, KConfigBase *config = nullptr);
     static void enablePluginGUI(KatePluginInfo *item);
 
+    /**
+     * Replace the stand-in of a lazily activated plugin with the real view.
+     * @param action name of the view's action to trigger afterwards, if any
+     */
+    static void activatePluginView(KatePluginInfo *item, KateMainWindow *win, const QString &action = QString());
+
     static void disablePluginGUI(KatePluginInfo *item, KateMainWindow *win);
     static void disablePluginGUI(KatePluginInfo *item);
 
@@ -74,6 +84,8 @@ public:
 private:
     void setupPluginList();
 
+    static void createPluginView(KatePluginInfo *item, KateMainWindow *win, KConfigBase *config);
+
     /**
      * all known plugins
      */
@@ -11,16 +11,39 @@
 #include <QDBusReply>
 #include <QFileInfo>
 #include <QRegularExpression>
+#include <QSet>
 #include <QStringList>
 
-bool fillinRunningKateAppInstances(KateRunningInstanceMap *map)
+bool fillinRunningKateAppInstances(KateRunningInstanceMap *map, QString *currentActivity)
 {
+    // running instances that published their state need not be asked about it
+    QSet<QString> registered;
+    if (KateInstanceRegistry::isAvailable()) {
+        const auto entries = KateInstanceRegistry::runningInstances();
+        qint64 newest = 0;
+        for (const auto &entry : entries) {
+            KateRunningInstanceInfo rii(entry);
+            if (map->find(rii.sessionName) != map->end()) {
+                return false; // ERROR no two instances may have the same session name
+            }
+            registered.insert(rii.serviceName);
+            auto sessionName = rii.sessionName;
+            map->emplace(sessionName, std::move(rii));
+
+            // the latest news about the current activity
+            if (currentActivity && !entry.currentActivity.isEmpty() && entry.updated > newest) {
+                *currentActivity = entry.currentActivity;
+                newest = entry.updated;
+            }
+        }
+    }
+
     QDBusConnectionInterface *i = QDBusConnection::sessionBus().interface();
     if (!i) {
         return true; // we do not know about any others...
     }
 
-    // look up all running kate instances and there sessions
+    // look up all other running kate instances and there sessions, e.g. older versions
     QDBusReply<QStringList> servicesReply = i->registeredServiceNames();
     QStringList services;
     if (servicesReply.isValid()) {
@@ -32,7 +55,7 @@ bool fillinRunningKateAppInstances(KateRunningInstanceMap *map)
                                      : QString::number(QCoreApplication::applicationPid());
 
     for (const QString &s : qAsConst(services)) {
-        if (s.startsWith(QLatin1String("org.kde.kate")) && !s.endsWith(my_pid)) {
+        if (s.startsWith(QLatin1String("org.kde.kate")) && !s.endsWith(my_pid) && !registered.contains(s)) {
             KateRunningInstanceInfo rii(s);
             if (rii.valid) {
                 if (map->find(rii.sessionName) != map->end()) {
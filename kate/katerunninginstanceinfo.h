@@ -8,12 +8,15 @@
 #ifndef _KATE_RUNNING_INSTANCE_INFO_
 #define _KATE_RUNNING_INSTANCE_INFO_
 
+#include "kateinstanceregistry.h"
+
 #include <QDBusConnection>
 #include <QDBusInterface>
+#include <QDBusMessage>
 #include <QMap>
 #include <QVariant>
 #include <iostream>
-#include <memory>
+#include <map>
 
 class KateRunningInstanceInfo
 {
@@ -23,15 +26,15 @@ public:
     KateRunningInstanceInfo(const QString &serviceName_)
         : valid(false)
         , serviceName(serviceName_)
-        , dbus_if(new QDBusInterface(serviceName_,
-                                     QStringLiteral("/MainApplication"),
-                                     QString(), // I don't know why it does not work if I specify org.kde.Kate.Application here
-                                     QDBusConnection::sessionBus()))
     {
-        if (!dbus_if->isValid()) {
+        QDBusInterface dbus_if(serviceName_,
+                               QStringLiteral("/MainApplication"),
+                               QString(), // I don't know why it does not work if I specify org.kde.Kate.Application here
+                               QDBusConnection::sessionBus());
+        if (!dbus_if.isValid()) {
             std::cerr << qPrintable(QDBusConnection::sessionBus().lastError().message()) << std::endl;
         }
-        QVariant a_s = dbus_if->property("activeSession");
+        QVariant a_s = dbus_if.property("activeSession");
         /*      std::cerr<<a_s.isValid()<<std::endl;
               std::cerr<<"property:"<<qPrintable(a_s.toString())<<std::endl;
               std::cerr<<qPrintable(QDBusConnection::sessionBus().lastError().message())<<std::endl;*/
@@ -48,17 +51,50 @@ public:
         }
     }
 
+    /**
+     * Instance as published in the registry, no need to ask it anything.
+     */
+    KateRunningInstanceInfo(const KateInstanceRegistry::Entry &entry)
+        : valid(true)
+        , serviceName(entry.serviceName)
+        , sessionName(entry.sessionName.isEmpty() ? QStringLiteral("___DEFAULT_CONSTRUCTED_SESSION__%1").arg(dummy_session++) : entry.sessionName)
+        , fromRegistry(true)
+        , desktop(entry.desktop)
+        , activities(entry.activities)
+    {
+    }
+
+    /**
+     * Ask the instance to activate itself.
+     */
+    void activate() const
+    {
+        QDBusConnection::sessionBus().call(QDBusMessage::createMethodCall(serviceName,
+                                                                          QStringLiteral("/MainApplication"),
+                                                                          QStringLiteral("org.kde.Kate.Application"),
+                                                                          QStringLiteral("activate")));
+    }
+
     bool valid = false;
     const QString serviceName;
-    std::unique_ptr<QDBusInterface> dbus_if;
     QString sessionName;
 
+    // only known for instances from the registry
+    bool fromRegistry = false;
+    int desktop = 0;
+    QStringList activities;
+
 private:
     static inline int dummy_session = 0;
 };
 
 typedef std::map<QString, KateRunningInstanceInfo> KateRunningInstanceMap;
 
-Q_DECL_EXPORT bool fillinRunningKateAppInstances(KateRunningInstanceMap *map);
+/**
+ * Fill in the running instances, from the registry if they published themselves there, the others via DBus.
+ * @param currentActivity if not null, set to the current activity as known by the instances in the registry
+ * @return false if two instances have the same session open
+ */
+Q_DECL_EXPORT bool fillinRunningKateAppInstances(KateRunningInstanceMap *map, QString *currentActivity = nullptr);
 
 #endif
@@ -14,15 +14,29 @@
 
 #include "ksharedconfig.h"
 
+#include <KTextEditor/MovingInterface>
+
 #include <QDir>
 #include <QFile>
 #include <QSaveFile>
 #include <QTextCodec>
 #include <QUrl>
+#include <QUuid>
 
 KateStashManager::KateStashManager(QObject *parent)
     : QObject(parent)
 {
+    m_writer.setMaxThreadCount(1);
+    connect(&m_autoStashTimer, &QTimer::timeout, this, &KateStashManager::autoStash);
+}
+
+void KateStashManager::setAutoStashInterval(int seconds)
+{
+    if (seconds <= 0) {
+        m_autoStashTimer.stop();
+        return;
+    }
+    m_autoStashTimer.start(seconds * 1000);
 }
 
 void KateStashManager::clearStashForSession(const KateSession::Ptr session)
@@ -39,36 +53,94 @@ void KateStashManager::clearStashForSession(const KateSession::Ptr session)
     }
 }
 
-void KateStashManager::stashDocuments(KConfig *config, const QList<KTextEditor::Document *> &documents)
+QString KateStashManager::stashDirectory()
 {
+    const auto activeSession = KateApp::self()->sessionManager()->activeSession();
+    if (!activeSession || activeSession->isAnonymous() || activeSession->name().isEmpty()) {
+        return QString();
+    }
+
     // prepare stash directory
     const QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir dir(appDataPath);
     dir.mkdir(QStringLiteral("stash"));
     dir.cd(QStringLiteral("stash"));
 
-    const auto activeSession = KateApp::self()->sessionManager()->activeSession();
-    if (!activeSession || activeSession->isAnonymous() || activeSession->name().isEmpty()) {
+    const QString sessionName = activeSession->name();
+    dir.mkdir(sessionName);
+    dir.cd(sessionName);
+    return dir.path();
+}
+
+void KateStashManager::autoStash()
+{
+    const QString path = stashDirectory();
+    if (path.isEmpty()) {
+        return;
+    }
+
+    const auto documents = KateApp::self()->documentManager()->documentList();
+    for (KTextEditor::Document *doc : documents) {
+        if (doc->isModified()) {
+            stashDocument(doc, path);
+        }
+    }
+
+    // stash files of closed or meanwhile saved documents are of no use any more,
+    // but the last synced session config may still reference them, see stashDocuments()
+    for (auto it = m_stashedDocuments.begin(); it != m_stashedDocuments.end();) {
+        const auto doc = it->second.document;
+        if (doc && doc->isModified() && willStashDoc(doc)) {
+            ++it;
+            continue;
+        }
+        if (doc) {
+            disconnect(doc, &KTextEditor::Document::reloaded, this, nullptr);
+        }
+        m_obsoleteFiles.append(it->second.fileName);
+        it = m_stashedDocuments.erase(it);
+    }
+}
+
+void KateStashManager::stashDocuments(KConfig *config, const QList<KTextEditor::Document *> &documents)
+{
+    const QString path = stashDirectory();
+    if (path.isEmpty()) {
         qDebug(LOG_KATE) << "Could not stash files without a session";
         return;
     }
 
-    const QString sessionName = activeSession->name();
-    dir.mkdir(sessionName);
-    dir.cd(sessionName);
+    // only documents changed since the last auto stash get written here
+    autoStash();
 
     int i = 0;
     for (KTextEditor::Document *doc : documents) {
         const QString entryName = QStringLiteral("Document %1").arg(i);
         KConfigGroup cg(config, entryName);
 
-        // stash the file content
-        if (doc->isModified()) {
-            stashDocument(doc, entryName, cg, dir.path());
+        const auto it = m_stashedDocuments.find(doc);
+        if (it != m_stashedDocuments.end() && it->second.document == doc) {
+            // write stash metadata to config
+            cg.writeEntry("stashedFile", it->second.fileName);
+            cg.writeEntry("stashCompressed", it->second.compressed);
+            if (doc->url().isValid()) {
+                // save checksum for already-saved documents
+                cg.writeEntry("checksum", doc->checksum());
+            }
         }
 
         i++;
     }
+
+    // the session must not reference stash files not yet written
+    m_writer.waitForDone();
+    config->sync();
+
+    // and only now no longer references the obsolete ones
+    for (const QString &fileName : qAsConst(m_obsoleteFiles)) {
+        QFile::remove(fileName);
+    }
+    m_obsoleteFiles.clear();
 }
 
 bool KateStashManager::willStashDoc(KTextEditor::Document *doc) const
@@ -77,7 +149,7 @@ bool KateStashManager::willStashDoc(KTextEditor::Document *doc) const
     if (!activeSession || activeSession->isAnonymous() || activeSession->name().isEmpty()) {
         return false;
     }
-    if (doc->text().isEmpty()) {
+    if (doc->isEmpty()) {
         return false;
     }
     if (doc->url().isEmpty()) {
@@ -93,28 +165,53 @@ bool KateStashManager::willStashDoc(KTextEditor::Document *doc) const
     return false;
 }
 
-void KateStashManager::stashDocument(KTextEditor::Document *doc, const QString &stashfileName, KConfigGroup &kconfig, const QString &path)
+void KateStashManager::stashDocument(KTextEditor::Document *doc, const QString &path)
 {
     if (!willStashDoc(doc)) {
         return;
     }
-    // Stash changes
-    QString stashedFile = path + QStringLiteral("/") + stashfileName;
 
-    // save the current document changes to stash
-    if (!doc->saveAs(QUrl::fromLocalFile(stashedFile))) {
-        qCWarning(LOG_KATE) << "Could not write to stash file" << stashedFile;
-        return;
+    auto &stashed = m_stashedDocuments[doc];
+    if (stashed.document != doc) {
+        // new document or a new one at the address of a deleted one, whose file is not ours to reuse
+        if (!stashed.fileName.isEmpty()) {
+            m_obsoleteFiles.append(stashed.fileName);
+        }
+        stashed.document = doc;
+        stashed.fileName = path + QStringLiteral("/") + QUuid::createUuid().toString(QUuid::WithoutBraces);
+        stashed.revision = -1;
+
+        // reloading may start the revisions over
+        connect(doc, &KTextEditor::Document::reloaded, this, [this](KTextEditor::Document *doc) {
+            const auto it = m_stashedDocuments.find(doc);
+            if (it != m_stashedDocuments.end()) {
+                it->second.revision = -1;
+            }
+        });
     }
 
-    // write stash metadata to config
-    kconfig.writeEntry("stashedFile", stashedFile);
-    if (doc->url().isValid()) {
-        // save checksum for already-saved documents
-        kconfig.writeEntry("checksum", doc->checksum());
+    // unchanged since last stashed, nothing to write
+    auto movingInterface = qobject_cast<KTextEditor::MovingInterface *>(doc);
+    const qint64 revision = movingInterface ? movingInterface->revision() : -1;
+    if (revision >= 0 && revision == stashed.revision) {
+        return;
     }
+    stashed.revision = revision;
+    stashed.compressed = m_compressStash;
 
-    kconfig.sync();
+    // snapshot the content here, encoding and writing happens in the background
+    m_writer.start([fileName = stashed.fileName, text = doc->text(), encoding = doc->encoding().toLatin1(), compress = stashed.compressed]() {
+        const auto codec = QTextCodec::codecForName(encoding);
+        QByteArray data = codec ? codec->fromUnicode(text) : text.toUtf8();
+        if (compress) {
+            data = qCompress(data);
+        }
+
+        QSaveFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+            qCWarning(LOG_KATE) << "Could not write to stash file" << fileName << file.errorString();
+        }
+    });
 }
 
 bool KateStashManager::popDocument(KTextEditor::Document *doc, const KConfigGroup &kconfig)
@@ -135,16 +232,23 @@ bool KateStashManager::popDocument(KTextEditor::Document *doc, const KConfigGrou
     }
 
     if (checksumOk) {
-        // open file with stashed content
+        // open file with stashed content, empty documents are never stashed
         QFile file(stashedFile);
-        file.open(QIODevice::ReadOnly);
-        QTextStream out(&file);
-        const auto codec = QTextCodec::codecForName(kconfig.readEntry("Encoding").toLocal8Bit());
-        if (codec != nullptr) {
-            out.setCodec(codec);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCWarning(LOG_KATE) << "Could not read stash file" << stashedFile << file.errorString();
+            return false;
+        }
+        QByteArray data = file.readAll();
+        if (kconfig.readEntry("stashCompressed", false)) {
+            data = qUncompress(data);
+        }
+        if (data.isEmpty()) {
+            qCWarning(LOG_KATE) << "Could not read stash file" << stashedFile;
+            return false;
         }
 
-        doc->setText(out.readAll());
+        const auto codec = QTextCodec::codecForName(kconfig.readEntry("Encoding").toLocal8Bit());
+        doc->setText(codec ? codec->toUnicode(data) : QString::fromUtf8(data));
 
         // clean stashed file
         if (!file.remove()) {
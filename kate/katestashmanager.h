@@ -10,10 +10,14 @@
 #include "katesession.h"
 #include "kconfiggroup.h"
 
-namespace KTextEditor
-{
-class Document;
-}
+#include <KTextEditor/Document>
+
+#include <QPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <unordered_map>
 
 class KateViewManager;
 
@@ -43,18 +47,75 @@ public:
         m_stashNewUnsavedFiles = stashNewUnsavedFiles;
     }
 
+    bool compressStash() const
+    {
+        return m_compressStash;
+    }
+
+    void setCompressStash(bool compressStash)
+    {
+        m_compressStash = compressStash;
+    }
+
+    /**
+     * Interval in seconds to stash changed documents in the background, 0 to only stash on shutdown.
+     */
+    int autoStashInterval() const
+    {
+        return m_autoStashTimer.interval() / 1000;
+    }
+
+    void setAutoStashInterval(int seconds);
+
+    /**
+     * Stash all modified documents and reference the stash files in the session config.
+     * Only documents changed since they were last stashed are written, see autoStash().
+     */
     void stashDocuments(KConfig *cfg, const QList<KTextEditor::Document *> &documents);
 
     bool willStashDoc(KTextEditor::Document *doc) const;
 
-    void stashDocument(KTextEditor::Document *doc, const QString &stashfileName, KConfigGroup &kconfig, const QString &path);
     static bool popDocument(KTextEditor::Document *doc, const KConfigGroup &kconfig);
 
     static void clearStashForSession(const KateSession::Ptr session);
 
 private:
+    /**
+     * Stash directory of the active session, empty if we have no session to stash for.
+     */
+    static QString stashDirectory();
+
+    /**
+     * Write the document contents to its stash file in the background, if changed since last time.
+     */
+    void stashDocument(KTextEditor::Document *doc, const QString &path);
+
+    /**
+     * Stash all modified documents in the background, drop stash files no longer needed.
+     */
+    void autoStash();
+
+    struct StashedDocument {
+        // guards against a new document at the address of a deleted one
+        QPointer<KTextEditor::Document> document;
+        QString fileName;
+        qint64 revision = -1;
+        // how the file was written, the setting may have changed since
+        bool compressed = false;
+    };
+
     bool m_stashUnsavedChanges = false;
     bool m_stashNewUnsavedFiles = true;
+    bool m_compressStash = false;
+
+    std::unordered_map<KTextEditor::Document *, StashedDocument> m_stashedDocuments;
+
+    // stash files to remove once a session config without them got synced
+    QStringList m_obsoleteFiles;
+
+    // single thread, a document's stash writes happen in order
+    QThreadPool m_writer;
+    QTimer m_autoStashTimer;
 };
 
 #endif // KATESTASHMANAGER_H
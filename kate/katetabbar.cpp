@@ -286,22 +286,26 @@ void KateTabBar::setTabDocument(int idx, KTextEditor::Document *doc)
     buttonData.doc = doc;
     setTabData(idx, QVariant::fromValue(buttonData));
     // BUG: 441340 We need to escape the & because it is used for accelerators/shortcut mnemonic by default
-    QString tabName = doc->documentName();
+    QString tabName = KateApp::self()->documentManager()->documentName(doc);
     tabName.replace(QLatin1Char('&'), QLatin1String("&&"));
     setTabText(idx, tabName);
-    setTabToolTip(idx, doc->url().toDisplayString());
+    setTabToolTip(idx, KateApp::self()->documentManager()->documentUrl(doc).toDisplayString());
     setTabIcon(idx, icon);
 }
 
 void KateTabBar::setCurrentDocument(KTextEditor::Document *doc)
 {
+    // documents get tabs only through here, unknown ones have none yet
+    // spares searching all tabs when many documents are opened at once
+    const bool knownDocument = m_docToLruCounterAndHasTab.find(doc) != m_docToLruCounterAndHasTab.end();
+
     // in any case: update lru counter for this document, might add new element to hash
     // we have a tab after this call, too!
     m_docToLruCounterAndHasTab[doc] = std::make_pair(++m_lruCounter, true);
 
     // do we have a tab for this document?
     // if yes => just set as current one
-    const int existingIndex = documentIdx(doc);
+    const int existingIndex = knownDocument ? documentIdx(doc) : -1;
     if (existingIndex != -1) {
         setCurrentIndex(existingIndex);
         return;
@@ -311,7 +315,7 @@ void KateTabBar::setCurrentDocument(KTextEditor::Document *doc)
     // => create new tab and be done
     if ((m_tabCountLimit == 0) || documentTabIndexes().size() < (size_t)m_tabCountLimit) {
         m_beingAdded = doc;
-        insertTab(-1, doc->documentName());
+        insertTab(-1, KateApp::self()->documentManager()->documentName(doc));
         return;
     }
 
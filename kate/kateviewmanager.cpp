@@ -35,6 +35,8 @@
 #include <QStyle>
 #include <QTimer>
 
+#include <utility>
+
 // END Includes
 
 static constexpr qint64 FileSizeAboveToAskUserIfProceedWithOpen = 10 * 1024 * 1024; // 10MB should suffice
@@ -62,6 +64,7 @@ KateViewManager::KateViewManager(QWidget *parentW, KateMainWindow *parent)
     connect(this, &KateViewManager::viewChanged, this, &KateViewManager::slotViewChanged);
 
     connect(KateApp::self()->documentManager(), &KateDocManager::documentCreatedViewManager, this, &KateViewManager::documentCreated);
+    connect(KateApp::self()->documentManager(), &KateDocManager::documentsCreatedViewManager, this, &KateViewManager::documentsCreated);
 
     /**
      * before document is really deleted: cleanup all views!
@@ -261,8 +264,9 @@ void KateViewManager::slotDocumentOpen()
     // activate view of last opened document
     KateDocumentInfo docInfo;
     docInfo.openedByUser = true;
-    if (KTextEditor::Document *lastID = openUrls(urls, QString(), false, docInfo)) {
-        activateView(lastID);
+    const auto docs = openUrls(urls, QString(), false, docInfo);
+    if (!docs.empty()) {
+        activateView(docs.back());
     }
 }
 
@@ -310,7 +314,8 @@ KTextEditor::Document *KateViewManager::openUrl(const QUrl &url, const QString &
     return doc;
 }
 
-KTextEditor::Document *KateViewManager::openUrls(const QList<QUrl> &urls, const QString &encoding, bool isTempFile, const KateDocumentInfo &docInfo)
+std::vector<KTextEditor::Document *>
+KateViewManager::openUrls(const QList<QUrl> &urls, const QString &encoding, bool isTempFile, const KateDocumentInfo &docInfo)
 {
     const std::vector<KTextEditor::Document *> docs = KateApp::self()->documentManager()->openUrls(urls, encoding, isTempFile, docInfo);
 
@@ -320,7 +325,7 @@ KTextEditor::Document *KateViewManager::openUrls(const QList<QUrl> &urls, const
         }
     }
 
-    return docs.empty() ? nullptr : docs.back();
+    return docs;
 }
 
 KTextEditor::View *KateViewManager::openUrlWithView(const QUrl &url, const QString &encoding)
@@ -365,6 +370,29 @@ void KateViewManager::documentCreated(KTextEditor::Document *doc)
         return;
     }
 
+    ensureViewsForDocument(doc);
+}
+
+void KateViewManager::documentsCreated(const QList<KTextEditor::Document *> &docs)
+{
+    if (docs.isEmpty()) {
+        return;
+    }
+
+    // register all documents first, views are only needed for the last one
+    const bool blocked = std::exchange(m_blockViewCreationAndActivation, true);
+    for (KTextEditor::Document *doc : docs) {
+        documentCreated(doc);
+    }
+    m_blockViewCreationAndActivation = blocked;
+
+    if (!m_blockViewCreationAndActivation) {
+        ensureViewsForDocument(docs.back());
+    }
+}
+
+void KateViewManager::ensureViewsForDocument(KTextEditor::Document *doc)
+{
     auto view = activeView();
     if (!view) {
         view = activateView(doc);
@@ -679,6 +707,7 @@ void KateViewManager::activateView(KTextEditor::View *view)
 
         // remember age of this view
         viewData.lruAge = m_minAge--;
+        KateApp::self()->documentManager()->documentUsed(view->document());
 
         Q_EMIT viewChanged(view);
 
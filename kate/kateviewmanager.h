@@ -62,7 +62,7 @@ public:
     KTextEditor::Document *
     openUrl(const QUrl &url, const QString &encoding, bool activate = true, bool isTempFile = false, const KateDocumentInfo &docInfo = KateDocumentInfo());
 
-    KTextEditor::Document *
+    std::vector<KTextEditor::Document *>
     openUrls(const QList<QUrl> &url, const QString &encoding, bool isTempFile = false, const KateDocumentInfo &docInfo = KateDocumentInfo());
 
     KTextEditor::View *openUrlWithView(const QUrl &url, const QString &encoding);
@@ -114,6 +114,11 @@ public:
 
 private:
     void moveViewtoSplit(KTextEditor::View *view);
+
+    /**
+     * ensure there is an active view and no view space is left empty after doc got created
+     */
+    void ensureViewsForDocument(KTextEditor::Document *doc);
     void moveViewtoStack(KTextEditor::View *view);
 
     /* Save the configuration of a single splitter.
@@ -137,6 +142,7 @@ private Q_SLOTS:
     void slotViewChanged();
 
     void documentCreated(KTextEditor::Document *doc);
+    void documentsCreated(const QList<KTextEditor::Document *> &docs);
     void documentWillBeDeleted(KTextEditor::Document *doc);
 
     void documentSavedOrUploaded(KTextEditor::Document *document, bool saveAs);
@@ -273,6 +273,11 @@ KTextEditor::View *KateViewSpace::createView(KTextEditor::Document *doc)
     // should only be called if a view does not yet exist
     Q_ASSERT(m_docToView.find(doc) == m_docToView.end());
 
+    /**
+     * Documents restored on demand get their content once they are shown
+     */
+    KateApp::self()->documentManager()->loadDocument(doc);
+
     /**
      * Create a fresh view
      */
@@ -295,6 +300,9 @@ KTextEditor::View *KateViewSpace::createView(KTextEditor::Document *doc)
         }
     }
 
+    // woken up from hibernation => back to where we were
+    KateApp::self()->documentManager()->restoreViewConfig(v);
+
     connect(v, &KTextEditor::View::cursorPositionChanged, this, [this](KTextEditor::View *view, const KTextEditor::Cursor &newPosition) {
         if (view && view->document())
             addPositionToHistory(view->document()->url(), newPosition);
@@ -627,7 +635,7 @@ void KateViewSpace::updateDocumentName(KTextEditor::Document *doc)
     const int buttonId = m_tabBar->documentIdx(doc);
     if (buttonId >= 0) {
         // BUG: 441278 We need to escape the & because it is used for accelerators/shortcut mnemonic by default
-        QString tabName = doc->documentName();
+        QString tabName = KateApp::self()->documentManager()->documentName(doc);
         tabName.replace(QLatin1Char('&'), QLatin1String("&&"));
         m_tabBar->setTabText(buttonId, tabName);
     }
@@ -638,7 +646,7 @@ void KateViewSpace::updateDocumentUrl(KTextEditor::Document *doc)
     // update tab button if available, might not be the case for tab limit set!
     const int buttonId = m_tabBar->documentIdx(doc);
     if (buttonId >= 0) {
-        m_tabBar->setTabToolTip(buttonId, doc->url().toDisplayString());
+        m_tabBar->setTabToolTip(buttonId, KateApp::self()->documentManager()->documentUrl(doc).toDisplayString());
     }
 }
 
@@ -936,15 +944,22 @@ void KateViewSpace::saveConfig(KConfigBase *config, int myIndex, const QString &
     QStringList lruList;
     const auto docList = documentList();
     for (KTextEditor::Document *doc : docList) {
-        lruList << doc->url().toString();
+        lruList << KateApp::self()->documentManager()->documentUrl(doc).toString();
         auto it = m_docToView.find(doc);
         if (it != m_docToView.end()) {
             views.push_back(it->second);
         }
     }
 
+    // most recently used first, these are loaded first if restored on demand
+    QStringList mruList;
+    for (auto rit = m_registeredDocuments.rbegin(); rit != m_registeredDocuments.rend(); ++rit) {
+        mruList << KateApp::self()->documentManager()->documentUrl(*rit).toString();
+    }
+
     KConfigGroup group(config, groupname);
     group.writeEntry("Documents", lruList);
+    group.writeEntry("MRU Documents", mruList);
     group.writeEntry("Count", static_cast<int>(views.size()));
 
     if (currentView()) {
@@ -990,6 +1005,16 @@ void KateViewSpace::restoreConfig(KateViewManager *viewMan, const KConfigBase *c
         }
     }
 
+    // prefetch the most recently used documents, if restored on demand
+    QList<KTextEditor::Document *> mruDocuments;
+    const QStringList mruList = group.readEntry("MRU Documents", QStringList());
+    for (const QString &url : mruList) {
+        if (auto doc = KateApp::self()->documentManager()->findDocument(QUrl(url))) {
+            mruDocuments.push_back(doc);
+        }
+    }
+    KateApp::self()->documentManager()->prefetchDocuments(mruDocuments);
+
     // restore active view properties
     const QString fn = group.readEntry("Active View");
     if (!fn.isEmpty()) {
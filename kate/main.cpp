@@ -26,12 +26,15 @@
 #include <QDBusMessage>
 #include <QDBusReply>
 #include <QDir>
+#include <QFile>
 #include <QJsonDocument>
 #include <QSessionManager>
 #include <QTextCodec>
+#include <QTimer>
 #include <QUrl>
 #include <QVariant>
 
+#include <katetrace.h>
 #include <urlinfo.h>
 
 #ifdef USE_QT_SINGLE_APP
@@ -42,9 +45,34 @@
 #include <unistd.h>
 #endif
 #include <iostream>
+#include <memory>
+
+/**
+ * trace file from --trace <file> or KATE_TRACE=<file>
+ * looked up by hand, we want to trace the startup before the command line parser exists
+ */
+static QString traceFileName(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray arg(argv[i]);
+        if (arg == "--trace" && i + 1 < argc) {
+            return QFile::decodeName(argv[i + 1]);
+        }
+        if (arg.startsWith("--trace=")) {
+            return QFile::decodeName(arg.mid(8));
+        }
+    }
+    return qEnvironmentVariable("KATE_TRACE");
+}
 
 int main(int argc, char **argv)
 {
+    /**
+     * startup tracing, if requested, the trace is written once we leave main
+     */
+    const std::unique_ptr<KateTracer> tracer(KateTracer::start(traceFileName(argc, argv)));
+    std::unique_ptr<KateTraceZone> startupZone(new KateTraceZone("startup"));
+
 #if !defined(Q_OS_WIN) && !defined(Q_OS_HAIKU)
     // Prohibit using sudo or kdesu (but allow using the root user directly)
     if (getuid() == 0) {
@@ -92,11 +120,20 @@ int main(int argc, char **argv)
     /**
      * Create application first
      */
+    std::unique_ptr<KateTraceZone> applicationZone(new KateTraceZone("create application"));
 #ifdef USE_QT_SINGLE_APP
     SharedTools::QtSingleApplication app(QStringLiteral("kate"), argc, argv);
 #else
     QApplication app(argc, argv);
 #endif
+    applicationZone.reset();
+
+    /**
+     * plugins find the tracer via the application
+     */
+    if (tracer) {
+        tracer->publish();
+    }
 
     /**
      * For Windows and macOS: use Breeze if available
@@ -272,6 +309,12 @@ int main(int argc, char **argv)
                                             i18n("The files/URLs opened by the application will be deleted after use"));
     parser.addOption(tempfileOption);
 
+    // --trace option, handled by traceFileName() above
+    const QCommandLineOption traceOption(QStringList() << QStringLiteral("trace"),
+                                         i18n("Write a trace of the startup phases in Chrome trace event format to the given file, it is written on exit."),
+                                         i18n("file"));
+    parser.addOption(traceOption);
+
     // urls to open
     parser.addPositionalArgument(QStringLiteral("urls"), i18n("Documents to open."), i18n("[urls...]"));
 
@@ -319,32 +362,46 @@ int main(int argc, char **argv)
      * allows for reuse of running Kate instances
      */
 #ifndef USE_QT_SINGLE_APP
+    std::unique_ptr<KateTraceZone> instanceZone(new KateTraceZone("find running instance"));
     if (QDBusConnectionInterface *const sessionBusInterface = QDBusConnection::sessionBus().interface()) {
         /**
          * try to get the current running kate instances
          */
         KateRunningInstanceMap mapSessionRii;
-        if (!fillinRunningKateAppInstances(&mapSessionRii)) {
+        QString currentActivity;
+        if (!fillinRunningKateAppInstances(&mapSessionRii, &currentActivity)) {
             return 1;
         }
 
-        QString currentActivity;
-        QDBusMessage m = QDBusMessage::createMethodCall(QStringLiteral("org.kde.ActivityManager"),
-                                                        QStringLiteral("/ActivityManager/Activities"),
-                                                        QStringLiteral("org.kde.ActivityManager.Activities"),
-                                                        QStringLiteral("CurrentActivity"));
-        QDBusMessage res = QDBusConnection::sessionBus().call(m);
-        QList<QVariant> answer = res.arguments();
-        if (answer.size() == 1) {
-            currentActivity = answer.at(0).toString();
+        // only ask the activity manager if no instance told us about the current activity
+        if (currentActivity.isEmpty() && !mapSessionRii.empty()) {
+            QDBusMessage m = QDBusMessage::createMethodCall(QStringLiteral("org.kde.ActivityManager"),
+                                                            QStringLiteral("/ActivityManager/Activities"),
+                                                            QStringLiteral("org.kde.ActivityManager.Activities"),
+                                                            QStringLiteral("CurrentActivity"));
+            QDBusMessage res = QDBusConnection::sessionBus().call(m);
+            QList<QVariant> answer = res.arguments();
+            if (answer.size() == 1) {
+                currentActivity = answer.at(0).toString();
+            }
         }
 
         QStringList kateServices;
+        std::map<QString, const KateRunningInstanceInfo *> serviceRii;
         for (const auto &[_, katerunninginstanceinfo] : mapSessionRii) {
             Q_UNUSED(_)
             QString serviceName = katerunninginstanceinfo.serviceName;
+            serviceRii[serviceName] = &katerunninginstanceinfo;
 
             if (currentActivity.length() != 0) {
+                // registered instances told us their activities already
+                if (katerunninginstanceinfo.fromRegistry) {
+                    if (katerunninginstanceinfo.activities.isEmpty() || katerunninginstanceinfo.activities.contains(currentActivity)) {
+                        kateServices << serviceName;
+                    }
+                    continue;
+                }
+
                 QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
                                                                 QStringLiteral("/MainApplication"),
                                                                 QStringLiteral("org.kde.Kate.Application"),
@@ -411,7 +468,17 @@ int main(int argc, char **argv)
             for (int s = 0; s < kateServices.count(); s++) {
                 serviceName = kateServices[s];
 
-                if (!serviceName.isEmpty()) {
+                // registered instances told us their desktop already, the entry might be stale or from another bus
+                const KateRunningInstanceInfo *rii = serviceRii[serviceName];
+                if (rii && rii->fromRegistry) {
+                    if (rii->desktop == desktopnumber || rii->desktop == NET::OnAllDesktops) {
+                        QDBusReply<bool> there = sessionBusInterface->isServiceRegistered(serviceName);
+                        if (there.isValid() && there.value()) {
+                            foundRunningService = true;
+                            break;
+                        }
+                    }
+                } else if (!serviceName.isEmpty()) {
                     QDBusReply<bool> there = sessionBusInterface->isServiceRegistered(serviceName);
 
                     if (there.isValid() && there.value()) {
@@ -446,6 +513,8 @@ int main(int argc, char **argv)
         }
 
         if (foundRunningService) {
+            KateTraceZone zone("hand over to running instance", serviceName);
+
             // open given session
             if (parser.isSet(startSessionOption) && (!session_already_opened)) {
                 QDBusMessage m = QDBusMessage::createMethodCall(serviceName,
@@ -607,6 +676,7 @@ int main(int argc, char **argv)
             return needToBlock ? app.exec() : 0;
         }
     }
+    instanceZone.reset();
 
     /**
      * for mac & windows: use QtSingleApplication
@@ -667,6 +737,7 @@ int main(int argc, char **argv)
      * behaves like a singleton, one unique instance
      * we are passing our local command line parser to it
      */
+    std::unique_ptr<KateTraceZone> initZone(new KateTraceZone("KateApp::init"));
     KateApp kateApp(parser);
 
     /**
@@ -677,12 +748,21 @@ int main(int argc, char **argv)
     if (!kateApp.init()) {
         return 0;
     }
+    initZone.reset();
 
 #ifndef USE_QT_SINGLE_APP
     /**
      * finally register this kate instance for dbus, don't die if no dbus is around!
      */
     const KDBusService dbusService(KDBusService::Multiple | KDBusService::NoExitOnFailure);
+
+    /**
+     * tell later started kate's about us, they can then hand over without asking us over dbus first
+     */
+    std::unique_ptr<KateInstanceRegistry> instanceRegistry;
+    if (dbusService.isRegistered() && KateInstanceRegistry::isAvailable()) {
+        instanceRegistry.reset(new KateInstanceRegistry(dbusService.serviceName()));
+    }
 #else
     /**
      * else: connect the single application notifications
@@ -696,6 +776,13 @@ int main(int argc, char **argv)
 
     /**
      * start main event loop for our application
+     * first events are still part of the startup, e.g. delayed view creation
      */
+    if (tracer) {
+        QTimer::singleShot(0, &app, [&startupZone]() {
+            startupZone.reset();
+        });
+        tracer->addInstant(QStringLiteral("event loop"));
+    }
     return app.exec();
 }
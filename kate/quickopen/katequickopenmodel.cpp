@@ -123,10 +123,12 @@ void KateQuickOpenModel::refresh(KateMainWindow *mainWindow)
         }
 
         // document with set url => use the url for displaying
-        if (!doc->url().isEmpty()) {
-            auto path = doc->url().toString(QUrl::NormalizePathSegments | QUrl::PreferLocalFile);
+        // documents restored on demand are listed with the url they will be loaded from
+        const QUrl url = KateApp::self()->documentManager()->documentUrl(doc);
+        if (!url.isEmpty()) {
+            auto path = url.toString(QUrl::NormalizePathSegments | QUrl::PreferLocalFile);
             openedDocUrls.insert(path);
-            allDocuments.push_back({doc->url(), QFileInfo(path).fileName(), path, doc, -1});
+            allDocuments.push_back({url, QFileInfo(path).fileName(), path, doc, -1});
             return;
         }
 
@@ -30,6 +30,8 @@
 #include <QInputDialog>
 #include <QUrl>
 
+#include <katetrace.h>
+
 #ifndef Q_OS_WIN
 #include <unistd.h>
 #endif
@@ -119,7 +121,7 @@ bool KateSessionManager::activateSession(KateSession::Ptr session, const bool cl
                                            KStandardGuiItem::no(),
                                            QStringLiteral("katesessionmanager_switch_instance"))
                 == KMessageBox::Yes) {
-                instances[session->name()].dbus_if->call(QStringLiteral("activate"));
+                instances.at(session->name()).activate();
                 return false;
             }
         }
@@ -155,6 +157,8 @@ bool KateSessionManager::activateSession(KateSession::Ptr session, const bool cl
 
 void KateSessionManager::loadSession(const KateSession::Ptr &session) const
 {
+    KateTraceZone zone("load session", session->name());
+
     // open the new session
     KSharedConfigPtr sharedConfig = KSharedConfig::openConfig();
     KConfig *sc = session->config();
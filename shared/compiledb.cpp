@@ -0,0 +1,228 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "compiledb.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPointer>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+static QString joinPath(const QString &dir, const QString &fileName)
+{
+    return dir.endsWith(QLatin1Char('/')) ? dir + fileName : dir + QLatin1Char('/') + fileName;
+}
+
+static QString canonicalDir(const QString &dir)
+{
+    const QString canonical = QFileInfo(dir).canonicalFilePath();
+    return canonical.isEmpty() ? QDir::cleanPath(dir) : canonical;
+}
+
+QString CompileDB::canonicalPath(const QString &file)
+{
+    // only the directory, the file may not exist (yet)
+    const QFileInfo info(file);
+    return joinPath(canonicalDir(info.absolutePath()), info.fileName());
+}
+
+QHash<QString, QString> CompileDB::parse(const QByteArray &json)
+{
+    QHash<QString, QString> commands;
+
+    int pos = 0;
+    while (pos < json.size() && (json.at(pos) == ' ' || json.at(pos) == '\n' || json.at(pos) == '\r' || json.at(pos) == '\t')) {
+        ++pos;
+    }
+    if (pos == json.size() || json.at(pos) != '[') {
+        qWarning() << "Invalid compile_commands, root element is not an array";
+        return commands;
+    }
+
+    // most entries share a few directories
+    QHash<QString, QString> canonicalDirs;
+    auto addEntry = [&commands, &canonicalDirs](const QJsonObject &entry) {
+        const QString file = entry.value(QStringLiteral("file")).toString();
+        if (file.isEmpty()) {
+            return;
+        }
+
+        QString command = entry.value(QStringLiteral("command")).toString();
+        if (command.isEmpty()) {
+            QStringList arguments;
+            const QJsonArray array = entry.value(QStringLiteral("arguments")).toArray();
+            for (const auto &argument : array) {
+                arguments.append(argument.toString());
+            }
+            command = arguments.join(QLatin1Char(' '));
+        }
+
+        // file can be relative to directory
+        const QFileInfo info(QDir(entry.value(QStringLiteral("directory")).toString()).absoluteFilePath(file));
+        const QString dir = info.absolutePath();
+        auto it = canonicalDirs.find(dir);
+        if (it == canonicalDirs.end()) {
+            it = canonicalDirs.insert(dir, canonicalDir(dir));
+        }
+
+        const QString path = joinPath(it.value(), info.fileName());
+        if (!commands.contains(path)) {
+            commands.insert(path, command);
+        }
+    };
+
+    // one entry after the other, a QJsonDocument of the whole database is a multiple of its size
+    const char *data = json.constData();
+    int depth = 0;
+    int entryStart = -1;
+    bool inString = false;
+    for (; pos < json.size(); ++pos) {
+        const char c = data[pos];
+        if (inString) {
+            if (c == '\\') {
+                ++pos;
+            } else if (c == '"') {
+                inString = false;
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            inString = true;
+            break;
+        case '{':
+            if (depth == 1) {
+                entryStart = pos;
+            }
+            ++depth;
+            break;
+        case '[':
+            ++depth;
+            break;
+        case '}':
+            --depth;
+            if (depth == 1 && entryStart >= 0) {
+                QJsonParseError error;
+                const QJsonDocument entry = QJsonDocument::fromJson(QByteArray::fromRawData(data + entryStart, pos - entryStart + 1), &error);
+                if (error.error != QJsonParseError::NoError) {
+                    qWarning() << "Failed to read compile_commands: " << error.errorString();
+                } else {
+                    addEntry(entry.object());
+                }
+                entryStart = -1;
+            }
+            break;
+        case ']':
+            --depth;
+            break;
+        }
+    }
+
+    return commands;
+}
+
+namespace
+{
+struct Request {
+    QPointer<QObject> context;
+    QString file;
+    std::function<void(const QString &)> done;
+};
+
+struct Database {
+    QDateTime modified;
+    QHash<QString, QString> commands;
+    bool loading = false;
+    std::vector<Request> waiting;
+};
+}
+
+static QHash<QString, Database> &databases()
+{
+    static QHash<QString, Database> databases;
+    return databases;
+}
+
+static void loaded(const QString &compileCommands, const QDateTime &modified, QHash<QString, QString> &&commands)
+{
+    Database &database = databases()[compileCommands];
+    database.modified = modified;
+    database.commands = std::move(commands);
+    database.loading = false;
+
+    // done may look up more, don't hold on to the database meanwhile
+    std::vector<std::pair<Request, QString>> answers;
+    for (auto &request : database.waiting) {
+        const QString command = database.commands.value(request.file);
+        answers.emplace_back(std::move(request), command);
+    }
+    database.waiting.clear();
+
+    for (const auto &answer : answers) {
+        if (answer.first.context) {
+            answer.first.done(answer.second);
+        }
+    }
+}
+
+void CompileDB::commandForFile(const QString &compileCommands, const QString &file, QObject *context, const std::function<void(const QString &command)> &done)
+{
+    if (compileCommands.isEmpty()) {
+        done(QString());
+        return;
+    }
+
+    Database &database = databases()[compileCommands];
+    const QDateTime modified = QFileInfo(compileCommands).lastModified();
+    if (!database.loading && database.modified.isValid() && database.modified == modified) {
+        done(database.commands.value(canonicalPath(file)));
+        return;
+    }
+
+    database.waiting.push_back({context, canonicalPath(file), done});
+    if (database.loading) {
+        return;
+    }
+    database.loading = true;
+
+    QThreadPool::globalInstance()->start([compileCommands]() {
+        // before reading, a write meanwhile leads to another read
+        const QDateTime modified = QFileInfo(compileCommands).lastModified();
+
+        QHash<QString, QString> commands;
+        QFile f(compileCommands);
+        if (!f.open(QFile::ReadOnly)) {
+            qWarning() << "Failed to load compile_commands: " << f.errorString();
+        } else if (f.size() > std::numeric_limits<int>::max()) {
+            // more than a QByteArray can hold
+            qWarning() << "compile_commands too large: " << compileCommands;
+        } else if (const uchar *mapped = f.map(0, f.size())) {
+            commands = parse(QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), int(f.size())));
+        } else {
+            commands = parse(f.readAll());
+        }
+
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [compileCommands, modified, commands = std::move(commands)]() mutable {
+                loaded(compileCommands, modified, std::move(commands));
+            },
+            Qt::QueuedConnection);
+    });
+}
@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+#include <functional>
+
+class QObject;
+
+/**
+ * compile_commands.json databases, shared by all users in the process.
+ *
+ * A database is read once on a worker thread, entry by entry, and indexed by the
+ * canonical path of its files. A lookup only checks the modification time of the
+ * database, a changed one is read again.
+ */
+class CompileDB
+{
+public:
+    /**
+     * Get the compile command of a file.
+     * @param compileCommands path of the compile_commands.json
+     * @param file the file to get the command for
+     * @param context @p done is only called while this is alive
+     * @param done called with the command, empty if the file is not in the database;
+     *        right away if the database is loaded already, otherwise once that is done
+     */
+    static void commandForFile(const QString &compileCommands, const QString &file, QObject *context, const std::function<void(const QString &command)> &done);
+
+    /**
+     * Parse the content of a compile_commands.json, thread-safe.
+     * Entries with "arguments" instead of "command" get these joined by spaces.
+     * @return canonical file path => command, the first one if a file has several
+     */
+    static QHash<QString, QString> parse(const QByteArray &json);
+
+    /**
+     * @return the path of @p file in the index
+     */
+    static QString canonicalPath(const QString &file);
+};
@@ -0,0 +1,306 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "gitdiffprovider.h"
+
+#include "gitprocess.h"
+
+#include <QCache>
+#include <QCoreApplication>
+#include <QThreadPool>
+
+#include <utility>
+
+// patches of all providers, cost in KiB
+static QCache<QByteArray, GitDiffProvider::FileDiff> &patchCache()
+{
+    static QCache<QByteArray, GitDiffProvider::FileDiff> cache(64 * 1024);
+    return cache;
+}
+
+static QByteArray lineAt(const QByteArray &text, int pos)
+{
+    const int end = text.indexOf('\n', pos);
+    return text.mid(pos, (end == -1 ? text.size() : end) - pos);
+}
+
+/**
+ * "-1,5" or "-1" for one line
+ */
+static void parseRange(const QByteArray &range, int &start, int &count)
+{
+    const int comma = range.indexOf(',');
+    start = range.mid(1, comma == -1 ? -1 : comma - 1).toInt();
+    count = comma == -1 ? 1 : range.mid(comma + 1).toInt();
+}
+
+static void parseFileDiff(GitDiffProvider::FileDiff &fileDiff)
+{
+    const QByteArray &patch = fileDiff.patch;
+    QByteArray oldPath;
+    QByteArray newPath;
+
+    int pos = 0;
+    while (pos < patch.size()) {
+        const QByteArray line = lineAt(patch, pos);
+        const int next = pos + line.size() + 1;
+
+        if (line.startsWith("@@")) {
+            // @@ -1,5 +1,6 @@ optional context
+            // @@@ -1,5 -1,4 +1,6 @@@ for merges, one old range per parent, we take the first one
+            GitDiffProvider::Hunk hunk;
+            const QList<QByteArray> parts = line.split(' ');
+            for (int i = 1; i < parts.size() && !parts.at(i).startsWith("@@"); ++i) {
+                if (parts.at(i).startsWith('+')) {
+                    parseRange(parts.at(i), hunk.newStart, hunk.newCount);
+                } else if (i == 1) {
+                    parseRange(parts.at(i), hunk.oldStart, hunk.oldCount);
+                }
+            }
+
+            // until the next hunk, body lines start with ' ', '+', '-' or '\'
+            int end = patch.indexOf("\n@@", pos);
+            end = end == -1 ? patch.size() : end + 1;
+            hunk.offset = pos;
+            hunk.length = end - pos;
+            fileDiff.hunks.push_back(hunk);
+            pos = end;
+            continue;
+        }
+
+        if (fileDiff.hunks.empty()) {
+            if (line.startsWith("diff --git ")) {
+                // a/path b/path, only unambiguous if both are the same
+                const QByteArray names = line.mid(sizeof("diff --git ") - 1);
+                const int length = (names.size() - 5) / 2;
+                if (length > 0 && names.startsWith("a/") && names.mid(2, length) == names.mid(length + 5)) {
+                    newPath = names.mid(length + 5);
+                }
+            } else if (line.startsWith("diff --cc ")) {
+                newPath = line.mid(sizeof("diff --cc ") - 1);
+            } else if (line.startsWith("diff --combined ")) {
+                newPath = line.mid(sizeof("diff --combined ") - 1);
+            } else if (line.startsWith("index ")) {
+                const QByteArray blobs = line.mid(sizeof("index ") - 1);
+                const int space = blobs.indexOf(' ');
+                fileDiff.blobs = space == -1 ? blobs : blobs.left(space);
+            } else if (line.startsWith("rename to ")) {
+                newPath = line.mid(sizeof("rename to ") - 1);
+            } else if (line.startsWith("--- a/")) {
+                oldPath = line.mid(sizeof("--- a/") - 1);
+            } else if (line.startsWith("+++ b/")) {
+                newPath = line.mid(sizeof("+++ b/") - 1);
+            } else if (line == "+++ /dev/null") {
+                newPath.clear();
+            }
+        }
+
+        pos = next;
+    }
+
+    fileDiff.path = QString::fromUtf8(newPath.isEmpty() ? oldPath : newPath);
+}
+
+static bool isFileHeader(const QByteArray &diff, int pos)
+{
+    // git show of a merge has combined diffs
+    for (const char *header : {"diff --git ", "diff --cc ", "diff --combined "}) {
+        if (qstrncmp(diff.constData() + pos, header, qstrlen(header)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Start of the next file header line after pos, -1 if none.
+ */
+static int nextFileHeader(const QByteArray &diff, int pos)
+{
+    // "diff --" can't start a line inside a patch, those start with ' ', '+', '-', '\' or '@'
+    for (int next = diff.indexOf("\ndiff --", pos); next != -1; next = diff.indexOf("\ndiff --", next + 1)) {
+        if (isFileHeader(diff, next + 1)) {
+            return next + 1;
+        }
+    }
+    return -1;
+}
+
+std::vector<GitDiffProvider::FileDiff> GitDiffProvider::parse(const QByteArray &diff)
+{
+    std::vector<FileDiff> diffs;
+
+    int pos = isFileHeader(diff, 0) ? 0 : nextFileHeader(diff, 0);
+    while (pos != -1) {
+        const int next = nextFileHeader(diff, pos);
+        const int end = next == -1 ? diff.size() : next;
+
+        FileDiff fileDiff;
+        fileDiff.patch = diff.mid(pos, end - pos);
+        parseFileDiff(fileDiff);
+        diffs.push_back(std::move(fileDiff));
+
+        pos = next;
+    }
+
+    return diffs;
+}
+
+GitDiffProvider::GitDiffProvider(const QString &workingDirectory, const QStringList &arguments, QObject *parent)
+    : QObject(parent)
+    , m_workingDirectory(workingDirectory)
+    , m_arguments(arguments)
+{
+}
+
+GitDiffProvider::~GitDiffProvider()
+{
+    // no results after we are gone
+    for (const auto &process : {m_allProcess, m_fileProcess}) {
+        if (process) {
+            disconnect(process, nullptr, this, nullptr);
+            process->kill();
+        }
+    }
+}
+
+void GitDiffProvider::requestFile(const QString &path)
+{
+    m_requested = path;
+    if (deliver(path)) {
+        return;
+    }
+
+    // all at once, the next requests will be served from that
+    if (!m_allDone && !m_allProcess) {
+        startAll();
+    }
+
+    // that can take a while for large diffs, or the patch got dropped from the cache meanwhile
+    startFile(path);
+}
+
+void GitDiffProvider::cancel()
+{
+    m_requested.clear();
+    if (m_fileProcess) {
+        disconnect(m_fileProcess, nullptr, this, nullptr);
+        m_fileProcess->kill();
+        m_fileProcess->deleteLater();
+    }
+}
+
+static QStringList diffArguments(const QStringList &arguments)
+{
+    // full blob ids for the cache, paths as they are
+    return QStringList{QStringLiteral("-c"), QStringLiteral("core.quotePath=false")} + arguments
+        + QStringList{QStringLiteral("--full-index"), QStringLiteral("--no-color"), QStringLiteral("--no-ext-diff")};
+}
+
+void GitDiffProvider::startAll()
+{
+    auto git = new QProcess(this);
+    if (!setupGitProcess(*git, m_workingDirectory, diffArguments(m_arguments))) {
+        delete git;
+        m_allDone = true;
+        return;
+    }
+    m_allProcess = git;
+
+    connect(git, &QProcess::finished, this, [this, git](int exitCode, QProcess::ExitStatus es) {
+        git->deleteLater();
+        if (es != QProcess::NormalExit || exitCode != 0) {
+            m_allDone = true;
+            return;
+        }
+        parseInBackground(git->readAllStandardOutput(), true);
+    });
+    git->start(QProcess::ReadOnly);
+}
+
+void GitDiffProvider::startFile(const QString &path)
+{
+    // only the last request matters
+    cancel();
+    m_requested = path;
+
+    auto git = new QProcess(this);
+    if (!setupGitProcess(*git, m_workingDirectory, diffArguments(m_arguments) + QStringList{QStringLiteral("--"), path})) {
+        delete git;
+        return;
+    }
+    m_fileProcess = git;
+
+    connect(git, &QProcess::finished, this, [this, git](int exitCode, QProcess::ExitStatus es) {
+        git->deleteLater();
+        if (es != QProcess::NormalExit || exitCode != 0) {
+            return;
+        }
+        parseInBackground(git->readAllStandardOutput(), false);
+    });
+    git->start(QProcess::ReadOnly);
+}
+
+void GitDiffProvider::parseInBackground(const QByteArray &output, bool all)
+{
+    QThreadPool::globalInstance()->start([provider = QPointer<GitDiffProvider>(this), output, all]() {
+        auto diffs = parse(output);
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [provider, diffs = std::move(diffs), all]() mutable {
+                if (provider) {
+                    provider->parsed(std::move(diffs), all);
+                }
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+void GitDiffProvider::parsed(std::vector<FileDiff> &&diffs, bool all)
+{
+    for (auto &fileDiff : diffs) {
+        // the same change in another range or commit is the same patch
+        QByteArray key = fileDiff.blobs.isEmpty() ? (m_workingDirectory + m_arguments.join(QLatin1Char(' '))).toUtf8() : fileDiff.blobs;
+        key += '\0' + fileDiff.path.toUtf8();
+
+        const QString path = fileDiff.path;
+        const int cost = fileDiff.patch.size() / 1024 + 1;
+        patchCache().insert(key, new FileDiff(std::move(fileDiff)), cost);
+        m_cacheKeys.insert(path, key);
+    }
+
+    if (all) {
+        m_allDone = true;
+    }
+
+    if (m_requested.isEmpty() || deliver(m_requested)) {
+        return;
+    }
+
+    // the file alone has no diff either => nothing to show
+    if (!all) {
+        const QString requested = std::exchange(m_requested, QString());
+        Q_EMIT diffReady(requested, QByteArray());
+    }
+}
+
+bool GitDiffProvider::deliver(const QString &path)
+{
+    const QByteArray key = m_cacheKeys.value(path);
+    if (key.isEmpty()) {
+        return false;
+    }
+
+    const FileDiff *fileDiff = patchCache().object(key);
+    if (!fileDiff) {
+        return false;
+    }
+
+    // the file on its own is not needed any longer
+    cancel();
+    Q_EMIT diffReady(path, fileDiff->patch);
+    return true;
+}
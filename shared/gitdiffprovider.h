@@ -0,0 +1,96 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Per file patches of one git diff/show, fetched asynchronously.
+ *
+ * The first request starts one git process for all files of the range, its output
+ * is split + parsed on a worker thread. Until that is done, the requested file is
+ * fetched on its own, a later request cancels the fetch of the former one.
+ * Parsed patches are cached by blob pair + path, shared by all providers.
+ */
+class GitDiffProvider : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Hunk {
+        int oldStart = 0;
+        int oldCount = 0;
+        int newStart = 0;
+        int newCount = 0;
+        // the hunk, header line included, in FileDiff::patch
+        int offset = 0;
+        int length = 0;
+    };
+
+    struct FileDiff {
+        // path in the new version, the old one for deleted files
+        QString path;
+        // "old..new" of the index line, "old,old..new" for merges, empty e.g. for mode changes only
+        QByteArray blobs;
+        // the patch of this file, starting at its "diff --git" or, for merges, "diff --cc" line
+        QByteArray patch;
+        std::vector<Hunk> hunks;
+    };
+
+    /**
+     * Split the output of git diff/show into the patches of the single files.
+     */
+    static std::vector<FileDiff> parse(const QByteArray &diff);
+
+    /**
+     * Diffs of the given git command, e.g. {"diff", "a...b"} or {"show", "--format=", hash}.
+     * @param workingDirectory the top level directory of the repository, paths are relative to it
+     */
+    GitDiffProvider(const QString &workingDirectory, const QStringList &arguments, QObject *parent = nullptr);
+    ~GitDiffProvider() override;
+
+    /**
+     * Get the patch of the file, arrives via diffReady, maybe right away.
+     * Only the last requested file is delivered.
+     */
+    void requestFile(const QString &path);
+
+    /**
+     * Forget about the requested file, e.g. selection changed to nothing.
+     */
+    void cancel();
+
+Q_SIGNALS:
+    void diffReady(const QString &path, const QByteArray &patch);
+
+private:
+    void startAll();
+    void startFile(const QString &path);
+    void parseInBackground(const QByteArray &output, bool all);
+    void parsed(std::vector<FileDiff> &&diffs, bool all);
+    bool deliver(const QString &path);
+
+    const QString m_workingDirectory;
+    const QStringList m_arguments;
+
+    // blob pair + path of the files parsed so far
+    QHash<QString, QByteArray> m_cacheKeys;
+
+    QPointer<QProcess> m_allProcess;
+    bool m_allDone = false;
+    QPointer<QProcess> m_fileProcess;
+    QString m_requested;
+};
@@ -0,0 +1,246 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVariant>
+
+#include <atomic>
+#include <vector>
+
+/**
+ * Tracing of where the time goes, mainly during startup.
+ *
+ * Enabled by "kate --trace <file>" or KATE_TRACE=<file>, the application then collects
+ * all zones and writes them on exit as Chrome trace event JSON, one track per thread.
+ * Load the file in chrome://tracing, https://ui.perfetto.dev or hotspot.
+ *
+ * Header only, to be usable from plugins, too, they find the tracer of the application
+ * via a property of the QCoreApplication. If tracing is off, a zone costs one atomic load.
+ */
+class KateTracer
+{
+public:
+    /**
+     * Start tracing into the given file, if not empty.
+     * To be done once, at the very beginning of main().
+     * Deleting the tracer writes the file.
+     */
+    static KateTracer *start(const QString &fileName)
+    {
+        if (fileName.isEmpty()) {
+            return nullptr;
+        }
+        auto tracer = new KateTracer(fileName);
+        self().store(tracer);
+        return tracer;
+    }
+
+    /**
+     * Make the tracer available to plugins, to be done once the QCoreApplication exists.
+     */
+    void publish()
+    {
+        QCoreApplication::instance()->setProperty(propertyName(), QVariant::fromValue(quintptr(this)));
+    }
+
+    /**
+     * The active tracer, nullptr if tracing is off.
+     */
+    static KateTracer *instance()
+    {
+        return self().load(std::memory_order_relaxed);
+    }
+
+    ~KateTracer()
+    {
+        self().store(nullptr);
+        if (auto app = QCoreApplication::instance()) {
+            app->setProperty(propertyName(), QVariant());
+        }
+        write();
+    }
+
+    /**
+     * Microseconds since tracing started.
+     */
+    qint64 now() const
+    {
+        return m_timer.nsecsElapsed() / 1000;
+    }
+
+    void addZone(const QString &name, const QString &detail, qint64 start, qint64 end)
+    {
+        QMutexLocker lock(&m_mutex);
+        m_events.push_back({name, detail, start, end - start, threadId(), 'X'});
+    }
+
+    /**
+     * Mark some point in time, like the start of the event loop.
+     */
+    void addInstant(const QString &name)
+    {
+        const qint64 time = now();
+        QMutexLocker lock(&m_mutex);
+        m_events.push_back({name, QString(), time, 0, threadId(), 'i'});
+    }
+
+private:
+    struct Event {
+        QString name;
+        QString detail;
+        qint64 start;
+        qint64 duration;
+        int thread;
+        char phase;
+    };
+
+    explicit KateTracer(const QString &fileName)
+        : m_fileName(fileName)
+    {
+        m_timer.start();
+    }
+
+    static const char *propertyName()
+    {
+        return "_kate_tracer";
+    }
+
+    /**
+     * Each plugin has its own copy of this, filled with the tracer of the application on first use.
+     */
+    static std::atomic<KateTracer *> &self()
+    {
+        static std::atomic<KateTracer *> tracer{[]() -> KateTracer * {
+            const auto app = QCoreApplication::instance();
+            return app ? reinterpret_cast<KateTracer *>(app->property(propertyName()).value<quintptr>()) : nullptr;
+        }()};
+        return tracer;
+    }
+
+    /**
+     * Small sequential id for the current thread, to be called with the mutex held.
+     */
+    int threadId()
+    {
+        const auto handle = QThread::currentThreadId();
+        const auto it = m_threads.constFind(handle);
+        if (it != m_threads.constEnd()) {
+            return it.value();
+        }
+
+        const int id = m_threads.size() + 1;
+        m_threads.insert(handle, id);
+
+        // thread pools name their threads all the same, keep them apart by id
+        QString name = QThread::currentThread()->objectName();
+        const auto app = QCoreApplication::instance();
+        if (app ? QThread::currentThread() == app->thread() : id == 1) {
+            name = QStringLiteral("main");
+        } else if (name.isEmpty()) {
+            name = QStringLiteral("thread");
+        }
+        m_threadNames.push_back(QStringLiteral("%1 %2").arg(name).arg(id));
+        return id;
+    }
+
+    void write()
+    {
+        QMutexLocker lock(&m_mutex);
+        const qint64 pid = QCoreApplication::applicationPid();
+
+        QJsonArray events;
+        for (int i = 0; i < m_threadNames.size(); ++i) {
+            events.append(QJsonObject{{QStringLiteral("ph"), QStringLiteral("M")},
+                                      {QStringLiteral("name"), QStringLiteral("thread_name")},
+                                      {QStringLiteral("pid"), pid},
+                                      {QStringLiteral("tid"), i + 1},
+                                      {QStringLiteral("args"), QJsonObject{{QStringLiteral("name"), m_threadNames[i]}}}});
+        }
+
+        for (const Event &event : m_events) {
+            QJsonObject object{{QStringLiteral("ph"), QString(QLatin1Char(event.phase))},
+                               {QStringLiteral("name"), event.name},
+                               {QStringLiteral("cat"), QStringLiteral("kate")},
+                               {QStringLiteral("pid"), pid},
+                               {QStringLiteral("tid"), event.thread},
+                               {QStringLiteral("ts"), event.start}};
+            if (event.phase == 'X') {
+                object[QStringLiteral("dur")] = event.duration;
+            } else {
+                // instant events span the whole process
+                object[QStringLiteral("s")] = QStringLiteral("p");
+            }
+            if (!event.detail.isEmpty()) {
+                object[QStringLiteral("args")] = QJsonObject{{QStringLiteral("detail"), event.detail}};
+            }
+            events.append(object);
+        }
+
+        QSaveFile file(m_fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return;
+        }
+        file.write(QJsonDocument(QJsonObject{{QStringLiteral("traceEvents"), events}, {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")}}).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+
+    const QString m_fileName;
+    QElapsedTimer m_timer;
+
+    // guards all members below, zones end on any thread
+    QMutex m_mutex;
+    std::vector<Event> m_events;
+    QHash<Qt::HANDLE, int> m_threads;
+    QStringList m_threadNames;
+};
+
+/**
+ * Scoped zone, from construction to destruction, shown on the track of the current thread.
+ *
+ *   KateTraceZone zone("load plugin", pluginName);
+ */
+class KateTraceZone
+{
+public:
+    explicit KateTraceZone(const char *name, const QString &detail = QString())
+        : m_tracer(KateTracer::instance())
+    {
+        if (m_tracer) {
+            m_name = QString::fromLatin1(name);
+            m_detail = detail;
+            m_start = m_tracer->now();
+        }
+    }
+
+    ~KateTraceZone()
+    {
+        if (m_tracer) {
+            m_tracer->addZone(m_name, m_detail, m_start, m_tracer->now());
+        }
+    }
+
+    KateTraceZone(const KateTraceZone &) = delete;
+    KateTraceZone &operator=(const KateTraceZone &) = delete;
+
+private:
+    KateTracer *const m_tracer;
+    QString m_name;
+    QString m_detail;
+    qint64 m_start = 0;
+};
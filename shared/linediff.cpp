@@ -0,0 +1,366 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#include "linediff.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace
+{
+/**
+ * Collapse white space runs to one space, drop trailing white space.
+ */
+QString normalizeWhitespace(const QString &line)
+{
+    QString normalized;
+    normalized.reserve(line.size());
+    bool inSpace = false;
+    for (const QChar c : line) {
+        if (c.isSpace()) {
+            inSpace = true;
+            continue;
+        }
+        if (inSpace && !normalized.isEmpty()) {
+            normalized.append(QLatin1Char(' '));
+        }
+        inSpace = false;
+        normalized.append(c);
+    }
+    // leading white space counts, too, like for diff -b
+    if (!line.isEmpty() && line.at(0).isSpace() && !normalized.isEmpty()) {
+        normalized.prepend(QLatin1Char(' '));
+    }
+    return normalized;
+}
+
+/**
+ * Myers' diff of two sequences of line ids, marks the lines not in the common subsequence.
+ * Divide and conquer on the middle snake, see "An O(ND) Difference Algorithm and Its Variations".
+ */
+class Myers
+{
+public:
+    Myers(const std::vector<int> &a, const std::vector<int> &b, std::vector<bool> &changedA, std::vector<bool> &changedB)
+        : m_a(a)
+        , m_b(b)
+        , m_changedA(changedA)
+        , m_changedB(changedB)
+    {
+    }
+
+    void compare(int aBegin, int aEnd, int bBegin, int bEnd)
+    {
+        // common prefix + suffix need no search
+        while (aBegin < aEnd && bBegin < bEnd && m_a[aBegin] == m_b[bBegin]) {
+            ++aBegin;
+            ++bBegin;
+        }
+        while (aBegin < aEnd && bBegin < bEnd && m_a[aEnd - 1] == m_b[bEnd - 1]) {
+            --aEnd;
+            --bEnd;
+        }
+
+        if (aBegin == aEnd || bBegin == bEnd) {
+            markChanged(aBegin, aEnd, bBegin, bEnd);
+            return;
+        }
+
+        int x = 0;
+        int y = 0;
+        if (!middleSnake(aBegin, aEnd, bBegin, bEnd, x, y)) {
+            markChanged(aBegin, aEnd, bBegin, bEnd);
+            return;
+        }
+
+        compare(aBegin, x, bBegin, y);
+        compare(x, aEnd, y, bEnd);
+    }
+
+private:
+    void markChanged(int aBegin, int aEnd, int bBegin, int bEnd)
+    {
+        std::fill(m_changedA.begin() + aBegin, m_changedA.begin() + aEnd, true);
+        std::fill(m_changedB.begin() + bBegin, m_changedB.begin() + bEnd, true);
+    }
+
+    /**
+     * Search forward from the start and backward from the end until the paths overlap,
+     * the overlap point splits the problem in two with about half the edit distance each.
+     */
+    bool middleSnake(int aBegin, int aEnd, int bBegin, int bEnd, int &splitA, int &splitB)
+    {
+        const int n = aEnd - aBegin;
+        const int m = bEnd - bBegin;
+        const int maxD = (n + m + 1) / 2;
+        const int offset = maxD;
+        const int size = 2 * maxD + 2;
+        const int delta = n - m;
+        const bool odd = (delta % 2) != 0;
+
+        // furthest reaching x per diagonal, forward from the start, backward from the end
+        m_forward.assign(size, -1);
+        m_backward.assign(size, -1);
+        m_forward[offset + 1] = 0;
+        m_backward[offset + 1] = 0;
+
+        // diagonals leaving the edit graph need no further look
+        int forwardStart = 0;
+        int forwardEnd = 0;
+        int backwardStart = 0;
+        int backwardEnd = 0;
+
+        for (int d = 0; d < maxD; ++d) {
+            for (int k = -d + forwardStart; k <= d - forwardEnd; k += 2) {
+                const int kOffset = offset + k;
+                int x = (k == -d || (k != d && m_forward[kOffset - 1] < m_forward[kOffset + 1])) ? m_forward[kOffset + 1] : m_forward[kOffset - 1] + 1;
+                int y = x - k;
+                while (x < n && y < m && m_a[aBegin + x] == m_b[bBegin + y]) {
+                    ++x;
+                    ++y;
+                }
+                m_forward[kOffset] = x;
+
+                if (x > n) {
+                    forwardEnd += 2;
+                } else if (y > m) {
+                    forwardStart += 2;
+                } else if (odd) {
+                    const int backwardOffset = offset + delta - k;
+                    if (backwardOffset >= 0 && backwardOffset < size && m_backward[backwardOffset] != -1 && x >= n - m_backward[backwardOffset]) {
+                        splitA = aBegin + x;
+                        splitB = bBegin + y;
+                        return true;
+                    }
+                }
+            }
+
+            for (int k = -d + backwardStart; k <= d - backwardEnd; k += 2) {
+                const int kOffset = offset + k;
+                int x = (k == -d || (k != d && m_backward[kOffset - 1] < m_backward[kOffset + 1])) ? m_backward[kOffset + 1] : m_backward[kOffset - 1] + 1;
+                int y = x - k;
+                while (x < n && y < m && m_a[aEnd - x - 1] == m_b[bEnd - y - 1]) {
+                    ++x;
+                    ++y;
+                }
+                m_backward[kOffset] = x;
+
+                if (x > n) {
+                    backwardEnd += 2;
+                } else if (y > m) {
+                    backwardStart += 2;
+                } else if (!odd) {
+                    const int forwardOffset = offset + delta - k;
+                    if (forwardOffset >= 0 && forwardOffset < size && m_forward[forwardOffset] != -1) {
+                        const int forwardX = m_forward[forwardOffset];
+                        if (forwardX >= n - x) {
+                            splitA = aBegin + forwardX;
+                            splitB = bBegin + forwardX - (forwardOffset - offset);
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+
+        // nothing in common
+        return false;
+    }
+
+    const std::vector<int> &m_a;
+    const std::vector<int> &m_b;
+    std::vector<bool> &m_changedA;
+    std::vector<bool> &m_changedB;
+
+    // reused by all levels, only needed during one search
+    std::vector<int> m_forward;
+    std::vector<int> m_backward;
+};
+
+/**
+ * Run the diff on the lines present on both sides, mark all others as changed.
+ */
+void diffIds(const std::vector<int> &a, const std::vector<int> &b, int idCount, std::vector<bool> &changedA, std::vector<bool> &changedB)
+{
+    std::vector<int> countA(idCount, 0);
+    std::vector<int> countB(idCount, 0);
+    for (int id : a) {
+        ++countA[id];
+    }
+    for (int id : b) {
+        ++countB[id];
+    }
+
+    std::vector<int> filteredA;
+    std::vector<int> indexA;
+    filteredA.reserve(a.size());
+    indexA.reserve(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (countB[a[i]] == 0) {
+            changedA[i] = true;
+        } else {
+            filteredA.push_back(a[i]);
+            indexA.push_back(int(i));
+        }
+    }
+
+    std::vector<int> filteredB;
+    std::vector<int> indexB;
+    filteredB.reserve(b.size());
+    indexB.reserve(b.size());
+    for (size_t i = 0; i < b.size(); ++i) {
+        if (countA[b[i]] == 0) {
+            changedB[i] = true;
+        } else {
+            filteredB.push_back(b[i]);
+            indexB.push_back(int(i));
+        }
+    }
+
+    std::vector<bool> filteredChangedA(filteredA.size(), false);
+    std::vector<bool> filteredChangedB(filteredB.size(), false);
+    Myers(filteredA, filteredB, filteredChangedA, filteredChangedB).compare(0, int(filteredA.size()), 0, int(filteredB.size()));
+
+    for (size_t i = 0; i < filteredA.size(); ++i) {
+        if (filteredChangedA[i]) {
+            changedA[indexA[i]] = true;
+        }
+    }
+    for (size_t i = 0; i < filteredB.size(); ++i) {
+        if (filteredChangedB[i]) {
+            changedB[indexB[i]] = true;
+        }
+    }
+}
+}
+
+QStringList LineDiff::splitLines(const QString &text)
+{
+    QStringList lines = text.split(QLatin1Char('\n'));
+    for (QString &line : lines) {
+        if (line.endsWith(QLatin1Char('\r'))) {
+            line.chop(1);
+        }
+    }
+    return lines;
+}
+
+std::vector<LineDiff::Hunk> LineDiff::diff(const QStringList &oldLines, const QStringList &newLines, Options options)
+{
+    // intern the lines, the diff itself only compares integers
+    QHash<QString, int> ids;
+    ids.reserve(oldLines.size() + newLines.size());
+    auto intern = [&ids, options](const QStringList &lines) {
+        std::vector<int> result;
+        result.reserve(lines.size());
+        for (const QString &line : lines) {
+            const QString key = (options & IgnoreWhitespaceAmount) ? normalizeWhitespace(line) : line;
+            auto it = ids.constFind(key);
+            if (it == ids.constEnd()) {
+                it = ids.insert(key, ids.size());
+            }
+            result.push_back(it.value());
+        }
+        return result;
+    };
+    const std::vector<int> a = intern(oldLines);
+    const std::vector<int> b = intern(newLines);
+
+    std::vector<bool> changedA(a.size(), false);
+    std::vector<bool> changedB(b.size(), false);
+    diffIds(a, b, ids.size(), changedA, changedB);
+
+    // the unchanged lines on both sides pair up in order, the rest forms the hunks
+    std::vector<Hunk> hunks;
+    int i = 0;
+    int j = 0;
+    const int n = int(a.size());
+    const int m = int(b.size());
+    while (i < n || j < m) {
+        if (i < n && j < m && !changedA[i] && !changedB[j]) {
+            ++i;
+            ++j;
+            continue;
+        }
+
+        Hunk hunk{i, 0, j, 0};
+        while (i < n && changedA[i]) {
+            ++i;
+            ++hunk.oldCount;
+        }
+        while (j < m && changedB[j]) {
+            ++j;
+            ++hunk.newCount;
+        }
+        if (hunk.oldCount == 0 && hunk.newCount == 0) {
+            break;
+        }
+        hunks.push_back(hunk);
+    }
+    return hunks;
+}
+
+QString LineDiff::unifiedDiff(const QStringList &oldLines,
+                              const QStringList &newLines,
+                              const std::vector<Hunk> &hunks,
+                              const QString &oldName,
+                              const QString &newName,
+                              int context)
+{
+    if (hunks.empty()) {
+        return QString();
+    }
+
+    QString result;
+    result += QStringLiteral("--- %1\n+++ %2\n").arg(oldName, newName);
+
+    size_t first = 0;
+    while (first < hunks.size()) {
+        // join changes with overlapping context into one block
+        size_t last = first;
+        while (last + 1 < hunks.size() && hunks[last + 1].oldStart - (hunks[last].oldStart + hunks[last].oldCount) <= 2 * context) {
+            ++last;
+        }
+
+        const int oldBegin = std::max(0, hunks[first].oldStart - context);
+        const int oldEnd = std::min(int(oldLines.size()), hunks[last].oldStart + hunks[last].oldCount + context);
+        const int newBegin = hunks[first].newStart - (hunks[first].oldStart - oldBegin);
+        const int newEnd = hunks[last].newStart + hunks[last].newCount + (oldEnd - hunks[last].oldStart - hunks[last].oldCount);
+
+        // like diff: empty ranges are given by the line before them, single lines without count
+        auto range = [](int begin, int end) {
+            const int count = end - begin;
+            if (count == 1) {
+                return QString::number(begin + 1);
+            }
+            return QStringLiteral("%1,%2").arg(count ? begin + 1 : begin).arg(count);
+        };
+        result += QStringLiteral("@@ -%1 +%2 @@\n").arg(range(oldBegin, oldEnd), range(newBegin, newEnd));
+
+        int oldLine = oldBegin;
+        for (size_t h = first; h <= last; ++h) {
+            const Hunk &hunk = hunks[h];
+            for (; oldLine < hunk.oldStart; ++oldLine) {
+                result += QLatin1Char(' ') + oldLines[oldLine] + QLatin1Char('\n');
+            }
+            for (int l = hunk.oldStart; l < hunk.oldStart + hunk.oldCount; ++l) {
+                result += QLatin1Char('-') + oldLines[l] + QLatin1Char('\n');
+            }
+            for (int l = hunk.newStart; l < hunk.newStart + hunk.newCount; ++l) {
+                result += QLatin1Char('+') + newLines[l] + QLatin1Char('\n');
+            }
+            oldLine = hunk.oldStart + hunk.oldCount;
+        }
+        for (; oldLine < oldEnd; ++oldLine) {
+            result += QLatin1Char(' ') + oldLines[oldLine] + QLatin1Char('\n');
+        }
+
+        first = last + 1;
+    }
+
+    return result;
+}
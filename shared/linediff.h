@@ -0,0 +1,62 @@
+/*
+    SPDX-FileCopyrightText: 2026 agent <agent@local>
+
+    SPDX-License-Identifier: MIT
+*/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+/**
+ * In-process line based diff, Myers' O(ND) algorithm in linear space.
+ *
+ * Lines are interned to integers first, lines only present on one side are
+ * taken out before the actual diff, they can't be part of any common subsequence.
+ * Thread-safe, meant to be run on some worker thread for larger inputs.
+ */
+namespace LineDiff
+{
+enum Option {
+    None = 0,
+    // like diff -b: ignore changes in the amount of white space
+    IgnoreWhitespaceAmount = 1,
+};
+Q_DECLARE_FLAGS(Options, Option)
+
+/**
+ * A change: oldCount lines at oldStart got replaced by newCount lines at newStart.
+ * Lines are 0-based, for pure insertions/deletions the start is where the lines would be.
+ */
+struct Hunk {
+    int oldStart = 0;
+    int oldCount = 0;
+    int newStart = 0;
+    int newCount = 0;
+};
+
+/**
+ * Split text into lines, at \n, a \r before it is dropped.
+ */
+QStringList splitLines(const QString &text);
+
+/**
+ * The changes from oldLines to newLines, ordered, without context.
+ */
+std::vector<Hunk> diff(const QStringList &oldLines, const QStringList &newLines, Options options = None);
+
+/**
+ * Unified diff of the given changes, like diff -u, empty if there are none.
+ */
+QString unifiedDiff(const QStringList &oldLines,
+                    const QStringList &newLines,
+                    const std::vector<Hunk> &hunks,
+                    const QString &oldName,
+                    const QString &newName,
+                    int context = 3);
+}
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(LineDiff::Options)